@@ -39,9 +39,18 @@
 
 
 #include <iostream>
+#include <map>
 #include <string>
 
 #include <QElapsedTimer>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#if defined(OPENFLUID_OS_UNIX)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 #include <openfluid/fluidx/FluidXDescriptor.hpp>
 #include <openfluid/base/ApplicationException.hpp>
@@ -58,6 +67,8 @@
 #include <openfluid/machine/ObserverInstance.hpp>
 #include <openfluid/machine/MonitoringInstance.hpp>
 #include <openfluid/machine/Factory.hpp>
+#include <openfluid/machine/HaloExchanger.hpp>
+#include <openfluid/core/SpatialGraphPartitioning.hpp>
 #include <openfluid/buddies/OpenFLUIDBuddy.hpp>
 #include <openfluid/buddies/NewSimBuddy.hpp>
 #include <openfluid/buddies/NewDataBuddy.hpp>
@@ -76,7 +87,7 @@
 
 
 OpenFLUIDApp::OpenFLUIDApp() :
-  mp_RunEnv(nullptr)
+  mp_RunEnv(nullptr), m_PartitionsCount(1)
 {
   m_RunType = None;
   mp_Engine = nullptr;
@@ -584,6 +595,12 @@ void OpenFLUIDApp::printEnvInfos()
 
 void OpenFLUIDApp::runSimulation()
 {
+  if (m_PartitionsCount > 1)
+  {
+    runPartitionedSimulation();
+    return;
+  }
+
   QElapsedTimer FullTimer;
   QElapsedTimer EffectiveRunTimer;
 
@@ -746,6 +763,243 @@ void OpenFLUIDApp::runSimulation()
 // =====================================================================
 
 
+void OpenFLUIDApp::runPartitionedSimulation()
+{
+#if defined(OPENFLUID_OS_UNIX)
+  typedef openfluid::core::SpatialGraphPartitioning::PartitionID_t PartitionID_t;
+
+  QElapsedTimer FullTimer;
+  FullTimer.start();
+
+  std::unique_ptr<openfluid::base::IOListener> IOListener(new DefaultIOListener());
+
+  printOpenFLUIDInfos();
+  printEnvInfos();
+
+
+  std::cout << "* Loading data... " << std::endl;
+  std::cout.flush();
+  openfluid::fluidx::FluidXDescriptor FXDesc(IOListener.get());
+  FXDesc.loadFromDirectory(openfluid::base::RunContextManager::instance()->getInputDir());
+
+
+  std::cout << "* Building spatial domain... ";
+  std::cout.flush();
+  openfluid::machine::Factory::buildSimulationBlobFromDescriptors(FXDesc,m_SimBlob);
+  openfluid::tools::Console::setOKColor();
+  std::cout << "[OK]";
+  openfluid::tools::Console::resetAttributes();
+  std::cout << std::endl;
+
+
+  std::cout << "* Partitioning spatial domain... ";
+  std::cout.flush();
+  openfluid::core::SpatialGraphPartitioning Partitioning;
+  Partitioning.compute(&(m_SimBlob.spatialGraph()),m_PartitionsCount);
+  openfluid::tools::Console::setOKColor();
+  std::cout << "[OK]";
+  openfluid::tools::Console::resetAttributes();
+  std::cout << std::endl;
+
+  std::cout << std::endl;
+  std::cout << "Spatial domain, " << m_SimBlob.spatialGraph().getUnitsCount() << " units in "
+            << m_PartitionsCount << " partitions, " << Partitioning.getCutLinksCount() << " cut links :" << std::endl;
+  for (PartitionID_t p = 0; p < m_PartitionsCount; p++)
+    std::cout << "  - partition " << p << ", " << Partitioning.units(p).size() << " units" << std::endl;
+  std::cout << std::endl;
+
+
+  // channels between partitions linked by their halos, the channel (P,Q) being used by the process of partition P
+
+  std::map<std::pair<PartitionID_t,PartitionID_t>,std::unique_ptr<openfluid::machine::HaloChannel>> Channels;
+
+  for (PartitionID_t p = 0; p < m_PartitionsCount; p++)
+  {
+    for (PartitionID_t q = p+1; q < m_PartitionsCount; q++)
+    {
+      if (!Partitioning.haloUnits(p,q).empty() || !Partitioning.haloUnits(q,p).empty())
+      {
+        std::unique_ptr<openfluid::machine::HaloChannel> ChannelP(new openfluid::machine::HaloChannel());
+        std::unique_ptr<openfluid::machine::HaloChannel> ChannelQ(new openfluid::machine::HaloChannel());
+        openfluid::machine::HaloChannel::createPair(*ChannelP,*ChannelQ);
+        Channels[std::make_pair(p,q)] = std::move(ChannelP);
+        Channels[std::make_pair(q,p)] = std::move(ChannelQ);
+      }
+    }
+  }
+
+
+  const std::string OutputDir = openfluid::base::RunContextManager::instance()->getOutputDir();
+
+  std::cout << "**** Running simulation in " << m_PartitionsCount << " processes ****" << std::endl;
+  std::cout.flush();
+
+  QElapsedTimer EffectiveRunTimer;
+  EffectiveRunTimer.start();
+
+  std::vector<pid_t> Processes;
+
+  for (PartitionID_t p = 0; p < m_PartitionsCount; p++)
+  {
+    pid_t PID = fork();
+
+    if (PID < 0)
+      throw openfluid::base::ApplicationException(openfluid::base::ApplicationException::computeContext("openfluid"),
+                                                  "Cannot create process for partition " + std::to_string(p));
+
+    if (PID == 0)
+    {
+      // process of the partition, which runs the engine on its restricted spatial graph
+      int ReturnValue = 0;
+
+      try
+      {
+        openfluid::machine::HaloExchanger Exchanger(&(m_SimBlob.spatialGraph()),Partitioning,p);
+
+        for (PartitionID_t Other : Exchanger.getNeighbourPartitions())
+          Exchanger.setChannel(Other,std::move(Channels[std::make_pair(p,Other)]));
+
+        // channels of other partitions are closed in this process
+        Channels.clear();
+
+        Exchanger.restrictSpatialGraph();
+
+        openfluid::base::RunContextManager::instance()->setOutputDir(OutputDir+"/partition-"+std::to_string(p));
+
+        openfluid::machine::MachineListener MListener;
+        openfluid::machine::ModelInstance Model(m_SimBlob,&MListener);
+        openfluid::machine::MonitoringInstance Monitoring(m_SimBlob);
+
+        openfluid::machine::Factory::buildModelInstanceFromDescriptor(FXDesc.modelDescriptor(),Model);
+        openfluid::machine::Factory::buildMonitoringInstanceFromDescriptor(FXDesc.monitoringDescriptor(),Monitoring);
+        Model.setHaloExchanger(&Exchanger);
+
+        openfluid::machine::Engine PartitionEngine(m_SimBlob,Model,Monitoring,&MListener);
+
+        PartitionEngine.initialize();
+        PartitionEngine.initParams();
+        PartitionEngine.prepareData();
+        PartitionEngine.checkConsistency();
+        PartitionEngine.run();
+        PartitionEngine.finalize();
+      }
+      catch (openfluid::base::Exception& E)
+      {
+        std::cerr << "ERROR in partition " << p << ": "
+                  << E.getMessage() << " [" << E.getContext().toString() << "]" << std::endl;
+        ReturnValue = 1;
+      }
+      catch (std::exception& E)
+      {
+        std::cerr << "ERROR in partition " << p << ": " << E.what() << std::endl;
+        ReturnValue = 1;
+      }
+
+      std::cout.flush();
+      std::cerr.flush();
+      _exit(ReturnValue);
+    }
+
+    Processes.push_back(PID);
+  }
+
+  // all channels are owned by the partitions processes,
+  // so that a failing process is detected by the processes of the partitions linked to it
+  Channels.clear();
+
+  std::vector<PartitionID_t> FailedPartitions;
+
+  for (PartitionID_t p = 0; p < m_PartitionsCount; p++)
+  {
+    int Status = 0;
+
+    if (waitpid(Processes[p],&Status,0) < 0 || !WIFEXITED(Status) || WEXITSTATUS(Status) != 0)
+      FailedPartitions.push_back(p);
+  }
+
+  qint64 EffectiveTime = EffectiveRunTimer.elapsed();
+
+  if (!FailedPartitions.empty())
+  {
+    std::string FailedStr;
+
+    for (PartitionID_t p : FailedPartitions)
+      FailedStr += (FailedStr.empty() ? "" : ", ") + std::to_string(p);
+
+    throw openfluid::base::ApplicationException(openfluid::base::ApplicationException::computeContext("openfluid"),
+                                                "Simulation failed in partitions " + FailedStr);
+  }
+
+  std::cout << "**** Simulation completed ****" << std::endl << std::endl;
+  std::cout << std::endl;
+
+  const unsigned int KeptCount = mergePartitionsOutputs(OutputDir);
+
+  std::cout << "Outputs of partitions are merged in " << OutputDir << std::endl;
+  if (KeptCount)
+    std::cout << KeptCount << " outputs produced by several partitions are kept in "
+              << OutputDir << "/partition-*" << std::endl;
+  std::cout << std::endl;
+
+  std::cout << "Simulation run time: " << openfluid::tools::getDurationAsPrettyString(EffectiveTime) << std::endl;
+  std::cout << "     Total run time: "
+            << openfluid::tools::getDurationAsPrettyString(FullTimer.elapsed()) << std::endl;
+  std::cout << std::endl;
+#else
+  throw openfluid::base::ApplicationException(openfluid::base::ApplicationException::computeContext("openfluid"),
+                                              "Partitioned simulations are not supported on this system");
+#endif
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+unsigned int OpenFLUIDApp::mergePartitionsOutputs(const std::string& OutputDir)
+{
+  const QDir OutputQDir(QString::fromStdString(OutputDir));
+  std::map<QString,std::vector<QString>> PartitionsDirsByOutput;
+
+  for (unsigned int p = 0; p < m_PartitionsCount; p++)
+  {
+    const QString PartitionDir = OutputQDir.filePath(QString("partition-%1").arg(p));
+
+    for (const QString& Name : QDir(PartitionDir).entryList(QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot))
+      PartitionsDirsByOutput[Name].push_back(PartitionDir);
+  }
+
+  unsigned int KeptCount = 0;
+
+  for (auto& Output : PartitionsDirsByOutput)
+  {
+    const QString Dest = OutputQDir.filePath(Output.first);
+
+    if (Output.second.size() == 1)
+    {
+      // outputs of a previous run are replaced, as in a non-partitioned run
+      if (QFileInfo(Dest).isFile())
+        QFile::remove(Dest);
+
+      if (QDir().rename(QDir(Output.second.front()).filePath(Output.first),Dest))
+        continue;
+    }
+
+    KeptCount++;
+  }
+
+  // output directories of partitions are removed when all their outputs are merged
+  for (unsigned int p = 0; p < m_PartitionsCount; p++)
+    OutputQDir.rmdir(QString("partition-%1").arg(p));
+
+  return KeptCount;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 void OpenFLUIDApp::processOptions(int ArgC, char **ArgV)
 {
 
@@ -762,7 +1016,10 @@ void OpenFLUIDApp::processOptions(int ArgC, char **ArgV)
     openfluid::utils::CommandLineOption("auto-output-dir","a","create automatic output directory"),
     openfluid::utils::CommandLineOption("max-threads","t",
                                         "set maximum number of threads for threaded spatial loops"
-                                        " (default is "+DefaultMaxThreadsStr+")",true)
+                                        " (default is "+DefaultMaxThreadsStr+")",true),
+    openfluid::utils::CommandLineOption("partitions","",
+                                        "run the simulation with one process per partition of the spatial domain"
+                                        " (default is 1, UNIX systems only)",true)
   };
 
 
@@ -891,6 +1148,22 @@ void OpenFLUIDApp::processOptions(int ArgC, char **ArgV)
                 "wrong value for threads number");
     }
 
+    if (Parser.command(ActiveCommandStr).isOptionActive("partitions"))
+    {
+      if (!openfluid::tools::convertString(Parser.command(ActiveCommandStr).getOptionValue("partitions"),
+                                           &m_PartitionsCount) || !m_PartitionsCount)
+        throw openfluid::base::ApplicationException(
+            openfluid::base::ApplicationException::computeContext("openfluid","command line parsing"),
+                "wrong value for partitions number");
+
+#if !defined(OPENFLUID_OS_UNIX)
+      if (m_PartitionsCount > 1)
+        throw openfluid::base::ApplicationException(
+            openfluid::base::ApplicationException::computeContext("openfluid","command line parsing"),
+                "partitioned simulations are only supported on UNIX systems");
+#endif
+    }
+
     if (Parser.command(ActiveCommandStr).isOptionActive("clean-output-dir"))
     {
       openfluid::base::RunContextManager::instance()->setClearOutputDir(true);
@@ -76,6 +76,8 @@ class OpenFLUIDApp
 
     std::unique_ptr<openfluid::machine::Engine> mp_Engine;
 
+    unsigned int m_PartitionsCount;
+
 
     void printlnExecMessagesStats();
 
@@ -113,6 +115,20 @@ class OpenFLUIDApp
     */
     void runSimulation();
 
+    /**
+      Runs simulation with one engine process per partition of the spatial graph
+    */
+    void runPartitionedSimulation();
+
+    /**
+      Merges the outputs of partitions into the output directory.
+      Files and directories produced by only one partition are moved to the output directory,
+      the others (such as logs produced by all partitions) are kept in the output directory of each partition.
+      @param[in] OutputDir the output directory of the simulation
+      @return the number of outputs kept in the output directories of partitions
+    */
+    unsigned int mergePartitionsOutputs(const std::string& OutputDir);
+
     /**
       Runs buddy
     */
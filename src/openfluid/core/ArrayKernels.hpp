@@ -0,0 +1,513 @@
+/*
+
+  This file is part of OpenFLUID software
+  Copyright(c) 2007, INRA - Montpellier SupAgro
+
+
+ == GNU General Public License Usage ==
+
+  OpenFLUID is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OpenFLUID is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OpenFLUID. If not, see <http://www.gnu.org/licenses/>.
+
+
+ == Other Usage ==
+
+  Other Usage means a use of OpenFLUID that is inconsistent with the GPL
+  license, and requires a written agreement between You and INRA.
+  Licensees for Other Usage of OpenFLUID may use this file in accordance
+  with the terms contained in the written agreement between You and INRA.
+  
+*/
+
+
+
+/**
+  @file ArrayKernels.hpp
+
+  @author Jean-Christophe FABRE <jean-christophe.fabre@supagro.inra.fr>
+*/
+
+
+#ifndef __OPENFLUID_CORE_ARRAYKERNELS_HPP__
+#define __OPENFLUID_CORE_ARRAYKERNELS_HPP__
+
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <algorithm>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define OPENFLUID_ARRAYKERNELS_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OPENFLUID_ARRAYKERNELS_SSE2
+#endif
+
+
+namespace openfluid { namespace core { namespace kernels {
+
+
+/**
+  Alignment in bytes of arrays allocated for vectors and matrices, matching the cache line size
+  and the widest SIMD registers
+*/
+constexpr std::size_t ArraysAlignment = 64;
+
+
+// =====================================================================
+// =====================================================================
+
+
+/**
+  Allocates an array of Size default-initialized elements, aligned on ArraysAlignment bytes
+  @param[in] Size the number of elements
+  @return a pointer to the first element, or nullptr if the allocation failed
+*/
+template<typename T>
+T* allocateAlignedArray(std::size_t Size)
+{
+  // the address of the raw memory block is stored just before the aligned array
+  void* Raw = ::operator new(Size*sizeof(T)+ArraysAlignment+sizeof(void*),std::nothrow);
+
+  if (Raw == nullptr)
+    return nullptr;
+
+  std::uintptr_t Address = reinterpret_cast<std::uintptr_t>(Raw)+sizeof(void*);
+  Address = (Address+ArraysAlignment-1) & ~static_cast<std::uintptr_t>(ArraysAlignment-1);
+
+  T* Array = reinterpret_cast<T*>(Address);
+  reinterpret_cast<void**>(Array)[-1] = Raw;
+
+  std::size_t i = 0;
+
+  try
+  {
+    for (;i<Size;i++)
+      new (Array+i) T;
+  }
+  catch (...)
+  {
+    while (i > 0)
+      Array[--i].~T();
+    ::operator delete(Raw);
+    throw;
+  }
+
+  return Array;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+/**
+  Releases an array allocated using allocateAlignedArray()
+  @param[in] Array the pointer to the first element, can be nullptr
+  @param[in] Size the number of elements
+*/
+template<typename T>
+void releaseAlignedArray(T* Array, std::size_t Size)
+{
+  if (Array == nullptr)
+    return;
+
+  for (std::size_t i=0;i<Size;i++)
+    Array[i].~T();
+
+  ::operator delete(reinterpret_cast<void**>(Array)[-1]);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+/*
+  Generic kernels, written with independent partial results so that they can be vectorized by the compiler.
+  Arrays may be aliased only if they are the same array (in-place operations).
+*/
+
+
+/**
+  Computes R[i] = A[i] + B[i]
+*/
+template<typename T>
+inline void add(const T* A, const T* B, T* R, std::size_t Size)
+{
+  for (std::size_t i=0;i<Size;i++)
+    R[i] = A[i]+B[i];
+}
+
+
+/**
+  Computes R[i] = A[i] - B[i]
+*/
+template<typename T>
+inline void subtract(const T* A, const T* B, T* R, std::size_t Size)
+{
+  for (std::size_t i=0;i<Size;i++)
+    R[i] = A[i]-B[i];
+}
+
+
+/**
+  Computes R[i] = A[i] * B[i]
+*/
+template<typename T>
+inline void multiply(const T* A, const T* B, T* R, std::size_t Size)
+{
+  for (std::size_t i=0;i<Size;i++)
+    R[i] = A[i]*B[i];
+}
+
+
+/**
+  Computes R[i] = A[i] / B[i]
+*/
+template<typename T>
+inline void divide(const T* A, const T* B, T* R, std::size_t Size)
+{
+  for (std::size_t i=0;i<Size;i++)
+    R[i] = A[i]/B[i];
+}
+
+
+/**
+  Computes X[i] = Factor * X[i]
+*/
+template<typename T>
+inline void scale(T Factor, T* X, std::size_t Size)
+{
+  for (std::size_t i=0;i<Size;i++)
+    X[i] *= Factor;
+}
+
+
+/**
+  Computes Y[i] = Y[i] + Factor * X[i]
+*/
+template<typename T>
+inline void axpy(T Factor, const T* X, T* Y, std::size_t Size)
+{
+  for (std::size_t i=0;i<Size;i++)
+    Y[i] += Factor*X[i];
+}
+
+
+/**
+  Returns the sum of A[i] * B[i]
+*/
+template<typename T>
+inline T dot(const T* A, const T* B, std::size_t Size)
+{
+  T Partial[4] = {T(),T(),T(),T()};
+  std::size_t i = 0;
+
+  for (;i+4<=Size;i+=4)
+  {
+    Partial[0] += A[i]*B[i];
+    Partial[1] += A[i+1]*B[i+1];
+    Partial[2] += A[i+2]*B[i+2];
+    Partial[3] += A[i+3]*B[i+3];
+  }
+
+  for (;i<Size;i++)
+    Partial[0] += A[i]*B[i];
+
+  return (Partial[0]+Partial[1])+(Partial[2]+Partial[3]);
+}
+
+
+/**
+  Returns the sum of X[i]
+*/
+template<typename T>
+inline T sum(const T* X, std::size_t Size)
+{
+  T Partial[4] = {T(),T(),T(),T()};
+  std::size_t i = 0;
+
+  for (;i+4<=Size;i+=4)
+  {
+    Partial[0] += X[i];
+    Partial[1] += X[i+1];
+    Partial[2] += X[i+2];
+    Partial[3] += X[i+3];
+  }
+
+  for (;i<Size;i++)
+    Partial[0] += X[i];
+
+  return (Partial[0]+Partial[1])+(Partial[2]+Partial[3]);
+}
+
+
+/**
+  Returns the minimum of X[i], Size must be greater than 0
+*/
+template<typename T>
+inline T min(const T* X, std::size_t Size)
+{
+  return *std::min_element(X,X+Size);
+}
+
+
+/**
+  Returns the maximum of X[i], Size must be greater than 0
+*/
+template<typename T>
+inline T max(const T* X, std::size_t Size)
+{
+  return *std::max_element(X,X+Size);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+#if defined(OPENFLUID_ARRAYKERNELS_AVX) || defined(OPENFLUID_ARRAYKERNELS_SSE2)
+
+
+/*
+  Kernels for double precision values using SIMD instructions, with unaligned loads and stores
+  so that they also apply to parts of arrays
+*/
+
+
+namespace detail {
+
+#if defined(OPENFLUID_ARRAYKERNELS_AVX)
+
+typedef __m256d DoublePack_t;
+
+constexpr std::size_t DoublePackWidth = 4;
+
+inline DoublePack_t loadPack(const double* P) { return _mm256_loadu_pd(P); }
+inline void storePack(double* P, DoublePack_t V) { _mm256_storeu_pd(P,V); }
+inline DoublePack_t broadcastPack(double V) { return _mm256_set1_pd(V); }
+struct PackAdd { DoublePack_t operator()(DoublePack_t A, DoublePack_t B) const { return _mm256_add_pd(A,B); } };
+struct PackSub { DoublePack_t operator()(DoublePack_t A, DoublePack_t B) const { return _mm256_sub_pd(A,B); } };
+struct PackMul { DoublePack_t operator()(DoublePack_t A, DoublePack_t B) const { return _mm256_mul_pd(A,B); } };
+struct PackDiv { DoublePack_t operator()(DoublePack_t A, DoublePack_t B) const { return _mm256_div_pd(A,B); } };
+struct PackMin { DoublePack_t operator()(DoublePack_t A, DoublePack_t B) const { return _mm256_min_pd(A,B); } };
+struct PackMax { DoublePack_t operator()(DoublePack_t A, DoublePack_t B) const { return _mm256_max_pd(A,B); } };
+
+#else
+
+typedef __m128d DoublePack_t;
+
+constexpr std::size_t DoublePackWidth = 2;
+
+inline DoublePack_t loadPack(const double* P) { return _mm_loadu_pd(P); }
+inline void storePack(double* P, DoublePack_t V) { _mm_storeu_pd(P,V); }
+inline DoublePack_t broadcastPack(double V) { return _mm_set1_pd(V); }
+struct PackAdd { DoublePack_t operator()(DoublePack_t A, DoublePack_t B) const { return _mm_add_pd(A,B); } };
+struct PackSub { DoublePack_t operator()(DoublePack_t A, DoublePack_t B) const { return _mm_sub_pd(A,B); } };
+struct PackMul { DoublePack_t operator()(DoublePack_t A, DoublePack_t B) const { return _mm_mul_pd(A,B); } };
+struct PackDiv { DoublePack_t operator()(DoublePack_t A, DoublePack_t B) const { return _mm_div_pd(A,B); } };
+struct PackMin { DoublePack_t operator()(DoublePack_t A, DoublePack_t B) const { return _mm_min_pd(A,B); } };
+struct PackMax { DoublePack_t operator()(DoublePack_t A, DoublePack_t B) const { return _mm_max_pd(A,B); } };
+
+#endif
+
+
+/**
+  Applies a binary operation on packs of elements, then on the remaining elements
+*/
+template<typename PackOp, typename ScalarOp>
+inline void applyBinary(const double* A, const double* B, double* R, std::size_t Size,
+                        PackOp POp, ScalarOp SOp)
+{
+  std::size_t i = 0;
+
+  for (;i+DoublePackWidth<=Size;i+=DoublePackWidth)
+    storePack(R+i,POp(loadPack(A+i),loadPack(B+i)));
+
+  for (;i<Size;i++)
+    R[i] = SOp(A[i],B[i]);
+}
+
+
+/**
+  Reduces packs of elements using two independent accumulators, then reduces the accumulators
+  and the remaining elements
+*/
+template<typename LoadOp, typename PackOp, typename ScalarOp>
+inline double reduce(std::size_t Size, DoublePack_t Init, double ScalarInit,
+                     LoadOp Load, PackOp POp, ScalarOp SOp)
+{
+  DoublePack_t Acc0 = Init, Acc1 = Init;
+  std::size_t i = 0;
+
+  for (;i+2*DoublePackWidth<=Size;i+=2*DoublePackWidth)
+  {
+    Acc0 = POp(Acc0,Load(i));
+    Acc1 = POp(Acc1,Load(i+DoublePackWidth));
+  }
+
+  for (;i+DoublePackWidth<=Size;i+=DoublePackWidth)
+    Acc0 = POp(Acc0,Load(i));
+
+  double Lanes[DoublePackWidth];
+  storePack(Lanes,POp(Acc0,Acc1));
+
+  double Result = ScalarInit;
+
+  for (std::size_t l=0;l<DoublePackWidth;l++)
+    Result = SOp(Result,Lanes[l]);
+
+  return Result;
+}
+
+}  // namespace detail
+
+
+// =====================================================================
+// =====================================================================
+
+
+template<>
+inline void add<double>(const double* A, const double* B, double* R, std::size_t Size)
+{
+  detail::applyBinary(A,B,R,Size,detail::PackAdd(),[](double X, double Y){ return X+Y; });
+}
+
+
+template<>
+inline void subtract<double>(const double* A, const double* B, double* R, std::size_t Size)
+{
+  detail::applyBinary(A,B,R,Size,detail::PackSub(),[](double X, double Y){ return X-Y; });
+}
+
+
+template<>
+inline void multiply<double>(const double* A, const double* B, double* R, std::size_t Size)
+{
+  detail::applyBinary(A,B,R,Size,detail::PackMul(),[](double X, double Y){ return X*Y; });
+}
+
+
+template<>
+inline void divide<double>(const double* A, const double* B, double* R, std::size_t Size)
+{
+  detail::applyBinary(A,B,R,Size,detail::PackDiv(),[](double X, double Y){ return X/Y; });
+}
+
+
+template<>
+inline void scale<double>(double Factor, double* X, std::size_t Size)
+{
+  const detail::DoublePack_t F = detail::broadcastPack(Factor);
+  std::size_t i = 0;
+
+  for (;i+detail::DoublePackWidth<=Size;i+=detail::DoublePackWidth)
+    detail::storePack(X+i,detail::PackMul()(F,detail::loadPack(X+i)));
+
+  for (;i<Size;i++)
+    X[i] *= Factor;
+}
+
+
+template<>
+inline void axpy<double>(double Factor, const double* X, double* Y, std::size_t Size)
+{
+  const detail::DoublePack_t F = detail::broadcastPack(Factor);
+  std::size_t i = 0;
+
+  for (;i+detail::DoublePackWidth<=Size;i+=detail::DoublePackWidth)
+    detail::storePack(Y+i,detail::PackAdd()(detail::loadPack(Y+i),detail::PackMul()(F,detail::loadPack(X+i))));
+
+  for (;i<Size;i++)
+    Y[i] += Factor*X[i];
+}
+
+
+template<>
+inline double dot<double>(const double* A, const double* B, std::size_t Size)
+{
+  const std::size_t PacksEnd = Size-Size%detail::DoublePackWidth;
+  double Result =
+    detail::reduce(PacksEnd,detail::broadcastPack(0.0),0.0,
+                   [A,B](std::size_t i){ return detail::PackMul()(detail::loadPack(A+i),detail::loadPack(B+i)); },
+                   detail::PackAdd(),[](double X, double Y){ return X+Y; });
+
+  for (std::size_t i=PacksEnd;i<Size;i++)
+    Result += A[i]*B[i];
+
+  return Result;
+}
+
+
+template<>
+inline double sum<double>(const double* X, std::size_t Size)
+{
+  const std::size_t PacksEnd = Size-Size%detail::DoublePackWidth;
+  double Result =
+    detail::reduce(PacksEnd,detail::broadcastPack(0.0),0.0,
+                   [X](std::size_t i){ return detail::loadPack(X+i); },
+                   detail::PackAdd(),[](double A, double B){ return A+B; });
+
+  for (std::size_t i=PacksEnd;i<Size;i++)
+    Result += X[i];
+
+  return Result;
+}
+
+
+template<>
+inline double min<double>(const double* X, std::size_t Size)
+{
+  const std::size_t PacksEnd = Size-Size%detail::DoublePackWidth;
+  double Result = X[0];
+
+  if (PacksEnd)
+    Result = detail::reduce(PacksEnd,detail::broadcastPack(X[0]),X[0],
+                            [X](std::size_t i){ return detail::loadPack(X+i); },
+                            detail::PackMin(),[](double A, double B){ return std::min(A,B); });
+
+  for (std::size_t i=PacksEnd;i<Size;i++)
+    Result = std::min(Result,X[i]);
+
+  return Result;
+}
+
+
+template<>
+inline double max<double>(const double* X, std::size_t Size)
+{
+  const std::size_t PacksEnd = Size-Size%detail::DoublePackWidth;
+  double Result = X[0];
+
+  if (PacksEnd)
+    Result = detail::reduce(PacksEnd,detail::broadcastPack(X[0]),X[0],
+                            [X](std::size_t i){ return detail::loadPack(X+i); },
+                            detail::PackMax(),[](double A, double B){ return std::max(A,B); });
+
+  for (std::size_t i=PacksEnd;i<Size;i++)
+    Result = std::max(Result,X[i]);
+
+  return Result;
+}
+
+
+#endif
+
+
+} } }  // namespaces
+
+
+#endif /* __OPENFLUID_CORE_ARRAYKERNELS_HPP__ */
@@ -52,7 +52,8 @@ namespace openfluid { namespace core {
 // =====================================================================
 
 
-Attributes::Attributes()
+Attributes::Attributes() :
+  mp_Table(nullptr), m_Slot(0)
 {
 
 }
@@ -62,9 +63,86 @@ Attributes::Attributes()
 // =====================================================================
 
 
+Attributes::Attributes(const Attributes& Attrs) :
+  mp_Table(nullptr), m_Slot(0)
+{
+  *this = Attrs;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+Attributes& Attributes::operator=(const Attributes& Attrs)
+{
+  if (this == &Attrs)
+    return *this;
+
+  clear();
+
+  if (Attrs.mp_Table)
+  {
+    for (auto& Name : Attrs.mp_Table->getNames(Attrs.m_Slot))
+      table()->setValue(m_Slot,Name,*(Attrs.mp_Table->value(Attrs.m_Slot,Name)));
+  }
+
+  return *this;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 Attributes::~Attributes()
 {
+  if (mp_Table && !m_OwnTable)
+    mp_Table->releaseSlot(m_Slot);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+AttributesTable* Attributes::table()
+{
+  if (!mp_Table)
+  {
+    m_OwnTable.reset(new AttributesTable());
+    mp_Table = m_OwnTable.get();
+    m_Slot = mp_Table->acquireSlot();
+  }
 
+  return mp_Table;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void Attributes::attachToTable(AttributesTable* Table)
+{
+  if (Table == mp_Table || Table == nullptr)
+    return;
+
+  std::size_t NewSlot = Table->acquireSlot();
+
+  if (mp_Table)
+  {
+    for (auto& Name : mp_Table->getNames(m_Slot))
+      Table->setValue(NewSlot,Name,*(mp_Table->value(m_Slot,Name)));
+
+    if (m_OwnTable)
+      m_OwnTable.reset();
+    else
+      mp_Table->releaseSlot(m_Slot);
+  }
+
+  mp_Table = Table;
+  m_Slot = NewSlot;
 }
 
 
@@ -77,7 +155,7 @@ bool Attributes::setValue(const AttributeName_t& aName, const Value& aValue)
   if (isAttributeExist(aName))
     return false;
 
-  m_Data[aName].reset(aValue.clone());
+  table()->setValue(m_Slot,aName,aValue);
 
   return true;
 }
@@ -92,7 +170,7 @@ bool Attributes::setValue(const AttributeName_t& aName, const std::string& aValu
   if (isAttributeExist(aName))
     return false;
 
-  m_Data[aName].reset(new StringValue(aValue));
+  table()->setValue(m_Slot,aName,StringValue(aValue));
 
   return true;
 }
@@ -116,7 +194,7 @@ bool Attributes::setValueFromRawString(const AttributeName_t& aName, const std::
       double TmpVal;
       if (!TmpStrValue.toDouble(TmpVal))
         return false;
-      m_Data[aName].reset(new DoubleValue(TmpVal));
+      table()->setValue(m_Slot,aName,DoubleValue(TmpVal));
       break;
     }
 
@@ -126,7 +204,7 @@ bool Attributes::setValueFromRawString(const AttributeName_t& aName, const std::
       long TmpVal;
       if (!TmpStrValue.toInteger(TmpVal))
         return false;
-      m_Data[aName].reset(new IntegerValue(TmpVal));
+      table()->setValue(m_Slot,aName,IntegerValue(TmpVal));
       break;
     }
 
@@ -135,13 +213,13 @@ bool Attributes::setValueFromRawString(const AttributeName_t& aName, const std::
       bool TmpVal;
       if (!TmpStrValue.toBoolean(TmpVal))
         return false;
-      m_Data[aName].reset(new BooleanValue(TmpVal));
+      table()->setValue(m_Slot,aName,BooleanValue(TmpVal));
       break;
     }
 
     case Value::STRING :
     {
-      m_Data[aName].reset(new StringValue(aValue));
+      table()->setValue(m_Slot,aName,TmpStrValue);
       break;
     }
 
@@ -150,7 +228,7 @@ bool Attributes::setValueFromRawString(const AttributeName_t& aName, const std::
       VectorValue TmpVal;
       if (!TmpStrValue.toVectorValue(TmpVal))
         return false;
-      m_Data[aName].reset(TmpVal.clone());
+      table()->setValue(m_Slot,aName,TmpVal);
       break;
     }
 
@@ -159,7 +237,7 @@ bool Attributes::setValueFromRawString(const AttributeName_t& aName, const std::
       MatrixValue TmpVal;
       if (!TmpStrValue.toMatrixValue(TmpVal))
         return false;
-      m_Data[aName].reset(TmpVal.clone());
+      table()->setValue(m_Slot,aName,TmpVal);
       break;
     }
 
@@ -168,7 +246,7 @@ bool Attributes::setValueFromRawString(const AttributeName_t& aName, const std::
       MapValue TmpVal;
       if (!TmpStrValue.toMapValue(TmpVal))
         return false;
-      m_Data[aName].reset(TmpVal.clone());
+      table()->setValue(m_Slot,aName,TmpVal);
       break;
     }
 
@@ -177,7 +255,7 @@ bool Attributes::setValueFromRawString(const AttributeName_t& aName, const std::
       TreeValue TmpVal;
       if (!TmpStrValue.toTreeValue(TmpVal))
         return false;
-      m_Data[aName].reset(TmpVal.clone());
+      table()->setValue(m_Slot,aName,TmpVal);
       break;
     }
 
@@ -186,7 +264,7 @@ bool Attributes::setValueFromRawString(const AttributeName_t& aName, const std::
       NullValue TmpVal;
       if (!TmpStrValue.toNullValue(TmpVal))
         return false;
-      m_Data[aName].reset(TmpVal.clone());
+      table()->setValue(m_Slot,aName,TmpVal);
       break;
     }
 
@@ -204,13 +282,11 @@ bool Attributes::setValueFromRawString(const AttributeName_t& aName, const std::
 
 bool Attributes::getValue(const AttributeName_t& aName, openfluid::core::StringValue& aValue) const
 {
-  // Don't use m_data[aName] because [] operator is not const
+  const Value* Val = value(aName);
 
-  AttributesMap_t::const_iterator it = m_Data.find(aName);
-
-  if (it != m_Data.end())
+  if (Val)
   {
-    aValue.set(it->second.get()->toString());
+    aValue.set(Val->toString());
 
     return true;
   }
@@ -225,10 +301,8 @@ bool Attributes::getValue(const AttributeName_t& aName, openfluid::core::StringV
 
 const openfluid::core::Value* Attributes::value(const AttributeName_t& aName) const
 {
-  AttributesMap_t::const_iterator it = m_Data.find(aName);
-
-  if (it != m_Data.end())
-    return it->second.get();
+  if (mp_Table)
+    return mp_Table->value(m_Slot,aName);
 
   return nullptr;
 }
@@ -240,11 +314,11 @@ const openfluid::core::Value* Attributes::value(const AttributeName_t& aName) co
 
 bool Attributes::getValue(const AttributeName_t& aName, std::string& aValue) const
 {
-  AttributesMap_t::const_iterator it = m_Data.find(aName);
+  const Value* Val = value(aName);
 
-  if (it != m_Data.end())
+  if (Val)
   {
-    aValue = it->second.get()->toString();
+    aValue = Val->toString();
     return true;
   }
 
@@ -258,11 +332,11 @@ bool Attributes::getValue(const AttributeName_t& aName, std::string& aValue) con
 
 bool Attributes::getValueAsDouble(const AttributeName_t& aName, double& aValue) const
 {
-  AttributesMap_t::const_iterator it = m_Data.find(aName);
+  const Value* Val = value(aName);
 
-  if (it != m_Data.end() && it->second.get()->isDoubleValue())
+  if (Val && Val->isDoubleValue())
   {
-    aValue = it->second.get()->asDoubleValue();
+    aValue = Val->asDoubleValue();
     return true;
   }
   return false;
@@ -275,11 +349,11 @@ bool Attributes::getValueAsDouble(const AttributeName_t& aName, double& aValue)
 
 bool Attributes::getValueAsLong(const AttributeName_t& aName, long& aValue) const
 {
-  AttributesMap_t::const_iterator it = m_Data.find(aName);
+  const Value* Val = value(aName);
 
-  if (it != m_Data.end() && it->second.get()->isIntegerValue())
+  if (Val && Val->isIntegerValue())
   {
-    aValue = it->second.get()->asIntegerValue();
+    aValue = Val->asIntegerValue();
     return true;
   }
   return false;
@@ -292,7 +366,7 @@ bool Attributes::getValueAsLong(const AttributeName_t& aName, long& aValue) cons
 
 bool Attributes::isAttributeExist(const AttributeName_t& aName) const
 {
-  return m_Data.find(aName) != m_Data.end();
+  return value(aName) != nullptr;
 }
 
 
@@ -302,14 +376,10 @@ bool Attributes::isAttributeExist(const AttributeName_t& aName) const
 
 std::vector<AttributeName_t> Attributes::getAttributesNames() const
 {
-  std::vector<AttributeName_t> TheNames;
-
-  AttributesMap_t::const_iterator it;
+  if (mp_Table)
+    return mp_Table->getNames(m_Slot);
 
-  for (it = m_Data.begin(); it != m_Data.end(); ++it)
-    TheNames.push_back(it->first);
-
-  return TheNames;
+  return std::vector<AttributeName_t>();
 }
 
 
@@ -321,7 +391,7 @@ bool Attributes::replaceValue(const AttributeName_t& aName, const StringValue& a
 {
   if(isAttributeExist(aName))
   {
-    m_Data[aName].reset(new StringValue(aValue));
+    mp_Table->setValue(m_Slot,aName,aValue);
 
     return true;
   }
@@ -338,7 +408,7 @@ bool Attributes::replaceValue(const AttributeName_t& aName, const std::string& a
 {
   if(isAttributeExist(aName))
   {
-    m_Data[aName].reset(new StringValue(aValue));
+    mp_Table->setValue(m_Slot,aName,StringValue(aValue));
 
     return true;
   }
@@ -354,12 +424,8 @@ bool Attributes::replaceValue(const AttributeName_t& aName, const std::string& a
 
 bool Attributes::removeAttribute(const AttributeName_t& aName)
 {
-  if(isAttributeExist(aName))
-  {
-    m_Data.erase(aName);
-
-    return true;
-  }
+  if (mp_Table)
+    return mp_Table->removeValue(m_Slot,aName);
 
   return false;
 }
@@ -371,7 +437,8 @@ bool Attributes::removeAttribute(const AttributeName_t& aName)
 
 void Attributes::clear()
 {
-  m_Data.clear();
+  if (mp_Table)
+    mp_Table->clearSlot(m_Slot);
 }
 
 
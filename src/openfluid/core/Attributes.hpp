@@ -49,26 +49,53 @@
 #include <openfluid/core/Value.hpp>
 #include <openfluid/core/StringValue.hpp>
 #include <openfluid/core/IntegerValue.hpp>
+#include <openfluid/core/AttributesTable.hpp>
 
 
 namespace openfluid { namespace core {
 
 
+/**
+  Attributes of a spatial unit.
+  The values are stored in a slot of an attributes table, which is shared by all the units of a units class
+  once the unit is added to a units collection. Until then, the unit owns a private table.
+*/
 class OPENFLUID_API Attributes
 {
   private:
 
-    typedef std::map<AttributeName_t,std::shared_ptr<Value>> AttributesMap_t;
+    AttributesTable* mp_Table;
+
+    std::size_t m_Slot;
+
+    std::unique_ptr<AttributesTable> m_OwnTable;
 
-    AttributesMap_t m_Data;
+    AttributesTable* table();
 
 
   public:
 
     Attributes();
 
+    Attributes(const Attributes& Attrs);
+
+    Attributes& operator=(const Attributes& Attrs);
+
     ~Attributes();
 
+    /**
+      Moves the attributes values to the given table, which becomes the storage of these attributes.
+      The table must outlive the attributes.
+      @param[in] Table the attributes table
+    */
+    void attachToTable(AttributesTable* Table);
+
+    /**
+      Returns the slot of these attributes in their attributes table
+    */
+    inline std::size_t getSlot() const
+    { return m_Slot; };
+
     bool setValue(const AttributeName_t& aName, const Value& aValue);
 
     bool setValue(const AttributeName_t& aName, const std::string& aValue) OPENFLUID_DEPRECATED;
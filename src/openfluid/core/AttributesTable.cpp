@@ -0,0 +1,505 @@
+/*
+
+  This file is part of OpenFLUID software
+  Copyright(c) 2007, INRA - Montpellier SupAgro
+
+
+ == GNU General Public License Usage ==
+
+  OpenFLUID is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OpenFLUID is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OpenFLUID. If not, see <http://www.gnu.org/licenses/>.
+
+
+ == Other Usage ==
+
+  Other Usage means a use of OpenFLUID that is inconsistent with the GPL
+  license, and requires a written agreement between You and INRA.
+  Licensees for Other Usage of OpenFLUID may use this file in accordance
+  with the terms contained in the written agreement between You and INRA.
+  
+*/
+
+
+/**
+  @file AttributesTable.cpp
+
+  @author Jean-Christophe FABRE <jean-christophe.fabre@supagro.inra.fr>
+ */
+
+
+#include <algorithm>
+
+#include <openfluid/core/AttributesTable.hpp>
+
+
+namespace openfluid { namespace core {
+
+
+const Value* AttributesTable::Column::value(std::size_t Slot) const
+{
+  if (Slot >= States.size())
+    return nullptr;
+
+  if (States[Slot] == OTHER)
+    return Others[Slot].get();
+
+  if (States[Slot] == TYPED)
+  {
+    switch (StorageKind.load(std::memory_order_acquire))
+    {
+      case Storage::DOUBLES :
+        return &Doubles[Slot];
+      case Storage::INTEGERS :
+        return &Integers[Slot];
+      case Storage::STRINGS :
+        return &Strings[Slot];
+      default :
+        return nullptr;
+    }
+  }
+
+  return nullptr;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+bool AttributesTable::Column::getDouble(std::size_t Slot, double& Val) const
+{
+  if (Slot >= States.size() || States[Slot] == UNSET)
+    return false;
+
+  if (States[Slot] == TYPED)
+  {
+    switch (StorageKind.load(std::memory_order_acquire))
+    {
+      case Storage::DOUBLES :
+        Val = Doubles[Slot].get();
+        return true;
+      case Storage::INTEGERS :
+        Val = Integers[Slot].get();
+        return true;
+      default :
+        return false;
+    }
+  }
+
+  const Value* OtherVal = Others[Slot].get();
+
+  if (OtherVal->isDoubleValue())
+  {
+    Val = OtherVal->asDoubleValue().get();
+    return true;
+  }
+  else if (OtherVal->isIntegerValue())
+  {
+    Val = OtherVal->asIntegerValue().get();
+    return true;
+  }
+
+  return false;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void AttributesTable::Column::store(std::size_t Slot, const Value& Val, std::size_t Capacity)
+{
+  Value::Type ValType = Val.getType();
+  Storage Kind = StorageKind.load(std::memory_order_relaxed);
+
+  if (Kind == Storage::NONE)
+  {
+    // the storage of the column is fixed by its first value
+    if (ValType == Value::DOUBLE)
+      Kind = Storage::DOUBLES;
+    else if (ValType == Value::INTEGER)
+      Kind = Storage::INTEGERS;
+    else if (ValType == Value::STRING)
+      Kind = Storage::STRINGS;
+    else
+      Kind = Storage::OTHERS;
+
+    Type = ValType;
+    StorageKind.store(Kind,std::memory_order_release);
+  }
+
+  // each value keeps its own type, values not matching the storage of the column are stored individually
+  bool IsTyped = (Kind == Storage::DOUBLES && ValType == Value::DOUBLE) ||
+                 (Kind == Storage::INTEGERS && ValType == Value::INTEGER) ||
+                 (Kind == Storage::STRINGS && ValType == Value::STRING);
+
+  if (!IsTyped && ValType != Type)
+    Type = Value::NONE;
+
+
+  // columns are sized for all the slots at once, so that storing values of existing slots
+  // does not resize the storage while other slots are read
+  std::size_t Size = std::max(Slot+1,Capacity);
+
+  if (States.size() < Size)
+    States.resize(Size,UNSET);
+
+  unsigned char& State = States[Slot];
+
+  if (IsTyped)
+  {
+    // resizing a deque at its end does not invalidate references to existing values
+    switch (Kind)
+    {
+      case Storage::DOUBLES :
+        if (Doubles.size() < Size)
+          Doubles.resize(Size);
+        Doubles[Slot].set(Val.asDoubleValue().get());
+        break;
+      case Storage::INTEGERS :
+        if (Integers.size() < Size)
+          Integers.resize(Size);
+        Integers[Slot].set(Val.asIntegerValue().get());
+        break;
+      default :
+        if (Strings.size() < Size)
+          Strings.resize(Size);
+        Strings[Slot].set(Val.asStringValue().get());
+        break;
+    }
+
+    if (State == OTHER)
+      Others[Slot].reset();
+  }
+  else
+  {
+    if (Others.size() < Size)
+      Others.resize(Size);
+
+    // a value of the same type is assigned in place, keeping pointers to it valid
+    if (State == OTHER && Others[Slot]->getType() == ValType)
+      *(Others[Slot]) = Val;
+    else
+      Others[Slot].reset(Val.clone());
+  }
+
+  if (State == UNSET)
+    SetCount++;
+
+  State = IsTyped ? TYPED : OTHER;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void AttributesTable::Column::unset(std::size_t Slot)
+{
+  if (Slot >= States.size() || States[Slot] == UNSET)
+    return;
+
+  if (States[Slot] == OTHER)
+    Others[Slot].reset();
+  else if (StorageKind.load(std::memory_order_relaxed) == Storage::STRINGS)
+    Strings[Slot].set(std::string());
+
+  States[Slot] = UNSET;
+  SetCount--;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+AttributesTable::AttributesTable() :
+  mp_Index(nullptr), m_SlotsCount(0)
+{
+  publishIndex(new ColumnsIndex_t());
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+AttributesTable::~AttributesTable()
+{
+
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void AttributesTable::publishIndex(ColumnsIndex_t* Index)
+{
+  m_Indexes.emplace_back(Index);
+  mp_Index.store(Index,std::memory_order_release);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+const AttributesTable::Column* AttributesTable::findColumn(const AttributeName_t& Name) const
+{
+  const ColumnsIndex_t* Index = mp_Index.load(std::memory_order_acquire);
+
+  ColumnsIndex_t::const_iterator it = Index->find(Name);
+
+  if (it != Index->end())
+    return it->second;
+
+  return nullptr;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+AttributesTable::Column* AttributesTable::findOrCreateColumn(const AttributeName_t& Name)
+{
+  const ColumnsIndex_t* Index = mp_Index.load(std::memory_order_relaxed);
+
+  ColumnsIndex_t::const_iterator it = Index->find(Name);
+
+  if (it != Index->end())
+    return it->second;
+
+  // the current index may be in use by readers, a new one is published
+  m_Columns.emplace_back();
+
+  ColumnsIndex_t* NewIndex = new ColumnsIndex_t(*Index);
+  NewIndex->insert(std::make_pair(Name,&m_Columns.back()));
+  publishIndex(NewIndex);
+
+  return &m_Columns.back();
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+std::size_t AttributesTable::acquireSlot()
+{
+  std::lock_guard<std::mutex> Lock(m_Mutex);
+
+  if (!m_FreeSlots.empty())
+  {
+    std::size_t Slot = m_FreeSlots.back();
+    m_FreeSlots.pop_back();
+    return Slot;
+  }
+
+  return m_SlotsCount++;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void AttributesTable::releaseSlot(std::size_t Slot)
+{
+  std::lock_guard<std::mutex> Lock(m_Mutex);
+
+  for (Column& Col : m_Columns)
+    Col.unset(Slot);
+
+  m_FreeSlots.push_back(Slot);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void AttributesTable::setValue(std::size_t Slot, const AttributeName_t& Name, const Value& Val)
+{
+  std::lock_guard<std::mutex> Lock(m_Mutex);
+
+  findOrCreateColumn(Name)->store(Slot,Val,m_SlotsCount);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+const Value* AttributesTable::value(std::size_t Slot, const AttributeName_t& Name) const
+{
+  const Column* Col = findColumn(Name);
+
+  if (Col)
+    return Col->value(Slot);
+
+  return nullptr;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+bool AttributesTable::isValueExist(std::size_t Slot, const AttributeName_t& Name) const
+{
+  return value(Slot,Name) != nullptr;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+bool AttributesTable::removeValue(std::size_t Slot, const AttributeName_t& Name)
+{
+  std::lock_guard<std::mutex> Lock(m_Mutex);
+
+  Column* Col = const_cast<Column*>(findColumn(Name));
+
+  if (!Col || !Col->value(Slot))
+    return false;
+
+  Col->unset(Slot);
+
+  return true;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void AttributesTable::clearSlot(std::size_t Slot)
+{
+  std::lock_guard<std::mutex> Lock(m_Mutex);
+
+  for (Column& Col : m_Columns)
+    Col.unset(Slot);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+std::vector<AttributeName_t> AttributesTable::getNames(std::size_t Slot) const
+{
+  std::vector<AttributeName_t> TheNames;
+
+  for (auto& Col : *(mp_Index.load(std::memory_order_acquire)))
+  {
+    if (Col.second->value(Slot))
+      TheNames.push_back(Col.first);
+  }
+
+  return TheNames;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+std::size_t AttributesTable::gatherDoubles(const AttributeName_t& Name, const std::vector<std::size_t>& Slots,
+                                           std::vector<double>& Values, double Default) const
+{
+  Values.assign(Slots.size(),Default);
+
+  const Column* Col = findColumn(Name);
+
+  if (!Col)
+    return 0;
+
+  std::size_t Count = 0;
+
+  for (std::size_t i=0; i<Slots.size(); i++)
+  {
+    if (Col->getDouble(Slots[i],Values[i]))
+      Count++;
+  }
+
+  return Count;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+std::vector<AttributeName_t> AttributesTable::getAttributesNames() const
+{
+  std::lock_guard<std::mutex> Lock(m_Mutex);
+
+  std::vector<AttributeName_t> TheNames;
+
+  for (auto& Col : *(mp_Index.load(std::memory_order_relaxed)))
+  {
+    if (Col.second->SetCount)
+      TheNames.push_back(Col.first);
+  }
+
+  return TheNames;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+Value::Type AttributesTable::getAttributeType(const AttributeName_t& Name) const
+{
+  std::lock_guard<std::mutex> Lock(m_Mutex);
+
+  const Column* Col = findColumn(Name);
+
+  if (Col && Col->SetCount)
+    return Col->Type;
+
+  return Value::NONE;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+std::size_t AttributesTable::getSlotsCount() const
+{
+  std::lock_guard<std::mutex> Lock(m_Mutex);
+
+  return m_SlotsCount-m_FreeSlots.size();
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void AttributesTable::clear()
+{
+  std::lock_guard<std::mutex> Lock(m_Mutex);
+
+  m_Indexes.clear();
+  m_Columns.clear();
+  publishIndex(new ColumnsIndex_t());
+}
+
+
+} } // namespaces
@@ -0,0 +1,237 @@
+/*
+
+  This file is part of OpenFLUID software
+  Copyright(c) 2007, INRA - Montpellier SupAgro
+
+
+ == GNU General Public License Usage ==
+
+  OpenFLUID is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OpenFLUID is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OpenFLUID. If not, see <http://www.gnu.org/licenses/>.
+
+
+ == Other Usage ==
+
+  Other Usage means a use of OpenFLUID that is inconsistent with the GPL
+  license, and requires a written agreement between You and INRA.
+  Licensees for Other Usage of OpenFLUID may use this file in accordance
+  with the terms contained in the written agreement between You and INRA.
+  
+*/
+
+
+/**
+  @file AttributesTable.hpp
+
+  @author Jean-Christophe FABRE <jean-christophe.fabre@supagro.inra.fr>
+ */
+
+#ifndef __OPENFLUID_CORE_ATTRIBUTESTABLE_HPP__
+#define __OPENFLUID_CORE_ATTRIBUTESTABLE_HPP__
+
+
+#include <atomic>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <openfluid/core/TypeDefs.hpp>
+#include <openfluid/dllexport.hpp>
+#include <openfluid/core/Value.hpp>
+#include <openfluid/core/DoubleValue.hpp>
+#include <openfluid/core/IntegerValue.hpp>
+#include <openfluid/core/StringValue.hpp>
+
+
+namespace openfluid { namespace core {
+
+
+/**
+  Storage of the attributes of a set of spatial units, organized as one column per attribute name.
+  Each unit uses a slot in the table, which is the row index in every column.
+
+  The storage of a column is fixed by its first value: contiguous double, integer or string values,
+  or individually allocated values for other types. Values are never converted: each value keeps its own type,
+  and values not matching the storage of their column are stored individually.
+
+  The storage of a column is never released while the table exists, so pointers to stored values
+  remain valid when other values are stored or removed. A pointer to a value is invalidated only
+  if this value is replaced by a value of another type.
+
+  Reading values does not lock the table. Writing values is serialized, and may be done concurrently with
+  reading values of other slots, except when acquiring new slots which must not be done during reads.
+*/
+class OPENFLUID_API AttributesTable
+{
+  private:
+
+    class Column
+    {
+      public:
+
+        enum class Storage { NONE, DOUBLES, INTEGERS, STRINGS, OTHERS };
+
+        enum SlotState : unsigned char { UNSET = 0, TYPED = 1, OTHER = 2 };
+
+        std::atomic<Storage> StorageKind;
+
+        /**
+          Common type of the stored values, Value::NONE if values have different types
+        */
+        Value::Type Type;
+
+        std::deque<DoubleValue> Doubles;
+
+        std::deque<IntegerValue> Integers;
+
+        std::deque<StringValue> Strings;
+
+        /**
+          Values not matching the storage of the column, or all values of an OTHERS column
+        */
+        std::deque<std::unique_ptr<Value>> Others;
+
+        std::vector<unsigned char> States;
+
+        std::size_t SetCount;
+
+        Column() : StorageKind(Storage::NONE), Type(Value::NONE), SetCount(0)
+        { }
+
+        const Value* value(std::size_t Slot) const;
+
+        bool getDouble(std::size_t Slot, double& Val) const;
+
+        void store(std::size_t Slot, const Value& Val, std::size_t Capacity);
+
+        void unset(std::size_t Slot);
+    };
+
+    typedef std::map<AttributeName_t,Column*> ColumnsIndex_t;
+
+    /**
+      Columns storage, a deque so that columns are never moved
+    */
+    std::deque<Column> m_Columns;
+
+    /**
+      Index of columns by name used by readers, replaced by a new index when a column is created
+    */
+    std::atomic<const ColumnsIndex_t*> mp_Index;
+
+    /**
+      All created indexes, the previous ones are kept since they may still be used by readers
+    */
+    std::vector<std::unique_ptr<ColumnsIndex_t>> m_Indexes;
+
+    std::size_t m_SlotsCount;
+
+    std::vector<std::size_t> m_FreeSlots;
+
+    mutable std::mutex m_Mutex;
+
+    const Column* findColumn(const AttributeName_t& Name) const;
+
+    Column* findOrCreateColumn(const AttributeName_t& Name);
+
+    void publishIndex(ColumnsIndex_t* Index);
+
+
+  public:
+
+    AttributesTable();
+
+    ~AttributesTable();
+
+    AttributesTable(const AttributesTable&) = delete;
+
+    AttributesTable& operator=(const AttributesTable&) = delete;
+
+    /**
+      Reserves a slot for a new unit, reusing a released slot if any
+      @return the reserved slot
+    */
+    std::size_t acquireSlot();
+
+    /**
+      Releases a slot, removing all the attributes values stored in it
+      @param[in] Slot the slot to release
+    */
+    void releaseSlot(std::size_t Slot);
+
+    /**
+      Stores a value for a given slot, replacing the existing one if any
+      @param[in] Slot the slot of the unit
+      @param[in] Name the name of the attribute
+      @param[in] Val the value to store
+    */
+    void setValue(std::size_t Slot, const AttributeName_t& Name, const Value& Val);
+
+    /**
+      Returns a pointer to the value stored for a given slot
+      @param[in] Slot the slot of the unit
+      @param[in] Name the name of the attribute
+      @return a pointer to the value, nullptr if the attribute does not exist for this slot
+    */
+    const Value* value(std::size_t Slot, const AttributeName_t& Name) const;
+
+    bool isValueExist(std::size_t Slot, const AttributeName_t& Name) const;
+
+    bool removeValue(std::size_t Slot, const AttributeName_t& Name);
+
+    void clearSlot(std::size_t Slot);
+
+    std::vector<AttributeName_t> getNames(std::size_t Slot) const;
+
+    /**
+      Gathers the numeric values of an attribute for the given slots into a contiguous array,
+      for vectorizable scans of an attribute over units. Integer values are converted to doubles.
+      @param[in] Name the name of the attribute
+      @param[in] Slots the slots of the units
+      @param[out] Values the values, indexed as the given slots
+      @param[in] Default the value given to slots without a numeric value for the attribute
+      @return the number of slots having a numeric value for the attribute
+    */
+    std::size_t gatherDoubles(const AttributeName_t& Name, const std::vector<std::size_t>& Slots,
+                              std::vector<double>& Values, double Default = 0.0) const;
+
+    /**
+      Returns the names of all the attributes stored in the table
+    */
+    std::vector<AttributeName_t> getAttributesNames() const;
+
+    /**
+      Returns the type of the values stored for the given attribute,
+      Value::NONE if the attribute does not exist or if its values have different types
+    */
+    Value::Type getAttributeType(const AttributeName_t& Name) const;
+
+    /**
+      Returns the number of slots in use
+    */
+    std::size_t getSlotsCount() const;
+
+    /**
+      Removes all the columns, it must not be called while pointers to stored values are in use
+    */
+    void clear();
+
+};
+
+
+} } // namespaces
+
+
+#endif /* __OPENFLUID_CORE_ATTRIBUTESTABLE_HPP__ */
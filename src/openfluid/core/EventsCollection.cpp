@@ -37,16 +37,68 @@
   @author Jean-Christophe FABRE <jean-christophe.fabre@supagro.inra.fr>
 */
 
-#include <openfluid/core/EventsCollection.hpp>
+#include <algorithm>
 #include <iostream>
 
+#include <openfluid/core/EventsCollection.hpp>
+
+
 namespace openfluid { namespace core
 {
 
 
+struct EventBeforeDate
+{
+  bool operator ()(const Event& Ev, const DateTime& Date) const
+  {
+    return (Ev.getDateTime() < Date);
+  }
+
+  bool operator ()(const DateTime& Date, const Event& Ev) const
+  {
+    return (Date < Ev.getDateTime());
+  }
+
+  bool operator ()(const Event& Ev1, const Event& Ev2) const
+  {
+    return (Ev1.getDateTime() < Ev2.getDateTime());
+  }
+};
+
+
+// =====================================================================
+// =====================================================================
+
+
+EventsCollection::EventsCollection() :
+  m_Cursor(0)
+{
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+EventsCollection::EventsCollection(const EventsCollection& Other) :
+  m_Events(Other.m_Events), m_Cursor(0)
+{
+}
+
+
+// =====================================================================
+// =====================================================================
+
 
-EventsCollection::EventsCollection()
+EventsCollection& EventsCollection::operator=(const EventsCollection& Other)
 {
+  if (this != &Other)
+  {
+    m_Events = Other.m_Events;
+    m_Cursor = 0;
+  }
+
+  return *this;
 }
 
 
@@ -75,44 +127,78 @@ bool EventsCollection::addEvent(const Event* Ev)
 
 bool EventsCollection::addEvent(const Event& Ev)
 {
-  // empty list
-  if (m_Events.empty())
+  if (m_Events.empty() || !(Ev.getDateTime() < m_Events.back().getDateTime()))
   {
+    // most frequent case : event date is after last collection item
     m_Events.push_back(Ev);
   }
   else
   {
-    // event date is before first collection item
-    if (m_Events.front().getDateTime() >= Ev.getDateTime())
-    {
-      m_Events.push_front(Ev);
-    }
-    else
+    // event has to be inserted after the events of the same date
+    m_Events.insert(std::upper_bound(m_Events.begin(),m_Events.end(),Ev.getDateTime(),EventBeforeDate()),Ev);
+  }
+
+  return true;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void EventsCollection::addEvents(const EventsList_t& Events)
+{
+  if (Events.empty())
+    return;
+
+  const std::size_t PreviousSize = m_Events.size();
+
+  m_Events.insert(m_Events.end(),Events.begin(),Events.end());
+
+  EventsList_t::iterator MiddleIt = m_Events.begin()+PreviousSize;
+
+  std::stable_sort(MiddleIt,m_Events.end(),EventBeforeDate());
+
+  if (PreviousSize && (MiddleIt->getDateTime() < (MiddleIt-1)->getDateTime()))
+    std::inplace_merge(m_Events.begin(),MiddleIt,m_Events.end(),EventBeforeDate());
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+std::size_t EventsCollection::lowerBoundIndex(const DateTime& BeginDate) const
+{
+  const std::size_t Count = m_Events.size();
+  std::size_t Hint = std::min<std::size_t>(m_Cursor.load(std::memory_order_relaxed),Count);
+
+  std::size_t Index;
+
+  if (Hint > 0 && !(m_Events[Hint-1].getDateTime() < BeginDate))
+  {
+    // the window moved backward : binary search before the cursor
+    Index = std::lower_bound(m_Events.begin(),m_Events.begin()+Hint,BeginDate,EventBeforeDate()) - m_Events.begin();
+  }
+  else
+  {
+    // the window moved forward : exponential search from the cursor
+    std::size_t Lo = Hint;
+    std::size_t Step = 1;
+
+    while (Lo+Step <= Count && m_Events[Lo+Step-1].getDateTime() < BeginDate)
     {
-      // event date is after last collection item
-      if (m_Events.back().getDateTime() <= Ev.getDateTime())
-      {
-        m_Events.push_back(Ev);
-      }
-      else
-      {
-        // event has to be inserted somewhere in the collection
-        EventsList_t::iterator DEiter;
-
-        for(DEiter=m_Events.begin(); DEiter != m_Events.end(); ++DEiter)
-        {
-          if ((*DEiter).getDateTime() >= Ev.getDateTime())
-          {
-            m_Events.insert(--DEiter,Ev);
-            return true;
-          }
-        }
-
-      }
+      Lo += Step;
+      Step *= 2;
     }
+
+    Index = std::lower_bound(m_Events.begin()+Lo,m_Events.begin()+std::min(Lo+Step,Count),
+                             BeginDate,EventBeforeDate()) - m_Events.begin();
   }
 
-  return true;
+  m_Cursor.store(Index,std::memory_order_relaxed);
+
+  return Index;
 }
 
 
@@ -134,18 +220,30 @@ bool EventsCollection::getEventsBetween(const DateTime& BeginDate, const DateTim
 bool EventsCollection::getEventsBetween(const DateTime& BeginDate, const DateTime& EndDate,
     EventsCollection& Events) const
 {
+  for (const Event& Ev : eventsBetween(BeginDate,EndDate))
+    Events.addEvent(Ev);
 
-  EventsList_t::const_iterator DEiter;
+  return true;
+}
 
-  for(DEiter=m_Events.begin(); DEiter != m_Events.end(); ++DEiter)
-  {
-    if ((*DEiter).getDateTime().isBetween(BeginDate,EndDate))
-    {
-      Events.addEvent(*DEiter);
-    }
-  }
 
-  return true;
+// =====================================================================
+// =====================================================================
+
+
+EventsRange EventsCollection::eventsBetween(const DateTime& BeginDate, const DateTime& EndDate) const
+{
+  if (m_Events.empty() || EndDate < BeginDate)
+    return EventsRange();
+
+  const Event* First = m_Events.data()+lowerBoundIndex(BeginDate);
+  const Event* Last = First;
+  const Event* End = m_Events.data()+m_Events.size();
+
+  while (Last != End && !(EndDate < Last->getDateTime()))
+    ++Last;
+
+  return EventsRange(First,Last);
 }
 
 
@@ -167,5 +265,3 @@ void EventsCollection::println() const
 
 
 } }  // namespaces
-
-
@@ -44,17 +44,99 @@
 #include <openfluid/core/Event.hpp>
 #include <openfluid/dllexport.hpp>
 
-#include <list>
+#include <atomic>
+#include <vector>
 
 
 namespace openfluid { namespace core {
 
 class Event;
 
-typedef std::list<Event> EventsList_t;
+/**
+  Type for a list of events, ordered by date.
+  Since version 2.1.5, this is a std::vector instead of a std::list: list-only operations
+  (such as push_front() or splice()) are not available anymore, and iterators and references to events
+  are invalidated when events are added to the list.
+*/
+typedef std::vector<Event> EventsList_t;
+
+
+/**
+  @brief Class defining a read-only view on a contiguous part of an events collection
+
+  The view does not own nor copy the events. It is valid as long as the viewed events collection is not modified.
+
+  example of use:
+  @code
+  for (const openfluid::core::Event& Ev : OPENFLUID_GetEventsRange(TU,BeginDate,EndDate))
+  {
+    if (Ev.isInfoEqual("molecule","glyphosate"))
+    {
+      // process the event
+    }
+  }
+  @endcode
+*/
+class OPENFLUID_API EventsRange
+{
+  public:
+
+    typedef const Event* const_iterator;
+
+    typedef const_iterator iterator;
+
+
+  private:
+
+    const Event* m_Begin;
+
+    const Event* m_End;
+
+
+  public:
+
+    EventsRange() :
+      m_Begin(nullptr), m_End(nullptr)
+    { }
+
+    EventsRange(const Event* Begin, const Event* End) :
+      m_Begin(Begin), m_End(End)
+    { }
+
+    inline const_iterator begin() const
+    { return m_Begin; };
+
+    inline const_iterator end() const
+    { return m_End; };
+
+    /**
+      Returns the number of events in the range
+    */
+    inline std::size_t size() const
+    { return (m_End-m_Begin); };
+
+    /**
+      Returns true if the range contains no event
+    */
+    inline bool empty() const
+    { return (m_Begin == m_End); };
+
+    inline const Event& front() const
+    { return *m_Begin; };
+
+    inline const Event& back() const
+    { return *(m_End-1); };
+
+    inline const Event& operator[](std::size_t Index) const
+    { return m_Begin[Index]; };
+};
 
 /**
   @brief Class defining a collection of discrete events
+
+  Events are stored in a contiguous list sorted by date. A time window query is performed
+  in O(log n + k) where k is the number of matching events. Successive queries with advancing windows,
+  as done during a simulation, start from a cursor kept on the last queried position.
 */
 class OPENFLUID_API EventsCollection
 {
@@ -62,6 +144,15 @@ class OPENFLUID_API EventsCollection
 
     EventsList_t m_Events;
 
+    /**
+      Position of the first event not before the last queried beginning date.
+      This is only a hint validated at each query, so it remains safe with concurrent queries.
+    */
+    mutable std::atomic<std::size_t> m_Cursor;
+
+    std::size_t lowerBoundIndex(const DateTime& BeginDate) const;
+
+
   public:
 
     /**
@@ -69,6 +160,10 @@ class OPENFLUID_API EventsCollection
     */
     EventsCollection();
 
+    EventsCollection(const EventsCollection& Other);
+
+    EventsCollection& operator=(const EventsCollection& Other);
+
     virtual ~EventsCollection();
 
 
@@ -79,10 +174,18 @@ class OPENFLUID_API EventsCollection
     bool addEvent(const Event* Ev) OPENFLUID_DEPRECATED;
 
     /**
-      Inserts an event in the event collection, ordered by date
+      Inserts an event in the event collection, ordered by date.
+      Events with the same date are kept in their insertion order.
     */
     bool addEvent(const Event& Ev);
 
+    /**
+      Inserts many events in the event collection, ordered by date.
+      The collection is sorted only once, this should be preferred for bulk loading.
+      @param[in] Events the events to insert, in any order
+    */
+    void addEvents(const EventsList_t& Events);
+
     /**
       Returns an event collection extracted from the current event collection, taking into account a time period
       If some events are already in the given collection, they are not deleted. Events matching the period are appended
@@ -102,11 +205,27 @@ class OPENFLUID_API EventsCollection
     bool getEventsBetween(const DateTime& BeginDate, const DateTime& EndDate, EventsCollection& Events) const;
 
     /**
-      Returns the event collection as a list
+      Returns a read-only view on the events of the collection occurring during a time period, without any copy
+      @param[in] BeginDate the beginning of the time period
+      @param[in] EndDate the ending of the time period
+      @return the range of events matching the period, valid until the collection is modified
+    */
+    EventsRange eventsBetween(const DateTime& BeginDate, const DateTime& EndDate) const;
+
+    /**
+      Returns the event collection as a list, ordered by date.
+      The order must be preserved if the list is modified.
+      Iterators on the list are invalidated when events are added to the collection.
     */
     inline EventsList_t* eventsList()
     { return &m_Events; };
 
+    /**
+      Returns the event collection as a list, ordered by date
+    */
+    inline const EventsList_t* eventsList() const
+    { return &m_Events; };
+
     /**
       @deprecated Since version 2.1.0. Use openfluid::core::EventsCollection::eventsList() instead
     */
@@ -123,7 +242,7 @@ class OPENFLUID_API EventsCollection
       Clears the event collection
     */
     void clear()
-    { m_Events.clear(); };
+    { m_Events.clear(); m_Cursor = 0; };
 
     void println() const;
 };
@@ -83,6 +83,16 @@ class IndexedValue
     IndexedValue(const IndexedValue& IndValue) : m_Index(IndValue.m_Index),m_Value(IndValue.m_Value.get()->clone())
     { }
 
+    /**
+      Move constructor, the value is moved without copy
+    */
+    IndexedValue(IndexedValue&& IndValue) : m_Index(IndValue.m_Index),m_Value(std::move(IndValue.m_Value))
+    { }
+
+    IndexedValue& operator=(const IndexedValue&) = default;
+
+    IndexedValue& operator=(IndexedValue&&) = default;
+
     /**
       Returns the time index of the indexed value
       @return the time index
@@ -38,6 +38,8 @@
 */
 
 
+#include <algorithm>
+
 #include <openfluid/core/MapValue.hpp>
 #include <openfluid/base/FrameworkException.hpp>
 
@@ -49,14 +51,31 @@ namespace openfluid { namespace core {
 // =====================================================================
 
 
+/**
+  Compares a key-value pair with a key, for binary searches in the sorted storage
+*/
+struct MapKeyLess
+{
+  bool operator()(const MapValue::Storage_t::value_type& Pair, const std::string& Key) const
+  {
+    return Pair.first < Key;
+  }
+};
+
+
+// =====================================================================
+// =====================================================================
+
+
 MapValue::MapValue(const MapValue& Val)
 : CompoundValue()
 {
-  m_Value.clear();
+  m_Value.reserve(Val.m_Value.size());
 
-  for (Map_t::const_iterator it=Val.m_Value.begin();it!=Val.m_Value.end();++it)
+  // source pairs are already sorted
+  for (Storage_t::const_iterator it=Val.m_Value.begin();it!=Val.m_Value.end();++it)
   {
-    m_Value[(*it).first].reset((*(*it).second).clone());
+    m_Value.emplace_back((*it).first,std::shared_ptr<Value>((*(*it).second).clone()));
   }
 };
 
@@ -65,6 +84,17 @@ MapValue::MapValue(const MapValue& Val)
 // =====================================================================
 
 
+MapValue::MapValue(const Map_t& Val)
+: CompoundValue(), m_Value(Val.begin(),Val.end())
+{
+  // pairs of the source map are already sorted by unique keys
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 Value& MapValue::operator=(const Value& Other)
 {
   if (this == &Other)
@@ -103,7 +133,7 @@ void MapValue::writeToStream(std::ostream& OutStm) const
   }
   else
   {
-    Map_t::const_iterator it;
+    Storage_t::const_iterator it;
 
     OutStm << "{";
     for (it=m_Value.begin(); it!=m_Value.end(); ++it)
@@ -127,9 +157,54 @@ void MapValue::writeToStream(std::ostream& OutStm) const
 // =====================================================================
 
 
+MapValue::Storage_t::iterator MapValue::findKey(const std::string& Key)
+{
+  Storage_t::iterator it = std::lower_bound(m_Value.begin(),m_Value.end(),Key,MapKeyLess());
+
+  if (it != m_Value.end() && (*it).first == Key)
+    return it;
+
+  return m_Value.end();
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+MapValue::Storage_t::const_iterator MapValue::findKey(const std::string& Key) const
+{
+  Storage_t::const_iterator it = std::lower_bound(m_Value.begin(),m_Value.end(),Key,MapKeyLess());
+
+  if (it != m_Value.end() && (*it).first == Key)
+    return it;
+
+  return m_Value.end();
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void MapValue::setShared(const std::string& Key, std::shared_ptr<Value>&& Element)
+{
+  Storage_t::iterator it = std::lower_bound(m_Value.begin(),m_Value.end(),Key,MapKeyLess());
+
+  if (it != m_Value.end() && (*it).first == Key)
+    (*it).second = std::move(Element);
+  else
+    m_Value.emplace(it,Key,std::move(Element));
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 void MapValue::set(const std::string& Key, Value* Element)
 {
-  m_Value[Key].reset(Element);
+  setShared(Key,std::shared_ptr<Value>(Element));
 }
 
 
@@ -139,10 +214,12 @@ void MapValue::set(const std::string& Key, Value* Element)
 
 Value& MapValue::operator[](const std::string& Key)
 {
-  if (!isKeyExist(Key))
+  Storage_t::iterator it = findKey(Key);
+
+  if (it == m_Value.end())
     throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Requested key " + Key + " does not exist");
 
-  return (*(m_Value[Key]));
+  return (*(*it).second);
 }
 
 
@@ -152,10 +229,12 @@ Value& MapValue::operator[](const std::string& Key)
 
 Value& MapValue::at(const std::string& Key)
 {
-  if (!isKeyExist(Key))
+  Storage_t::iterator it = findKey(Key);
+
+  if (it == m_Value.end())
     throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Requested key " + Key + " does not exist");
 
-  return (*(m_Value[Key]));
+  return (*(*it).second);
 }
 
 
@@ -165,10 +244,12 @@ Value& MapValue::at(const std::string& Key)
 
 const Value& MapValue::at(const std::string& Key) const
 {
-  if (!isKeyExist(Key))
+  Storage_t::const_iterator it = findKey(Key);
+
+  if (it == m_Value.end())
     throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Requested key " + Key + " does not exist");
 
-  return (*(m_Value.at(Key)));
+  return (*(*it).second);
 }
 
 
@@ -178,7 +259,13 @@ const Value& MapValue::at(const std::string& Key) const
 
 bool MapValue::remove(const std::string& Key)
 {
-  return (m_Value.erase(Key) == 1);
+  Storage_t::iterator it = findKey(Key);
+
+  if (it == m_Value.end())
+    return false;
+
+  m_Value.erase(it);
+  return true;
 }
 
 
@@ -189,7 +276,9 @@ bool MapValue::remove(const std::string& Key)
 std::vector<std::string> MapValue::getKeys() const
 {
   std::vector<std::string> Keys;
-  Map_t::const_iterator it;
+  Storage_t::const_iterator it;
+
+  Keys.reserve(m_Value.size());
 
   for (it=m_Value.begin(); it!=m_Value.end(); ++it)
     Keys.push_back((*it).first);
@@ -42,6 +42,7 @@
 
 
 #include <map>
+#include <vector>
 #include <memory>
 
 #include <openfluid/core/CompoundValue.hpp>
@@ -58,7 +59,10 @@ namespace openfluid { namespace core {
 
 /**
   MapValue is a container for a key => value map,
-  where keys are strings and values can be any type derived from openfluid::core::Value.\n
+  where keys are strings and values can be any type derived from openfluid::core::Value.
+  Elements are stored contiguously, sorted by keys. Inserting or removing an element invalidates iterators,
+  but not references to the values. Iterators are therefore not Map_t iterators, code iterating over a MapValue
+  must use the MapValue::iterator and MapValue::const_iterator types.\n
 
 \see Value
 
@@ -137,14 +141,33 @@ class OPENFLUID_API MapValue : public CompoundValue
 
     typedef std::map<std::string,std::shared_ptr<Value> > Map_t;
 
-    typedef Map_t::iterator iterator;
+    /**
+      Flat storage of the map, as a vector of key-value pairs sorted by keys.
+      Values are not stored inline, even small scalar ones: they are accessed through references to
+      openfluid::core::Value which must remain valid when other elements are inserted or removed,
+      and they are shared with copies made by the assignment operator.
+    */
+    typedef std::vector<std::pair<std::string,std::shared_ptr<Value> > > Storage_t;
+
+    /**
+      Iterator on the elements of the map, sorted by keys.
+      Since the flat storage is not a Map_t, it is not a Map_t::iterator: elements are pairs of key and value,
+      and keys must not be modified through iterators.
+    */
+    typedef Storage_t::iterator iterator;
 
-    typedef Map_t::const_iterator const_iterator;
+    typedef Storage_t::const_iterator const_iterator;
 
 
   private:
 
-    Map_t m_Value;
+    Storage_t m_Value;
+
+    Storage_t::iterator findKey(const std::string& Key);
+
+    Storage_t::const_iterator findKey(const std::string& Key) const;
+
+    void setShared(const std::string& Key, std::shared_ptr<Value>&& Element);
 
 
   public:
@@ -160,8 +183,10 @@ class OPENFLUID_API MapValue : public CompoundValue
     */
     MapValue(const MapValue& Val);
 
-    MapValue(const Map_t& Val) : CompoundValue(), m_Value(Val)
-    { }
+    /**
+      Constructor from a map of values, sharing the values of the given map
+    */
+    MapValue(const Map_t& Val);
 
     ~MapValue();
 
@@ -192,7 +217,7 @@ class OPENFLUID_API MapValue : public CompoundValue
       @param[in] Val the value to add
     */
     inline void setDouble(const std::string& Key, const double& Val)
-    { set(Key,new DoubleValue(Val)); }
+    { setShared(Key,std::make_shared<DoubleValue>(Val)); }
 
     /**
       Sets a new long value at the given key
@@ -201,7 +226,7 @@ class OPENFLUID_API MapValue : public CompoundValue
 
     */
     inline void setInteger(const std::string& Key, const long& Val)
-    { set(Key,new IntegerValue(Val)); }
+    { setShared(Key,std::make_shared<IntegerValue>(Val)); }
 
     /**
       Sets a new boolean value at the given key
@@ -209,7 +234,7 @@ class OPENFLUID_API MapValue : public CompoundValue
       @param[in] Val the value to add
     */
     inline void setBoolean(const std::string& Key, const bool& Val)
-      { set(Key,new BooleanValue(Val)); }
+      { setShared(Key,std::make_shared<BooleanValue>(Val)); }
 
     /**
       Sets a new string value at the given key
@@ -217,7 +242,7 @@ class OPENFLUID_API MapValue : public CompoundValue
       @param[in] Val the value to add
     */
     inline void setString(const std::string& Key, const std::string& Val)
-    { set(Key,new StringValue(Val)); }
+    { setShared(Key,std::make_shared<StringValue>(Val)); }
 
     /**
       Sets a new VectorValue value at the given key
@@ -225,7 +250,7 @@ class OPENFLUID_API MapValue : public CompoundValue
       @param[in] Val the value to add
     */
     inline void setVectorValue(const std::string& Key, const VectorValue& Val)
-    { set(Key,new VectorValue(Val)); }
+    { setShared(Key,std::make_shared<VectorValue>(Val)); }
 
     /**
       Sets a new MatrixValue value at the given key
@@ -233,7 +258,7 @@ class OPENFLUID_API MapValue : public CompoundValue
       @param[in] Val the value to add
     */
     inline void setMatrixValue(const std::string& Key, const MatrixValue& Val)
-    { set(Key,new MatrixValue(Val)); }
+    { setShared(Key,std::make_shared<MatrixValue>(Val)); }
 
     /**
       Sets a new MapValue value at the given key
@@ -241,7 +266,7 @@ class OPENFLUID_API MapValue : public CompoundValue
       @param[in] Val the value to add
     */
     inline void setMapValue(const std::string& Key, const MapValue& Val)
-    { set(Key,new MapValue(Val)); }
+    { setShared(Key,std::make_shared<MapValue>(Val)); }
 
     /**
       Operator to get/set a value at a key given between []
@@ -345,7 +370,7 @@ class OPENFLUID_API MapValue : public CompoundValue
       @return true if the given key is present
     */
     inline bool isKeyExist(const std::string& Key) const
-    { return (m_Value.find(Key) != m_Value.end()); }
+    { return (findKey(Key) != m_Value.end()); }
 
     /**
       Returns the list of keys of the map
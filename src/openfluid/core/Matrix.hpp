@@ -44,13 +44,17 @@
 
 #include <openfluid/dllexport.hpp>
 #include <openfluid/base/FrameworkException.hpp>
+#include <openfluid/core/ArrayKernels.hpp>
+#include <openfluid/core/Vector.hpp>
 
 
 namespace openfluid { namespace core {
 
 
 /**
-  Template class for matrix data
+  Template class for matrix data.
+  Elements are stored column by column in an array aligned for SIMD instructions.
+  Arithmetic operations and reductions use vectorized kernels for double precision values.
 */
 template <class T>
 class OPENFLUID_API Matrix
@@ -163,7 +167,7 @@ class OPENFLUID_API Matrix
     { setElement(ColIndex,RowIndex,Element); };
 
     /**
-      Allocation operator
+      Allocation operator. The current array is reused without reallocation if it has the same dimensions
     */
     Matrix<T>& operator=(const Matrix &A);
 
@@ -177,6 +181,48 @@ class OPENFLUID_API Matrix
     */
     void clear();
 
+    /**
+      Adds the elements of the given Matrix to the elements of this Matrix
+      @throw openfluid::base::FrameworkException if the dimensions of the matrices are different
+    */
+    void add(const Matrix& Other);
+
+    /**
+      Subtracts the elements of the given Matrix from the elements of this Matrix
+      @throw openfluid::base::FrameworkException if the dimensions of the matrices are different
+    */
+    void subtract(const Matrix& Other);
+
+    /**
+      Multiplies all elements of the Matrix by the given factor
+    */
+    void scale(const T& Factor);
+
+    /**
+      Computes the product of this Matrix and the given vector
+      @param[in] X the vector, its size must be the number of columns
+      @param[out] Result the resulting vector, resized to the number of rows if needed
+      @throw openfluid::base::FrameworkException if the size of the vector is not the number of columns
+    */
+    void multiply(const Vector<T>& X, Vector<T>& Result) const;
+
+    /**
+      Returns the sum of the elements of the Matrix, or 0 if the Matrix is empty
+    */
+    T sum() const;
+
+    /**
+      Returns the minimum element of the Matrix
+      @throw openfluid::base::FrameworkException if the Matrix is empty
+    */
+    T min() const;
+
+    /**
+      Returns the maximum element of the Matrix
+      @throw openfluid::base::FrameworkException if the Matrix is empty
+    */
+    T max() const;
+
 };
 
 
@@ -273,7 +319,7 @@ bool Matrix<T>::allocate(unsigned long ColsNbr, unsigned long RowsNbr)
 {
   if (ColsNbr > 0 && RowsNbr > 0)
   {
-    m_Data = new T[ColsNbr*RowsNbr];
+    m_Data = kernels::allocateAlignedArray<T>(ColsNbr*RowsNbr);
     if (m_Data)
     {
       m_RowsNbr = RowsNbr;
@@ -341,10 +387,14 @@ Matrix<T>& Matrix<T>::operator=(const Matrix &A)
   if (this == &A) // in case somebody tries assign array to itself
     return *this;
 
-  clear();
+  // the current array is reused if it has the same dimensions
+  if (m_ColsNbr != A.m_ColsNbr || m_RowsNbr != A.m_RowsNbr)
+  {
+    clear();
 
-  if (!allocate(A.m_ColsNbr,A.m_RowsNbr))
-    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Cannot allocate memory");
+    if (!allocate(A.m_ColsNbr,A.m_RowsNbr))
+      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Cannot allocate memory");
+  }
 
   std::copy(A.m_Data, A.m_Data + (A.m_ColsNbr*A.m_RowsNbr), m_Data);
 
@@ -359,9 +409,7 @@ Matrix<T>& Matrix<T>::operator=(const Matrix &A)
 template <class T>
 void Matrix<T>::fill(const T& Val)
 {
-  for (unsigned long i=0;i<m_RowsNbr;i++)
-    for (unsigned long j=0;j<m_ColsNbr;j++)
-      m_Data[i*m_ColsNbr+j] = Val;
+  std::fill(m_Data,m_Data+(m_ColsNbr*m_RowsNbr),Val);
 }
 
 
@@ -372,11 +420,110 @@ void Matrix<T>::fill(const T& Val)
 template <class T>
 void Matrix<T>::clear()
 {
-  delete [] m_Data;
+  kernels::releaseAlignedArray(m_Data,m_ColsNbr*m_RowsNbr);
   init();
 }
 
 
+// =====================================================================
+// =====================================================================
+
+
+template <class T>
+void Matrix<T>::add(const Matrix& Other)
+{
+  if (Other.m_ColsNbr != m_ColsNbr || Other.m_RowsNbr != m_RowsNbr)
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"matrices dimensions mismatch");
+
+  kernels::add(m_Data,Other.m_Data,m_Data,m_ColsNbr*m_RowsNbr);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+template <class T>
+void Matrix<T>::subtract(const Matrix& Other)
+{
+  if (Other.m_ColsNbr != m_ColsNbr || Other.m_RowsNbr != m_RowsNbr)
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"matrices dimensions mismatch");
+
+  kernels::subtract(m_Data,Other.m_Data,m_Data,m_ColsNbr*m_RowsNbr);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+template <class T>
+void Matrix<T>::scale(const T& Factor)
+{
+  kernels::scale(Factor,m_Data,m_ColsNbr*m_RowsNbr);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+template <class T>
+void Matrix<T>::multiply(const Vector<T>& X, Vector<T>& Result) const
+{
+  if (X.size() != m_ColsNbr)
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"matrix and vector dimensions mismatch");
+
+  if (Result.size() != m_RowsNbr)
+    Result = Vector<T>(m_RowsNbr);
+
+  Result.fill(T());
+
+  // elements are stored by columns, the product is computed as a sum of scaled columns
+  for (unsigned long j=0;j<m_ColsNbr;j++)
+    kernels::axpy(X.data()[j],m_Data+j*m_RowsNbr,Result.data(),m_RowsNbr);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+template <class T>
+T Matrix<T>::sum() const
+{
+  return kernels::sum(m_Data,m_ColsNbr*m_RowsNbr);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+template <class T>
+T Matrix<T>::min() const
+{
+  if (m_Data == nullptr)
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"empty matrix");
+
+  return kernels::min(m_Data,m_ColsNbr*m_RowsNbr);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+template <class T>
+T Matrix<T>::max() const
+{
+  if (m_Data == nullptr)
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"empty matrix");
+
+  return kernels::max(m_Data,m_ColsNbr*m_RowsNbr);
+}
+
+
 
 } }
 
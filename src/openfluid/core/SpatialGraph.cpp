@@ -36,7 +36,18 @@
 */
 
 
+#include <algorithm>
+#include <deque>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <limits>
+#include <cstdint>
+
+#include <ogr_geometry.h>
+
 #include <openfluid/core/SpatialGraph.hpp>
+#include <openfluid/base/FrameworkException.hpp>
 
 
 namespace openfluid { namespace core {
@@ -51,7 +62,7 @@ struct SortUnitsPtrByProcessOrder
 {
   bool operator ()(SpatialUnit*& U1,SpatialUnit*& U2) const
   {
-    return (U1->getProcessOrder() <= U2->getProcessOrder());
+    return (U1->getProcessOrder() < U2->getProcessOrder());
   }
 
 };
@@ -61,7 +72,164 @@ struct SortUnitsPtrByProcessOrder
 // =====================================================================
 
 
-SpatialGraph::SpatialGraph()
+/**
+  Computes the reverse Cuthill-McKee ranks of units, using the from-to connections between units of a same class.
+  Neighbours are visited breadth-first from a unit of lowest degree, by increasing degrees.
+*/
+static std::vector<std::size_t> computeCuthillMcKeeRanks(const UnitsAdjacency* FromAdj, const UnitsAdjacency* ToAdj,
+                                                         std::size_t UnitsCount)
+{
+  std::vector<std::vector<std::size_t>> Neighbours(UnitsCount);
+
+  for (const UnitsAdjacency* Adj : {FromAdj,ToAdj})
+  {
+    if (Adj == nullptr)
+      continue;
+
+    for (std::size_t i = 0; i < UnitsCount; i++)
+    {
+      for (std::size_t j = Adj->offsets()[i]; j < Adj->offsets()[i+1]; j++)
+      {
+        // ghost units are not reordered
+        if (Adj->neighboursIndices()[j] < UnitsCount)
+          Neighbours[i].push_back(Adj->neighboursIndices()[j]);
+      }
+    }
+  }
+
+  auto LowerDegree = [&Neighbours](std::size_t A, std::size_t B)
+  {
+    return (Neighbours[A].size() < Neighbours[B].size() || (Neighbours[A].size() == Neighbours[B].size() && A < B));
+  };
+
+  std::vector<std::size_t> Seeds(UnitsCount);
+  for (std::size_t i = 0; i < UnitsCount; i++)
+    Seeds[i] = i;
+  std::sort(Seeds.begin(),Seeds.end(),LowerDegree);
+
+  std::vector<bool> Visited(UnitsCount,false);
+  std::vector<std::size_t> Order;
+  Order.reserve(UnitsCount);
+
+  for (std::size_t Seed : Seeds)
+  {
+    if (Visited[Seed])
+      continue;
+
+    std::size_t Front = Order.size();
+    Visited[Seed] = true;
+    Order.push_back(Seed);
+
+    while (Front < Order.size())
+    {
+      const std::size_t Current = Order[Front++];
+      const std::size_t LevelBegin = Order.size();
+
+      for (std::size_t Neighbour : Neighbours[Current])
+      {
+        if (!Visited[Neighbour])
+        {
+          Visited[Neighbour] = true;
+          Order.push_back(Neighbour);
+        }
+      }
+
+      std::sort(Order.begin()+LevelBegin,Order.end(),LowerDegree);
+    }
+  }
+
+  std::vector<std::size_t> Ranks(UnitsCount);
+
+  for (std::size_t k = 0; k < UnitsCount; k++)
+    Ranks[Order[k]] = UnitsCount-1-k;
+
+  return Ranks;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+/**
+  Computes the positions of units geometries centroids on a Hilbert curve covering their extent.
+  Units without geometry get the highest possible position.
+*/
+static std::vector<std::uint64_t> computeHilbertKeys(const UnitsPtrVector_t& Units)
+{
+  const std::uint32_t CurveSide = 1 << 16;
+  std::vector<std::uint64_t> Keys(Units.size(),std::numeric_limits<std::uint64_t>::max());
+  std::vector<std::pair<double,double>> Centroids(Units.size());
+  std::vector<bool> HasCentroid(Units.size(),false);
+
+  double MinX = std::numeric_limits<double>::max(), MinY = MinX;
+  double MaxX = std::numeric_limits<double>::lowest(), MaxY = MaxX;
+
+  for (std::size_t i = 0; i < Units.size(); i++)
+  {
+    const OGRGeometry* Geom = Units[i]->geometry();
+    OGRPoint Centroid;
+
+    if (Geom != nullptr && !Geom->IsEmpty() && Geom->Centroid(&Centroid) == OGRERR_NONE)
+    {
+      Centroids[i] = std::make_pair(Centroid.getX(),Centroid.getY());
+      HasCentroid[i] = true;
+      MinX = std::min(MinX,Centroid.getX());
+      MaxX = std::max(MaxX,Centroid.getX());
+      MinY = std::min(MinY,Centroid.getY());
+      MaxY = std::max(MaxY,Centroid.getY());
+    }
+  }
+
+  const double Extent = std::max(MaxX-MinX,MaxY-MinY);
+
+  for (std::size_t i = 0; i < Units.size(); i++)
+  {
+    if (!HasCentroid[i])
+      continue;
+
+    std::uint32_t X = 0, Y = 0;
+
+    if (Extent > 0.0)
+    {
+      X = std::min<std::uint32_t>(CurveSide-1,static_cast<std::uint32_t>((Centroids[i].first-MinX)/Extent*CurveSide));
+      Y = std::min<std::uint32_t>(CurveSide-1,static_cast<std::uint32_t>((Centroids[i].second-MinY)/Extent*CurveSide));
+    }
+
+    // conversion of cell coordinates to position on the curve, rotating quadrants at each level
+    std::uint64_t Key = 0;
+
+    for (std::uint32_t Side = CurveSide/2; Side > 0; Side /= 2)
+    {
+      const std::uint32_t RX = (X & Side) ? 1 : 0;
+      const std::uint32_t RY = (Y & Side) ? 1 : 0;
+
+      Key += static_cast<std::uint64_t>(Side)*Side*((3*RX)^RY);
+
+      if (!RY)
+      {
+        if (RX)
+        {
+          X = CurveSide-1-X;
+          Y = CurveSide-1-Y;
+        }
+        std::swap(X,Y);
+      }
+    }
+
+    Keys[i] = Key;
+  }
+
+  return Keys;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+SpatialGraph::SpatialGraph() :
+  m_IsAdjacencyUpToDate(false), m_AdjacencyLinksRevision(0)
 {
 
 }
@@ -102,6 +270,8 @@ bool SpatialGraph::addUnit(const SpatialUnit& aUnit)
 {
   SpatialUnit* TheUnit = m_PcsOrderedUnitsByClass[aUnit.getClass()].addSpatialUnit(aUnit);
 
+  m_IsAdjacencyUpToDate = false;
+
   if (TheUnit != nullptr)
   {
     m_PcsOrderedUnitsGlobal.push_back(TheUnit);
@@ -121,6 +291,7 @@ bool SpatialGraph::deleteUnit(SpatialUnit* aUnit)
 
   std::vector<openfluid::core::UnitsClass_t> ClassVector;
 
+  m_IsAdjacencyUpToDate = false;
 
   openfluid::core::UnitsListByClassMap_t::const_iterator itUnitsClass;
 
@@ -184,24 +355,60 @@ bool SpatialGraph::deleteUnit(SpatialUnit* aUnit)
   it = m_PcsOrderedUnitsByClass.find(aUnit->getClass());
 
   if (it != m_PcsOrderedUnitsByClass.end())
+    Found = it->second.removeSpatialUnit(aUnit->getID());
+
+
+  return Found;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void SpatialGraph::restrictToUnits(const UnitsPtrVector_t& Units, const UnitsPtrVector_t& Ghosts)
+{
+  std::unordered_set<const SpatialUnit*> Owned(Units.begin(),Units.end());
+  std::unordered_set<const SpatialUnit*> Kept(Owned);
+  Kept.insert(Ghosts.begin(),Ghosts.end());
+
+  auto isRemoved = [&Kept](const SpatialUnit* U)
   {
-    UnitsList_t* UnitsBase = it->second.list();
-    UnitsList_t::iterator UnitsBaseIt;
+    return (Kept.find(U) == Kept.end());
+  };
 
-    UnitsBaseIt = UnitsBase->begin();
-    while (!Found && UnitsBaseIt!=UnitsBase->end())
-    {
-      Found = ((*UnitsBaseIt).getID() == aUnit->getID() && (*UnitsBaseIt).getClass() == aUnit->getClass());
+  auto isNotOwned = [&Owned](const SpatialUnit* U)
+  {
+    return (Owned.find(U) == Owned.end());
+  };
 
-      if (Found)
-        UnitsBase->erase(UnitsBaseIt);
-      else
-        ++UnitsBaseIt;
+
+  // links of kept units to removed units
+
+  for (const UnitsPtrVector_t* KeptUnits : {&Units,&Ghosts})
+  {
+    for (SpatialUnit* U : *KeptUnits)
+    {
+      for (LinkedUnitsListByClassMap_t* Links : {&U->m_FromUnits,&U->m_ToUnits,&U->m_ParentUnits,&U->m_ChildrenUnits})
+      {
+        for (auto& ClassLinks : *Links)
+          ClassLinks.second.remove_if(isRemoved);
+      }
     }
   }
 
 
-  return Found;
+  // units lists
+
+  m_PcsOrderedUnitsGlobal.remove_if(isNotOwned);
+
+  for (auto& ClassUnits : m_PcsOrderedUnitsByClass)
+  {
+    ClassUnits.second.removeSpatialUnits([&isRemoved](const SpatialUnit& U) { return isRemoved(&U); });
+    ClassUnits.second.setGhostSpatialUnits([&isNotOwned](const SpatialUnit& U) { return isNotOwned(&U); });
+  }
+
+  m_IsAdjacencyUpToDate = false;
 }
 
 
@@ -212,6 +419,8 @@ bool SpatialGraph::deleteUnit(SpatialUnit* aUnit)
 bool SpatialGraph::removeFromToConnection(SpatialUnit* FromUnit,
                                           SpatialUnit* ToUnit)
 {
+  m_IsAdjacencyUpToDate = false;
+
   if (FromUnit != nullptr && ToUnit != nullptr)
   {
     return (removeUnitFromList(FromUnit->toSpatialUnits(ToUnit->getClass()),ToUnit->getID()) &&
@@ -229,6 +438,8 @@ bool SpatialGraph::removeFromToConnection(SpatialUnit* FromUnit,
 bool SpatialGraph::removeChildParentConnection(SpatialUnit* ChildUnit,
                                                SpatialUnit* ParentUnit)
 {
+  m_IsAdjacencyUpToDate = false;
+
   if (ChildUnit != nullptr && ParentUnit != nullptr)
   {
     return (removeUnitFromList(ChildUnit->parentSpatialUnits(ParentUnit->getClass()),ParentUnit->getID()) &&
@@ -253,6 +464,244 @@ bool SpatialGraph::isUnitsClassExist(const UnitsClass_t& UnitsClass) const
 // =====================================================================
 
 
+void SpatialGraph::computeProcessOrders()
+{
+  computeProcessOrders(std::vector<SpatialUnit*>(m_PcsOrderedUnitsGlobal.begin(),m_PcsOrderedUnitsGlobal.end()));
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void SpatialGraph::computeProcessOrders(const std::vector<SpatialUnit*>& Units)
+{
+  // number of upstream units not processed yet, for each unit to compute
+  std::unordered_map<SpatialUnit*,unsigned int> PendingUpstreams;
+
+  for (SpatialUnit* U : Units)
+    PendingUpstreams[U] = 0;
+
+  for (SpatialUnit* U : Units)
+  {
+    for (auto& ToUnits : U->m_ToUnits)
+    {
+      for (SpatialUnit* ToU : ToUnits.second)
+      {
+        auto it = PendingUpstreams.find(ToU);
+        if (it != PendingUpstreams.end())
+          it->second++;
+      }
+    }
+  }
+
+
+  // Kahn's algorithm, upstream units with fixed process orders are already processed
+  std::deque<SpatialUnit*> ReadyUnits;
+  std::size_t ProcessedCount = 0;
+
+  for (SpatialUnit* U : Units)
+  {
+    if (!PendingUpstreams[U])
+      ReadyUnits.push_back(U);
+  }
+
+  while (!ReadyUnits.empty())
+  {
+    SpatialUnit* U = ReadyUnits.front();
+    ReadyUnits.pop_front();
+    ProcessedCount++;
+
+    PcsOrd_t Order = 1;
+
+    for (auto& FromUnits : U->m_FromUnits)
+    {
+      for (SpatialUnit* FromU : FromUnits.second)
+        Order = std::max(Order,PcsOrd_t(FromU->getProcessOrder()+1));
+    }
+
+    U->setProcessOrder(Order);
+
+    for (auto& ToUnits : U->m_ToUnits)
+    {
+      for (SpatialUnit* ToU : ToUnits.second)
+      {
+        auto it = PendingUpstreams.find(ToU);
+        if (it != PendingUpstreams.end() && !(--(it->second)))
+          ReadyUnits.push_back(ToU);
+      }
+    }
+  }
+
+
+  if (ProcessedCount != Units.size())
+  {
+    std::ostringstream UnitsStr;
+    unsigned int ReportedCount = 0;
+
+    for (SpatialUnit* U : Units)
+    {
+      if (PendingUpstreams[U])
+      {
+        if (ReportedCount == 10)
+        {
+          UnitsStr << ", ...";
+          break;
+        }
+
+        UnitsStr << (ReportedCount ? ", " : "") << U->getClass() << "#" << U->getID();
+        ReportedCount++;
+      }
+    }
+
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                              "Cycle detected in from-to connections, involving units " +
+                                              UnitsStr.str());
+  }
+
+  sortUnitsByProcessOrder();
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void SpatialGraph::buildAdjacency()
+{
+  m_Adjacencies.clear();
+  m_AdjacencyLinksRevision = SpatialUnit::getLinksRevision();
+
+  for (auto& ClassUnits : m_PcsOrderedUnitsByClass)
+  {
+    const UnitsClass_t& SourceClass = ClassUnits.first;
+    const UnitsPtrVector_t* Units = ClassUnits.second.units();
+    const std::size_t UnitsCount = Units->size();
+
+    const std::vector<std::pair<UnitsLinkType,LinkedUnitsListByClassMap_t SpatialUnit::*>> Links =
+      {
+        {UnitsLinkType::FROM,&SpatialUnit::m_FromUnits},
+        {UnitsLinkType::TO,&SpatialUnit::m_ToUnits},
+        {UnitsLinkType::PARENT,&SpatialUnit::m_ParentUnits},
+        {UnitsLinkType::CHILD,&SpatialUnit::m_ChildrenUnits}
+      };
+
+    for (auto& Link : Links)
+    {
+      // counting links by target class
+      std::map<UnitsClass_t,std::size_t> LinksCountByClass;
+
+      for (SpatialUnit* U : *Units)
+      {
+        for (auto& Linked : U->*(Link.second))
+          LinksCountByClass[Linked.first] += Linked.second.size();
+      }
+
+      for (auto& TargetCount : LinksCountByClass)
+      {
+        if (!TargetCount.second)
+          continue;
+
+        UnitsAdjacency& Adj = m_Adjacencies[std::make_tuple(SourceClass,Link.first,TargetCount.first)];
+
+        Adj.m_Offsets.reserve(UnitsCount+1);
+        Adj.m_Neighbours.reserve(TargetCount.second);
+        Adj.m_NeighboursIndices.reserve(TargetCount.second);
+
+        for (SpatialUnit* U : *Units)
+        {
+          Adj.m_Offsets.push_back(Adj.m_Neighbours.size());
+
+          auto itLinked = (U->*(Link.second)).find(TargetCount.first);
+
+          if (itLinked != (U->*(Link.second)).end())
+          {
+            for (SpatialUnit* LinkedU : itLinked->second)
+            {
+              Adj.m_Neighbours.push_back(LinkedU);
+              Adj.m_NeighboursIndices.push_back(LinkedU->getIndex());
+            }
+          }
+        }
+        Adj.m_Offsets.push_back(Adj.m_Neighbours.size());
+      }
+    }
+  }
+
+  m_IsAdjacencyUpToDate = true;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+const UnitsAdjacency* SpatialGraph::adjacency(const UnitsClass_t& SourceClass, UnitsLinkType LinkType,
+                                              const UnitsClass_t& TargetClass)
+{
+  if (!isAdjacencyUpToDate())
+    buildAdjacency();
+
+  auto it = m_Adjacencies.find(std::make_tuple(SourceClass,LinkType,TargetClass));
+
+  if (it != m_Adjacencies.end())
+    return &(it->second);
+
+  return nullptr;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+UnitsGrid* SpatialGraph::addUnitsGrid(const UnitsClass_t& UnitsClass, unsigned long ColsNbr, unsigned long RowsNbr)
+{
+  if (isUnitsClassExist(UnitsClass))
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                              "Spatial units of class " + UnitsClass + " already exist");
+
+  UnitsGrid& Grid = m_UnitsGrids[UnitsClass];
+  Grid = UnitsGrid(ColsNbr,RowsNbr);
+
+  return &Grid;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+UnitsGrid* SpatialGraph::unitsGrid(const UnitsClass_t& UnitsClass)
+{
+  auto it = m_UnitsGrids.find(UnitsClass);
+
+  if (it != m_UnitsGrids.end())
+    return &(it->second);
+
+  return nullptr;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+const UnitsGrid* SpatialGraph::unitsGrid(const UnitsClass_t& UnitsClass) const
+{
+  auto it = m_UnitsGrids.find(UnitsClass);
+
+  if (it != m_UnitsGrids.end())
+    return &(it->second);
+
+  return nullptr;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 SpatialUnit* SpatialGraph::spatialUnit(const UnitsClass_t& UnitsClass, UnitID_t UnitID)
 {
   UnitsListByClassMap_t::iterator it;
@@ -341,6 +790,9 @@ bool SpatialGraph::sortUnitsByProcessOrder()
   // sort global units structure
   m_PcsOrderedUnitsGlobal.sort(SortUnitsPtrByProcessOrder());
 
+  // dense indices may have changed
+  m_IsAdjacencyUpToDate = false;
+
   return true;
 }
 
@@ -348,12 +800,65 @@ bool SpatialGraph::sortUnitsByProcessOrder()
 // =====================================================================
 
 
+void SpatialGraph::sortUnitsByLocality(UnitsOrdering Ordering)
+{
+  sortUnitsByProcessOrder();
+
+  if (Ordering == UnitsOrdering::DEFAULT)
+    return;
+
+  for (auto& ClassUnits : m_PcsOrderedUnitsByClass)
+  {
+    const UnitsClass_t& UnitsClass = ClassUnits.first;
+    UnitsCollection& Units = ClassUnits.second;
+    const std::size_t UnitsCount = Units.size();
+
+    std::vector<std::size_t> Ranks = computeCuthillMcKeeRanks(adjacency(UnitsClass,UnitsLinkType::FROM,UnitsClass),
+                                                              adjacency(UnitsClass,UnitsLinkType::TO,UnitsClass),
+                                                              UnitsCount);
+
+    if (Ordering == UnitsOrdering::HILBERT_CURVE)
+    {
+      std::vector<std::uint64_t> Keys = computeHilbertKeys(*(Units.units()));
+
+      if (UnitsCount && std::all_of(Keys.begin(),Keys.end(),
+                                    [](std::uint64_t Key){ return Key == std::numeric_limits<std::uint64_t>::max(); }))
+        throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                                  "No geometry for units of class " + UnitsClass +
+                                                  ", hilbert ordering cannot be applied");
+
+      std::vector<std::size_t> Order(UnitsCount);
+
+      for (std::size_t i = 0; i < UnitsCount; i++)
+        Order[i] = i;
+
+      std::sort(Order.begin(),Order.end(),[&Keys,&Ranks](std::size_t A, std::size_t B)
+      {
+        return (Keys[A] < Keys[B] || (Keys[A] == Keys[B] && Ranks[A] < Ranks[B]));
+      });
+
+      for (std::size_t k = 0; k < UnitsCount; k++)
+        Ranks[Order[k]] = k;
+    }
+
+    Units.sortByProcessOrder(Ranks);
+
+    // dense indices have changed
+    m_IsAdjacencyUpToDate = false;
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 void SpatialGraph::streamContents(std::ostream& OStream)
 {
   UnitsListByClassMap_t::iterator ClassIt;
 
-  UnitsList_t* Units;
-  UnitsList_t::iterator UnitIt;
+  const UnitsPtrVector_t* Units;
+  UnitsPtrVector_t::const_iterator UnitIt;
 
 
   if (m_PcsOrderedUnitsByClass.empty())
@@ -367,11 +872,11 @@ void SpatialGraph::streamContents(std::ostream& OStream)
     OStream << "** Units class : " << ClassIt->first << " **" << std::endl;
 
 
-    Units = (ClassIt->second).list();
+    Units = (ClassIt->second).units();
 
     for (UnitIt = Units->begin();UnitIt != Units->end();++UnitIt)
     {
-      UnitIt->streamContents(OStream);
+      (*UnitIt)->streamContents(OStream);
     }
 
 
@@ -388,6 +893,12 @@ void SpatialGraph::clearAllVariables()
 {
   for (openfluid::core::SpatialUnit* CurrentUnit : m_PcsOrderedUnitsGlobal)
     CurrentUnit->variables()->clear();
+
+  for (auto& ClassUnits : m_PcsOrderedUnitsByClass)
+  {
+    for (openfluid::core::SpatialUnit* GhostUnit : *(ClassUnits.second.ghosts()))
+      GhostUnit->variables()->clear();
+  }
 }
 
 
@@ -440,6 +951,11 @@ void SpatialGraph::clearUnits()
   {
     deleteUnit(*(UnitPtrIt++));
   }
+
+  for (auto& ClassUnits : m_PcsOrderedUnitsByClass)
+    ClassUnits.second.removeSpatialUnits([](const SpatialUnit&) { return true; });
+
+  m_UnitsGrids.clear();
 }
 
 } } // namespaces
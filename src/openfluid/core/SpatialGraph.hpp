@@ -39,7 +39,11 @@
 #define __OPENFLUID_CORE_SPATIALGRAPH_HPP__
 
 
+#include <tuple>
+
 #include <openfluid/core/SpatialUnit.hpp>
+#include <openfluid/core/UnitsAdjacency.hpp>
+#include <openfluid/core/UnitsGrid.hpp>
 #include <openfluid/dllexport.hpp>
 
 
@@ -57,6 +61,16 @@ class OPENFLUID_API SpatialGraph
 
     UnitsPtrList_t m_PcsOrderedUnitsGlobal;
 
+    typedef std::tuple<UnitsClass_t,UnitsLinkType,UnitsClass_t> AdjacencyKey_t;
+
+    std::map<AdjacencyKey_t,UnitsAdjacency> m_Adjacencies;
+
+    bool m_IsAdjacencyUpToDate;
+
+    unsigned long long m_AdjacencyLinksRevision;
+
+    std::map<UnitsClass_t,UnitsGrid> m_UnitsGrids;
+
     static bool removeUnitFromList(UnitsPtrList_t* UnitsList,
                                    const UnitID_t& UnitID);
 
@@ -68,6 +82,16 @@ class OPENFLUID_API SpatialGraph
 
     bool deleteUnit(SpatialUnit* aUnit);
 
+    /**
+      Restricts the spatial graph to the given units and ghost units, in a single pass over units.
+      Other units are deleted and the links to them are removed. Ghost units are kept with their links
+      to the remaining units, but they are removed from the units lists so that loops on units do not process them
+      (see openfluid::core::UnitsCollection).
+      @param[in] Units the units to keep
+      @param[in] Ghosts the units to keep as ghost units
+    */
+    void restrictToUnits(const UnitsPtrVector_t& Units, const UnitsPtrVector_t& Ghosts);
+
     bool removeFromToConnection(SpatialUnit* FromUnit,
                                 SpatialUnit* ToUnit);
 
@@ -76,6 +100,36 @@ class OPENFLUID_API SpatialGraph
 
     bool sortUnitsByProcessOrder();
 
+    /**
+      Sorts units by process order, then sorts units of a same process order following the given ordering,
+      so that linked or close units are stored close to each other in the dense arrays of their class.
+      Units IDs and process orders are not modified. With the Hilbert curve ordering, units without geometry
+      are placed after units with geometry, following the Cuthill-McKee ordering.
+      Later sorts by process order are stable and keep the resulting order.
+      @param[in] Ordering the ordering of units within process orders levels
+      @throw openfluid::base::FrameworkException with the Hilbert curve ordering,
+      if no unit of a units class has a geometry
+    */
+    void sortUnitsByLocality(UnitsOrdering Ordering);
+
+    /**
+      Computes the process orders of units from the from-to connections, using a topological sort:
+      a unit with no upstream unit gets the process order 1, other units get the process order
+      following the highest process order of their upstream units.
+      Units are then sorted by process order.
+      @throw openfluid::base::FrameworkException if the from-to connections contain a cycle
+    */
+    void computeProcessOrders();
+
+    /**
+      Computes the process orders of the given units only, from the from-to connections.
+      The process orders of the other units are kept unchanged and used as fixed values.
+      Units are then sorted by process order.
+      @param[in] Units the units for which process orders have to be computed
+      @throw openfluid::base::FrameworkException if the from-to connections between these units contain a cycle
+    */
+    void computeProcessOrders(const std::vector<SpatialUnit*>& Units);
+
     SpatialUnit* spatialUnit(const UnitsClass_t& UnitsClass, UnitID_t UnitID);
 
     const SpatialUnit* spatialUnit(const UnitsClass_t& UnitsClass, UnitID_t UnitID) const;
@@ -93,8 +147,62 @@ class OPENFLUID_API SpatialGraph
     inline UnitsPtrList_t* allSpatialUnits()
     { return &m_PcsOrderedUnitsGlobal; };
 
+    /**
+      Returns the total number of units, all classes included
+    */
+    inline std::size_t getUnitsCount() const
+    { return m_PcsOrderedUnitsGlobal.size(); };
+
     bool isUnitsClassExist(const UnitsClass_t& UnitsClass) const;
 
+    /**
+      Builds the compressed adjacency of all links between units,
+      for every combination of source class, link type and target class
+    */
+    void buildAdjacency();
+
+    /**
+      Marks the compressed adjacency as outdated, it will be rebuilt at next access.
+      Links added through units are detected automatically,
+      this must be called when the lists of linked units are modified directly.
+    */
+    inline void invalidateAdjacency()
+    { m_IsAdjacencyUpToDate = false; };
+
+    /**
+      Returns true if the compressed adjacency is built and no link has been added to units since
+    */
+    inline bool isAdjacencyUpToDate() const
+    { return m_IsAdjacencyUpToDate && m_AdjacencyLinksRevision == SpatialUnit::getLinksRevision(); };
+
+    /**
+      Returns the compressed adjacency of links of a given type from units of a class to units of another class.
+      The adjacency is rebuilt if outdated, so this method must not be called concurrently.
+      @param[in] SourceClass the class of the source units
+      @param[in] LinkType the type of links
+      @param[in] TargetClass the class of the linked units
+      @return the adjacency, nullptr if no link of this type exists between these classes
+    */
+    const UnitsAdjacency* adjacency(const UnitsClass_t& SourceClass, UnitsLinkType LinkType,
+                                    const UnitsClass_t& TargetClass);
+
+    /**
+      Adds a regular grid of units. If a grid already exists for this units class, it is replaced.
+      @param[in] UnitsClass the units class of the grid cells
+      @param[in] ColsNbr the number of columns of the grid
+      @param[in] RowsNbr the number of rows of the grid
+      @return the added grid
+      @throw openfluid::base::FrameworkException if spatial units of this class already exist
+    */
+    UnitsGrid* addUnitsGrid(const UnitsClass_t& UnitsClass, unsigned long ColsNbr, unsigned long RowsNbr);
+
+    UnitsGrid* unitsGrid(const UnitsClass_t& UnitsClass);
+
+    const UnitsGrid* unitsGrid(const UnitsClass_t& UnitsClass) const;
+
+    inline bool isUnitsGridExist(const UnitsClass_t& UnitsClass) const
+    { return (m_UnitsGrids.find(UnitsClass) != m_UnitsGrids.end()); };
+
     void streamContents(std::ostream& OStream);
 
     void clearAllVariables();
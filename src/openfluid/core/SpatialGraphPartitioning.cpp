@@ -0,0 +1,427 @@
+/*
+
+  This file is part of OpenFLUID software
+  Copyright(c) 2007, INRA - Montpellier SupAgro
+
+
+ == GNU General Public License Usage ==
+
+  OpenFLUID is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OpenFLUID is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OpenFLUID. If not, see <http://www.gnu.org/licenses/>.
+
+
+ == Other Usage ==
+
+  Other Usage means a use of OpenFLUID that is inconsistent with the GPL
+  license, and requires a written agreement between You and INRA.
+  Licensees for Other Usage of OpenFLUID may use this file in accordance
+  with the terms contained in the written agreement between You and INRA.
+  
+*/
+
+
+/**
+  @file SpatialGraphPartitioning.cpp
+
+  @author Jean-Christophe FABRE <jean-christophe.fabre@supagro.inra.fr>
+ */
+
+
+
+#include <algorithm>
+#include <cmath>
+
+#include <openfluid/core/SpatialGraphPartitioning.hpp>
+#include <openfluid/core/UnitsAdjacency.hpp>
+#include <openfluid/base/FrameworkException.hpp>
+
+
+namespace openfluid { namespace core {
+
+
+SpatialGraphPartitioning::SpatialGraphPartitioning() :
+  m_PartitionsCount(0), m_CutLinksCount(0)
+{
+
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void SpatialGraphPartitioning::clear()
+{
+  m_PartitionsCount = 0;
+  m_PartitionsByClass.clear();
+  m_Units.clear();
+  m_HaloUnits.clear();
+  m_CutLinksCount = 0;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void SpatialGraphPartitioning::compute(SpatialGraph* Graph, unsigned int PartitionsCount, double Tolerance)
+{
+  if (!PartitionsCount)
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Number of partitions must be greater than 0");
+
+  clear();
+
+  m_PartitionsCount = PartitionsCount;
+  m_Units.resize(PartitionsCount);
+
+
+  // global indexing of units, following the process order
+
+  const UnitsPtrVector_t AllUnits(Graph->allSpatialUnits()->begin(),Graph->allSpatialUnits()->end());
+  const std::size_t UnitsCount = AllUnits.size();
+  std::map<UnitsClass_t,std::vector<std::size_t>> GlobalIndices;
+
+  for (auto& ClassUnits : *(Graph->allSpatialUnitsByClass()))
+    GlobalIndices[ClassUnits.first].resize(ClassUnits.second.size());
+
+  for (std::size_t i = 0; i < UnitsCount; i++)
+    GlobalIndices[AllUnits[i]->getClass()][AllUnits[i]->getIndex()] = i;
+
+
+  // links between units using global indices
+
+  std::vector<std::vector<std::size_t>> Upstream(UnitsCount);
+  std::vector<std::vector<std::size_t>> Downstream(UnitsCount);
+  std::vector<std::vector<std::size_t>> Related(UnitsCount);
+
+  for (auto& Source : GlobalIndices)
+  {
+    for (auto& Target : GlobalIndices)
+    {
+      for (UnitsLinkType Link : {UnitsLinkType::FROM,UnitsLinkType::TO,UnitsLinkType::PARENT,UnitsLinkType::CHILD})
+      {
+        const UnitsAdjacency* Adj = Graph->adjacency(Source.first,Link,Target.first);
+
+        if (Adj == nullptr)
+          continue;
+
+        for (std::size_t i = 0; i < Adj->getSourcesCount(); i++)
+        {
+          const std::size_t SrcIndex = Source.second[i];
+
+          for (std::size_t j = Adj->offsets()[i]; j < Adj->offsets()[i+1]; j++)
+          {
+            const std::size_t TgtIndex = Target.second[Adj->neighboursIndices()[j]];
+
+            if (Link == UnitsLinkType::FROM)
+              Upstream[SrcIndex].push_back(TgtIndex);
+            else if (Link == UnitsLinkType::TO)
+              Downstream[SrcIndex].push_back(TgtIndex);
+            else
+              Related[SrcIndex].push_back(TgtIndex);
+          }
+        }
+      }
+    }
+  }
+
+
+  // sub-basins partitions, built by accumulating units from upstream to downstream.
+  // Each unit is attached to the first processed downstream unit, and sub-basins are closed as partitions
+  // when their size reaches the target size. Units without from-to links are not part of sub-basins,
+  // they are set afterwards with their related units.
+
+  std::size_t ConnectedCount = 0;
+
+  for (std::size_t i = 0; i < UnitsCount; i++)
+  {
+    if (!Upstream[i].empty() || !Downstream[i].empty())
+      ConnectedCount++;
+  }
+
+  const PartitionID_t Unassigned = PartitionsCount;
+  const std::size_t TargetSize = std::max<std::size_t>((ConnectedCount+PartitionsCount-1)/PartitionsCount,1);
+  std::vector<PartitionID_t> Partitions(UnitsCount,Unassigned);
+  std::vector<std::size_t> Sizes(PartitionsCount,0);
+  std::vector<std::size_t> Pending(UnitsCount,0);
+  std::vector<std::vector<std::size_t>> Attached(UnitsCount);
+  std::vector<bool> IsAttached(UnitsCount,false);
+  PartitionID_t Current = 0;
+
+  auto closeSubBasin = [&](std::size_t Root)
+  {
+    std::vector<std::size_t> Stack(1,Root);
+
+    while (!Stack.empty())
+    {
+      const std::size_t Index = Stack.back();
+      Stack.pop_back();
+
+      if (Partitions[Index] != Unassigned)
+        continue;
+
+      Partitions[Index] = Current;
+      Sizes[Current]++;
+
+      Stack.insert(Stack.end(),Attached[Index].begin(),Attached[Index].end());
+    }
+
+    Current++;
+  };
+
+  for (std::size_t i = 0; i < UnitsCount; i++)
+  {
+    if (Upstream[i].empty() && Downstream[i].empty())
+      continue;
+
+    Pending[i] = 1;
+
+    for (std::size_t Up : Upstream[i])
+    {
+      if (Up < i && !IsAttached[Up] && Partitions[Up] == Unassigned)
+      {
+        IsAttached[Up] = true;
+        Attached[i].push_back(Up);
+        Pending[i] += Pending[Up];
+      }
+    }
+
+    // largest upstream sub-basins are closed first when the sub-basin of the unit is too large
+
+    std::sort(Attached[i].begin(),Attached[i].end(),
+              [&Pending](std::size_t A, std::size_t B) { return Pending[A] > Pending[B]; });
+
+    for (std::size_t Up : Attached[i])
+    {
+      if (Pending[i] <= TargetSize || Current+1 >= PartitionsCount)
+        break;
+
+      Pending[i] -= Pending[Up];
+      closeSubBasin(Up);
+    }
+
+    if (Pending[i] >= TargetSize && Current+1 < PartitionsCount)
+      closeSubBasin(i);
+  }
+
+  // remaining connected units are set in the last partition,
+  // units without from-to links are set with their related units or in the smallest partition
+
+  Current = std::min(Current,static_cast<PartitionID_t>(PartitionsCount-1));
+
+  for (std::size_t i = 0; i < UnitsCount; i++)
+  {
+    if (Partitions[i] == Unassigned && (!Upstream[i].empty() || !Downstream[i].empty()))
+    {
+      Partitions[i] = Current;
+      Sizes[Current]++;
+    }
+  }
+
+  for (std::size_t i = 0; i < UnitsCount; i++)
+  {
+    if (Partitions[i] == Unassigned)
+    {
+      PartitionID_t Chosen = std::min_element(Sizes.begin(),Sizes.end())-Sizes.begin();
+
+      for (std::size_t Linked : Related[i])
+      {
+        if (Partitions[Linked] != Unassigned)
+        {
+          Chosen = Partitions[Linked];
+          break;
+        }
+      }
+
+      Partitions[i] = Chosen;
+      Sizes[Chosen]++;
+    }
+  }
+
+
+  // ordering of partitions following the process order: a unit linked to a unit processed before it
+  // is moved to the partition of this unit if its own partition comes before.
+  // Units being processed in process order, partitions are thus only linked to previous partitions by
+  // units processed before their own linked units, which allows to run them as a pipeline.
+
+  auto getAllowedRange = [&](std::size_t i, PartitionID_t& Lowest, PartitionID_t& Highest)
+  {
+    Lowest = 0;
+    Highest = PartitionsCount-1;
+
+    for (const std::vector<std::size_t>* LinkedList : {&Upstream[i],&Downstream[i],&Related[i]})
+    {
+      for (std::size_t Linked : *LinkedList)
+      {
+        if (Linked < i)
+          Lowest = std::max(Lowest,Partitions[Linked]);
+        else if (Linked > i)
+          Highest = std::min(Highest,Partitions[Linked]);
+      }
+    }
+  };
+
+  for (std::size_t i = 0; i < UnitsCount; i++)
+  {
+    PartitionID_t Lowest, Highest;
+    getAllowedRange(i,Lowest,Highest);
+
+    if (Partitions[i] < Lowest)
+    {
+      Sizes[Partitions[i]]--;
+      Partitions[i] = Lowest;
+      Sizes[Lowest]++;
+    }
+  }
+
+
+  // refinement of boundaries, moving units to the partition holding most of their linked units
+  // within the range of partitions keeping the ordering
+
+  const double AverageSize = double(UnitsCount)/PartitionsCount;
+  const std::size_t MaxSize = std::max(TargetSize,static_cast<std::size_t>(std::ceil(AverageSize*(1.0+Tolerance))));
+  const std::size_t MinSize = static_cast<std::size_t>(std::floor(AverageSize*(1.0-Tolerance)));
+  std::vector<long> LinksCounts(PartitionsCount,0);
+  bool Moved = true;
+
+  for (unsigned int Pass = 0; Pass < 4 && Moved; Pass++)
+  {
+    Moved = false;
+
+    for (std::size_t i = 0; i < UnitsCount; i++)
+    {
+      const PartitionID_t Own = Partitions[i];
+
+      for (std::size_t Linked : Upstream[i])
+        LinksCounts[Partitions[Linked]]++;
+      for (std::size_t Linked : Downstream[i])
+        LinksCounts[Partitions[Linked]]++;
+
+      PartitionID_t Best = Own;
+      long BestGain = 0;
+      PartitionID_t Lowest, Highest;
+      getAllowedRange(i,Lowest,Highest);
+
+      for (PartitionID_t p = Lowest; p <= Highest; p++)
+      {
+        const long Gain = LinksCounts[p]-LinksCounts[Own];
+
+        if (p != Own && Gain > BestGain && Sizes[p]+1 <= MaxSize && Sizes[Own] > std::max<std::size_t>(MinSize,1))
+        {
+          Best = p;
+          BestGain = Gain;
+        }
+      }
+
+      std::fill(LinksCounts.begin(),LinksCounts.end(),0);
+
+      if (Best != Own)
+      {
+        Partitions[i] = Best;
+        Sizes[Own]--;
+        Sizes[Best]++;
+        Moved = true;
+      }
+    }
+  }
+
+
+  // partitions contents, cut links and halos
+
+  std::map<std::pair<PartitionID_t,PartitionID_t>,std::vector<std::size_t>> HaloIndices;
+
+  for (std::size_t i = 0; i < UnitsCount; i++)
+  {
+    const PartitionID_t Own = Partitions[i];
+
+    m_Units[Own].push_back(AllUnits[i]);
+    m_PartitionsByClass[AllUnits[i]->getClass()].resize(GlobalIndices[AllUnits[i]->getClass()].size());
+    m_PartitionsByClass[AllUnits[i]->getClass()][AllUnits[i]->getIndex()] = Own;
+
+    for (std::size_t Linked : Downstream[i])
+    {
+      if (Partitions[Linked] != Own)
+        m_CutLinksCount++;
+    }
+
+    for (const std::vector<std::size_t>* LinkedList : {&Upstream[i],&Downstream[i],&Related[i]})
+    {
+      for (std::size_t Linked : *LinkedList)
+      {
+        if (Partitions[Linked] != Own)
+          HaloIndices[std::make_pair(Own,Partitions[Linked])].push_back(Linked);
+      }
+    }
+  }
+
+  for (auto& Halo : HaloIndices)
+  {
+    std::sort(Halo.second.begin(),Halo.second.end());
+    Halo.second.erase(std::unique(Halo.second.begin(),Halo.second.end()),Halo.second.end());
+
+    UnitsPtrVector_t& HaloUnits = m_HaloUnits[Halo.first];
+
+    for (std::size_t Index : Halo.second)
+      HaloUnits.push_back(AllUnits[Index]);
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+SpatialGraphPartitioning::PartitionID_t SpatialGraphPartitioning::getPartition(const SpatialUnit* Unit) const
+{
+  auto it = m_PartitionsByClass.find(Unit->getClass());
+
+  if (it == m_PartitionsByClass.end() || Unit->getIndex() >= it->second.size())
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                              "Unit " + Unit->getClass() + "#" + std::to_string(Unit->getID()) +
+                                              " is not partitioned");
+
+  return it->second[Unit->getIndex()];
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+const UnitsPtrVector_t& SpatialGraphPartitioning::units(PartitionID_t Partition) const
+{
+  if (Partition >= m_PartitionsCount)
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Wrong partition");
+
+  return m_Units[Partition];
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+const UnitsPtrVector_t& SpatialGraphPartitioning::haloUnits(PartitionID_t Partition, PartitionID_t Other) const
+{
+  static const UnitsPtrVector_t EmptyHalo;
+
+  auto it = m_HaloUnits.find(std::make_pair(Partition,Other));
+
+  if (it != m_HaloUnits.end())
+    return it->second;
+
+  return EmptyHalo;
+}
+
+
+} } // namespaces
@@ -0,0 +1,137 @@
+/*
+
+  This file is part of OpenFLUID software
+  Copyright(c) 2007, INRA - Montpellier SupAgro
+
+
+ == GNU General Public License Usage ==
+
+  OpenFLUID is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OpenFLUID is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OpenFLUID. If not, see <http://www.gnu.org/licenses/>.
+
+
+ == Other Usage ==
+
+  Other Usage means a use of OpenFLUID that is inconsistent with the GPL
+  license, and requires a written agreement between You and INRA.
+  Licensees for Other Usage of OpenFLUID may use this file in accordance
+  with the terms contained in the written agreement between You and INRA.
+  
+*/
+
+
+/**
+  @file SpatialGraphPartitioning.hpp
+
+  @author Jean-Christophe FABRE <jean-christophe.fabre@supagro.inra.fr>
+ */
+
+
+
+#ifndef __OPENFLUID_CORE_SPATIALGRAPHPARTITIONING_HPP__
+#define __OPENFLUID_CORE_SPATIALGRAPHPARTITIONING_HPP__
+
+
+#include <map>
+#include <vector>
+
+#include <openfluid/dllexport.hpp>
+#include <openfluid/core/SpatialGraph.hpp>
+
+
+namespace openfluid { namespace core {
+
+
+/**
+  Partitioning of a spatial graph into sub-domains, for distributed execution.
+  Partitions are grown as sub-basins along the from-to connections, accumulating units following
+  the process order, from the upstream units to the outlets.
+
+  The links between units are oriented by the process order: partitions are numbered so that a unit linked
+  to a unit of another partition belongs to the partition with the lower number if it is processed first.
+  A partition thus only needs the values of units of lower partitions processed before its own units,
+  and the partitions can be run as a pipeline.
+  Partitions are then refined by moving boundary units to reduce the number of from-to links cut between
+  partitions, while keeping this ordering and partitions sizes balanced.
+
+  For each partition, the halo gives the units of other partitions that are linked to units of the partition
+  (by from-to or parent-child links), which variables have to be received from the other partitions
+  at each time point.
+*/
+class OPENFLUID_API SpatialGraphPartitioning
+{
+  public:
+
+    typedef unsigned int PartitionID_t;
+
+
+  private:
+
+    unsigned int m_PartitionsCount;
+
+    std::map<UnitsClass_t,std::vector<PartitionID_t>> m_PartitionsByClass;
+
+    std::vector<UnitsPtrVector_t> m_Units;
+
+    std::map<std::pair<PartitionID_t,PartitionID_t>,UnitsPtrVector_t> m_HaloUnits;
+
+    std::size_t m_CutLinksCount;
+
+
+  public:
+
+    SpatialGraphPartitioning();
+
+    /**
+      Computes the partitioning of a spatial graph
+      @param[in] Graph the spatial graph, which must be sorted by process order
+      @param[in] PartitionsCount the number of partitions, greater than 0
+      @param[in] Tolerance the allowed relative imbalance of partitions sizes during refinement
+      @throw openfluid::base::FrameworkException if the number of partitions is 0
+    */
+    void compute(SpatialGraph* Graph, unsigned int PartitionsCount, double Tolerance = 0.05);
+
+    inline unsigned int getPartitionsCount() const
+    { return m_PartitionsCount; };
+
+    /**
+      Returns the partition of a unit of the partitioned graph
+    */
+    PartitionID_t getPartition(const SpatialUnit* Unit) const;
+
+    /**
+      Returns the units of a partition, sorted by process order
+    */
+    const UnitsPtrVector_t& units(PartitionID_t Partition) const;
+
+    /**
+      Returns the units of partition Other linked to units of partition Partition,
+      sorted by process order
+    */
+    const UnitsPtrVector_t& haloUnits(PartitionID_t Partition, PartitionID_t Other) const;
+
+    /**
+      Returns the number of from-to links between units of different partitions
+    */
+    inline std::size_t getCutLinksCount() const
+    { return m_CutLinksCount; };
+
+    void clear();
+
+};
+
+
+} } // namespaces
+
+
+#endif /* __OPENFLUID_CORE_SPATIALGRAPHPARTITIONING_HPP__ */
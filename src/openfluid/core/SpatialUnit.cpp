@@ -44,9 +44,16 @@
 namespace openfluid { namespace core {
 
 
+std::atomic<unsigned long long> SpatialUnit::s_LinksRevision(0);
+
+
+// =====================================================================
+// =====================================================================
+
+
 SpatialUnit::SpatialUnit(const UnitsClass_t& aClass, const UnitID_t anID,
                          const PcsOrd_t aPcsOrder) :
-  m_ID(anID), m_Class(aClass), m_PcsOrder(aPcsOrder), m_Geometry(nullptr)
+  m_ID(anID), m_Index(0), m_Class(aClass), m_PcsOrder(aPcsOrder), m_Geometry(nullptr)
 {
 
 }
@@ -69,6 +76,7 @@ SpatialUnit::~SpatialUnit()
 bool SpatialUnit::addToUnit(SpatialUnit* aUnit)
 {
   m_ToUnits[aUnit->getClass()].push_back(aUnit);
+  s_LinksRevision++;
   return true;
 }
 
@@ -80,6 +88,7 @@ bool SpatialUnit::addToUnit(SpatialUnit* aUnit)
 bool SpatialUnit::addFromUnit(SpatialUnit* aUnit)
 {
   m_FromUnits[aUnit->getClass()].push_back(aUnit);
+  s_LinksRevision++;
   return true;
 
 }
@@ -92,6 +101,7 @@ bool SpatialUnit::addFromUnit(SpatialUnit* aUnit)
 bool SpatialUnit::addParentUnit(SpatialUnit* aUnit)
 {
   m_ParentUnits[aUnit->getClass()].push_back(aUnit);
+  s_LinksRevision++;
   return true;
 }
 
@@ -103,6 +113,7 @@ bool SpatialUnit::addParentUnit(SpatialUnit* aUnit)
 bool SpatialUnit::addChildUnit(SpatialUnit* aUnit)
 {
   m_ChildrenUnits[aUnit->getClass()].push_back(aUnit);
+  s_LinksRevision++;
   return true;
 
 }
@@ -41,8 +41,10 @@
 #define __OPENFLUID_CORE_SPATIALUNIT_HPP__
 
 
+#include <atomic>
 #include <map>
 #include <string>
+#include <vector>
 
 #include <openfluid/dllexport.hpp>
 #include <openfluid/deprecation.hpp>
@@ -76,6 +78,12 @@ typedef std::list<SpatialUnit*> UnitsPtrList_t;
 typedef std::map<UnitsClass_t,UnitsPtrList_t> LinkedUnitsListByClassMap_t;
 
 
+/**
+  Type for a list of units associated to a read-only view on some of their events
+*/
+typedef std::vector<std::pair<SpatialUnit*,EventsRange>> UnitsEventsRanges_t;
+
+
 /**
   Class defining a spatial unit
 
@@ -106,10 +114,15 @@ typedef std::map<UnitsClass_t,UnitsPtrList_t> LinkedUnitsListByClassMap_t;
 */
 class OPENFLUID_API SpatialUnit
 {
+  friend class UnitsCollection;
+  friend class SpatialGraph;
+
   private:
 
     UnitID_t m_ID;
 
+    std::size_t m_Index;
+
     UnitsClass_t m_Class;
 
     // TODO use openfluid::core::PcsOrd_t instead
@@ -131,6 +144,8 @@ class OPENFLUID_API SpatialUnit
 
     OGRGeometry* m_Geometry;
 
+    static std::atomic<unsigned long long> s_LinksRevision;
+
 
   public:
 
@@ -159,6 +174,14 @@ class OPENFLUID_API SpatialUnit
     inline UnitID_t getID() const
     { return m_ID; };
 
+    /**
+      Returns the dense index of this unit in its units class, following the process order.
+      This index is valid once the unit is added to the spatial graph,
+      and may change when units are added or removed.
+    */
+    inline std::size_t getIndex() const
+    { return m_Index; };
+
 
     /**
       Returns the class of the unit
@@ -174,6 +197,13 @@ class OPENFLUID_API SpatialUnit
 
     bool addChildUnit(SpatialUnit* aUnit);
 
+    /**
+      Returns the revision of links between units, incremented each time a link is added to any unit.
+      It is used to detect outdated adjacencies of spatial graphs.
+    */
+    static unsigned long long getLinksRevision()
+    { return s_LinksRevision.load(); };
+
     /**
       Returns a list of units, of the requested class, connected to this unit.
       Returns nullptr if no units of the requested class are connected to this unit.
@@ -39,6 +39,7 @@
 #ifndef __OPENFLUID_CORE_TREE_HPP__
 #define __OPENFLUID_CORE_TREE_HPP__
 
+#include <map>
 #include <sstream>
 #include <iostream>
 #include <iomanip>
@@ -274,13 +275,15 @@ class OPENFLUID_API Tree
     */
     Tree<K,V>& addChild(const K& Key, const V& Val)
     {
-      if (hasChild(Key))
+      // single lookup for both existence check and insertion
+      auto Inserted = m_Children.emplace(Key,Tree<K,V>());
+
+      if (!Inserted.second)
         throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Key " + keyToStr(Key) + " already exists");
 
-      m_Children[Key] = Tree<K,V>();
-      m_Children[Key].setValue(Val);
+      (*Inserted.first).second.setValue(Val);
 
-      return m_Children[Key];
+      return (*Inserted.first).second;
     }
 
 
@@ -296,12 +299,12 @@ class OPENFLUID_API Tree
     */
     Tree<K,V>& addChild(const K& Key)
     {
-      if (hasChild(Key))
-        throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Key " + keyToStr(Key) + " already exists");
+      auto Inserted = m_Children.emplace(Key,Tree<K,V>());
 
-      m_Children[Key] = Tree<K,V>();
+      if (!Inserted.second)
+        throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Key " + keyToStr(Key) + " already exists");
 
-      return m_Children[Key];
+      return (*Inserted.first).second;
     }
 
 
@@ -0,0 +1,125 @@
+/*
+
+  This file is part of OpenFLUID software
+  Copyright(c) 2007, INRA - Montpellier SupAgro
+
+
+ == GNU General Public License Usage ==
+
+  OpenFLUID is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OpenFLUID is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OpenFLUID. If not, see <http://www.gnu.org/licenses/>.
+
+
+ == Other Usage ==
+
+  Other Usage means a use of OpenFLUID that is inconsistent with the GPL
+  license, and requires a written agreement between You and INRA.
+  Licensees for Other Usage of OpenFLUID may use this file in accordance
+  with the terms contained in the written agreement between You and INRA.
+  
+*/
+
+
+/**
+  @file UnitsAdjacency.cpp
+
+  @author Jean-Christophe FABRE <jean-christophe.fabre@supagro.inra.fr>
+ */
+
+
+
+#include <openfluid/core/UnitsAdjacency.hpp>
+
+
+namespace openfluid { namespace core {
+
+
+bool UnitsAdjacency::computeLevels(std::vector<std::size_t>& Order, std::vector<std::size_t>& LevelsOffsets) const
+{
+  const std::size_t SourcesCount = getSourcesCount();
+
+  Order.clear();
+  Order.reserve(SourcesCount);
+  LevelsOffsets.assign(1,0);
+
+  // reversed links, from each unit to the units depending on it
+
+  std::vector<std::size_t> DependentsOffsets(SourcesCount+1,0);
+  std::vector<std::size_t> Dependents(m_NeighboursIndices.size());
+  std::vector<std::size_t> RemainingCount(SourcesCount);
+
+  // neighbours out of the sources range are ghost units, their values are already available
+
+  for (std::size_t i = 0; i < SourcesCount; i++)
+  {
+    RemainingCount[i] = 0;
+
+    for (std::size_t j = m_Offsets[i]; j < m_Offsets[i+1]; j++)
+    {
+      if (m_NeighboursIndices[j] < SourcesCount)
+      {
+        RemainingCount[i]++;
+        DependentsOffsets[m_NeighboursIndices[j]+1]++;
+      }
+    }
+  }
+
+  for (std::size_t i = 0; i < SourcesCount; i++)
+    DependentsOffsets[i+1] += DependentsOffsets[i];
+
+  std::vector<std::size_t> Positions(DependentsOffsets.begin(),DependentsOffsets.end()-1);
+
+  for (std::size_t i = 0; i < SourcesCount; i++)
+  {
+    for (std::size_t j = m_Offsets[i]; j < m_Offsets[i+1]; j++)
+    {
+      if (m_NeighboursIndices[j] < SourcesCount)
+        Dependents[Positions[m_NeighboursIndices[j]]++] = i;
+    }
+  }
+
+
+  // levels by successive fronts
+
+  for (std::size_t i = 0; i < SourcesCount; i++)
+  {
+    if (!RemainingCount[i])
+      Order.push_back(i);
+  }
+
+  std::size_t LevelBegin = 0;
+
+  while (LevelBegin < Order.size())
+  {
+    const std::size_t LevelEnd = Order.size();
+
+    for (std::size_t k = LevelBegin; k < LevelEnd; k++)
+    {
+      const std::size_t Current = Order[k];
+
+      for (std::size_t j = DependentsOffsets[Current]; j < DependentsOffsets[Current+1]; j++)
+      {
+        if (!(--RemainingCount[Dependents[j]]))
+          Order.push_back(Dependents[j]);
+      }
+    }
+
+    LevelsOffsets.push_back(LevelEnd);
+    LevelBegin = LevelEnd;
+  }
+
+  return (Order.size() == SourcesCount);
+}
+
+
+} } // namespaces
@@ -0,0 +1,162 @@
+/*
+
+  This file is part of OpenFLUID software
+  Copyright(c) 2007, INRA - Montpellier SupAgro
+
+
+ == GNU General Public License Usage ==
+
+  OpenFLUID is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OpenFLUID is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OpenFLUID. If not, see <http://www.gnu.org/licenses/>.
+
+
+ == Other Usage ==
+
+  Other Usage means a use of OpenFLUID that is inconsistent with the GPL
+  license, and requires a written agreement between You and INRA.
+  Licensees for Other Usage of OpenFLUID may use this file in accordance
+  with the terms contained in the written agreement between You and INRA.
+  
+*/
+
+
+/**
+  @file UnitsAdjacency.hpp
+
+  @author Jean-Christophe FABRE <jean-christophe.fabre@supagro.inra.fr>
+ */
+
+
+#ifndef __OPENFLUID_CORE_UNITSADJACENCY_HPP__
+#define __OPENFLUID_CORE_UNITSADJACENCY_HPP__
+
+
+#include <vector>
+
+#include <openfluid/dllexport.hpp>
+#include <openfluid/core/TypeDefs.hpp>
+#include <openfluid/core/UnitsCollection.hpp>
+
+
+namespace openfluid { namespace core {
+
+
+/**
+  Types of links between spatial units
+*/
+enum class UnitsLinkType { FROM, TO, PARENT, CHILD };
+
+
+/**
+  Compressed sparse row representation of the links of a given type
+  from the units of a source class to the units of a target class.
+  Neighbours of a source unit are accessed through its dense index (see openfluid::core::SpatialUnit::getIndex()),
+  as a contiguous span of units, in the same order as the links lists of the source unit.
+
+  <I>Example : </I>
+  @code
+  const openfluid::core::UnitsAdjacency* ToRS =
+    OPENFLUID_GetUnitsAdjacency("SU",openfluid::core::UnitsLinkType::TO,"RS");
+
+  OPENFLUID_UNITS_ORDERED_LOOP("SU",SU)
+  {
+    if (ToRS)
+    {
+      for (openfluid::core::SpatialUnit* RS : ToRS->neighbours(SU->getIndex()))
+      {
+        // process connected unit
+      }
+    }
+  }
+  @endcode
+*/
+class OPENFLUID_API UnitsAdjacency
+{
+  friend class SpatialGraph;
+
+  private:
+
+    std::vector<std::size_t> m_Offsets;
+
+    UnitsPtrVector_t m_Neighbours;
+
+    std::vector<std::size_t> m_NeighboursIndices;
+
+
+  public:
+
+    UnitsAdjacency()
+    { }
+
+    /**
+      Returns the units linked to a source unit
+      @param[in] Index the dense index of the source unit
+    */
+    inline UnitsSpan neighbours(std::size_t Index) const
+    {
+      return UnitsSpan(m_Neighbours.data()+m_Offsets[Index],m_Neighbours.data()+m_Offsets[Index+1]);
+    }
+
+    /**
+      Returns the number of units linked to a source unit
+      @param[in] Index the dense index of the source unit
+    */
+    inline std::size_t neighboursCount(std::size_t Index) const
+    { return m_Offsets[Index+1]-m_Offsets[Index]; };
+
+    /**
+      Returns the offsets of the neighbours of each source unit, indexed by the source units dense indices.
+      The neighbours of the source unit i are stored from offset i to offset i+1 (excluded).
+    */
+    inline const std::vector<std::size_t>& offsets() const
+    { return m_Offsets; };
+
+    /**
+      Returns the dense indices of the neighbours in the target class, stored at the offsets.
+      Indices of ghost units are greater than or equal to the number of units of the target class
+      (see openfluid::core::UnitsCollection::ghosts()).
+    */
+    inline const std::vector<std::size_t>& neighboursIndices() const
+    { return m_NeighboursIndices; };
+
+    /**
+      Returns the number of source units
+    */
+    inline std::size_t getSourcesCount() const
+    { return m_Offsets.empty() ? 0 : m_Offsets.size()-1; };
+
+    /**
+      Returns the total number of links
+    */
+    inline std::size_t getLinksCount() const
+    { return m_Neighbours.size(); };
+
+    /**
+      Computes the dependency levels of the source units, for an adjacency where source and target classes
+      are the same. A source unit is at level 0 if it has no neighbour among the source units, otherwise at the level
+      following the highest level of its neighbours. Units of a same level do not depend on each other.
+      Ghost units neighbours are considered as already processed, so units of level 0 may have ghost neighbours.
+      @param[out] Order the dense indices of the source units, sorted by level
+      @param[out] LevelsOffsets the offsets of the levels in Order, level i being stored
+      from offset i to offset i+1 (excluded)
+      @return false if the links contain a cycle
+    */
+    bool computeLevels(std::vector<std::size_t>& Order, std::vector<std::size_t>& LevelsOffsets) const;
+
+};
+
+
+} } // namespaces
+
+
+#endif /* __OPENFLUID_CORE_UNITSADJACENCY_HPP__ */
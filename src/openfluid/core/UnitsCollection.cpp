@@ -38,6 +38,7 @@
 
 #include <openfluid/core/SpatialUnit.hpp>
 #include <openfluid/core/UnitsCollection.hpp>
+#include <openfluid/base/FrameworkException.hpp>
 
 
 
@@ -49,7 +50,7 @@ struct SortByProcessOrder
 {
   bool operator ()(SpatialUnit& U1,SpatialUnit& U2) const
   {
-    return (U1.getProcessOrder() <= U2.getProcessOrder());
+    return (U1.getProcessOrder() < U2.getProcessOrder());
   }
 
 };
@@ -59,7 +60,8 @@ struct SortByProcessOrder
 // =====================================================================
 
 
-UnitsCollection::UnitsCollection()
+UnitsCollection::UnitsCollection() :
+  m_LevelsOffsets(1,0)
 {
 
 }
@@ -69,6 +71,47 @@ UnitsCollection::UnitsCollection()
 // =====================================================================
 
 
+UnitsCollection::UnitsCollection(const UnitsCollection& Coll) :
+  m_LevelsOffsets(1,0)
+{
+  *this = Coll;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+UnitsCollection& UnitsCollection::operator=(const UnitsCollection& Coll)
+{
+  if (this == &Coll)
+    return *this;
+
+  m_Data.clear();
+  m_GhostsData.clear();
+
+  for (const SpatialUnit& U : Coll.m_Data)
+  {
+    m_Data.push_back(U);
+    m_Data.back().attributes()->attachToTable(&m_AttributesTable);
+  }
+
+  for (const SpatialUnit& U : Coll.m_GhostsData)
+  {
+    m_GhostsData.push_back(U);
+    m_GhostsData.back().attributes()->attachToTable(&m_AttributesTable);
+  }
+
+  updateIndex();
+
+  return *this;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 UnitsCollection::~UnitsCollection()
 {
 
@@ -79,34 +122,109 @@ UnitsCollection::~UnitsCollection()
 // =====================================================================
 
 
-SpatialUnit* UnitsCollection::spatialUnit(UnitID_t aUnitID)
+void UnitsCollection::appendToIndex(SpatialUnit* aUnit)
+{
+  // a new level starts when the process order changes, the last offset is always the end of the last level
+  if (m_PcsOrders.empty() || m_PcsOrders.back() != aUnit->getProcessOrder())
+    m_LevelsOffsets.push_back(m_Units.size()+1);
+  else
+    m_LevelsOffsets.back() = m_Units.size()+1;
+
+  aUnit->m_Index = m_Units.size();
+  m_IndexByID[aUnit->getID()] = m_Units.size();
+  m_Units.push_back(aUnit);
+  m_IDs.push_back(aUnit->getID());
+  m_PcsOrders.push_back(aUnit->getProcessOrder());
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void UnitsCollection::eraseFromData(UnitsList_t& Data, const SpatialUnit* aUnit)
 {
-  UnitsList_t::iterator it;
+  for (UnitsList_t::iterator itData = Data.begin(); itData != Data.end(); ++itData)
+  {
+    if (&(*itData) == aUnit)
+    {
+      Data.erase(itData);
+      return;
+    }
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void UnitsCollection::updateIndex()
+{
+  m_Units.clear();
+  m_IDs.clear();
+  m_PcsOrders.clear();
+  m_IndexByID.clear();
+  m_LevelsOffsets.assign(1,0);
+
+  m_Units.reserve(m_Data.size());
+  m_IDs.reserve(m_Data.size());
+  m_PcsOrders.reserve(m_Data.size());
+  m_IndexByID.reserve(m_Data.size());
+
+  for (SpatialUnit& U : m_Data)
+    appendToIndex(&U);
+
+
+  // ghost units are indexed after the units of the collection
 
-  for (it=m_Data.begin();it!=m_Data.end();++it)
+  m_Ghosts.clear();
+  m_GhostIndexByID.clear();
+
+  for (SpatialUnit& U : m_GhostsData)
   {
-    if (it->getID() == aUnitID)
-      return &(*it);
+    U.m_Index = m_Units.size()+m_Ghosts.size();
+    m_GhostIndexByID[U.getID()] = m_Ghosts.size();
+    m_Ghosts.push_back(&U);
   }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+SpatialUnit* UnitsCollection::spatialUnit(UnitID_t aUnitID)
+{
+  auto it = m_IndexByID.find(aUnitID);
+
+  if (it != m_IndexByID.end())
+    return m_Units[it->second];
+
+  it = m_GhostIndexByID.find(aUnitID);
+
+  if (it != m_GhostIndexByID.end())
+    return m_Ghosts[it->second];
 
   return nullptr;
 }
 
 
-
 // =====================================================================
 // =====================================================================
 
 
 const SpatialUnit* UnitsCollection::spatialUnit(UnitID_t aUnitID) const
 {
-  UnitsList_t::const_iterator it;
+  auto it = m_IndexByID.find(aUnitID);
 
-  for (it=m_Data.begin();it!=m_Data.end();++it)
-  {
-    if (it->getID() == aUnitID)
-      return &(*it);
-  }
+  if (it != m_IndexByID.end())
+    return m_Units[it->second];
+
+  it = m_GhostIndexByID.find(aUnitID);
+
+  if (it != m_GhostIndexByID.end())
+    return m_Ghosts[it->second];
 
   return nullptr;
 }
@@ -122,12 +240,134 @@ SpatialUnit* UnitsCollection::addSpatialUnit(const SpatialUnit& aUnit)
   if (spatialUnit(aUnit.getID()) == nullptr)
   {
     m_Data.push_back(aUnit);
+    m_Data.back().attributes()->attachToTable(&m_AttributesTable);
+    appendToIndex(&(m_Data.back()));
     return &(m_Data.back());
   }
   else
     return nullptr;
 }
 
+
+// =====================================================================
+// =====================================================================
+
+
+bool UnitsCollection::removeSpatialUnit(UnitID_t aUnitID)
+{
+  const SpatialUnit* TheUnit = spatialUnit(aUnitID);
+
+  if (TheUnit == nullptr)
+    return false;
+
+  if (isGhostSpatialUnit(aUnitID))
+  {
+    const std::size_t GhostIndex = m_GhostIndexByID[aUnitID];
+
+    // dense indices of following ghost units are shifted in place
+    m_GhostIndexByID.erase(aUnitID);
+    m_Ghosts.erase(m_Ghosts.begin()+GhostIndex);
+
+    for (std::size_t i = GhostIndex; i < m_Ghosts.size(); i++)
+    {
+      m_Ghosts[i]->m_Index--;
+      m_GhostIndexByID[m_Ghosts[i]->getID()]--;
+    }
+
+    eraseFromData(m_GhostsData,TheUnit);
+
+    return true;
+  }
+
+  const std::size_t Index = m_IndexByID[aUnitID];
+
+  // the level of the unit is the one ending after its index
+  std::size_t Level = 0;
+  while (m_LevelsOffsets[Level+1] <= Index)
+    Level++;
+
+  // dense indices of following units and of ghost units are shifted in place
+  m_IndexByID.erase(aUnitID);
+  m_Units.erase(m_Units.begin()+Index);
+  m_IDs.erase(m_IDs.begin()+Index);
+  m_PcsOrders.erase(m_PcsOrders.begin()+Index);
+
+  for (std::size_t i = Index; i < m_Units.size(); i++)
+  {
+    m_Units[i]->m_Index--;
+    m_IndexByID[m_IDs[i]]--;
+  }
+
+  for (SpatialUnit* G : m_Ghosts)
+    G->m_Index--;
+
+  for (std::size_t l = Level+1; l < m_LevelsOffsets.size(); l++)
+    m_LevelsOffsets[l]--;
+
+  // an emptied level is removed, its neighbour levels are merged if they have the same process order
+  if (m_LevelsOffsets[Level] == m_LevelsOffsets[Level+1])
+  {
+    m_LevelsOffsets.erase(m_LevelsOffsets.begin()+Level+1);
+
+    if (Level > 0 && Level+1 < m_LevelsOffsets.size() &&
+        m_PcsOrders[m_LevelsOffsets[Level]-1] == m_PcsOrders[m_LevelsOffsets[Level]])
+      m_LevelsOffsets.erase(m_LevelsOffsets.begin()+Level);
+  }
+
+  eraseFromData(m_Data,TheUnit);
+
+  return true;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+std::size_t UnitsCollection::removeSpatialUnits(const std::function<bool(const SpatialUnit&)>& Predicate)
+{
+  const std::size_t PreviousCount = m_Data.size()+m_GhostsData.size();
+
+  m_Data.remove_if(Predicate);
+  m_GhostsData.remove_if(Predicate);
+
+  const std::size_t RemovedCount = PreviousCount-m_Data.size()-m_GhostsData.size();
+
+  if (RemovedCount)
+    updateIndex();
+
+  return RemovedCount;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+std::size_t UnitsCollection::setGhostSpatialUnits(const std::function<bool(const SpatialUnit&)>& Predicate)
+{
+  std::size_t GhostsCount = 0;
+  UnitsList_t::iterator itData = m_Data.begin();
+
+  // units are moved between lists without being copied, so that pointers to them remain valid
+  while (itData != m_Data.end())
+  {
+    UnitsList_t::iterator itCurrent = itData++;
+
+    if (Predicate(*itCurrent))
+    {
+      m_GhostsData.splice(m_GhostsData.end(),m_Data,itCurrent);
+      GhostsCount++;
+    }
+  }
+
+  if (GhostsCount)
+    updateIndex();
+
+  return GhostsCount;
+}
+
+
 // =====================================================================
 // =====================================================================
 
@@ -135,10 +375,46 @@ SpatialUnit* UnitsCollection::addSpatialUnit(const SpatialUnit& aUnit)
 void UnitsCollection::sortByProcessOrder()
 {
   m_Data.sort(SortByProcessOrder());
+  updateIndex();
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void UnitsCollection::sortByProcessOrder(const std::vector<std::size_t>& Ranks)
+{
+  if (Ranks.size() != m_Units.size())
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Wrong number of units ranks");
+
+  // dense indices are updated only after sorting, they still give the ranks of units during sorting
+  m_Data.sort([&Ranks](const SpatialUnit& U1, const SpatialUnit& U2)
+  {
+    if (U1.getProcessOrder() != U2.getProcessOrder())
+      return (U1.getProcessOrder() < U2.getProcessOrder());
+
+    return (Ranks[U1.getIndex()] < Ranks[U2.getIndex()]);
+  });
+
+  updateIndex();
 }
 
 
+// =====================================================================
+// =====================================================================
+
 
+std::size_t UnitsCollection::gatherAttributeDoubles(const AttributeName_t& Name, std::vector<double>& Values,
+                                                    double Default) const
+{
+  std::vector<std::size_t> Slots(m_Units.size());
+
+  for (std::size_t i=0; i<m_Units.size(); i++)
+    Slots[i] = m_Units[i]->attributes()->getSlot();
+
+  return m_AttributesTable.gatherDoubles(Name,Slots,Values,Default);
+}
 
 
 } } // namespaces
@@ -40,8 +40,14 @@
 #define __OPENFLUID_CORE_UNITSCOLLECTION_HPP__
 
 
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
 #include <openfluid/dllexport.hpp>
 #include <openfluid/core/TypeDefs.hpp>
+#include <openfluid/core/AttributesTable.hpp>
 
 
 namespace openfluid { namespace core {
@@ -54,18 +60,112 @@ class /*DLLEXPORT*/ SpatialUnit;
 */
 typedef std::list<SpatialUnit> UnitsList_t;
 
+/**
+  Type definition for a contiguous array of pointers to units
+*/
+typedef std::vector<SpatialUnit*> UnitsPtrVector_t;
+
+
+/**
+  Orderings of units within their process order levels
+*/
+enum class UnitsOrdering
+{
+  DEFAULT,        // order of units creation
+  CUTHILL_MCKEE,  // reverse Cuthill-McKee ordering of the from-to connections graph
+  HILBERT_CURVE   // Hilbert space-filling curve ordering of the geometries centroids
+};
+
+
+/**
+  Read-only view on a contiguous sequence of pointers to units. It does not own the pointed data.
+*/
+class OPENFLUID_API UnitsSpan
+{
+  private:
+
+    SpatialUnit* const* m_Begin;
+
+    SpatialUnit* const* m_End;
+
+
+  public:
+
+    UnitsSpan() : m_Begin(nullptr), m_End(nullptr)
+    { }
+
+    UnitsSpan(SpatialUnit* const* Begin, SpatialUnit* const* End) : m_Begin(Begin), m_End(End)
+    { }
+
+    inline SpatialUnit* const* begin() const
+    { return m_Begin; };
+
+    inline SpatialUnit* const* end() const
+    { return m_End; };
+
+    inline std::size_t size() const
+    { return m_End-m_Begin; };
 
+    inline bool empty() const
+    { return m_Begin == m_End; };
+
+    inline SpatialUnit* operator[](std::size_t Index) const
+    { return m_Begin[Index]; };
+};
+
+
+/**
+  Collection of the spatial units of a units class.
+  Units objects are stored in a list so that pointers to units remain valid during the whole simulation.
+  In addition, units are indexed by dense indices following their process order, which give access
+  to the units and to their IDs and process orders as contiguous arrays.
+  These arrays are maintained by the collection, the units list must not be modified directly.
+
+  When the spatial graph is restricted to a partition, the collection also holds ghost units: copies of units
+  owned by other partitions and linked to units of the collection. Ghost units are found by their IDs
+  and keep their variables, but they are not part of the units list nor of the dense arrays, so that loops
+  on units do not process them. Their dense indices follow the indices of the units of the collection.
+*/
 class OPENFLUID_API UnitsCollection
 {
   private :
 
+    // declared before units list since units must be destroyed before the table storing their attributes
+    AttributesTable m_AttributesTable;
+
     UnitsList_t m_Data;
 
+    UnitsPtrVector_t m_Units;
+
+    std::vector<UnitID_t> m_IDs;
+
+    std::vector<PcsOrd_t> m_PcsOrders;
+
+    std::vector<std::size_t> m_LevelsOffsets;
+
+    std::unordered_map<UnitID_t,std::size_t> m_IndexByID;
+
+    UnitsList_t m_GhostsData;
+
+    UnitsPtrVector_t m_Ghosts;
+
+    std::unordered_map<UnitID_t,std::size_t> m_GhostIndexByID;
+
+    void appendToIndex(SpatialUnit* aUnit);
+
+    static void eraseFromData(UnitsList_t& Data, const SpatialUnit* aUnit);
+
+    void updateIndex();
+
 
   public :
 
     UnitsCollection();
 
+    UnitsCollection(const UnitsCollection& Coll);
+
+    UnitsCollection& operator=(const UnitsCollection& Coll);
+
     ~UnitsCollection();
 
     SpatialUnit* spatialUnit(UnitID_t aUnitID);
@@ -74,13 +174,123 @@ class OPENFLUID_API UnitsCollection
 
     SpatialUnit* addSpatialUnit(const SpatialUnit& aUnit);
 
+    /**
+      Removes a unit from the collection, without removing its connections to other units.
+      Dense arrays are updated in place, shifting the indices of the units following the removed one.
+      Use removeSpatialUnits() to remove many units at once.
+      @param[in] aUnitID the ID of the unit to remove
+      @return true if the unit has been removed, false if it does not exist
+    */
+    bool removeSpatialUnit(UnitID_t aUnitID);
+
+    /**
+      Removes the units matching a predicate, without removing their connections to other units.
+      Dense arrays are updated once for all removed units.
+      @param[in] Predicate the predicate returning true for units to remove
+      @return the number of removed units
+    */
+    std::size_t removeSpatialUnits(const std::function<bool(const SpatialUnit&)>& Predicate);
+
+    /**
+      Turns the units matching a predicate into ghost units, keeping their connections, variables and attributes.
+      Dense arrays are updated once for all ghost units.
+      @param[in] Predicate the predicate returning true for units to turn into ghost units
+      @return the number of new ghost units
+    */
+    std::size_t setGhostSpatialUnits(const std::function<bool(const SpatialUnit&)>& Predicate);
+
+    /**
+      Returns the ghost units of the collection, indexed by their dense indices minus the number of units
+    */
+    inline const UnitsPtrVector_t* ghosts() const
+    { return &m_Ghosts; };
+
+    /**
+      Returns true if the given ID is the ID of a ghost unit of the collection
+    */
+    inline bool isGhostSpatialUnit(UnitID_t aUnitID) const
+    { return (m_GhostIndexByID.find(aUnitID) != m_GhostIndexByID.end()); };
+
     void sortByProcessOrder();
 
+    /**
+      Sorts units by process order, then by rank within a same process order
+      @param[in] Ranks the ranks of units, indexed by the units dense indices before sorting
+      @throw openfluid::base::FrameworkException if the number of ranks is not the number of units
+    */
+    void sortByProcessOrder(const std::vector<std::size_t>& Ranks);
+
+    /**
+      Returns the dense array of units, ordered by process order
+    */
+    inline const UnitsPtrVector_t* units() const
+    { return &m_Units; };
+
+    /**
+      Returns the IDs of units, indexed by the units dense indices
+    */
+    inline const std::vector<UnitID_t>* unitsIDs() const
+    { return &m_IDs; };
+
+    /**
+      Returns the process orders of units, indexed by the units dense indices
+    */
+    inline const std::vector<PcsOrd_t>* processOrders() const
+    { return &m_PcsOrders; };
+
+    /**
+      Returns the offsets of the process order levels in the dense arrays.
+      Units of the level l have dense indices from offset l to offset l+1 (excluded),
+      the last offset being the number of units.
+    */
+    inline const std::vector<std::size_t>* levelsOffsets() const
+    { return &m_LevelsOffsets; };
+
+    /**
+      Returns the number of process order levels
+    */
+    inline std::size_t getLevelsCount() const
+    { return m_LevelsOffsets.size()-1; };
+
+    /**
+      Returns the unit at the given dense index
+    */
+    inline SpatialUnit* unitAt(std::size_t Index) const
+    { return m_Units[Index]; };
+
+    inline std::size_t size() const
+    { return m_Units.size(); };
+
+    /**
+      Returns a read-only view on the dense array of units, ordered by process order.
+      The view remains valid as long as no unit is added to or removed from the collection
+    */
+    inline UnitsSpan span() const
+    { return UnitsSpan(m_Units.data(),m_Units.data()+m_Units.size()); };
+
+    /**
+      Returns the units list, in read-only access since the dense arrays are built from it.
+      Units are modified through units() or spatialUnit()
+    */
     inline const UnitsList_t* list() const
     { return &m_Data; };
 
-    inline UnitsList_t* list()
-    { return &m_Data; };
+    /**
+      Returns the table storing the attributes of all units of the collection
+    */
+    inline const AttributesTable* attributesTable() const
+    { return &m_AttributesTable; };
+
+    /**
+      Gathers the numeric values of an attribute of all units into a contiguous array indexed by the units
+      dense indices, for vectorizable scans. Integer values are converted to doubles.
+      @param[in] Name the name of the attribute
+      @param[out] Values the values of the attribute
+      @param[in] Default the value given to units without a numeric value for the attribute
+      @return the number of units having a numeric value for the attribute
+    */
+    std::size_t gatherAttributeDoubles(const AttributeName_t& Name, std::vector<double>& Values,
+                                       double Default = 0.0) const;
 
 };
 
@@ -0,0 +1,279 @@
+/*
+
+  This file is part of OpenFLUID software
+  Copyright(c) 2007, INRA - Montpellier SupAgro
+
+
+ == GNU General Public License Usage ==
+
+  OpenFLUID is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OpenFLUID is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OpenFLUID. If not, see <http://www.gnu.org/licenses/>.
+
+
+ == Other Usage ==
+
+  Other Usage means a use of OpenFLUID that is inconsistent with the GPL
+  license, and requires a written agreement between You and INRA.
+  Licensees for Other Usage of OpenFLUID may use this file in accordance
+  with the terms contained in the written agreement between You and INRA.
+  
+*/
+
+
+/**
+  @file UnitsGrid.cpp
+
+  @author Jean-Christophe FABRE <jean-christophe.fabre@supagro.inra.fr>
+ */
+
+
+
+#include <cmath>
+
+#include <openfluid/core/UnitsGrid.hpp>
+#include <openfluid/base/FrameworkException.hpp>
+
+
+namespace openfluid { namespace core {
+
+
+namespace {
+
+// columns and rows shifts of neighbours, in the order of D8 directions (E, SE, S, SW, W, NW, N, NE)
+const int NeighboursColShift[UnitsGrid::MaxNeighboursCount] = {1,1,0,-1,-1,-1,0,1};
+const int NeighboursRowShift[UnitsGrid::MaxNeighboursCount] = {0,1,1,1,0,-1,-1,-1};
+
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+UnitsGrid::UnitsGrid() :
+  m_ColsNbr(0), m_RowsNbr(0)
+{
+
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+UnitsGrid::UnitsGrid(unsigned long ColsNbr, unsigned long RowsNbr) :
+  m_ColsNbr(ColsNbr), m_RowsNbr(RowsNbr)
+{
+
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+unsigned int UnitsGrid::getNeighbours(std::size_t Index, GridNeighbourhood Neighbourhood,
+                                      std::size_t* Neighbours) const
+{
+  const long Col = getColIndex(Index);
+  const long Row = getRowIndex(Index);
+  const unsigned int Step = (Neighbourhood == GridNeighbourhood::FOUR ? 2 : 1);
+  unsigned int Count = 0;
+
+  for (unsigned int i = 0; i < MaxNeighboursCount; i += Step)
+  {
+    const long NCol = Col+NeighboursColShift[i];
+    const long NRow = Row+NeighboursRowShift[i];
+
+    if (isInside(NCol,NRow))
+      Neighbours[Count++] = getIndex(NCol,NRow);
+  }
+
+  return Count;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+bool UnitsGrid::getNeighbour(std::size_t Index, int Direction, std::size_t& NeighbourIndex) const
+{
+  for (unsigned int i = 0; i < MaxNeighboursCount; i++)
+  {
+    if (getD8Direction(i) == Direction)
+    {
+      const long NCol = static_cast<long>(getColIndex(Index))+NeighboursColShift[i];
+      const long NRow = static_cast<long>(getRowIndex(Index))+NeighboursRowShift[i];
+
+      if (!isInside(NCol,NRow))
+        return false;
+
+      NeighbourIndex = getIndex(NCol,NRow);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void UnitsGrid::getNeighboursOffsets(long* Offsets) const
+{
+  for (unsigned int i = 0; i < MaxNeighboursCount; i++)
+    Offsets[i] = NeighboursColShift[i]*static_cast<long>(m_RowsNbr)+NeighboursRowShift[i];
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+int UnitsGrid::getD8Direction(unsigned int Position)
+{
+  if (Position >= MaxNeighboursCount)
+    return D8_NONE;
+
+  return (1 << Position);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void UnitsGrid::computeD8Directions(const Layer_t& Elevation, DirectionsLayer_t& Directions) const
+{
+  if (Elevation.getColsNbr() != m_ColsNbr || Elevation.getRowsNbr() != m_RowsNbr)
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                              "Elevation layer does not match the grid dimensions");
+
+  if (Directions.getColsNbr() != m_ColsNbr || Directions.getRowsNbr() != m_RowsNbr)
+    Directions = DirectionsLayer_t(m_ColsNbr,m_RowsNbr,D8_NONE);
+
+  const double* Z = Elevation.data();
+  int* Dirs = Directions.data();
+  const double Distances[2] = {1.0,std::sqrt(2.0)};
+
+  forEachCell([&](unsigned long Col, unsigned long Row, std::size_t Index)
+  {
+    double MaxSlope = 0.0;
+    int Dir = D8_NONE;
+
+    for (unsigned int i = 0; i < MaxNeighboursCount; i++)
+    {
+      const long NCol = static_cast<long>(Col)+NeighboursColShift[i];
+      const long NRow = static_cast<long>(Row)+NeighboursRowShift[i];
+
+      if (isInside(NCol,NRow))
+      {
+        const double Slope = (Z[Index]-Z[getIndex(NCol,NRow)])/Distances[i%2];
+
+        if (Slope > MaxSlope)
+        {
+          MaxSlope = Slope;
+          Dir = getD8Direction(i);
+        }
+      }
+    }
+
+    Dirs[Index] = Dir;
+  });
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+UnitsGrid::Layer_t* UnitsGrid::addLayer(const std::string& Name, double InitValue)
+{
+  Layer_t& Layer = m_Layers[Name];
+  Layer = Layer_t(m_ColsNbr,m_RowsNbr,InitValue);
+
+  return &Layer;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+UnitsGrid::Layer_t* UnitsGrid::layer(const std::string& Name)
+{
+  auto it = m_Layers.find(Name);
+
+  if (it != m_Layers.end())
+    return &(it->second);
+
+  return nullptr;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+const UnitsGrid::Layer_t* UnitsGrid::layer(const std::string& Name) const
+{
+  auto it = m_Layers.find(Name);
+
+  if (it != m_Layers.end())
+    return &(it->second);
+
+  return nullptr;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+bool UnitsGrid::removeLayer(const std::string& Name)
+{
+  return (m_Layers.erase(Name) > 0);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+std::vector<std::string> UnitsGrid::getLayersNames() const
+{
+  std::vector<std::string> Names;
+
+  for (auto& Layer : m_Layers)
+    Names.push_back(Layer.first);
+
+  return Names;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void UnitsGrid::clear()
+{
+  m_Layers.clear();
+  m_ColsNbr = 0;
+  m_RowsNbr = 0;
+}
+
+
+} } // namespaces
@@ -0,0 +1,287 @@
+/*
+
+  This file is part of OpenFLUID software
+  Copyright(c) 2007, INRA - Montpellier SupAgro
+
+
+ == GNU General Public License Usage ==
+
+  OpenFLUID is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OpenFLUID is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OpenFLUID. If not, see <http://www.gnu.org/licenses/>.
+
+
+ == Other Usage ==
+
+  Other Usage means a use of OpenFLUID that is inconsistent with the GPL
+  license, and requires a written agreement between You and INRA.
+  Licensees for Other Usage of OpenFLUID may use this file in accordance
+  with the terms contained in the written agreement between You and INRA.
+  
+*/
+
+
+/**
+  @file UnitsGrid.hpp
+
+  @author Jean-Christophe FABRE <jean-christophe.fabre@supagro.inra.fr>
+ */
+
+
+
+#ifndef __OPENFLUID_CORE_UNITSGRID_HPP__
+#define __OPENFLUID_CORE_UNITSGRID_HPP__
+
+
+#include <map>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <openfluid/dllexport.hpp>
+#include <openfluid/core/TypeDefs.hpp>
+#include <openfluid/core/Matrix.hpp>
+
+
+namespace openfluid { namespace core {
+
+
+/**
+  Types of neighbourhood of a grid cell
+*/
+enum class GridNeighbourhood { FOUR = 4, EIGHT = 8 };
+
+
+/**
+  Regular grid of units, stored implicitly by its dimensions.
+  Cells are not instanciated as spatial units and are not connected by explicit links:
+  neighbourhoods (4 or 8 connected) and D8 flow directions are computed from cells positions.
+  Data on cells are stored in named dense layers, as matrices sharing the layout of the grid
+  (cells of a column are contiguous in memory), which allows tiled and vectorized stencil loops.
+
+  Cells are identified by their column and row indexes, or by their dense index
+  (see openfluid::core::UnitsGrid::getIndex()).
+  The cell ID returned by openfluid::core::UnitsGrid::getCellID() is the same as the one of the unit
+  that would have been created at the same position by OPENFLUID_BuildUnitsMatrix().
+  Rows are numbered from north to south, columns from west to east.
+
+  <I>Example : </I>
+  @code
+  openfluid::core::UnitsGrid* Grid = OPENFLUID_GetUnitsGrid("MU");
+  const openfluid::core::UnitsGrid::Layer_t* Height = Grid->layer("height");
+  openfluid::core::UnitsGrid::Layer_t* Outflow = Grid->layer("outflow");
+
+  Grid->forEachTile(64,64,
+                    [&](unsigned long ColBegin, unsigned long ColEnd, unsigned long RowBegin, unsigned long RowEnd)
+  {
+    for (unsigned long Col = ColBegin; Col < ColEnd; Col++)
+    {
+      const double* In = Height->data()+Grid->getIndex(Col,0);
+      double* Out = Outflow->data()+Grid->getIndex(Col,0);
+
+      for (unsigned long Row = RowBegin; Row < RowEnd; Row++)
+        Out[Row] = In[Row]*0.5;
+    }
+  });
+  @endcode
+*/
+class OPENFLUID_API UnitsGrid
+{
+  public:
+
+    typedef Matrix<double> Layer_t;
+
+    typedef Matrix<int> DirectionsLayer_t;
+
+    /**
+      D8 flow directions codes, with 0 for cells without downslope neighbour
+    */
+    enum D8Direction { D8_NONE = 0, D8_E = 1, D8_SE = 2, D8_S = 4, D8_SW = 8,
+                       D8_W = 16, D8_NW = 32, D8_N = 64, D8_NE = 128 };
+
+    /**
+      Maximum number of neighbours of a cell
+    */
+    static const unsigned int MaxNeighboursCount = 8;
+
+
+  private:
+
+    unsigned long m_ColsNbr;
+
+    unsigned long m_RowsNbr;
+
+    std::map<std::string,Layer_t> m_Layers;
+
+
+  public:
+
+    UnitsGrid();
+
+    UnitsGrid(unsigned long ColsNbr, unsigned long RowsNbr);
+
+    inline unsigned long getColsNbr() const
+    { return m_ColsNbr; };
+
+    inline unsigned long getRowsNbr() const
+    { return m_RowsNbr; };
+
+    inline std::size_t getCellsCount() const
+    { return static_cast<std::size_t>(m_ColsNbr)*m_RowsNbr; };
+
+    inline bool isInside(long ColIndex, long RowIndex) const
+    {
+      return (ColIndex >= 0 && RowIndex >= 0 &&
+              static_cast<unsigned long>(ColIndex) < m_ColsNbr && static_cast<unsigned long>(RowIndex) < m_RowsNbr);
+    };
+
+    /**
+      Returns the dense index of a cell, which is also its position in layers data
+    */
+    inline std::size_t getIndex(unsigned long ColIndex, unsigned long RowIndex) const
+    { return static_cast<std::size_t>(ColIndex)*m_RowsNbr+RowIndex; };
+
+    inline unsigned long getColIndex(std::size_t Index) const
+    { return static_cast<unsigned long>(Index/m_RowsNbr); };
+
+    inline unsigned long getRowIndex(std::size_t Index) const
+    { return static_cast<unsigned long>(Index%m_RowsNbr); };
+
+    /**
+      Returns the ID of a cell, numbered row by row starting at 1
+    */
+    inline UnitID_t getCellID(unsigned long ColIndex, unsigned long RowIndex) const
+    { return static_cast<UnitID_t>(1+m_ColsNbr*RowIndex+ColIndex); };
+
+    /**
+      Gets the neighbours of a cell
+      @param[in] Index the dense index of the cell
+      @param[in] Neighbourhood the type of neighbourhood
+      @param[out] Neighbours the dense indexes of the neighbours, the array must hold at least
+      openfluid::core::UnitsGrid::MaxNeighboursCount elements
+      @return the number of neighbours
+    */
+    unsigned int getNeighbours(std::size_t Index, GridNeighbourhood Neighbourhood, std::size_t* Neighbours) const;
+
+    /**
+      Gets the neighbour of a cell in a given D8 direction
+      @param[in] Index the dense index of the cell
+      @param[in] Direction the D8 direction code
+      @param[out] NeighbourIndex the dense index of the neighbour
+      @return false if there is no neighbour in this direction
+    */
+    bool getNeighbour(std::size_t Index, int Direction, std::size_t& NeighbourIndex) const;
+
+    /**
+      Computes the D8 flow direction of every cell, as the direction of the steepest downslope neighbour
+      @param[in] Elevation the elevation layer
+      @param[out] Directions the resulting D8 directions codes
+    */
+    void computeD8Directions(const Layer_t& Elevation, DirectionsLayer_t& Directions) const;
+
+    /**
+      Adds a layer to the grid, initialized with the given value.
+      If the layer already exists, it is reinitialized.
+      @return the added layer
+    */
+    Layer_t* addLayer(const std::string& Name, double InitValue = 0.0);
+
+    Layer_t* layer(const std::string& Name);
+
+    const Layer_t* layer(const std::string& Name) const;
+
+    inline bool isLayerExist(const std::string& Name) const
+    { return (m_Layers.find(Name) != m_Layers.end()); };
+
+    bool removeLayer(const std::string& Name);
+
+    std::vector<std::string> getLayersNames() const;
+
+    /**
+      Calls the given function for every tile of the grid.
+      The function is called with the bounds of the tile as arguments (ColBegin,ColEnd,RowBegin,RowEnd),
+      end bounds being excluded.
+      Tiles are independent and can be processed concurrently.
+      @param[in] TileColsNbr the number of columns of a tile
+      @param[in] TileRowsNbr the number of rows of a tile
+      @param[in] Func the function to call
+    */
+    template<typename Function>
+    void forEachTile(unsigned long TileColsNbr, unsigned long TileRowsNbr, Function Func) const
+    {
+      TileColsNbr = std::max(TileColsNbr,1UL);
+      TileRowsNbr = std::max(TileRowsNbr,1UL);
+
+      for (unsigned long ColBegin = 0; ColBegin < m_ColsNbr; ColBegin += TileColsNbr)
+      {
+        const unsigned long ColEnd = std::min(ColBegin+TileColsNbr,m_ColsNbr);
+
+        for (unsigned long RowBegin = 0; RowBegin < m_RowsNbr; RowBegin += TileRowsNbr)
+          Func(ColBegin,ColEnd,RowBegin,std::min(RowBegin+TileRowsNbr,m_RowsNbr));
+      }
+    }
+
+    /**
+      Calls the given function for every cell of the grid, with the column index, the row index
+      and the dense index of the cell as arguments. Cells are visited in memory order.
+    */
+    template<typename Function>
+    void forEachCell(Function Func) const
+    {
+      std::size_t Index = 0;
+
+      for (unsigned long Col = 0; Col < m_ColsNbr; Col++)
+      {
+        for (unsigned long Row = 0; Row < m_RowsNbr; Row++)
+          Func(Col,Row,Index++);
+      }
+    }
+
+    /**
+      Calls the given function for every interior cell of the grid (cells having all their 8 neighbours),
+      with the column index, the row index and the dense index of the cell as arguments.
+      Neighbours of an interior cell can be accessed without bounds checking,
+      using the offsets given by openfluid::core::UnitsGrid::getNeighboursOffsets().
+    */
+    template<typename Function>
+    void forEachInteriorCell(Function Func) const
+    {
+      for (unsigned long Col = 1; Col+1 < m_ColsNbr; Col++)
+      {
+        std::size_t Index = getIndex(Col,1);
+
+        for (unsigned long Row = 1; Row+1 < m_RowsNbr; Row++)
+          Func(Col,Row,Index++);
+      }
+    }
+
+    /**
+      Gets the offsets of dense indexes from an interior cell to its neighbours,
+      in the order of D8 directions (E, SE, S, SW, W, NW, N, NE)
+      @param[out] Offsets the offsets, the array must hold openfluid::core::UnitsGrid::MaxNeighboursCount elements
+    */
+    void getNeighboursOffsets(long* Offsets) const;
+
+    /**
+      Returns the D8 direction code for the neighbour at the given position in D8 order
+    */
+    static int getD8Direction(unsigned int Position);
+
+    void clear();
+
+};
+
+
+} } // namespaces
+
+
+#endif /* __OPENFLUID_CORE_UNITSGRID_HPP__ */
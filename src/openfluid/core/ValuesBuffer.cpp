@@ -59,6 +59,30 @@ class ValuesBuffer::PrivateImpl
 
     DataContainer_t m_Data;
 
+    /**
+      Returns true if the value of the given indexed value can be overwritten by the given value
+      instead of being destroyed and replaced by a copy
+    */
+    static bool isRecyclable(const IndexedValue& IndValue, const Value& aValue)
+    {
+      if (IndValue.m_Value.use_count() != 1 || IndValue.m_Value->getType() != aValue.getType())
+        return false;
+
+      // only types implementing value assignment
+      switch (aValue.getType())
+      {
+        case Value::BOOLEAN:
+        case Value::INTEGER:
+        case Value::DOUBLE:
+        case Value::STRING:
+        case Value::VECTOR:
+        case Value::MATRIX:
+          return true;
+        default:
+          return false;
+      }
+    }
+
     DataContainer_t::iterator findAtIndex(const TimeIndex_t& anIndex)
     {
       if (m_Data.empty())
@@ -355,7 +379,20 @@ bool ValuesBuffer::appendValue(const TimeIndex_t& anIndex, const openfluid::core
   if (!m_PImpl->m_Data.empty() && anIndex <= m_PImpl->m_Data.back().m_Index)
     return false;
 
-  m_PImpl->m_Data.push_back(IndexedValue(anIndex,aValue));
+  if (!m_PImpl->m_Data.empty() && m_PImpl->m_Data.full() &&
+      m_PImpl->isRecyclable(m_PImpl->m_Data.front(),aValue))
+  {
+    // the oldest value is evicted: its value object and buffers are reused for the appended value,
+    // avoiding memory allocations once the buffer is full for values of fixed type and shape
+    if (m_PImpl->m_Data.size() > 1)
+      m_PImpl->m_Data.rotate(m_PImpl->m_Data.begin()+1);
+
+    IndexedValue& Recycled = m_PImpl->m_Data.back();
+    Recycled.m_Index = anIndex;
+    *(Recycled.m_Value) = aValue;
+  }
+  else
+    m_PImpl->m_Data.push_back(IndexedValue(anIndex,aValue));
 
   return true;
 }
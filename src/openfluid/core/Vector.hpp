@@ -44,13 +44,16 @@
 #include <iostream>
 #include <openfluid/dllexport.hpp>
 #include <openfluid/base/FrameworkException.hpp>
+#include <openfluid/core/ArrayKernels.hpp>
 
 
 namespace openfluid { namespace core {
 
 
 /**
-  Template class for vector data
+  Template class for vector data.
+  Elements are stored in an array aligned for SIMD instructions.
+  Arithmetic operations and reductions use vectorized kernels for double precision values.
 */
 template <class T>
 class OPENFLUID_API Vector
@@ -164,7 +167,7 @@ class OPENFLUID_API Vector
     T& operator[](unsigned long Index);
 
     /**
-      Allocation operator
+      Allocation operator. The current array is reused without reallocation if it has the same size
     */
     Vector<T>& operator=(const Vector &A);
 
@@ -179,6 +182,65 @@ class OPENFLUID_API Vector
     */
     void clear();
 
+    /**
+      Adds the elements of the given vector to the elements of this vector
+      @throw openfluid::base::FrameworkException if the sizes of the vectors are different
+    */
+    void add(const Vector& Other);
+
+    /**
+      Subtracts the elements of the given vector from the elements of this vector
+      @throw openfluid::base::FrameworkException if the sizes of the vectors are different
+    */
+    void subtract(const Vector& Other);
+
+    /**
+      Multiplies the elements of this vector by the elements of the given vector
+      @throw openfluid::base::FrameworkException if the sizes of the vectors are different
+    */
+    void multiply(const Vector& Other);
+
+    /**
+      Divides the elements of this vector by the elements of the given vector
+      @throw openfluid::base::FrameworkException if the sizes of the vectors are different
+    */
+    void divide(const Vector& Other);
+
+    /**
+      Multiplies all elements of the vector by the given factor
+    */
+    void scale(const T& Factor);
+
+    /**
+      Adds the elements of the given vector multiplied by the given factor to the elements of this vector
+      (this = this + Factor * X)
+      @throw openfluid::base::FrameworkException if the sizes of the vectors are different
+    */
+    void axpy(const T& Factor, const Vector& X);
+
+    /**
+      Returns the dot product of this vector and the given vector
+      @throw openfluid::base::FrameworkException if the sizes of the vectors are different
+    */
+    T dot(const Vector& Other) const;
+
+    /**
+      Returns the sum of the elements of the vector, or 0 if the vector is empty
+    */
+    T sum() const;
+
+    /**
+      Returns the minimum element of the vector
+      @throw openfluid::base::FrameworkException if the vector is empty
+    */
+    T min() const;
+
+    /**
+      Returns the maximum element of the vector
+      @throw openfluid::base::FrameworkException if the vector is empty
+    */
+    T max() const;
+
     /**
       Returns an iterator referring to the first element in the vector
       @return an iterator to the first element in the vector
@@ -310,7 +372,7 @@ bool Vector<T>::allocate(unsigned long Size)
 
   if (Size > 0)
   {
-    m_Data = new T[Size];
+    m_Data = kernels::allocateAlignedArray<T>(Size);
     if (m_Data != nullptr)
       m_Size = Size;
     else
@@ -388,9 +450,15 @@ Vector<T>& Vector<T>::operator=(const Vector &A)
   if (this == &A) // in case somebody tries assign array to itself
     return *this;
 
-  clear();
+  // the current array is reused if it has the same size
+  if (m_Size != A.m_Size)
+  {
+    clear();
+
+    if (!allocate(A.m_Size))
+      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Cannot allocate memory");
+  }
 
-  allocate(A.m_Size);
   std::copy(A.m_Data, A.m_Data + A.m_Size, m_Data);
 
   return *this;
@@ -427,7 +495,7 @@ void Vector<T>::fill(const T& Val)
 template <class T>
 void Vector<T>::clear()
 {
-  delete [] m_Data;
+  kernels::releaseAlignedArray(m_Data,m_Size);
   init();
 }
 
@@ -448,6 +516,140 @@ void Vector<T>::copy(const Vector& Source, Vector& Dest)
 }
 
 
+// =====================================================================
+// =====================================================================
+
+
+template <class T>
+void Vector<T>::add(const Vector& Other)
+{
+  if (Other.m_Size != m_Size)
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"vectors sizes mismatch");
+
+  kernels::add(m_Data,Other.m_Data,m_Data,m_Size);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+template <class T>
+void Vector<T>::subtract(const Vector& Other)
+{
+  if (Other.m_Size != m_Size)
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"vectors sizes mismatch");
+
+  kernels::subtract(m_Data,Other.m_Data,m_Data,m_Size);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+template <class T>
+void Vector<T>::multiply(const Vector& Other)
+{
+  if (Other.m_Size != m_Size)
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"vectors sizes mismatch");
+
+  kernels::multiply(m_Data,Other.m_Data,m_Data,m_Size);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+template <class T>
+void Vector<T>::divide(const Vector& Other)
+{
+  if (Other.m_Size != m_Size)
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"vectors sizes mismatch");
+
+  kernels::divide(m_Data,Other.m_Data,m_Data,m_Size);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+template <class T>
+void Vector<T>::scale(const T& Factor)
+{
+  kernels::scale(Factor,m_Data,m_Size);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+template <class T>
+void Vector<T>::axpy(const T& Factor, const Vector& X)
+{
+  if (X.m_Size != m_Size)
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"vectors sizes mismatch");
+
+  kernels::axpy(Factor,X.m_Data,m_Data,m_Size);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+template <class T>
+T Vector<T>::dot(const Vector& Other) const
+{
+  if (Other.m_Size != m_Size)
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"vectors sizes mismatch");
+
+  return kernels::dot(m_Data,Other.m_Data,m_Size);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+template <class T>
+T Vector<T>::sum() const
+{
+  return kernels::sum(m_Data,m_Size);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+template <class T>
+T Vector<T>::min() const
+{
+  if (m_Size == 0)
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"empty vector");
+
+  return kernels::min(m_Data,m_Size);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+template <class T>
+T Vector<T>::max() const
+{
+  if (m_Size == 0)
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"empty vector");
+
+  return kernels::max(m_Data,m_Size);
+}
+
+
 } }  // namespaces
 
 
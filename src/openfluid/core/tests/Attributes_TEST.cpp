@@ -327,3 +327,137 @@ BOOST_AUTO_TEST_CASE(check_operations_from_rawstring)
   BOOST_REQUIRE_EQUAL(Attrs.value("map0")->asMapValue().size(),0);
 }
 
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_shared_table)
+{
+  openfluid::core::AttributesTable Table;
+
+  {
+    openfluid::core::Attributes Attrs1, Attrs2, Attrs3;
+
+    BOOST_REQUIRE(Attrs1.setValue("area",openfluid::core::DoubleValue(10.5)));
+    BOOST_REQUIRE(Attrs1.setValue("code",openfluid::core::StringValue("A1")));
+    BOOST_REQUIRE(Attrs2.setValueFromRawString("area","20.5"));
+    BOOST_REQUIRE(Attrs2.setValueFromRawString("code","B2"));
+    BOOST_REQUIRE(Attrs3.setValueFromRawString("area","30"));
+
+    Attrs1.attachToTable(&Table);
+    Attrs2.attachToTable(&Table);
+
+    BOOST_REQUIRE_EQUAL(Table.getSlotsCount(),2);
+    BOOST_REQUIRE_EQUAL(Table.getAttributesNames().size(),2);
+    BOOST_REQUIRE_EQUAL(Table.getAttributeType("area"),openfluid::core::Value::DOUBLE);
+    BOOST_REQUIRE_EQUAL(Table.getAttributeType("code"),openfluid::core::Value::STRING);
+
+    BOOST_REQUIRE_CLOSE(Attrs1.value("area")->asDoubleValue().get(),10.5,0.00001);
+    BOOST_REQUIRE_CLOSE(Attrs2.value("area")->asDoubleValue().get(),20.5,0.00001);
+    BOOST_REQUIRE_EQUAL(Attrs2.value("code")->asStringValue().get(),"B2");
+
+    // values pointers are not invalidated by new units
+    const openfluid::core::Value* AreaPtr = Attrs1.value("area");
+
+    // integer value in a double column: the value keeps its integer type
+    Attrs3.attachToTable(&Table);
+    BOOST_REQUIRE_EQUAL(Table.getAttributeType("area"),openfluid::core::Value::NONE);
+    BOOST_REQUIRE(Attrs3.value("area")->isIntegerValue());
+    BOOST_REQUIRE_EQUAL(Attrs3.value("area")->asIntegerValue().get(),30);
+    BOOST_REQUIRE_EQUAL(AreaPtr,Attrs1.value("area"));
+    BOOST_REQUIRE(AreaPtr->isDoubleValue());
+    BOOST_REQUIRE_CLOSE(AreaPtr->asDoubleValue().get(),10.5,0.00001);
+    BOOST_REQUIRE(!Attrs3.isAttributeExist("code"));
+    BOOST_REQUIRE_EQUAL(Attrs3.getAttributesNames().size(),1);
+
+    const openfluid::core::Value* CodePtr = Attrs1.value("code");
+    BOOST_REQUIRE(Attrs2.replaceValue("code",std::string("C3")));
+    BOOST_REQUIRE_EQUAL(Attrs2.value("code")->asStringValue().get(),"C3");
+    BOOST_REQUIRE_EQUAL(CodePtr,Attrs1.value("code"));
+    BOOST_REQUIRE_CLOSE(AreaPtr->asDoubleValue().get(),10.5,0.00001);
+
+    // copies are independent from the table
+    openfluid::core::Attributes Attrs4(Attrs1);
+    BOOST_REQUIRE(Attrs4.removeAttribute("code"));
+    BOOST_REQUIRE(Attrs1.isAttributeExist("code"));
+    BOOST_REQUIRE_EQUAL(Table.getSlotsCount(),3);
+
+    BOOST_REQUIRE(Attrs1.removeAttribute("code"));
+    BOOST_REQUIRE(!Attrs1.removeAttribute("code"));
+    BOOST_REQUIRE(Attrs2.isAttributeExist("code"));
+
+    Attrs2.clear();
+    BOOST_REQUIRE_EQUAL(Table.getAttributesNames().size(),1);
+  }
+
+  // released slots are reused
+  BOOST_REQUIRE_EQUAL(Table.getSlotsCount(),0);
+  BOOST_REQUIRE_EQUAL(Table.getAttributesNames().size(),0);
+
+  openfluid::core::Attributes Attrs5;
+  Attrs5.attachToTable(&Table);
+  BOOST_REQUIRE(Attrs5.setValue("count",openfluid::core::IntegerValue(5)));
+  BOOST_REQUIRE_EQUAL(Table.getAttributeType("count"),openfluid::core::Value::INTEGER);
+  BOOST_REQUIRE_EQUAL(Table.getSlotsCount(),1);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_table_columns)
+{
+  openfluid::core::AttributesTable Table;
+  std::vector<std::size_t> Slots;
+
+  for (unsigned int i=0; i<4; i++)
+    Slots.push_back(Table.acquireSlot());
+
+  // integer and double values in the same column keep their own types, previous pointers remain valid
+  Table.setValue(Slots[0],"count",openfluid::core::IntegerValue(3));
+  Table.setValue(Slots[1],"count",openfluid::core::IntegerValue(4));
+  const openfluid::core::Value* CountPtr = Table.value(Slots[0],"count");
+  BOOST_REQUIRE_EQUAL(Table.getAttributeType("count"),openfluid::core::Value::INTEGER);
+
+  Table.setValue(Slots[2],"count",openfluid::core::DoubleValue(5.5));
+  BOOST_REQUIRE_EQUAL(Table.getAttributeType("count"),openfluid::core::Value::NONE);
+  BOOST_REQUIRE(Table.value(Slots[0],"count")->isIntegerValue());
+  BOOST_REQUIRE_EQUAL(Table.value(Slots[0],"count")->asIntegerValue().get(),3);
+  BOOST_REQUIRE(Table.value(Slots[2],"count")->isDoubleValue());
+  BOOST_REQUIRE_CLOSE(Table.value(Slots[2],"count")->asDoubleValue().get(),5.5,0.00001);
+  BOOST_REQUIRE_EQUAL(CountPtr,Table.value(Slots[0],"count"));
+
+  // large integers are not converted to doubles
+  Table.setValue(Slots[0],"big",openfluid::core::DoubleValue(1.5));
+  Table.setValue(Slots[1],"big",openfluid::core::IntegerValue(9007199254740993L));
+  BOOST_REQUIRE(Table.value(Slots[1],"big")->isIntegerValue());
+  BOOST_REQUIRE_EQUAL(Table.value(Slots[1],"big")->asIntegerValue().get(),9007199254740993L);
+
+  // value not matching the column storage
+  const openfluid::core::Value* Count1Ptr = Table.value(Slots[1],"count");
+  Table.setValue(Slots[3],"count",openfluid::core::StringValue("none"));
+  BOOST_REQUIRE_EQUAL(Table.getAttributeType("count"),openfluid::core::Value::NONE);
+  BOOST_REQUIRE_EQUAL(Table.value(Slots[3],"count")->asStringValue().get(),"none");
+  BOOST_REQUIRE_EQUAL(Count1Ptr,Table.value(Slots[1],"count"));
+  BOOST_REQUIRE_EQUAL(Count1Ptr->asIntegerValue().get(),4);
+
+  // removed values do not release the storage of other values
+  BOOST_REQUIRE(Table.removeValue(Slots[3],"count"));
+  BOOST_REQUIRE(!Table.removeValue(Slots[3],"count"));
+  BOOST_REQUIRE_EQUAL(Count1Ptr,Table.value(Slots[1],"count"));
+
+  // column scan
+  std::vector<double> Values;
+  BOOST_REQUIRE_EQUAL(Table.gatherDoubles("count",Slots,Values,-1.0),3);
+  BOOST_REQUIRE_EQUAL(Values.size(),4);
+  BOOST_REQUIRE_CLOSE(Values[0],3.0,0.00001);
+  BOOST_REQUIRE_CLOSE(Values[1],4.0,0.00001);
+  BOOST_REQUIRE_CLOSE(Values[2],5.5,0.00001);
+  BOOST_REQUIRE_CLOSE(Values[3],-1.0,0.00001);
+
+  BOOST_REQUIRE_EQUAL(Table.gatherDoubles("unknown",Slots,Values),0);
+  BOOST_REQUIRE_EQUAL(Values.size(),4);
+}
@@ -133,5 +133,148 @@ BOOST_AUTO_TEST_CASE(check_operations)
   BOOST_REQUIRE_EQUAL(EvColl3.getCount(),0);
 }
 
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_ranges)
+{
+  openfluid::core::EventsCollection EvColl;
+  const openfluid::core::DateTime RefDate(2000,1,1,0,0,0);
+
+  BOOST_REQUIRE(EvColl.eventsBetween(RefDate,RefDate+openfluid::core::DateTime::Days(1)).empty());
+
+  for (int i=0; i<48; i++)
+  {
+    openfluid::core::Event Ev(RefDate+openfluid::core::DateTime::Hours(i));
+    Ev.addInfo("index",std::to_string(i));
+    EvColl.addEvent(Ev);
+  }
+
+  openfluid::core::EventsRange Range = EvColl.eventsBetween(RefDate+openfluid::core::DateTime::Hours(10),
+                                                            RefDate+openfluid::core::DateTime::Hours(19));
+  BOOST_REQUIRE_EQUAL(Range.size(),10);
+  BOOST_REQUIRE(Range.front().getDateTime() == RefDate+openfluid::core::DateTime::Hours(10));
+  BOOST_REQUIRE(Range.back().getDateTime() == RefDate+openfluid::core::DateTime::Hours(19));
+
+  // the range gives access to the stored events, not to copies
+  BOOST_REQUIRE_EQUAL(&Range[0],&EvColl.eventsList()->at(10));
+
+  int Index = 10;
+  for (const openfluid::core::Event& Ev : Range)
+  {
+    std::string Info;
+    BOOST_REQUIRE(Ev.getInfoAsString("index",Info));
+    BOOST_REQUIRE_EQUAL(Info,std::to_string(Index));
+    Index++;
+  }
+  BOOST_REQUIRE_EQUAL(Index,20);
+
+  // same content as the copying access
+  openfluid::core::EventsCollection EvColl2;
+  EvColl.getEventsBetween(RefDate+openfluid::core::DateTime::Hours(10),
+                          RefDate+openfluid::core::DateTime::Hours(19),EvColl2);
+  BOOST_REQUIRE_EQUAL(EvColl2.getCount(),Range.size());
+
+  BOOST_REQUIRE(EvColl.eventsBetween(RefDate+openfluid::core::DateTime::Days(3),
+                                     RefDate+openfluid::core::DateTime::Days(4)).empty());
+  BOOST_REQUIRE(EvColl.eventsBetween(RefDate+openfluid::core::DateTime::Hours(5),RefDate).empty());
+  BOOST_REQUIRE_EQUAL(EvColl.eventsBetween(RefDate-openfluid::core::DateTime::Days(1),
+                                           RefDate+openfluid::core::DateTime::Days(3)).size(),48);
+}
+
 // =====================================================================
 // =====================================================================
+
+BOOST_AUTO_TEST_CASE(check_ordering)
+{
+  openfluid::core::EventsCollection EvColl, EvColl2;
+  openfluid::core::Event Ev;
+
+  Ev = openfluid::core::Event(openfluid::core::DateTime(2010,1,1,0,0,0));
+  Ev.addInfo("order","2");
+  EvColl.addEvent(Ev);
+
+  Ev = openfluid::core::Event(openfluid::core::DateTime(2000,1,1,0,0,0));
+  Ev.addInfo("order","1");
+  EvColl.addEvent(Ev);
+
+  Ev = openfluid::core::Event(openfluid::core::DateTime(2010,1,1,0,0,0));
+  Ev.addInfo("order","3");
+  EvColl.addEvent(Ev);
+
+  Ev = openfluid::core::Event(openfluid::core::DateTime(2005,1,1,0,0,0));
+  Ev.addInfo("order","1.5");
+  EvColl.addEvent(Ev);
+
+  BOOST_REQUIRE_EQUAL(EvColl.getCount(),4);
+  BOOST_REQUIRE(EvColl.eventsList()->at(0).isInfoEqual("order","1"));
+  BOOST_REQUIRE(EvColl.eventsList()->at(1).isInfoEqual("order","1.5"));
+  BOOST_REQUIRE(EvColl.eventsList()->at(2).isInfoEqual("order","2"));
+  BOOST_REQUIRE(EvColl.eventsList()->at(3).isInfoEqual("order","3"));
+
+  EvColl.getEventsBetween(openfluid::core::DateTime(2010,1,1,0,0,0),openfluid::core::DateTime(2010,1,1,0,0,0),EvColl2);
+  BOOST_REQUIRE_EQUAL(EvColl2.getCount(),2);
+  BOOST_REQUIRE(EvColl2.eventsList()->front().isInfoEqual("order","2"));
+  BOOST_REQUIRE(EvColl2.eventsList()->back().isInfoEqual("order","3"));
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_bulk_and_windows)
+{
+  openfluid::core::EventsCollection EvColl;
+  openfluid::core::EventsList_t EvList;
+  const openfluid::core::DateTime RefDate(2000,1,1,0,0,0);
+
+  // one event every 2 hours over 100 days, given in reverse order
+  for (int i=1199; i>=0; i--)
+    EvList.push_back(openfluid::core::Event(RefDate+openfluid::core::DateTime::Hours(2*i)));
+
+  EvColl.addEvents(EvList);
+  BOOST_REQUIRE_EQUAL(EvColl.getCount(),1200);
+
+  for (unsigned int i=1; i<EvColl.eventsList()->size(); i++)
+    BOOST_REQUIRE(EvColl.eventsList()->at(i-1).getDateTime() < EvColl.eventsList()->at(i).getDateTime());
+
+  // forward moving windows, as during a simulation
+  for (int d=0; d<100; d++)
+  {
+    openfluid::core::EventsCollection EvColl2;
+    EvColl.getEventsBetween(RefDate+openfluid::core::DateTime::Days(d),
+                            RefDate+openfluid::core::DateTime::Days(d+1)-1,EvColl2);
+    BOOST_REQUIRE_EQUAL(EvColl2.getCount(),12);
+    BOOST_REQUIRE(EvColl2.eventsList()->front().getDateTime() == RefDate+openfluid::core::DateTime::Days(d));
+  }
+
+  // backward windows
+  for (int d=99; d>=0; d-=7)
+  {
+    openfluid::core::EventsCollection EvColl2;
+    EvColl.getEventsBetween(RefDate+openfluid::core::DateTime::Days(d)+1,
+                            RefDate+openfluid::core::DateTime::Days(d+1),EvColl2);
+    BOOST_REQUIRE_EQUAL(EvColl2.getCount(),d < 99 ? 12 : 11);
+  }
+
+  // merge of new events in an existing collection
+  EvList.clear();
+  EvList.push_back(openfluid::core::Event(RefDate+openfluid::core::DateTime::Hours(1)));
+  EvList.push_back(openfluid::core::Event(RefDate-openfluid::core::DateTime::Hours(1)));
+  EvColl.addEvents(EvList);
+  BOOST_REQUIRE_EQUAL(EvColl.getCount(),1202);
+  BOOST_REQUIRE(EvColl.eventsList()->front().getDateTime() == RefDate-openfluid::core::DateTime::Hours(1));
+  BOOST_REQUIRE(EvColl.eventsList()->at(2).getDateTime() == RefDate+openfluid::core::DateTime::Hours(1));
+
+  openfluid::core::EventsCollection EvColl3;
+  EvColl.getEventsBetween(RefDate+openfluid::core::DateTime::Days(1),RefDate,EvColl3);
+  BOOST_REQUIRE_EQUAL(EvColl3.getCount(),0);
+}
+
+
+// =====================================================================
+// =====================================================================
+
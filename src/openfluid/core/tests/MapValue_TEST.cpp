@@ -44,6 +44,9 @@
 #include <boost/test/unit_test.hpp>
 #include <boost/test/auto_unit_test.hpp>
 
+#include <chrono>
+#include <map>
+
 #include <openfluid/core/MapValue.hpp>
 
 
@@ -142,3 +145,86 @@ BOOST_AUTO_TEST_CASE(check_map)
 
 }
 
+
+BOOST_AUTO_TEST_CASE(check_flat_storage)
+{
+  openfluid::core::MapValue::Map_t Pairs;
+  Pairs["zz"] = std::make_shared<openfluid::core::IntegerValue>(1);
+  Pairs["aa"] = std::make_shared<openfluid::core::IntegerValue>(2);
+  Pairs["mm"] = std::make_shared<openfluid::core::IntegerValue>(4);
+
+  // elements are sorted by keys, values are shared with the source map
+  openfluid::core::MapValue Val(Pairs);
+  BOOST_REQUIRE_EQUAL(Val.getSize(),3);
+  BOOST_REQUIRE_EQUAL(Val.getKeys().at(0),"aa");
+  BOOST_REQUIRE_EQUAL(Val.getKeys().at(2),"zz");
+  BOOST_REQUIRE_EQUAL(Val.getInteger("zz"),1);
+  BOOST_REQUIRE_EQUAL(&Val["zz"],Pairs["zz"].get());
+
+  // references to values remain valid when inserting and removing other elements
+  openfluid::core::Value& MValue = Val["mm"];
+  for (unsigned int i=0; i<100; i++)
+    Val.setDouble("key"+std::to_string(i),i);
+  Val.remove("aa");
+  BOOST_REQUIRE_EQUAL(MValue.asIntegerValue().get(),4);
+  BOOST_REQUIRE_EQUAL(Val.getSize(),102);
+  BOOST_REQUIRE(!Val.remove("aa"));
+
+  std::string PrevKey;
+  for (const auto& Pair : Val)
+  {
+    BOOST_REQUIRE(PrevKey < Pair.first);
+    PrevKey = Pair.first;
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_performance)
+{
+  const unsigned int KeysCount = 50;
+  const unsigned int Repeats = 20000;
+
+  openfluid::core::MapValue Val;
+  std::map<std::string,std::shared_ptr<openfluid::core::Value>> RefMap;
+  std::vector<std::string> Keys;
+
+  for (unsigned int i=0; i<KeysCount; i++)
+  {
+    Keys.push_back("parameter."+std::to_string(i*7919 % 1000));
+    Val.setDouble(Keys.back(),i);
+    RefMap[Keys.back()].reset(new openfluid::core::DoubleValue(i));
+  }
+
+  double MapSum = 0.0, ValSum = 0.0;
+
+  auto Start = std::chrono::high_resolution_clock::now();
+  for (unsigned int r=0; r<Repeats; r++)
+  {
+    for (const auto& Key : Keys)
+      MapSum += RefMap.at(Key)->asDoubleValue().get();
+    for (const auto& Pair : RefMap)
+      MapSum += Pair.second->asDoubleValue().get();
+  }
+  auto MapDuration =
+    std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now()-Start);
+
+  Start = std::chrono::high_resolution_clock::now();
+  for (unsigned int r=0; r<Repeats; r++)
+  {
+    for (const auto& Key : Keys)
+      ValSum += Val.getDouble(Key);
+    for (const auto& Pair : Val)
+      ValSum += Pair.second->asDoubleValue().get();
+  }
+  auto ValDuration =
+    std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now()-Start);
+
+  std::cout << "Duration [std::map], lookup+iteration: " << MapDuration.count() << "us" << std::endl;
+  std::cout << "Duration [MapValue], lookup+iteration: " << ValDuration.count() << "us" << std::endl;
+
+  BOOST_REQUIRE_CLOSE(MapSum,ValSum,0.0001);
+}
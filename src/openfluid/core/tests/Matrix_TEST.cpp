@@ -110,3 +110,37 @@ BOOST_AUTO_TEST_CASE(check_operations)
 // =====================================================================
 // =====================================================================
 
+
+BOOST_AUTO_TEST_CASE(check_kernels)
+{
+  // 3 columns x 2 rows
+  openfluid::core::Matrix<double> M(3,2);
+  M.set(0,0,1.0); M.set(1,0,2.0); M.set(2,0,3.0);
+  M.set(0,1,4.0); M.set(1,1,5.0); M.set(2,1,6.0);
+
+  BOOST_REQUIRE_CLOSE(M.sum(),21.0,0.0001);
+  BOOST_REQUIRE_EQUAL(M.min(),1.0);
+  BOOST_REQUIRE_EQUAL(M.max(),6.0);
+
+  openfluid::core::Vector<double> X(3),Y;
+  X[0] = 1.0; X[1] = 0.5; X[2] = -1.0;
+
+  M.multiply(X,Y);
+  BOOST_REQUIRE_EQUAL(Y.size(),2);
+  BOOST_REQUIRE_CLOSE(Y[0],-1.0,0.0001);
+  BOOST_REQUIRE_CLOSE(Y[1],0.5,0.0001);
+
+  BOOST_REQUIRE_THROW(M.multiply(Y,X),openfluid::base::FrameworkException);
+
+  openfluid::core::Matrix<double> M2(M);
+  M2.scale(2.0);
+  M2.subtract(M);
+  BOOST_REQUIRE_CLOSE(M2.at(2,1),6.0,0.0001);
+  M2.add(M);
+  BOOST_REQUIRE_CLOSE(M2.at(2,1),12.0,0.0001);
+
+  openfluid::core::Matrix<double> M3(2,3),M4;
+  BOOST_REQUIRE_THROW(M2.add(M3),openfluid::base::FrameworkException);
+  BOOST_REQUIRE_THROW(M4.max(),openfluid::base::FrameworkException);
+  BOOST_REQUIRE_EQUAL(M4.sum(),0.0);
+}
@@ -44,6 +44,8 @@
 #include <boost/test/unit_test.hpp>
 #include <boost/test/auto_unit_test.hpp>
 #include <openfluid/core/SpatialGraph.hpp>
+#include <openfluid/core/SpatialGraphPartitioning.hpp>
+#include <openfluid/base/FrameworkException.hpp>
 
 
 // =====================================================================
@@ -67,7 +69,7 @@ BOOST_AUTO_TEST_CASE(check_operations)
   openfluid::core::SpatialGraph* SGraph;
   int i, PcsOrder;
   openfluid::core::UnitsCollection* UnitsColl;
-  openfluid::core::UnitsList_t::iterator UnitsIt, PrevUnitsIt;
+  openfluid::core::UnitsList_t::const_iterator UnitsIt, PrevUnitsIt;
   openfluid::core::SpatialUnit* U;
 
 
@@ -148,3 +150,598 @@ BOOST_AUTO_TEST_CASE(check_operations)
 
 // =====================================================================
 // =====================================================================
+
+BOOST_AUTO_TEST_CASE(check_adjacency)
+{
+  openfluid::core::SpatialGraph SGraph;
+
+  // chain of SU units (process order decreasing with ID), each one connected to the next one and to a RS unit
+  for (int i=1; i<=20; i++)
+    SGraph.addUnit(openfluid::core::SpatialUnit("SU",i,21-i));
+  for (int i=1; i<=4; i++)
+    SGraph.addUnit(openfluid::core::SpatialUnit("RS",i,1));
+
+  for (int i=2; i<=20; i++)
+  {
+    openfluid::core::SpatialUnit* From = SGraph.spatialUnit("SU",i);
+    openfluid::core::SpatialUnit* To = SGraph.spatialUnit("SU",i-1);
+    From->addToUnit(To);
+    To->addFromUnit(From);
+  }
+
+  for (int i=1; i<=20; i++)
+  {
+    openfluid::core::SpatialUnit* From = SGraph.spatialUnit("SU",i);
+    openfluid::core::SpatialUnit* To = SGraph.spatialUnit("RS",(i%4)+1);
+    From->addToUnit(To);
+    To->addFromUnit(From);
+    To->addParentUnit(From);
+    From->addChildUnit(To);
+  }
+
+  SGraph.sortUnitsByProcessOrder();
+  BOOST_REQUIRE(!SGraph.isAdjacencyUpToDate());
+
+  SGraph.buildAdjacency();
+  BOOST_REQUIRE(SGraph.isAdjacencyUpToDate());
+
+  BOOST_REQUIRE(SGraph.adjacency("SU",openfluid::core::UnitsLinkType::PARENT,"RS") == nullptr);
+  BOOST_REQUIRE(SGraph.adjacency("XX",openfluid::core::UnitsLinkType::TO,"SU") == nullptr);
+
+  const openfluid::core::UnitsAdjacency* ToSU = SGraph.adjacency("SU",openfluid::core::UnitsLinkType::TO,"SU");
+  const openfluid::core::UnitsAdjacency* ToRS = SGraph.adjacency("SU",openfluid::core::UnitsLinkType::TO,"RS");
+  const openfluid::core::UnitsAdjacency* FromSU = SGraph.adjacency("RS",openfluid::core::UnitsLinkType::FROM,"SU");
+  const openfluid::core::UnitsAdjacency* ParentSU = SGraph.adjacency("RS",openfluid::core::UnitsLinkType::PARENT,"SU");
+
+  BOOST_REQUIRE(ToSU != nullptr);
+  BOOST_REQUIRE(ToRS != nullptr);
+  BOOST_REQUIRE(FromSU != nullptr);
+  BOOST_REQUIRE(ParentSU != nullptr);
+
+  BOOST_REQUIRE_EQUAL(ToSU->getSourcesCount(),20);
+  BOOST_REQUIRE_EQUAL(ToSU->getLinksCount(),19);
+  BOOST_REQUIRE_EQUAL(ToRS->getLinksCount(),20);
+  BOOST_REQUIRE_EQUAL(FromSU->getSourcesCount(),4);
+  BOOST_REQUIRE_EQUAL(FromSU->getLinksCount(),20);
+  BOOST_REQUIRE_EQUAL(ParentSU->getLinksCount(),20);
+
+  // spans are the same as the linked units lists
+  for (openfluid::core::SpatialUnit* U : *(SGraph.spatialUnits("SU")->units()))
+  {
+    openfluid::core::UnitsSpan Span = ToSU->neighbours(U->getIndex());
+    const openfluid::core::UnitsPtrList_t* List = U->toSpatialUnits("SU");
+
+    if (U->getID() == 1)
+    {
+      BOOST_REQUIRE(Span.empty());
+      BOOST_REQUIRE(List == nullptr || List->empty());
+    }
+    else
+    {
+      BOOST_REQUIRE_EQUAL(Span.size(),1);
+      BOOST_REQUIRE_EQUAL(Span[0],List->front());
+      BOOST_REQUIRE_EQUAL(Span[0]->getID(),U->getID()-1);
+      BOOST_REQUIRE_EQUAL(ToSU->neighboursIndices()[ToSU->offsets()[U->getIndex()]],Span[0]->getIndex());
+    }
+
+    BOOST_REQUIRE_EQUAL(ToRS->neighboursCount(U->getIndex()),1);
+    BOOST_REQUIRE_EQUAL(ToRS->neighbours(U->getIndex())[0]->getID(),(U->getID()%4)+1);
+  }
+
+  for (openfluid::core::SpatialUnit* U : *(SGraph.spatialUnits("RS")->units()))
+  {
+    BOOST_REQUIRE_EQUAL(FromSU->neighboursCount(U->getIndex()),5);
+
+    int Count = 0;
+    for (openfluid::core::SpatialUnit* Linked : FromSU->neighbours(U->getIndex()))
+    {
+      BOOST_REQUIRE_EQUAL(Linked->getClass(),"SU");
+      Count++;
+    }
+    BOOST_REQUIRE_EQUAL(Count,5);
+  }
+
+  // modification of the graph
+  SGraph.removeFromToConnection(SGraph.spatialUnit("SU",5),SGraph.spatialUnit("SU",4));
+  BOOST_REQUIRE(!SGraph.isAdjacencyUpToDate());
+  ToSU = SGraph.adjacency("SU",openfluid::core::UnitsLinkType::TO,"SU");
+  BOOST_REQUIRE(SGraph.isAdjacencyUpToDate());
+  BOOST_REQUIRE_EQUAL(ToSU->getLinksCount(),18);
+  BOOST_REQUIRE(ToSU->neighbours(SGraph.spatialUnit("SU",5)->getIndex()).empty());
+
+  // links added directly on units outdate the adjacency
+  SGraph.spatialUnit("SU",5)->addToUnit(SGraph.spatialUnit("SU",3));
+  BOOST_REQUIRE(!SGraph.isAdjacencyUpToDate());
+  ToSU = SGraph.adjacency("SU",openfluid::core::UnitsLinkType::TO,"SU");
+  BOOST_REQUIRE(SGraph.isAdjacencyUpToDate());
+  BOOST_REQUIRE_EQUAL(ToSU->getLinksCount(),19);
+  BOOST_REQUIRE_EQUAL(ToSU->neighboursCount(SGraph.spatialUnit("SU",5)->getIndex()),1);
+  BOOST_REQUIRE_EQUAL(ToSU->neighbours(SGraph.spatialUnit("SU",5)->getIndex())[0]->getID(),3);
+
+  SGraph.spatialUnit("SU",3)->addFromUnit(SGraph.spatialUnit("SU",5));
+  BOOST_REQUIRE(!SGraph.isAdjacencyUpToDate());
+  const openfluid::core::UnitsAdjacency* FromSUSU = SGraph.adjacency("SU",openfluid::core::UnitsLinkType::FROM,"SU");
+  BOOST_REQUIRE_EQUAL(FromSUSU->neighboursCount(SGraph.spatialUnit("SU",3)->getIndex()),2);
+
+  SGraph.spatialUnit("SU",5)->addParentUnit(SGraph.spatialUnit("RS",1));
+  BOOST_REQUIRE(!SGraph.isAdjacencyUpToDate());
+  BOOST_REQUIRE(SGraph.adjacency("SU",openfluid::core::UnitsLinkType::PARENT,"RS") != nullptr);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+BOOST_AUTO_TEST_CASE(check_computed_pcsorders)
+{
+  openfluid::core::SpatialGraph SGraph;
+
+  // tree of SU units flowing to RS units
+  //   SU1 -> SU3 -> SU4 -> RS1 -> RS2
+  //   SU2 -> SU4
+  //   SU5 -> RS2
+  for (int i=1; i<=5; i++)
+    SGraph.addUnit(openfluid::core::SpatialUnit("SU",i,1));
+  SGraph.addUnit(openfluid::core::SpatialUnit("RS",1,1));
+  SGraph.addUnit(openfluid::core::SpatialUnit("RS",2,1));
+
+  auto connect = [&SGraph](const std::string& FromClass, int FromID, const std::string& ToClass, int ToID)
+  {
+    openfluid::core::SpatialUnit* From = SGraph.spatialUnit(FromClass,FromID);
+    openfluid::core::SpatialUnit* To = SGraph.spatialUnit(ToClass,ToID);
+    From->addToUnit(To);
+    To->addFromUnit(From);
+  };
+
+  connect("SU",1,"SU",3);
+  connect("SU",3,"SU",4);
+  connect("SU",2,"SU",4);
+  connect("SU",4,"RS",1);
+  connect("RS",1,"RS",2);
+  connect("SU",5,"RS",2);
+
+  SGraph.computeProcessOrders();
+
+  BOOST_REQUIRE_EQUAL(SGraph.spatialUnit("SU",1)->getProcessOrder(),1);
+  BOOST_REQUIRE_EQUAL(SGraph.spatialUnit("SU",2)->getProcessOrder(),1);
+  BOOST_REQUIRE_EQUAL(SGraph.spatialUnit("SU",3)->getProcessOrder(),2);
+  BOOST_REQUIRE_EQUAL(SGraph.spatialUnit("SU",4)->getProcessOrder(),3);
+  BOOST_REQUIRE_EQUAL(SGraph.spatialUnit("SU",5)->getProcessOrder(),1);
+  BOOST_REQUIRE_EQUAL(SGraph.spatialUnit("RS",1)->getProcessOrder(),4);
+  BOOST_REQUIRE_EQUAL(SGraph.spatialUnit("RS",2)->getProcessOrder(),5);
+
+  // levels of process orders
+  const openfluid::core::UnitsCollection* SUs = SGraph.spatialUnits("SU");
+  BOOST_REQUIRE_EQUAL(SUs->getLevelsCount(),3);
+  BOOST_REQUIRE_EQUAL(SUs->levelsOffsets()->at(0),0);
+  BOOST_REQUIRE_EQUAL(SUs->levelsOffsets()->at(1),3);
+  BOOST_REQUIRE_EQUAL(SUs->levelsOffsets()->at(2),4);
+  BOOST_REQUIRE_EQUAL(SUs->levelsOffsets()->at(3),5);
+  BOOST_REQUIRE_EQUAL(SUs->unitAt(3)->getID(),3);
+  BOOST_REQUIRE_EQUAL(SUs->unitAt(4)->getID(),4);
+  BOOST_REQUIRE_EQUAL(SGraph.spatialUnits("RS")->getLevelsCount(),2);
+
+  BOOST_REQUIRE_EQUAL(SGraph.allSpatialUnits()->front()->getProcessOrder(),1);
+  BOOST_REQUIRE_EQUAL(SGraph.allSpatialUnits()->back()->getID(),2);
+  BOOST_REQUIRE_EQUAL(SGraph.allSpatialUnits()->back()->getClass(),"RS");
+
+
+  // computation of some units only, with fixed process orders for the others
+  SGraph.spatialUnit("SU",4)->setProcessOrder(10);
+  std::vector<openfluid::core::SpatialUnit*> ComputedUnits = {SGraph.spatialUnit("RS",1),SGraph.spatialUnit("RS",2)};
+  SGraph.computeProcessOrders(ComputedUnits);
+  BOOST_REQUIRE_EQUAL(SGraph.spatialUnit("SU",4)->getProcessOrder(),10);
+  BOOST_REQUIRE_EQUAL(SGraph.spatialUnit("RS",1)->getProcessOrder(),11);
+  BOOST_REQUIRE_EQUAL(SGraph.spatialUnit("RS",2)->getProcessOrder(),12);
+
+
+  // cycle
+  connect("RS",2,"SU",1);
+  BOOST_REQUIRE_THROW(SGraph.computeProcessOrders(),openfluid::base::FrameworkException);
+
+  // cycle outside of computed units
+  BOOST_REQUIRE_NO_THROW(SGraph.computeProcessOrders({SGraph.spatialUnit("SU",5)}));
+  BOOST_REQUIRE_EQUAL(SGraph.spatialUnit("SU",5)->getProcessOrder(),1);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_adjacency_levels)
+{
+  openfluid::core::SpatialGraph SGraph;
+
+  // binary tree of 7 SU units draining to unit 1 : 2,3 -> 1 ; 4,5 -> 2 ; 6,7 -> 3, plus an isolated unit 8
+  for (int i=1; i<=8; i++)
+    SGraph.addUnit(openfluid::core::SpatialUnit("SU",i,1));
+
+  for (int i=2; i<=7; i++)
+  {
+    openfluid::core::SpatialUnit* From = SGraph.spatialUnit("SU",i);
+    openfluid::core::SpatialUnit* To = SGraph.spatialUnit("SU",i/2);
+    From->addToUnit(To);
+    To->addFromUnit(From);
+  }
+
+  const openfluid::core::UnitsAdjacency* FromSU = SGraph.adjacency("SU",openfluid::core::UnitsLinkType::FROM,"SU");
+  BOOST_REQUIRE(FromSU != nullptr);
+
+  std::vector<std::size_t> Order;
+  std::vector<std::size_t> LevelsOffsets;
+
+  BOOST_REQUIRE(FromSU->computeLevels(Order,LevelsOffsets));
+  BOOST_REQUIRE_EQUAL(Order.size(),8);
+  BOOST_REQUIRE_EQUAL(LevelsOffsets.size(),4);
+  BOOST_REQUIRE_EQUAL(LevelsOffsets[1],5);
+  BOOST_REQUIRE_EQUAL(LevelsOffsets[2],7);
+  BOOST_REQUIRE_EQUAL(LevelsOffsets[3],8);
+
+  const openfluid::core::UnitsCollection* Units = SGraph.spatialUnits("SU");
+  BOOST_REQUIRE_EQUAL(Units->unitAt(Order[7])->getID(),1);
+
+  // every unit comes after its upstream units
+  std::vector<std::size_t> Positions(Order.size());
+  for (std::size_t k=0; k<Order.size(); k++)
+    Positions[Order[k]] = k;
+
+  for (std::size_t i=0; i<Order.size(); i++)
+  {
+    for (openfluid::core::SpatialUnit* Up : FromSU->neighbours(i))
+      BOOST_REQUIRE_LT(Positions[Up->getIndex()],Positions[i]);
+  }
+
+  // cycle between units 1 and 8
+  openfluid::core::SpatialUnit* U1 = SGraph.spatialUnit("SU",1);
+  openfluid::core::SpatialUnit* U8 = SGraph.spatialUnit("SU",8);
+  U1->addToUnit(U8);
+  U8->addFromUnit(U1);
+  U8->addToUnit(U1);
+  U1->addFromUnit(U8);
+  SGraph.invalidateAdjacency();
+
+  FromSU = SGraph.adjacency("SU",openfluid::core::UnitsLinkType::FROM,"SU");
+  BOOST_REQUIRE(!FromSU->computeLevels(Order,LevelsOffsets));
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_partitioning)
+{
+  openfluid::core::SpatialGraph SGraph;
+
+  // binary tree of 63 SU units draining to unit 1, connected to 4 RS units as children
+  for (int i=1; i<=63; i++)
+    SGraph.addUnit(openfluid::core::SpatialUnit("SU",i,1));
+  for (int i=1; i<=4; i++)
+    SGraph.addUnit(openfluid::core::SpatialUnit("RS",i,1));
+
+  for (int i=2; i<=63; i++)
+  {
+    openfluid::core::SpatialUnit* From = SGraph.spatialUnit("SU",i);
+    openfluid::core::SpatialUnit* To = SGraph.spatialUnit("SU",i/2);
+    From->addToUnit(To);
+    To->addFromUnit(From);
+  }
+
+  for (int i=1; i<=4; i++)
+  {
+    openfluid::core::SpatialUnit* Parent = SGraph.spatialUnit("SU",i);
+    openfluid::core::SpatialUnit* Child = SGraph.spatialUnit("RS",i);
+    Parent->addChildUnit(Child);
+    Child->addParentUnit(Parent);
+  }
+
+  SGraph.computeProcessOrders();
+
+  openfluid::core::SpatialGraphPartitioning Partitioning;
+
+  BOOST_REQUIRE_THROW(Partitioning.compute(&SGraph,0),openfluid::base::FrameworkException);
+
+  Partitioning.compute(&SGraph,4);
+  BOOST_REQUIRE_EQUAL(Partitioning.getPartitionsCount(),4);
+
+  std::size_t Total = 0;
+  for (unsigned int p=0; p<4; p++)
+  {
+    const openfluid::core::UnitsPtrVector_t& Units = Partitioning.units(p);
+    Total += Units.size();
+
+    BOOST_REQUIRE_GE(Units.size(),14);
+    BOOST_REQUIRE_LE(Units.size(),19);
+
+    for (std::size_t i=0; i<Units.size(); i++)
+    {
+      BOOST_REQUIRE_EQUAL(Partitioning.getPartition(Units[i]),p);
+      if (i)
+        BOOST_REQUIRE_LE(Units[i-1]->getProcessOrder(),Units[i]->getProcessOrder());
+    }
+  }
+  BOOST_REQUIRE_EQUAL(Total,67);
+
+  // sub-basins partitions of a tree cut a few links only
+  BOOST_REQUIRE_GT(Partitioning.getCutLinksCount(),0);
+  BOOST_REQUIRE_LE(Partitioning.getCutLinksCount(),8);
+
+  // every link crossing partitions is in the halos
+  std::size_t CutCount = 0;
+  for (openfluid::core::SpatialUnit* U : *(SGraph.allSpatialUnits()))
+  {
+    const openfluid::core::UnitsPtrList_t* ToUnits = U->toSpatialUnits("SU");
+
+    if (ToUnits == nullptr)
+      continue;
+
+    for (openfluid::core::SpatialUnit* ToU : *ToUnits)
+    {
+      unsigned int FromPart = Partitioning.getPartition(U);
+      unsigned int ToPart = Partitioning.getPartition(ToU);
+
+      if (FromPart != ToPart)
+      {
+        CutCount++;
+
+        const openfluid::core::UnitsPtrVector_t& ToHalo = Partitioning.haloUnits(ToPart,FromPart);
+        const openfluid::core::UnitsPtrVector_t& FromHalo = Partitioning.haloUnits(FromPart,ToPart);
+        BOOST_REQUIRE(std::find(ToHalo.begin(),ToHalo.end(),U) != ToHalo.end());
+        BOOST_REQUIRE(std::find(FromHalo.begin(),FromHalo.end(),ToU) != FromHalo.end());
+      }
+    }
+  }
+  BOOST_REQUIRE_EQUAL(CutCount,Partitioning.getCutLinksCount());
+
+  // linked units of different partitions are ordered as the partitions, following the process order
+  std::map<const openfluid::core::SpatialUnit*,std::size_t> Positions;
+  for (openfluid::core::SpatialUnit* U : *(SGraph.allSpatialUnits()))
+    Positions[U] = Positions.size();
+
+  for (openfluid::core::SpatialUnit* U : *(SGraph.allSpatialUnits()))
+  {
+    for (const openfluid::core::UnitsClass_t& Class : {"SU","RS"})
+    {
+      for (const openfluid::core::UnitsPtrList_t* LinkedUnits : {U->toSpatialUnits(Class),U->fromSpatialUnits(Class),
+                                                                  U->parentSpatialUnits(Class),
+                                                                  U->childSpatialUnits(Class)})
+      {
+        if (LinkedUnits == nullptr)
+          continue;
+
+        for (openfluid::core::SpatialUnit* Linked : *LinkedUnits)
+        {
+          if (Positions[U] < Positions[Linked])
+            BOOST_REQUIRE_LE(Partitioning.getPartition(U),Partitioning.getPartition(Linked));
+        }
+      }
+    }
+  }
+
+  Partitioning.compute(&SGraph,1);
+  BOOST_REQUIRE_EQUAL(Partitioning.units(0).size(),67);
+  BOOST_REQUIRE_EQUAL(Partitioning.getCutLinksCount(),0);
+  BOOST_REQUIRE(Partitioning.haloUnits(0,1).empty());
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_restriction)
+{
+  openfluid::core::SpatialGraph SGraph;
+
+  // chain of 10 SU units : 1 -> 2 -> ... -> 10, each one being the parent of a RS unit
+  for (int i=1; i<=10; i++)
+  {
+    SGraph.addUnit(openfluid::core::SpatialUnit("SU",i,i));
+    SGraph.addUnit(openfluid::core::SpatialUnit("RS",i,i));
+  }
+
+  for (int i=1; i<=10; i++)
+  {
+    openfluid::core::SpatialUnit* SU = SGraph.spatialUnit("SU",i);
+    openfluid::core::SpatialUnit* RS = SGraph.spatialUnit("RS",i);
+    SU->addChildUnit(RS);
+    RS->addParentUnit(SU);
+
+    if (i < 10)
+    {
+      openfluid::core::SpatialUnit* To = SGraph.spatialUnit("SU",i+1);
+      SU->addToUnit(To);
+      To->addFromUnit(SU);
+    }
+  }
+  SGraph.sortUnitsByProcessOrder();
+
+  openfluid::core::SpatialGraphPartitioning Partitioning;
+  Partitioning.compute(&SGraph,2);
+
+  openfluid::core::UnitsPtrVector_t Ghosts = Partitioning.haloUnits(1,0);
+  openfluid::core::UnitsPtrVector_t Owned = Partitioning.units(1);
+  BOOST_REQUIRE(!Ghosts.empty());
+
+  openfluid::core::SpatialUnit* Ghost = Ghosts.front();
+  const openfluid::core::UnitID_t GhostID = Ghost->getID();
+  const openfluid::core::UnitsClass_t GhostClass = Ghost->getClass();
+  Ghost->variables()->createVariable("water");
+
+  SGraph.restrictToUnits(Owned,Ghosts);
+
+  // ghost units are found by ID but are not processed by loops
+  BOOST_REQUIRE_EQUAL(SGraph.getUnitsCount(),Owned.size());
+  BOOST_REQUIRE_EQUAL(SGraph.spatialUnit(GhostClass,GhostID),Ghost);
+  BOOST_REQUIRE(SGraph.spatialUnits(GhostClass)->isGhostSpatialUnit(GhostID));
+  BOOST_REQUIRE(Ghost->variables()->isVariableExist("water"));
+
+  std::size_t UnitsCount = 0;
+  for (auto& ClassUnits : *(SGraph.allSpatialUnitsByClass()))
+  {
+    UnitsCount += ClassUnits.second.size();
+
+    for (openfluid::core::SpatialUnit* U : *(ClassUnits.second.units()))
+      BOOST_REQUIRE(std::find(Owned.begin(),Owned.end(),U) != Owned.end());
+
+    for (openfluid::core::SpatialUnit* U : *(ClassUnits.second.ghosts()))
+      BOOST_REQUIRE_GE(U->getIndex(),ClassUnits.second.size());
+  }
+  BOOST_REQUIRE_EQUAL(UnitsCount,Owned.size());
+
+  // links to deleted units are removed, links to ghost units are kept in the adjacency
+  std::size_t GhostLinksCount = 0;
+
+  for (openfluid::core::SpatialUnit* U : Owned)
+  {
+    for (const openfluid::core::UnitsClass_t& Class : {"SU","RS"})
+    {
+      for (const openfluid::core::UnitsPtrList_t* LinkedUnits : {U->toSpatialUnits(Class),U->fromSpatialUnits(Class),
+                                                                  U->parentSpatialUnits(Class),
+                                                                  U->childSpatialUnits(Class)})
+      {
+        if (LinkedUnits == nullptr)
+          continue;
+
+        for (openfluid::core::SpatialUnit* Linked : *LinkedUnits)
+        {
+          BOOST_REQUIRE(std::find(Owned.begin(),Owned.end(),Linked) != Owned.end() ||
+                        std::find(Ghosts.begin(),Ghosts.end(),Linked) != Ghosts.end());
+          if (std::find(Ghosts.begin(),Ghosts.end(),Linked) != Ghosts.end())
+            GhostLinksCount++;
+        }
+      }
+    }
+  }
+  BOOST_REQUIRE_GT(GhostLinksCount,0);
+
+  const openfluid::core::UnitsAdjacency* FromSU = SGraph.adjacency("SU",openfluid::core::UnitsLinkType::FROM,"SU");
+  BOOST_REQUIRE(FromSU != nullptr);
+  BOOST_REQUIRE_EQUAL(FromSU->getSourcesCount(),SGraph.spatialUnits("SU")->size());
+
+  std::vector<std::size_t> Order, LevelsOffsets;
+  BOOST_REQUIRE(FromSU->computeLevels(Order,LevelsOffsets));
+  BOOST_REQUIRE_EQUAL(Order.size(),SGraph.spatialUnits("SU")->size());
+
+  SGraph.clearUnits();
+  BOOST_REQUIRE(SGraph.spatialUnit(GhostClass,GhostID) == nullptr);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_locality_ordering)
+{
+  openfluid::core::SpatialGraph SGraph;
+  const unsigned int UnitsCount = 50;
+
+  // chain of units with the same process order, created in a scrambled order, and 5 single units
+  std::vector<int> ChainIDs;
+  for (unsigned int i=0; i<UnitsCount-5; i++)
+    ChainIDs.push_back(1+((i*17)%(UnitsCount-5)));
+
+  for (unsigned int i=1; i<=UnitsCount; i++)
+  {
+    SGraph.addUnit(openfluid::core::SpatialUnit("TU",i,(i > UnitsCount-5) ? 2 : 1));
+    SGraph.spatialUnit("TU",i)->importGeometryFromWkt("POINT ("+std::to_string(UnitsCount-i)+" 0)");
+  }
+
+  for (unsigned int i=0; i<ChainIDs.size()-1; i++)
+  {
+    openfluid::core::SpatialUnit* From = SGraph.spatialUnit("TU",ChainIDs[i]);
+    openfluid::core::SpatialUnit* To = SGraph.spatialUnit("TU",ChainIDs[i+1]);
+    From->addToUnit(To);
+    To->addFromUnit(From);
+  }
+
+  auto Bandwidth = [&SGraph]()
+  {
+    std::size_t Width = 0;
+    const openfluid::core::UnitsAdjacency* Adj =
+      SGraph.adjacency("TU",openfluid::core::UnitsLinkType::TO,"TU");
+
+    for (std::size_t i=0; i<Adj->getSourcesCount(); i++)
+    {
+      for (std::size_t j=Adj->offsets()[i]; j<Adj->offsets()[i+1]; j++)
+      {
+        std::size_t Other = Adj->neighboursIndices()[j];
+        Width = std::max(Width,(Other > i) ? Other-i : i-Other);
+      }
+    }
+    return Width;
+  };
+
+  auto CheckUnits = [&SGraph,UnitsCount]()
+  {
+    const openfluid::core::UnitsCollection* Units = SGraph.spatialUnits("TU");
+    BOOST_REQUIRE_EQUAL(Units->size(),UnitsCount);
+
+    for (std::size_t i=0; i<Units->size(); i++)
+    {
+      BOOST_REQUIRE_EQUAL(Units->unitAt(i)->getIndex(),i);
+      BOOST_REQUIRE_EQUAL(Units->unitAt(i)->getProcessOrder(),(Units->unitAt(i)->getID() > UnitsCount-5) ? 2 : 1);
+      BOOST_REQUIRE_EQUAL(Units->spatialUnit(Units->unitAt(i)->getID()),Units->unitAt(i));
+      if (i > 0)
+        BOOST_REQUIRE(Units->unitAt(i-1)->getProcessOrder() <= Units->unitAt(i)->getProcessOrder());
+    }
+  };
+
+  SGraph.sortUnitsByLocality(openfluid::core::UnitsOrdering::DEFAULT);
+  CheckUnits();
+  std::size_t DefaultBandwidth = Bandwidth();
+
+  SGraph.sortUnitsByLocality(openfluid::core::UnitsOrdering::CUTHILL_MCKEE);
+  CheckUnits();
+  BOOST_REQUIRE_LT(Bandwidth(),DefaultBandwidth);
+  BOOST_REQUIRE_EQUAL(Bandwidth(),1);
+
+  SGraph.sortUnitsByLocality(openfluid::core::UnitsOrdering::HILBERT_CURVE);
+  CheckUnits();
+
+  // units of process order 1 are aligned, their order follows their positions along the line
+  const openfluid::core::UnitsCollection* Units = SGraph.spatialUnits("TU");
+  for (std::size_t i=1; i<UnitsCount-5; i++)
+    BOOST_REQUIRE_GT(Units->unitAt(i-1)->getID(),Units->unitAt(i)->getID());
+
+  // the order is kept by later sorts by process order, when units are added or deleted
+  SGraph.addUnit(openfluid::core::SpatialUnit("TU",UnitsCount+1,1));
+  SGraph.deleteUnit(SGraph.spatialUnit("TU",UnitsCount-5));
+  SGraph.sortUnitsByProcessOrder();
+
+  BOOST_REQUIRE_EQUAL(Units->size(),UnitsCount);
+  for (std::size_t i=1; i<UnitsCount-6; i++)
+    BOOST_REQUIRE_GT(Units->unitAt(i-1)->getID(),Units->unitAt(i)->getID());
+  BOOST_REQUIRE_EQUAL(Units->unitAt(UnitsCount-6)->getID(),UnitsCount+1);
+  BOOST_REQUIRE_EQUAL(Units->unitAt(UnitsCount-5)->getProcessOrder(),2);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_locality_ordering_without_geometry)
+{
+  openfluid::core::SpatialGraph SGraph;
+
+  for (unsigned int i=1; i<=5; i++)
+    SGraph.addUnit(openfluid::core::SpatialUnit("TU",i,1));
+
+  // units of a same process order keep their creation order
+  SGraph.sortUnitsByProcessOrder();
+  for (unsigned int i=0; i<5; i++)
+    BOOST_REQUIRE_EQUAL(SGraph.spatialUnits("TU")->unitAt(i)->getID(),i+1);
+
+  BOOST_REQUIRE_THROW(SGraph.sortUnitsByLocality(openfluid::core::UnitsOrdering::HILBERT_CURVE),
+                      openfluid::base::FrameworkException);
+
+  SGraph.sortUnitsByLocality(openfluid::core::UnitsOrdering::CUTHILL_MCKEE);
+  BOOST_REQUIRE_EQUAL(SGraph.spatialUnits("TU")->size(),5);
+}
@@ -98,7 +98,7 @@ BOOST_AUTO_TEST_CASE(check_sortbypcsorder)
 {
   openfluid::core::UnitsCollection* pUC = nullptr;
   openfluid::core::PcsOrd_t LastOrd;
-  openfluid::core::UnitsList_t::iterator it;
+  openfluid::core::UnitsList_t::const_iterator it;
 
   pUC = new openfluid::core::UnitsCollection();
 
@@ -124,3 +124,147 @@ BOOST_AUTO_TEST_CASE(check_sortbypcsorder)
   delete pUC;
 }
 
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_dense_index)
+{
+  openfluid::core::UnitsCollection UC;
+
+  for (unsigned int i=1; i<=100; i++)
+    BOOST_REQUIRE(UC.addSpatialUnit(openfluid::core::SpatialUnit("Test",i,(i*7)%5+1)) != nullptr);
+
+  openfluid::core::SpatialUnit* Unit50 = UC.spatialUnit(50);
+
+  UC.sortByProcessOrder();
+
+  BOOST_REQUIRE_EQUAL(UC.size(),100);
+  BOOST_REQUIRE_EQUAL(UC.units()->size(),100);
+  BOOST_REQUIRE_EQUAL(UC.unitsIDs()->size(),100);
+  BOOST_REQUIRE_EQUAL(UC.processOrders()->size(),100);
+  BOOST_REQUIRE_EQUAL(UC.span().size(),100);
+  BOOST_REQUIRE_EQUAL(UC.span()[0],UC.unitAt(0));
+  BOOST_REQUIRE_EQUAL(*(UC.span().end()-1),UC.unitAt(99));
+
+  // units objects are not moved by sorting
+  BOOST_REQUIRE_EQUAL(UC.spatialUnit(50),Unit50);
+
+  openfluid::core::UnitsList_t::const_iterator it = UC.list()->begin();
+  for (std::size_t i=0; i<UC.size(); i++, ++it)
+  {
+    BOOST_REQUIRE_EQUAL(UC.unitAt(i),&(*it));
+    BOOST_REQUIRE_EQUAL(UC.unitAt(i)->getIndex(),i);
+    BOOST_REQUIRE_EQUAL(UC.unitsIDs()->at(i),it->getID());
+    BOOST_REQUIRE_EQUAL(UC.processOrders()->at(i),it->getProcessOrder());
+    if (i)
+      BOOST_REQUIRE_LE(UC.processOrders()->at(i-1),UC.processOrders()->at(i));
+  }
+
+  BOOST_REQUIRE(UC.removeSpatialUnit(50));
+  BOOST_REQUIRE(!UC.removeSpatialUnit(50));
+  BOOST_REQUIRE(UC.spatialUnit(50) == nullptr);
+  BOOST_REQUIRE_EQUAL(UC.size(),99);
+  BOOST_REQUIRE_EQUAL(UC.list()->size(),99);
+
+  for (std::size_t i=0; i<UC.size(); i++)
+  {
+    BOOST_REQUIRE_EQUAL(UC.unitAt(i)->getIndex(),i);
+    BOOST_REQUIRE_EQUAL(UC.spatialUnit(UC.unitsIDs()->at(i)),UC.unitAt(i));
+  }
+
+  // copy of a collection
+  openfluid::core::UnitsCollection UC2(UC);
+  BOOST_REQUIRE_EQUAL(UC2.size(),99);
+  BOOST_REQUIRE(UC2.spatialUnit(1) != UC.spatialUnit(1));
+  BOOST_REQUIRE_EQUAL(UC2.spatialUnit(1)->getID(),1);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_remove_in_place)
+{
+  openfluid::core::UnitsCollection UC;
+
+  // unsorted process orders, so that removing a level merges its neighbour levels
+  const std::vector<openfluid::core::PcsOrd_t> PcsOrders = {1,1,2,3,3,2,2,1,4,4,4,1};
+
+  for (unsigned int i=0; i<PcsOrders.size(); i++)
+    BOOST_REQUIRE(UC.addSpatialUnit(openfluid::core::SpatialUnit("Test",i+1,PcsOrders[i])) != nullptr);
+
+  BOOST_REQUIRE_EQUAL(UC.setGhostSpatialUnits([](const openfluid::core::SpatialUnit& U)
+                                              { return U.getID() == 5 || U.getID() == 9; }),2);
+  BOOST_REQUIRE_EQUAL(UC.getLevelsCount(),7);
+
+  // dense arrays updated in place are the same as dense arrays rebuilt by a copy
+  for (openfluid::core::UnitID_t ID : {1,3,9,4,6,7,12,10,2,5,8,11})
+  {
+    BOOST_REQUIRE(UC.removeSpatialUnit(ID));
+    BOOST_REQUIRE(UC.spatialUnit(ID) == nullptr);
+
+    openfluid::core::UnitsCollection Rebuilt(UC);
+
+    BOOST_REQUIRE(*(UC.unitsIDs()) == *(Rebuilt.unitsIDs()));
+    BOOST_REQUIRE(*(UC.processOrders()) == *(Rebuilt.processOrders()));
+    BOOST_REQUIRE(*(UC.levelsOffsets()) == *(Rebuilt.levelsOffsets()));
+    BOOST_REQUIRE_EQUAL(UC.ghosts()->size(),Rebuilt.ghosts()->size());
+
+    for (std::size_t i=0; i<UC.size(); i++)
+    {
+      BOOST_REQUIRE_EQUAL(UC.unitAt(i)->getIndex(),i);
+      BOOST_REQUIRE_EQUAL(UC.spatialUnit(UC.unitsIDs()->at(i)),UC.unitAt(i));
+    }
+
+    for (std::size_t i=0; i<UC.ghosts()->size(); i++)
+    {
+      const openfluid::core::SpatialUnit* Ghost = UC.ghosts()->at(i);
+      BOOST_REQUIRE_EQUAL(Ghost->getIndex(),UC.size()+i);
+      BOOST_REQUIRE_EQUAL(UC.spatialUnit(Ghost->getID()),Ghost);
+      BOOST_REQUIRE(UC.isGhostSpatialUnit(Ghost->getID()));
+    }
+  }
+
+  BOOST_REQUIRE_EQUAL(UC.size(),0);
+  BOOST_REQUIRE_EQUAL(UC.getLevelsCount(),0);
+  BOOST_REQUIRE(UC.ghosts()->empty());
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_gather_attributes)
+{
+  openfluid::core::UnitsCollection UC;
+
+  for (unsigned int i=1; i<=10; i++)
+  {
+    openfluid::core::SpatialUnit* U = UC.addSpatialUnit(openfluid::core::SpatialUnit("Test",i,11-i));
+
+    if (i != 5)
+      BOOST_REQUIRE(U->attributes()->setValueFromRawString("area",i%2 ? "1.5" : "2"));
+  }
+
+  UC.sortByProcessOrder();
+
+  std::vector<double> Areas;
+  BOOST_REQUIRE_EQUAL(UC.gatherAttributeDoubles("area",Areas,-1.0),9);
+  BOOST_REQUIRE_EQUAL(Areas.size(),10);
+
+  for (std::size_t i=0; i<UC.size(); i++)
+  {
+    openfluid::core::UnitID_t ID = UC.unitAt(i)->getID();
+
+    if (ID == 5)
+      BOOST_REQUIRE_CLOSE(Areas[i],-1.0,0.00001);
+    else
+      BOOST_REQUIRE_CLOSE(Areas[i],ID%2 ? 1.5 : 2.0,0.00001);
+  }
+}
+
@@ -0,0 +1,202 @@
+/*
+
+  This file is part of OpenFLUID software
+  Copyright(c) 2007, INRA - Montpellier SupAgro
+
+
+ == GNU General Public License Usage ==
+
+  OpenFLUID is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OpenFLUID is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OpenFLUID. If not, see <http://www.gnu.org/licenses/>.
+
+
+ == Other Usage ==
+
+  Other Usage means a use of OpenFLUID that is inconsistent with the GPL
+  license, and requires a written agreement between You and INRA.
+  Licensees for Other Usage of OpenFLUID may use this file in accordance
+  with the terms contained in the written agreement between You and INRA.
+  
+*/
+
+
+
+/**
+  @file UnitsGrid_TEST.cpp
+
+  @author Jean-Christophe FABRE <jean-christophe.fabre@supagro.inra.fr>
+ */
+
+#define BOOST_TEST_MAIN
+#define BOOST_AUTO_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE unittest_unitsgrid
+#include <boost/test/unit_test.hpp>
+#include <boost/test/auto_unit_test.hpp>
+#include <boost/test/floating_point_comparison.hpp>
+#include <openfluid/core/UnitsGrid.hpp>
+#include <openfluid/core/SpatialGraph.hpp>
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_construction)
+{
+  openfluid::core::UnitsGrid Grid(5,7);
+
+  BOOST_REQUIRE_EQUAL(Grid.getColsNbr(),5);
+  BOOST_REQUIRE_EQUAL(Grid.getRowsNbr(),7);
+  BOOST_REQUIRE_EQUAL(Grid.getCellsCount(),35);
+
+  BOOST_REQUIRE_EQUAL(Grid.getIndex(2,3),17);
+  BOOST_REQUIRE_EQUAL(Grid.getColIndex(17),2);
+  BOOST_REQUIRE_EQUAL(Grid.getRowIndex(17),3);
+  BOOST_REQUIRE_EQUAL(Grid.getCellID(0,0),1);
+  BOOST_REQUIRE_EQUAL(Grid.getCellID(2,3),18);
+
+  BOOST_REQUIRE(Grid.isInside(4,6));
+  BOOST_REQUIRE(!Grid.isInside(5,6));
+  BOOST_REQUIRE(!Grid.isInside(-1,0));
+
+  openfluid::core::UnitsGrid::Layer_t* Layer = Grid.addLayer("water",1.5);
+  BOOST_REQUIRE(Grid.isLayerExist("water"));
+  BOOST_REQUIRE_EQUAL(Layer->getColsNbr(),5);
+  BOOST_REQUIRE_EQUAL(Layer->getRowsNbr(),7);
+  BOOST_REQUIRE_CLOSE(Layer->at(4,6),1.5,0.0001);
+
+  Layer->set(2,3,4.0);
+  BOOST_REQUIRE_CLOSE(Grid.layer("water")->data()[Grid.getIndex(2,3)],4.0,0.0001);
+
+  BOOST_REQUIRE(Grid.layer("wrong") == nullptr);
+  BOOST_REQUIRE(Grid.removeLayer("water"));
+  BOOST_REQUIRE(!Grid.isLayerExist("water"));
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_neighbours)
+{
+  openfluid::core::UnitsGrid Grid(4,3);
+  std::size_t Neighbours[openfluid::core::UnitsGrid::MaxNeighboursCount];
+
+  BOOST_REQUIRE_EQUAL(Grid.getNeighbours(Grid.getIndex(0,0),openfluid::core::GridNeighbourhood::FOUR,Neighbours),2);
+  BOOST_REQUIRE_EQUAL(Grid.getNeighbours(Grid.getIndex(0,0),openfluid::core::GridNeighbourhood::EIGHT,Neighbours),3);
+  BOOST_REQUIRE_EQUAL(Grid.getNeighbours(Grid.getIndex(1,1),openfluid::core::GridNeighbourhood::FOUR,Neighbours),4);
+  BOOST_REQUIRE_EQUAL(Grid.getNeighbours(Grid.getIndex(1,1),openfluid::core::GridNeighbourhood::EIGHT,Neighbours),8);
+  BOOST_REQUIRE_EQUAL(Neighbours[0],Grid.getIndex(2,1));
+  BOOST_REQUIRE_EQUAL(Neighbours[2],Grid.getIndex(1,2));
+
+  std::size_t Index = 0;
+  BOOST_REQUIRE(Grid.getNeighbour(Grid.getIndex(1,1),openfluid::core::UnitsGrid::D8_SE,Index));
+  BOOST_REQUIRE_EQUAL(Index,Grid.getIndex(2,2));
+  BOOST_REQUIRE(!Grid.getNeighbour(Grid.getIndex(0,0),openfluid::core::UnitsGrid::D8_N,Index));
+
+  long Offsets[openfluid::core::UnitsGrid::MaxNeighboursCount];
+  Grid.getNeighboursOffsets(Offsets);
+
+  unsigned int InteriorCount = 0;
+  Grid.forEachInteriorCell([&](unsigned long Col, unsigned long Row, std::size_t Index)
+  {
+    InteriorCount++;
+    BOOST_REQUIRE_EQUAL(Index,Grid.getIndex(Col,Row));
+    BOOST_REQUIRE_EQUAL(Index+Offsets[6],Grid.getIndex(Col,Row-1));
+    BOOST_REQUIRE_EQUAL(Index+Offsets[3],Grid.getIndex(Col-1,Row+1));
+  });
+  BOOST_REQUIRE_EQUAL(InteriorCount,2);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_d8)
+{
+  openfluid::core::UnitsGrid Grid(3,3);
+  openfluid::core::UnitsGrid::Layer_t* Elevation = Grid.addLayer("z");
+
+  // tilted plane lowering to the south-east corner
+  Grid.forEachCell([&](unsigned long Col, unsigned long Row, std::size_t Index)
+  {
+    Elevation->data()[Index] = 10.0-Col-Row;
+  });
+
+  openfluid::core::UnitsGrid::DirectionsLayer_t Directions;
+  Grid.computeD8Directions(*Elevation,Directions);
+
+  BOOST_REQUIRE_EQUAL(Directions.at(0,0),openfluid::core::UnitsGrid::D8_SE);
+  BOOST_REQUIRE_EQUAL(Directions.at(2,0),openfluid::core::UnitsGrid::D8_S);
+  BOOST_REQUIRE_EQUAL(Directions.at(0,2),openfluid::core::UnitsGrid::D8_E);
+  BOOST_REQUIRE_EQUAL(Directions.at(2,2),openfluid::core::UnitsGrid::D8_NONE);
+
+  BOOST_REQUIRE_THROW(Grid.computeD8Directions(openfluid::core::UnitsGrid::Layer_t(2,2,0.0),Directions),
+                      openfluid::base::FrameworkException);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_tiles)
+{
+  openfluid::core::UnitsGrid Grid(10,7);
+  openfluid::core::UnitsGrid::Layer_t* Layer = Grid.addLayer("count");
+  unsigned int TilesCount = 0;
+
+  Grid.forEachTile(4,3,[&](unsigned long ColBegin, unsigned long ColEnd, unsigned long RowBegin, unsigned long RowEnd)
+  {
+    TilesCount++;
+
+    for (unsigned long Col = ColBegin; Col < ColEnd; Col++)
+    {
+      double* Values = Layer->data()+Grid.getIndex(Col,0);
+
+      for (unsigned long Row = RowBegin; Row < RowEnd; Row++)
+        Values[Row] += 1.0;
+    }
+  });
+
+  BOOST_REQUIRE_EQUAL(TilesCount,9);
+
+  for (unsigned long i = 0; i < Layer->size(); i++)
+    BOOST_REQUIRE_CLOSE(Layer->data()[i],1.0,0.0001);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_graph)
+{
+  openfluid::core::SpatialGraph Graph;
+
+  Graph.addUnit(openfluid::core::SpatialUnit("SU",1,1));
+
+  BOOST_REQUIRE_THROW(Graph.addUnitsGrid("SU",10,10),openfluid::base::FrameworkException);
+
+  openfluid::core::UnitsGrid* Grid = Graph.addUnitsGrid("MU",100,50);
+  BOOST_REQUIRE(Graph.isUnitsGridExist("MU"));
+  BOOST_REQUIRE_EQUAL(Graph.unitsGrid("MU"),Grid);
+  BOOST_REQUIRE_EQUAL(Grid->getCellsCount(),5000);
+  BOOST_REQUIRE(Graph.unitsGrid("SU") == nullptr);
+
+  Graph.clearUnits();
+  BOOST_REQUIRE(!Graph.isUnitsGridExist("MU"));
+}
@@ -45,6 +45,7 @@
 #include <boost/test/unit_test.hpp>
 #include <boost/test/auto_unit_test.hpp>
 #include <boost/test/floating_point_comparison.hpp>
+#include <set>
 #include <openfluid/core/ValuesBuffer.hpp>
 #include <openfluid/core/DoubleValue.hpp>
 #include <openfluid/core/NullValue.hpp>
@@ -52,6 +53,7 @@
 #include <openfluid/core/StringValue.hpp>
 #include <openfluid/core/IntegerValue.hpp>
 #include <openfluid/core/VectorValue.hpp>
+#include <openfluid/core/MatrixValue.hpp>
 
 
 // =====================================================================
@@ -331,3 +333,44 @@ BOOST_AUTO_TEST_CASE(check_type_operations)
 
 // =====================================================================
 // =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_recycling)
+{
+  openfluid::core::ValuesBufferProperties::setBufferSize(4);
+  openfluid::core::ValuesBuffer VBuffer;
+
+  for (unsigned int i=0; i<4; i++)
+    BOOST_REQUIRE(VBuffer.appendValue(i,openfluid::core::VectorValue(10,double(i))));
+
+  std::set<const double*> Arrays;
+  for (unsigned int i=0; i<4; i++)
+    Arrays.insert(VBuffer.value(i)->asVectorValue().data());
+
+  // once the buffer is full, arrays of evicted values are reused for values of same shape
+  for (unsigned int i=4; i<50; i++)
+  {
+    BOOST_REQUIRE(VBuffer.appendValue(i,openfluid::core::VectorValue(10,double(i))));
+    BOOST_REQUIRE_EQUAL(VBuffer.getValuesCount(),4);
+    BOOST_REQUIRE_EQUAL(VBuffer.getCurrentIndex(),i);
+    BOOST_REQUIRE(!VBuffer.isValueExist(i-4));
+    BOOST_REQUIRE(Arrays.count(VBuffer.currentValue()->asVectorValue().data()));
+    BOOST_REQUIRE_EQUAL(VBuffer.currentValue()->asVectorValue().at(9),double(i));
+    BOOST_REQUIRE_EQUAL(VBuffer.value(i-3)->asVectorValue().at(0),double(i-3));
+  }
+
+  // values of another shape or another type
+  BOOST_REQUIRE(VBuffer.appendValue(50,openfluid::core::VectorValue(3,50.0)));
+  BOOST_REQUIRE_EQUAL(VBuffer.currentValue()->asVectorValue().size(),3);
+  BOOST_REQUIRE(VBuffer.appendValue(51,openfluid::core::MatrixValue(2,2,51.0)));
+  BOOST_REQUIRE(VBuffer.currentValue()->isMatrixValue());
+  BOOST_REQUIRE(VBuffer.appendValue(52,openfluid::core::DoubleValue(52.0)));
+  BOOST_REQUIRE_EQUAL(VBuffer.currentValue()->asDoubleValue().get(),52.0);
+
+  openfluid::core::IndexedValueList IValueList;
+  BOOST_REQUIRE(VBuffer.getLatestIndexedValues(49,IValueList));
+  BOOST_REQUIRE_EQUAL(IValueList.size(),4);
+  BOOST_REQUIRE_EQUAL(IValueList.front().getIndex(),49);
+  BOOST_REQUIRE_EQUAL(IValueList.front().value()->asVectorValue().at(0),49.0);
+  BOOST_REQUIRE_EQUAL(IValueList.back().getIndex(),52);
+}
@@ -44,6 +44,9 @@
 #include <boost/test/unit_test.hpp>
 #include <boost/test/auto_unit_test.hpp>
 #include <boost/test/floating_point_comparison.hpp>
+#include <chrono>
+#include <cstdint>
+#include <string>
 #include <openfluid/core/Vector.hpp>
 
 
@@ -112,3 +115,110 @@ BOOST_AUTO_TEST_CASE(check_operations)
 // =====================================================================
 // =====================================================================
 
+
+BOOST_AUTO_TEST_CASE(check_kernels)
+{
+  // sizes not multiple of SIMD packs widths
+  openfluid::core::Vector<double> V1(1003),V2(1003);
+
+  for (unsigned long i=0;i<V1.size();i++)
+  {
+    V1[i] = i*0.5;
+    V2[i] = 2.0;
+  }
+
+  // arrays are aligned
+  BOOST_REQUIRE_EQUAL(reinterpret_cast<std::uintptr_t>(V1.data()) % openfluid::core::kernels::ArraysAlignment,0);
+
+  BOOST_REQUIRE_CLOSE(V1.sum(),0.5*1002*1003/2,0.0001);
+  BOOST_REQUIRE_CLOSE(V1.dot(V2),1002*1003/2.0,0.0001);
+  BOOST_REQUIRE_EQUAL(V1.min(),0.0);
+  BOOST_REQUIRE_EQUAL(V1.max(),501.0);
+
+  V1.add(V2);
+  BOOST_REQUIRE_CLOSE(V1.at(1002),503.0,0.0001);
+  V1.multiply(V2);
+  BOOST_REQUIRE_CLOSE(V1.at(1002),1006.0,0.0001);
+  V1.divide(V2);
+  BOOST_REQUIRE_CLOSE(V1.at(1002),503.0,0.0001);
+  V1.subtract(V2);
+  BOOST_REQUIRE_CLOSE(V1.at(1002),501.0,0.0001);
+
+  V1.scale(2.0);
+  BOOST_REQUIRE_CLOSE(V1.at(1001),1001.0,0.0001);
+  V1.axpy(-0.5,V2);
+  BOOST_REQUIRE_CLOSE(V1.at(1001),1000.0,0.0001);
+  BOOST_REQUIRE_CLOSE(V1.at(0),-1.0,0.0001);
+
+  V1[17] = -3.0;
+  V1[1000] = 5000.0;
+  BOOST_REQUIRE_EQUAL(V1.min(),-3.0);
+  BOOST_REQUIRE_EQUAL(V1.max(),5000.0);
+
+  // small and empty vectors
+  openfluid::core::Vector<double> V3(3,1.5),V4;
+  BOOST_REQUIRE_CLOSE(V3.sum(),4.5,0.0001);
+  BOOST_REQUIRE_EQUAL(V3.max(),1.5);
+  BOOST_REQUIRE_EQUAL(V4.sum(),0.0);
+  BOOST_REQUIRE_THROW(V4.min(),openfluid::base::FrameworkException);
+  BOOST_REQUIRE_THROW(V1.add(V3),openfluid::base::FrameworkException);
+  BOOST_REQUIRE_THROW(V1.dot(V3),openfluid::base::FrameworkException);
+
+  // generic kernels
+  openfluid::core::Vector<int> V5(10,3),V6(10,2);
+  V5.axpy(2,V6);
+  BOOST_REQUIRE_EQUAL(V5.sum(),70);
+  BOOST_REQUIRE_EQUAL(V5.dot(V6),140);
+
+  // non trivial elements
+  openfluid::core::Vector<std::string> V7(5,"openfluid");
+  openfluid::core::Vector<std::string> V8(V7);
+  BOOST_REQUIRE_EQUAL(V8.at(4),"openfluid");
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_performance)
+{
+  const unsigned long Size = 1000;
+  const unsigned int Repeats = 20000;
+
+  openfluid::core::Vector<double> X(Size,0.5),Y(Size,1.0);
+  double* NX = new double[Size];
+  double* NY = new double[Size];
+  std::fill(NX,NX+Size,0.5);
+  std::fill(NY,NY+Size,1.0);
+
+  double NaiveDot = 0.0, KernelDot = 0.0;
+
+  auto Start = std::chrono::high_resolution_clock::now();
+  for (unsigned int r=0;r<Repeats;r++)
+  {
+    for (unsigned long i=0;i<Size;i++)
+      NY[i] += 1.0e-6*NX[i];
+    for (unsigned long i=0;i<Size;i++)
+      NaiveDot += NX[i]*NY[i];
+  }
+  auto NaiveDuration =
+    std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now()-Start);
+
+  Start = std::chrono::high_resolution_clock::now();
+  for (unsigned int r=0;r<Repeats;r++)
+  {
+    Y.axpy(1.0e-6,X);
+    KernelDot += X.dot(Y);
+  }
+  auto KernelDuration =
+    std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now()-Start);
+
+  std::cout << "Duration [naive loops], axpy+dot: " << NaiveDuration.count() << "us" << std::endl;
+  std::cout << "Duration [kernels], axpy+dot: " << KernelDuration.count() << "us" << std::endl;
+
+  BOOST_REQUIRE_CLOSE(NaiveDot,KernelDot,0.0001);
+
+  delete [] NX;
+  delete [] NY;
+}
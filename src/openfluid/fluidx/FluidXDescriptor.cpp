@@ -374,6 +374,31 @@ void FluidXDescriptor::extractRunFromNode(QDomElement& Node)
         throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
             "missing size attribute for valuesbuffer tag (" + m_CurrentFile + ")");
     }
+
+
+    // unitsordering
+
+    if (CurrNode.tagName() == QString("unitsordering"))
+    {
+      QString xmlMethod = CurrNode.attributeNode(QString("method")).value();
+
+      if (!xmlMethod.isNull())
+      {
+        std::string ReadMethodStr = xmlMethod.toStdString();
+        if (ReadMethodStr == "default")
+          m_RunDescriptor.setUnitsOrdering(openfluid::core::UnitsOrdering::DEFAULT);
+        else if (ReadMethodStr == "cuthill-mckee")
+          m_RunDescriptor.setUnitsOrdering(openfluid::core::UnitsOrdering::CUTHILL_MCKEE);
+        else if (ReadMethodStr == "hilbert")
+          m_RunDescriptor.setUnitsOrdering(openfluid::core::UnitsOrdering::HILBERT_CURVE);
+        else
+          throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                                    "wrong value for units ordering method (" + m_CurrentFile + ")");
+      }
+      else
+        throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+            "missing method attribute for unitsordering tag (" + m_CurrentFile + ")");
+    }
   }
 
   if (!FoundPeriod)
@@ -431,7 +456,8 @@ void FluidXDescriptor::extractDomainDefinitionFromNode(QDomElement& Node)
       QString xmlUnitClass = CurrNode.attributeNode(QString("class")).value();
       QString xmlPcsOrd = CurrNode.attributeNode(QString("pcsorder")).value();
 
-      if (!xmlUnitID.isNull() && !xmlUnitClass.isNull() && !xmlPcsOrd.isNull())
+      // process order is computed from connections when it is omitted or set to "auto"
+      if (!xmlUnitID.isNull() && !xmlUnitClass.isNull())
       {
         openfluid::fluidx::SpatialUnitDescriptor UnitDesc;
         openfluid::core::PcsOrd_t PcsOrder;
@@ -443,11 +469,16 @@ void FluidXDescriptor::extractDomainDefinitionFromNode(QDomElement& Node)
           throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
               "wrong format for ID in unit definition (" + m_CurrentFile + ")");
 
-        if (!openfluid::tools::convertString(xmlPcsOrd.toStdString(),&PcsOrder))
-          throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
-              "wrong format for process order in unit definition (" + m_CurrentFile + ")");
+        if (xmlPcsOrd.isEmpty() || xmlPcsOrd == QString("auto"))
+          UnitDesc.setProcessOrderComputed();
+        else
+        {
+          if (!openfluid::tools::convertString(xmlPcsOrd.toStdString(),&PcsOrder))
+            throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                "wrong format for process order in unit definition (" + m_CurrentFile + ")");
 
-        UnitDesc.setProcessOrder(PcsOrder);
+          UnitDesc.setProcessOrder(PcsOrder);
+        }
         UnitDesc.setID(UnitID);
 
 
@@ -946,8 +977,14 @@ void FluidXDescriptor::writeDomainDefinitionToStream(std::ostream& Contents)
       Units.begin(); it != Units.end(); ++it)
   {
     Contents << m_IndentStr << m_IndentStr << m_IndentStr << "<unit class=\""
-             << it->getUnitsClass() << "\" ID=\"" << it->getID()
-             << "\" pcsorder=\"" << it->getProcessOrder() << "\">\n";
+             << it->getUnitsClass() << "\" ID=\"" << it->getID() << "\" pcsorder=\"";
+
+    if (it->isProcessOrderComputed())
+      Contents << "auto";
+    else
+      Contents << it->getProcessOrder();
+
+    Contents << "\">\n";
 
     std::list<openfluid::core::UnitClassID_t>& Tos = it->toSpatialUnits();
     for (itRel = Tos.begin(); itRel != Tos.end(); ++itRel)
@@ -1113,6 +1150,12 @@ void FluidXDescriptor::writeRunConfigurationToStream(std::ostream& Contents)
       Contents << m_IndentStr << m_IndentStr << "<valuesbuffer size=\""
                << m_RunDescriptor.getValuesBufferSize() << "\" />\n";
 
+    // units ordering
+    if (m_RunDescriptor.getUnitsOrdering() == openfluid::core::UnitsOrdering::CUTHILL_MCKEE)
+      Contents << m_IndentStr << m_IndentStr << "<unitsordering method=\"cuthill-mckee\" />\n";
+    else if (m_RunDescriptor.getUnitsOrdering() == openfluid::core::UnitsOrdering::HILBERT_CURVE)
+      Contents << m_IndentStr << m_IndentStr << "<unitsordering method=\"hilbert\" />\n";
+
   }
 
   Contents << m_IndentStr << "</run>\n";
@@ -48,7 +48,8 @@ namespace openfluid { namespace fluidx {
 RunDescriptor::RunDescriptor():
   m_DeltaT(-1), m_SchedConstraint(openfluid::base::SimulationStatus::SCHED_NONE),
   m_BeginDate(openfluid::core::DateTime()), m_EndDate(openfluid::core::DateTime()),
-  m_IsUserValuesBufferSize(false), m_ValuesBufferSize(0), m_Filled(false)
+  m_IsUserValuesBufferSize(false), m_ValuesBufferSize(0),
+  m_UnitsOrdering(openfluid::core::UnitsOrdering::DEFAULT), m_Filled(false)
 {
 
 }
@@ -63,7 +64,8 @@ RunDescriptor::RunDescriptor(int DeltaT,
                              openfluid::core::DateTime EndDate):
   m_DeltaT(DeltaT), m_SchedConstraint(openfluid::base::SimulationStatus::SCHED_NONE),
   m_BeginDate(BeginDate), m_EndDate(EndDate),
-  m_IsUserValuesBufferSize(false), m_ValuesBufferSize(0), m_Filled(false)
+  m_IsUserValuesBufferSize(false), m_ValuesBufferSize(0),
+  m_UnitsOrdering(openfluid::core::UnitsOrdering::DEFAULT), m_Filled(false)
 {
 
 }
@@ -45,6 +45,7 @@
 #include <openfluid/dllexport.hpp>
 #include <openfluid/core/DateTime.hpp>
 #include <openfluid/base/SimulationStatus.hpp>
+#include <openfluid/core/UnitsCollection.hpp>
 
 
 namespace openfluid { namespace fluidx {
@@ -63,6 +64,8 @@ class OPENFLUID_API RunDescriptor
     bool m_IsUserValuesBufferSize;
     unsigned int m_ValuesBufferSize;
 
+    openfluid::core::UnitsOrdering m_UnitsOrdering;
+
    bool m_Filled;
 
   public:
@@ -109,6 +112,12 @@ class OPENFLUID_API RunDescriptor
     inline void setSchedulingConstraint(const openfluid::base::SimulationStatus::SchedulingConstraint& SConst)
     { m_SchedConstraint = SConst; };
 
+    inline openfluid::core::UnitsOrdering getUnitsOrdering() const
+    { return m_UnitsOrdering; };
+
+    inline void setUnitsOrdering(const openfluid::core::UnitsOrdering Ordering)
+    { m_UnitsOrdering = Ordering; };
+
     inline bool isFilled() const
     { return m_Filled; };
 
@@ -45,7 +45,7 @@ namespace openfluid { namespace fluidx {
 
 
 SpatialUnitDescriptor::SpatialUnitDescriptor():
-  m_UnitID(0), m_UnitsClass(""), m_PcsOrder(1)
+  m_UnitID(0), m_UnitsClass(""), m_PcsOrder(1), m_IsProcessOrderComputed(false)
 {
 
 }
@@ -56,6 +56,7 @@ class OPENFLUID_API SpatialUnitDescriptor
     openfluid::core::UnitID_t m_UnitID;
     openfluid::core::UnitsClass_t m_UnitsClass;
     openfluid::core::PcsOrd_t m_PcsOrder;
+    bool m_IsProcessOrderComputed;
     std::list<openfluid::core::UnitClassID_t> m_ToUnits;
     std::list<openfluid::core::UnitClassID_t> m_ParentUnits;
 
@@ -82,7 +83,16 @@ class OPENFLUID_API SpatialUnitDescriptor
     { return m_PcsOrder; };
 
     inline void setProcessOrder(openfluid::core::PcsOrd_t Order)
-    { m_PcsOrder = Order; };
+    { m_PcsOrder = Order; m_IsProcessOrderComputed = false; };
+
+    /**
+      Returns true if the process order of the unit is not given but computed from the connections
+    */
+    inline bool isProcessOrderComputed() const
+    { return m_IsProcessOrderComputed; };
+
+    inline void setProcessOrderComputed()
+    { m_IsProcessOrderComputed = true; };
 
     inline std::list<openfluid::core::UnitClassID_t>& toSpatialUnits()
     { return m_ToUnits; };
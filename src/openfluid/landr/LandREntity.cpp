@@ -142,6 +142,17 @@ std::set<LandREntity*>* LandREntity::neighbours()
 // =====================================================================
 
 
+void LandREntity::clearNeighbours()
+{
+  delete mp_Neighbours;
+  mp_Neighbours = nullptr;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 bool LandREntity::getAttributeValue(const std::string& AttributeName,
                                     core::Value& Value) const
 {
@@ -115,11 +115,19 @@ class OPENFLUID_API LandREntity : public geos::planargraph::GraphComponent
     // for limiting access to m_Attributes creation/deletion to LandRGraph class
     friend class LandRGraph;
 
+    // for storing and restoring attributes and neighbours state in cache files
+    friend class LandRGraphCache;
+
     /**
       @brief Computes the neighbours of this LandREntity.
     */
     virtual void computeNeighbours() = 0;
 
+    /**
+      @brief Resets the neighbours of this LandREntity, which are computed again on their next access.
+    */
+    virtual void clearNeighbours();
+
 
   public:
 
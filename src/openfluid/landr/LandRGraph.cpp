@@ -38,13 +38,22 @@
 
 
 #include <sstream>
+#include <memory>
+#include <algorithm>
+#include <unordered_map>
 
 #include <geos/planargraph/Node.h>
+#include <geos/planargraph/Edge.h>
+#include <geos/planargraph/DirectedEdge.h>
+#include <geos/planargraph/DirectedEdgeStar.h>
 #include <geos/geom/Polygon.h>
 #include <geos/geom/Point.h>
 #include <geos/geom/LineString.h>
 #include <geos/geom/LineSegment.h>
 #include <geos/geom/GeometryFactory.h>
+#include <geos/geom/Envelope.h>
+#include <geos/index/strtree/STRtree.h>
+#include <geos/index/quadtree/Quadtree.h>
 #include <geos/operation/overlay/snap/GeometrySnapper.h>
 
 #include <openfluid/landr/LandRGraph.hpp>
@@ -53,6 +62,7 @@
 #include <openfluid/landr/LineStringEntity.hpp>
 #include <openfluid/landr/VectorDataset.hpp>
 #include <openfluid/landr/RasterDataset.hpp>
+#include <openfluid/tools/ParallelHelpers.hpp>
 #include <openfluid/core/DoubleValue.hpp>
 #include <openfluid/core/IntegerValue.hpp>
 #include <openfluid/core/StringValue.hpp>
@@ -70,10 +80,29 @@ int LandRGraph::m_FileNum = 0;
 // =====================================================================
 
 
+/**
+  Creates the value of a field of a feature, typed according to the field type
+*/
+static openfluid::core::Value* createFieldValue(OGRFeature* Feat, int FieldIndex, OGRFieldType FieldType)
+{
+  if (FieldType == OFTInteger)
+    return new openfluid::core::IntegerValue(Feat->GetFieldAsInteger(FieldIndex));
+  else if (FieldType == OFTReal)
+    return new openfluid::core::DoubleValue(Feat->GetFieldAsDouble(FieldIndex));
+
+  return new openfluid::core::StringValue(Feat->GetFieldAsString(FieldIndex));
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 LandRGraph::LandRGraph() :
   geos::planargraph::PlanarGraph(),
   mp_Vector(nullptr), mp_Factory(geos::geom::GeometryFactory::getDefaultInstance()),
-  mp_Raster(nullptr), mp_RasterPolygonized(nullptr), mp_RasterPolygonizedPolys(nullptr)
+  mp_Raster(nullptr), mp_RasterPolygonized(nullptr), mp_RasterPolygonizedPolys(nullptr),
+  m_NeighboursComputed(false)
 {
 
 }
@@ -86,9 +115,11 @@ LandRGraph::LandRGraph() :
 LandRGraph::LandRGraph(openfluid::core::GeoVectorValue& Val) :
   geos::planargraph::PlanarGraph(),
   mp_Factory(geos::geom::GeometryFactory::getDefaultInstance()),
-  mp_Raster(nullptr), mp_RasterPolygonized(nullptr), mp_RasterPolygonizedPolys(nullptr)
+  mp_Raster(nullptr), mp_RasterPolygonized(nullptr), mp_RasterPolygonizedPolys(nullptr),
+  m_NeighboursComputed(false)
 {
-  mp_Vector = new VectorDataset(Val);
+  // the graph only reads the dataset, which is opened in place rather than copied
+  mp_Vector = new VectorDataset(Val,true);
 
   if (!mp_Vector)
     throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"No GeoVectorValue");
@@ -120,7 +151,8 @@ LandRGraph::LandRGraph(openfluid::core::GeoVectorValue& Val) :
 
 LandRGraph::LandRGraph(const openfluid::landr::VectorDataset& Vect) :
         geos::planargraph::PlanarGraph(), mp_Factory(geos::geom::GeometryFactory::getDefaultInstance()),
-        mp_Raster(nullptr), mp_RasterPolygonized(nullptr), mp_RasterPolygonizedPolys(nullptr)
+        mp_Raster(nullptr), mp_RasterPolygonized(nullptr), mp_RasterPolygonizedPolys(nullptr),
+  m_NeighboursComputed(false)
 {
   mp_Vector = new openfluid::landr::VectorDataset(Vect);
 
@@ -216,10 +248,9 @@ void LandRGraph::addEntitiesFromGeoVector()
     // c++ cast doesn't work (have to use C-style casting instead)
     geos::geom::Geometry* GeosGeom = (geos::geom::Geometry*) openfluid::landr::convertOGRGeometryToGEOS(OGRGeom);
 
-    addEntity(createNewEntity(GeosGeom->clone(), Feat->GetFieldAsInteger("OFLD_ID")));
+    addEntity(createNewEntity(GeosGeom, Feat->GetFieldAsInteger("OFLD_ID")));
 
     // destroying the feature destroys also the associated OGRGeom
-   delete GeosGeom;
    OGRFeature::DestroyFeature(Feat);
   }
 
@@ -255,6 +286,7 @@ geos::planargraph::Node* LandRGraph::node(const geos::geom::Coordinate& Coordina
   {
     Node = new geos::planargraph::Node(Coordinate);
     add(Node);
+    m_UnusedNodesCandidates.insert(Coordinate);
   }
 
   return Node;
@@ -265,16 +297,179 @@ geos::planargraph::Node* LandRGraph::node(const geos::geom::Coordinate& Coordina
 // =====================================================================
 
 
+void LandRGraph::remove(geos::planargraph::Edge* Edge)
+{
+  geos::planargraph::DirectedEdge* DirEdge = Edge->getDirEdge(0);
+
+  if (DirEdge)
+  {
+    if (DirEdge->getFromNode())
+      m_UnusedNodesCandidates.insert(DirEdge->getFromNode()->getCoordinate());
+    if (DirEdge->getToNode())
+      m_UnusedNodesCandidates.insert(DirEdge->getToNode()->getCoordinate());
+  }
+
+  geos::planargraph::PlanarGraph::remove(Edge);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void LandRGraph::setAttributeFromLayerId(const std::string& AttributeName, OGRLayer* Layer,
+                                         const std::string& IdColumn, const std::string& ValueColumn)
+{
+  addAttribute(AttributeName);
+
+  setlocale(LC_NUMERIC, "C");
+
+  OGRFeatureDefn* Defn = Layer->GetLayerDefn();
+  int IdIndex = Defn->GetFieldIndex(IdColumn.c_str());
+  int ValueIndex = Defn->GetFieldIndex(ValueColumn.c_str());
+  OGRFieldType ValueType = Defn->GetFieldDefn(ValueIndex)->GetType();
+
+  Layer->ResetReading();
+
+  OGRFeature* Feat;
+  while ((Feat = Layer->GetNextFeature()) != nullptr)
+  {
+    std::map<int, LandREntity*>::iterator itEntity = m_EntitiesByOfldId.find(Feat->GetFieldAsInteger(IdIndex));
+
+    if (itEntity != m_EntitiesByOfldId.end())
+      itEntity->second->setAttributeValue(AttributeName, createFieldValue(Feat,ValueIndex,ValueType));
+
+    // destroying the feature
+    OGRFeature::DestroyFeature(Feat);
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void LandRGraph::setAttributeFromLayerLocation(const std::string& AttributeName, OGRLayer* Layer,
+                                               const std::string& Column, double Thresh, unsigned int MaxThreads)
+{
+  addAttribute(AttributeName);
+
+  setlocale(LC_NUMERIC, "C");
+
+  OGRFeatureDefn* Defn = Layer->GetLayerDefn();
+  int ColumnIndex = Defn->GetFieldIndex(Column.c_str());
+  OGRFieldType ColumnType = Defn->GetFieldDefn(ColumnIndex)->GetType();
+
+
+  // features geometries are converted once and indexed
+
+  std::vector<std::unique_ptr<geos::geom::Geometry>> Geometries;
+  std::vector<std::unique_ptr<openfluid::core::Value>> Values;
+
+  Layer->ResetReading();
+
+  OGRFeature* Feat;
+  while ((Feat = Layer->GetNextFeature()) != nullptr)
+  {
+    // c++ cast doesn't work (have to use C-style casting instead)
+    Geometries.emplace_back((geos::geom::Geometry*)openfluid::landr::convertOGRGeometryToGEOS(Feat->GetGeometryRef()));
+    Values.emplace_back(createFieldValue(Feat,ColumnIndex,ColumnType));
+
+    // destroying the feature destroys also the associated OGRGeom
+    OGRFeature::DestroyFeature(Feat);
+  }
+
+  Layer->ResetReading();
+
+  std::vector<std::size_t> Indexes(Geometries.size());
+  geos::index::strtree::STRtree Index;
+
+  for (std::size_t i = 0; i < Geometries.size(); i++)
+  {
+    Indexes[i] = i;
+    Index.insert(Geometries[i]->getEnvelopeInternal(),&Indexes[i]);
+  }
+
+  // the tree is built before concurrent queries
+  Index.build();
+
+
+  // location points of the entities
+
+  std::vector<LandREntity*> Entities(m_Entities.begin(),m_Entities.end());
+  std::vector<std::unique_ptr<geos::geom::Point>> Points;
+  std::vector<geos::geom::Envelope> Envelopes;
+
+  for (LandREntity* Entity : Entities)
+  {
+    geos::geom::Point* IntPoint;
+
+    if (Entity->geometry()->getDimension() == 1)
+    {
+      const geos::geom::LineString* Line = dynamic_cast<openfluid::landr::LineStringEntity*>(Entity)->line();
+      const geos::geom::Coordinate FirstCoord = Line->getCoordinateN(0);
+      const geos::geom::Coordinate SecondCoord = Line->getCoordinateN(1);
+      geos::geom::LineSegment LineSegment(FirstCoord,SecondCoord);
+      geos::geom::Coordinate CoordInteriorPoint;
+      LineSegment.midPoint(CoordInteriorPoint);
+      IntPoint = mp_Factory->createPoint(CoordInteriorPoint);
+    }
+    else
+      IntPoint = Entity->geometry()->getInteriorPoint();
+
+    Points.emplace_back(IntPoint);
+    Envelopes.push_back(*IntPoint->getEnvelopeInternal());
+    Envelopes.back().expandBy(Thresh);
+  }
+
+
+  // the last feature within the threshold distance gives its value to the entity, as in the layer order
+
+  std::vector<long> Located(Entities.size(),-1);
+
+  openfluid::tools::runParallelRange(0,Entities.size(),[&](std::size_t Begin, std::size_t End)
+  {
+    for (std::size_t e = Begin; e < End; e++)
+    {
+      std::vector<void*> Found;
+      Index.query(&Envelopes[e],Found);
+
+      for (void* Item : Found)
+      {
+        long i = *static_cast<std::size_t*>(Item);
+
+        if (i > Located[e] && Points[e]->isWithinDistance(Geometries[i].get(),Thresh))
+          Located[e] = i;
+      }
+    }
+  },MaxThreads);
+
+  for (std::size_t e = 0; e < Entities.size(); e++)
+  {
+    if (Located[e] >= 0)
+      Entities[e]->setAttributeValue(AttributeName, Values[Located[e]]->clone());
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 void LandRGraph::removeUnusedNodes()
 {
-  std::vector<geos::planargraph::Node*>* Unused = findNodesOfDegree(0);
+  std::set<geos::geom::Coordinate,geos::geom::CoordinateLessThen>::iterator it = m_UnusedNodesCandidates.begin();
+  std::set<geos::geom::Coordinate,geos::geom::CoordinateLessThen>::iterator ite = m_UnusedNodesCandidates.end();
 
-  unsigned int UnSize=Unused->size();
-  for (unsigned int i = 0; i < UnSize; i++)
-    remove(Unused->at(i));
+  for (; it != ite; ++it)
+  {
+    geos::planargraph::Node* Node = findNode(*it);
 
-  delete Unused;
+    if (Node && Node->getDegree() == 0)
+      remove(Node);
+  }
 
+  m_UnusedNodesCandidates.clear();
 }
 
 
@@ -531,25 +726,22 @@ double LandRGraph::getRasterValueForEntityCentroid(const LandREntity& Entity)
 
 void LandRGraph::setAttributeFromRasterValueAtCentroid(const std::string& AttributeName)
 {
+  if (!mp_Raster)
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"No raster associated to the LandRGraph");
+
   addAttribute(AttributeName);
 
-  LandRGraph::Entities_t::iterator it = m_Entities.begin();
-  LandRGraph::Entities_t::iterator ite = m_Entities.end();
-  for (; it != ite; ++it)
-  {
-    double* Val = new double (getRasterValueForEntityCentroid(*const_cast<LandREntity*>(*it)));
+  // centroids values are sampled at once, grouped by raster blocks
+  std::vector<geos::geom::Coordinate> Coos;
 
-    if (!Val)
-    {
-      std::ostringstream s;
-      s << "No raster value for entity " << (*it)->getOfldId() << " centroid.";
+  for (LandREntity* Entity : m_Entities)
+    Coos.push_back(*Entity->centroid()->getCoordinate());
 
-      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, s.str());
-    }
+  std::vector<float> Values = mp_Raster->getValuesOfCoordinates(Coos);
 
-    (*it)->setAttributeValue(AttributeName, new core::DoubleValue(*Val));
-    delete Val;
-  }
+  unsigned int i = 0;
+  for (LandREntity* Entity : m_Entities)
+    Entity->setAttributeValue(AttributeName, new core::DoubleValue(Values[i++]));
 }
 
 
@@ -557,14 +749,89 @@ void LandRGraph::setAttributeFromRasterValueAtCentroid(const std::string& Attrib
 // =====================================================================
 
 
-void LandRGraph::computeNeighbours()
+LandRGraph::NeighboursAdjacency LandRGraph::computeNeighbours(unsigned int MaxThreads)
 {
-  LandRGraph::Entities_t::iterator it = m_Entities.begin();
-  LandRGraph::Entities_t::iterator ite = m_Entities.end();
+  NeighboursAdjacency Adjacency;
+  Adjacency.Entities.assign(m_Entities.begin(),m_Entities.end());
 
-  for (; it != ite; ++it)
-    (*it)->computeNeighbours();
+  std::unordered_map<const LandREntity*,unsigned int> Ranks;
+  for (unsigned int i = 0; i < Adjacency.Entities.size(); i++)
+    Ranks[Adjacency.Entities[i]] = i;
+
+  std::vector<unsigned int> IncOffsets;
+  std::vector<unsigned int> Incidents;
+  computeIncidences(Ranks,IncOffsets,Incidents);
+
+  // each entity incident to a linking element gets the other incident entities as neighbours
+
+  Adjacency.Offsets.assign(Adjacency.Entities.size()+1,0);
+  for (unsigned int e = 0; e+1 < IncOffsets.size(); e++)
+  {
+    for (unsigned int k = IncOffsets[e]; k < IncOffsets[e+1]; k++)
+      Adjacency.Offsets[Incidents[k]+1] += IncOffsets[e+1]-IncOffsets[e]-1;
+  }
+
+  for (unsigned int i = 0; i < Adjacency.Entities.size(); i++)
+    Adjacency.Offsets[i+1] += Adjacency.Offsets[i];
+
+  Adjacency.Neighbours.resize(Adjacency.Offsets.back());
+  std::vector<unsigned int> Positions(Adjacency.Offsets.begin(),Adjacency.Offsets.end()-1);
+
+  for (unsigned int e = 0; e+1 < IncOffsets.size(); e++)
+  {
+    for (unsigned int k = IncOffsets[e]; k < IncOffsets[e+1]; k++)
+    {
+      for (unsigned int l = IncOffsets[e]; l < IncOffsets[e+1]; l++)
+      {
+        if (l != k)
+          Adjacency.Neighbours[Positions[Incidents[k]]++] = Incidents[l];
+      }
+    }
+  }
+
+  std::vector<unsigned int>().swap(Incidents);
+  std::vector<unsigned int>().swap(Positions);
+
+  // entities sharing several linking elements appear several times in a row,
+  // each row only is written by its own thread
+
+  std::vector<unsigned int> RowsSizes(Adjacency.Entities.size());
+
+  openfluid::tools::runParallelRange(0,Adjacency.Entities.size(),
+                                     [&Adjacency,&RowsSizes](std::size_t Begin, std::size_t End)
+  {
+    for (std::size_t i = Begin; i < End; i++)
+    {
+      std::vector<unsigned int>::iterator itB = Adjacency.Neighbours.begin()+Adjacency.Offsets[i];
+      std::vector<unsigned int>::iterator itE = Adjacency.Neighbours.begin()+Adjacency.Offsets[i+1];
+
+      std::sort(itB,itE);
+      RowsSizes[i] = std::unique(itB,itE)-itB;
+    }
+  },MaxThreads);
 
+  unsigned int Size = 0;
+  for (unsigned int i = 0; i < Adjacency.Entities.size(); i++)
+  {
+    std::copy(Adjacency.Neighbours.begin()+Adjacency.Offsets[i],
+              Adjacency.Neighbours.begin()+Adjacency.Offsets[i]+RowsSizes[i],
+              Adjacency.Neighbours.begin()+Size);
+    Adjacency.Offsets[i] = Size;
+    Size += RowsSizes[i];
+  }
+  Adjacency.Offsets.back() = Size;
+
+  Adjacency.Neighbours.resize(Size);
+  Adjacency.Neighbours.shrink_to_fit();
+
+  // the neighbours of the entities are not duplicated, they are computed again on their next access
+
+  for (LandREntity* Entity : m_Entities)
+    Entity->clearNeighbours();
+
+  m_NeighboursComputed = true;
+
+  return Adjacency;
 }
 
 
@@ -657,42 +924,7 @@ void LandRGraph::setAttributeFromVectorId(const std::string& AttributeName,
     throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, s.str());
   }
 
-  addAttribute(AttributeName);
-
-  setlocale(LC_NUMERIC, "C");
-
-  OGRLayer* Layer0 = Vector.layer(0);
-  Layer0->ResetReading();
-
-  int columnIndex=Vector.getFieldIndex(ValueColumn);
-  OGRFeature* Feat;
-  while ((Feat = Layer0->GetNextFeature()) != nullptr)
-  {
-    int OfldId=Feat->GetFieldAsInteger(IdColumn.c_str());
-    openfluid::landr::LandREntity* Entity=entity(OfldId);
-
-    if (Entity)
-    {
-      if (Vector.isFieldOfType(ValueColumn, OFTInteger))
-      {
-        int value=Feat->GetFieldAsInteger(columnIndex);
-        Entity->setAttributeValue(AttributeName, new openfluid::core::IntegerValue(value));
-      }
-      else if (Vector.isFieldOfType(ValueColumn, OFTReal))
-      {
-        double value=Feat->GetFieldAsDouble(columnIndex);
-        Entity->setAttributeValue(AttributeName, new openfluid::core::DoubleValue(value));
-      }
-      else
-      {
-        std::string value=Feat->GetFieldAsString(columnIndex);
-        Entity->setAttributeValue(AttributeName, new openfluid::core::StringValue(value));
-      }
-    }
-
-    // destroying the feature
-    OGRFeature::DestroyFeature(Feat);
-  }
+  setAttributeFromLayerId(AttributeName,Vector.layer(0),IdColumn,ValueColumn);
 }
 
 
@@ -720,41 +952,7 @@ void LandRGraph::setAttributeFromVectorId(const std::string& AttributeName,
     throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, s.str());
   }
 
-  addAttribute(AttributeName);
-
-  setlocale(LC_NUMERIC, "C");
-
-  OGRLayer* Layer0 = Vector.layer(0);
-  Layer0->ResetReading();
-
-  int columnIndex=Vector.getFieldIndex(ValueColumn);
-  OGRFeature* Feat;
-  while ((Feat = Layer0->GetNextFeature()) != nullptr)
-  {
-    int OfldId=Feat->GetFieldAsInteger(IdColumn.c_str());
-    openfluid::landr::LandREntity* Entity=entity(OfldId);
-    if (Entity)
-    {
-      if (Vector.isFieldOfType(ValueColumn, OFTInteger))
-      {
-        int value=Feat->GetFieldAsInteger(columnIndex);
-        Entity->setAttributeValue(AttributeName, new openfluid::core::IntegerValue(value));
-      }
-      else if (Vector.isFieldOfType(ValueColumn, OFTReal))
-      {
-        double value=Feat->GetFieldAsDouble(columnIndex);
-        Entity->setAttributeValue(AttributeName, new openfluid::core::DoubleValue(value));
-      }
-      else
-      {
-        std::string value=Feat->GetFieldAsString(columnIndex);
-        Entity->setAttributeValue(AttributeName, new openfluid::core::StringValue(value));
-      }
-    }
-
-    // destroying the feature
-    OGRFeature::DestroyFeature(Feat);
-  }
+  setAttributeFromLayerId(AttributeName,Vector.layer(0),IdColumn,ValueColumn);
 }
 
 
@@ -764,25 +962,43 @@ void LandRGraph::setAttributeFromVectorId(const std::string& AttributeName,
 
 void LandRGraph::snapVertices(double snapTolerance)
 {
+  // entities are indexed by their envelopes, so each entity is only snapped to the entities
+  // having vertices within the snap tolerance, which are the only ones the snapper can use
+
+  geos::index::quadtree::Quadtree EntitiesIndex;
+  std::map<int,geos::geom::Envelope> EntitiesEnvelopes;
+
   LandRGraph::Entities_t::iterator it = m_Entities.begin();
   LandRGraph::Entities_t::iterator ite = m_Entities.end();
   std::list<int> listOfldId;
   for (; it != ite; ++it)
+  {
     listOfldId.push_back((*it)->getOfldId());
+    EntitiesEnvelopes[listOfldId.back()] = *((*it)->geometry()->getEnvelopeInternal());
+  }
 
   std::list<int>::iterator li=listOfldId.begin();
   std::list<int>::iterator lie=listOfldId.end();
 
   for (; li != lie; ++li)
+    EntitiesIndex.insert(&EntitiesEnvelopes[*li],&(*li));
+
+  for (li=listOfldId.begin(); li != lie; ++li)
   {
+    geos::geom::Envelope SearchEnv(EntitiesEnvelopes[*li]);
+    SearchEnv.expandBy(snapTolerance);
+
+    std::vector<void*> Candidates;
+    EntitiesIndex.query(&SearchEnv,Candidates);
+
     std::vector<geos::geom::Geometry*> entitiesGeoms;
-    LandRGraph::Entities_t::iterator jt = m_Entities.begin();
-    LandRGraph::Entities_t::iterator jte = m_Entities.end();
 
-    for (; jt != jte; ++jt)
+    for (unsigned int i = 0; i < Candidates.size(); i++)
     {
-      if (static_cast<unsigned>(*li)!=(*jt)->getOfldId())
-        entitiesGeoms.push_back(const_cast<geos::geom::Geometry*>((*jt)->geometry()));
+      int CandidateId = *(static_cast<int*>(Candidates[i]));
+
+      if (CandidateId != *li && SearchEnv.intersects(EntitiesEnvelopes[CandidateId]))
+        entitiesGeoms.push_back(const_cast<geos::geom::Geometry*>(entity(CandidateId)->geometry()));
     }
 
     geos::geom::Geometry* entitiesGeom =
@@ -792,11 +1008,19 @@ void LandRGraph::snapVertices(double snapTolerance)
     std::unique_ptr<geos::geom::Geometry> snapEntityGeom=geomSnapper.snapTo(*entitiesGeom,snapTolerance);
     geos::geom::Geometry* snappedEntityGeom=snapEntityGeom.release();
 
+    EntitiesIndex.remove(&EntitiesEnvelopes[*li],&(*li));
+
     removeEntity(*(li));
     addEntity(createNewEntity(snappedEntityGeom,(*li)));
 
     removeUnusedNodes();
 
+    if (entity(*li))
+    {
+      EntitiesEnvelopes[*li] = *(entity(*li)->geometry()->getEnvelopeInternal());
+      EntitiesIndex.insert(&EntitiesEnvelopes[*li],&(*li));
+    }
+
     delete entitiesGeom;
   }
 }
@@ -810,7 +1034,8 @@ void LandRGraph::snapVertices(double snapTolerance)
 void LandRGraph::setAttributeFromVectorLocation(const std::string& AttributeName,
                                                 openfluid::core::GeoVectorValue& Vector,
                                                 const std::string& Column,
-                                                double Thresh)
+                                                double Thresh,
+                                                unsigned int MaxThreads)
 {
   if (!Vector.isPolygonType()&&!Vector.isLineType())
     throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Vector is not Line nor Polygon type");
@@ -824,69 +1049,7 @@ void LandRGraph::setAttributeFromVectorLocation(const std::string& AttributeName
     throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, s.str());
   }
 
-  addAttribute(AttributeName);
-
-  setlocale(LC_NUMERIC, "C");
-
-  OGRLayer* Layer0 = Vector.layer(0);
-  Layer0->ResetReading();
-
-  int columnIndex=Vector.getFieldIndex(Column);
-
-
-  LandRGraph::Entities_t::iterator it = m_Entities.begin();
-  LandRGraph::Entities_t::iterator ite = m_Entities.end();
-
-  for (; it != ite; ++it)
-  {
-    geos::geom::Point* IntPoint;
-    if((*it)->geometry()->getDimension() == 1)
-    {
-      const geos::geom::LineString* Line = dynamic_cast<openfluid::landr::LineStringEntity*>(*it)->line();
-      const geos::geom::Coordinate FirstCoord = Line->getCoordinateN(0);
-      const geos::geom::Coordinate SecondCoord = Line->getCoordinateN(1);
-      geos::geom::LineSegment LineSegment(FirstCoord,SecondCoord);
-      geos::geom::Coordinate CoordInteriorPoint;
-      LineSegment.midPoint(CoordInteriorPoint);
-      IntPoint = mp_Factory->createPoint(CoordInteriorPoint);
-    }
-    else
-      IntPoint=(*it)->geometry()->getInteriorPoint();
-
-    OGRFeature* Feat;
-    while ((Feat = Layer0->GetNextFeature()) != nullptr)
-    {
-      OGRGeometry* OGRGeom = Feat->GetGeometryRef();
-
-      // c++ cast doesn't work (have to use C-style casting instead)
-      geos::geom::Geometry* GeosGeom =
-          (geos::geom::Geometry*)openfluid::landr::convertOGRGeometryToGEOS(OGRGeom);
-
-      if (IntPoint->isWithinDistance(GeosGeom,Thresh))
-      {
-        if (Vector.isFieldOfType(Column, OFTInteger))
-        {
-          int value=Feat->GetFieldAsInteger(columnIndex);
-          (*it)->setAttributeValue(AttributeName, new openfluid::core::IntegerValue(value));
-        }
-        else if (Vector.isFieldOfType(Column, OFTReal))
-        {
-          double value=Feat->GetFieldAsDouble(columnIndex);
-          (*it)->setAttributeValue(AttributeName, new openfluid::core::DoubleValue(value));
-        }
-        else
-        {
-          std::string value=Feat->GetFieldAsString(columnIndex);
-          (*it)->setAttributeValue(AttributeName, new openfluid::core::StringValue(value));
-        }
-      }
-      // destroying the feature destroys also the associated OGRGeom
-      OGRFeature::DestroyFeature(Feat);
-      delete GeosGeom;
-    }
-
-    Layer0->ResetReading();
-  }
+  setAttributeFromLayerLocation(AttributeName,Vector.layer(0),Column,Thresh,MaxThreads);
 }
 
 
@@ -897,7 +1060,8 @@ void LandRGraph::setAttributeFromVectorLocation(const std::string& AttributeName
 void LandRGraph::setAttributeFromVectorLocation(const std::string& AttributeName,
                                                 openfluid::landr::VectorDataset& Vector,
                                                 const std::string& Column,
-                                                double Thresh)
+                                                double Thresh,
+                                                unsigned int MaxThreads)
 {
   if (!Vector.isPolygonType()&&!Vector.isLineType())
     throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Vector is not Line nor Polygon type");
@@ -911,71 +1075,7 @@ void LandRGraph::setAttributeFromVectorLocation(const std::string& AttributeName
     throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, s.str());
   }
 
-  addAttribute(AttributeName);
-
-  setlocale(LC_NUMERIC, "C");
-
-  OGRLayer* Layer0 = Vector.layer(0);
-  Layer0->ResetReading();
-
-  int columnIndex=Vector.getFieldIndex(Column);
-
-
-  LandRGraph::Entities_t::iterator it = m_Entities.begin();
-  LandRGraph::Entities_t::iterator ite = m_Entities.end();
-
-
-  for (; it != ite; ++it)
-  {
-    geos::geom::Point* IntPoint;
-    if((*it)->geometry()->getDimension() == 1)
-    {
-      const geos::geom::LineString* Line = dynamic_cast<openfluid::landr::LineStringEntity*>(*it)->line();
-      const geos::geom::Coordinate FirstCoord = Line->getCoordinateN(0);
-      const geos::geom::Coordinate SecondCoord = Line->getCoordinateN(1);
-      geos::geom::LineSegment LineSegment(FirstCoord,SecondCoord);
-      geos::geom::Coordinate CoordInteriorPoint;
-      LineSegment.midPoint(CoordInteriorPoint);
-      IntPoint = mp_Factory->createPoint(CoordInteriorPoint);
-    }
-    else
-      IntPoint=(*it)->geometry()->getInteriorPoint();
-
-    OGRFeature* Feat;
-    while ((Feat = Layer0->GetNextFeature()) != nullptr)
-    {
-      OGRGeometry* OGRGeom = Feat->GetGeometryRef();
-
-      // c++ cast doesn't work (have to use the C API instead)
-      geos::geom::Geometry* GeosGeom =
-          (geos::geom::Geometry*) openfluid::landr::convertOGRGeometryToGEOS(OGRGeom);
-
-
-      if(IntPoint->isWithinDistance(GeosGeom,Thresh))
-      {
-        if (Vector.isFieldOfType(Column, OFTInteger))
-        {
-          int value=Feat->GetFieldAsInteger(columnIndex);
-          (*it)->setAttributeValue(AttributeName, new openfluid::core::IntegerValue(value));
-        }
-        else if (Vector.isFieldOfType(Column, OFTReal))
-        {
-          double value=Feat->GetFieldAsDouble(columnIndex);
-          (*it)->setAttributeValue(AttributeName, new openfluid::core::DoubleValue(value));
-        }
-        else
-        {
-          std::string value=Feat->GetFieldAsString(columnIndex);
-          (*it)->setAttributeValue(AttributeName, new openfluid::core::StringValue(value));
-        }
-
-      }
-      // destroying the feature destroys also the associated OGRGeom
-      OGRFeature::DestroyFeature(Feat);
-      delete GeosGeom;
-    }
-    Layer0->ResetReading();
-  }
+  setAttributeFromLayerLocation(AttributeName,Vector.layer(0),Column,Thresh,MaxThreads);
 }
 
 
@@ -41,10 +41,14 @@
 
 
 #include <list>
+#include <set>
+#include <unordered_map>
+#include <vector>
 
 #include <ogrsf_frmts.h>
 
 #include <geos/planargraph/PlanarGraph.h>
+#include <geos/geom/Coordinate.h>
 
 #include <openfluid/dllexport.hpp>
 
@@ -59,6 +63,7 @@ class Coordinate;
 
 namespace planargraph {
 class Node;
+class Edge;
 }
 
 namespace openfluid {
@@ -91,6 +96,20 @@ class OPENFLUID_API LandRGraph: public geos::planargraph::PlanarGraph
 
     typedef std::list<LandREntity*> Entities_t;
 
+    /**
+      @brief Compact adjacency of the LandREntity of a LandRGraph, in compressed sparse row layout.
+      @details The neighbours of Entities[i] are the entities of ranks Neighbours[Offsets[i]]
+      to Neighbours[Offsets[i+1]-1] in Entities, in ascending order.
+    */
+    struct NeighboursAdjacency
+    {
+      std::vector<LandREntity*> Entities;
+
+      std::vector<unsigned int> Offsets;
+
+      std::vector<unsigned int> Neighbours;
+    };
+
 
   protected:
     /**
@@ -128,8 +147,21 @@ class OPENFLUID_API LandRGraph: public geos::planargraph::PlanarGraph
     */
     std::vector<geos::geom::Polygon*>* mp_RasterPolygonizedPolys;
 
+    /**
+      @brief The coordinates of the nodes created or detached from an edge since the last removal of unused nodes,
+      which are the only nodes that may be of degree 0.
+    */
+    std::set<geos::geom::Coordinate,geos::geom::CoordinateLessThen> m_UnusedNodesCandidates;
+
+    /**
+      @brief True if the neighbours of the LandREntity of this LandRGraph were computed by computeNeighbours().
+    */
+    bool m_NeighboursComputed;
+
     static int m_FileNum;
 
+    friend class LandRGraphCache;
+
     LandRGraph();
 
     /**
@@ -166,6 +198,18 @@ class OPENFLUID_API LandRGraph: public geos::planargraph::PlanarGraph
     virtual LandREntity* createNewEntity(const geos::geom::Geometry* Geom,
                                       unsigned int OfldId) = 0;
 
+    /**
+      @brief Gets the incidences between the linking elements of this LandRGraph and its LandREntity,
+      the linking elements being the edges or the nodes shared by neighbour LandREntity, according to its type.
+      @details The ranks of the LandREntity incident to the linking element i are Incidents[Offsets[i]]
+      to Incidents[Offsets[i+1]-1], without duplicates. Linking elements with less than two LandREntity are skipped.
+      @param Ranks The ranks of the LandREntity of this LandRGraph.
+      @param Offsets The offsets of the incident LandREntity of each linking element, filled by this method.
+      @param Incidents The ranks of the incident LandREntity, filled by this method.
+    */
+    virtual void computeIncidences(const std::unordered_map<const LandREntity*,unsigned int>& Ranks,
+                                   std::vector<unsigned int>& Offsets, std::vector<unsigned int>& Incidents) = 0;
+
     /**
       @brief Returns a geos::planagraph::Node of this LandRGraph from a geos::geom::Coordinate.
       @param Coordinate A geos::geom::Coordinate.
@@ -173,6 +217,23 @@ class OPENFLUID_API LandRGraph: public geos::planargraph::PlanarGraph
     */
     geos::planargraph::Node* node(const geos::geom::Coordinate& Coordinate);
 
+    /**
+      @brief Creates a new attribute for all the LandREntity of this LandRGraph, and set for each LandREntity
+      this attribute value as the value of the layer feature with the entity ID number.
+      @details The features are read once, the field types being resolved once for the whole layer.
+    */
+    void setAttributeFromLayerId(const std::string& AttributeName, OGRLayer* Layer,
+                                 const std::string& IdColumn, const std::string& ValueColumn);
+
+    /**
+      @brief Creates a new attribute for all the LandREntity of this LandRGraph, and set for each LandREntity
+      this attribute value as the value of the last layer feature within the threshold distance of the entity.
+      @details The features geometries are converted once and indexed in a spatial index,
+      which is queried concurrently for all the LandREntity.
+    */
+    void setAttributeFromLayerLocation(const std::string& AttributeName, OGRLayer* Layer,
+                                       const std::string& Column, double Thresh, unsigned int MaxThreads);
+
   public:
 
     /**
@@ -212,9 +273,18 @@ class OPENFLUID_API LandRGraph: public geos::planargraph::PlanarGraph
 
     /**
       @brief Removes from this LandRGraph the nodes of degree 0.
+      @details Only the nodes created or detached from an edge since the previous call are checked.
     */
     void removeUnusedNodes();
 
+    using geos::planargraph::PlanarGraph::remove;
+
+    /**
+      @brief Removes an edge from this LandRGraph, keeping its end nodes as candidates for removeUnusedNodes().
+      @param Edge The geos::planargraph::Edge to remove.
+    */
+    void remove(geos::planargraph::Edge* Edge);
+
     /**
       @brief Adds an attribute to this LandRGraph.
       @details Doesn't reset if the AttributeName already exists.
@@ -288,8 +358,14 @@ class OPENFLUID_API LandRGraph: public geos::planargraph::PlanarGraph
 
     /**
       @brief Computes the LandREntity neighbours of each LandREntity of this LandRGraph, according to its type.
+      @details The adjacency is built in a single pass over the incidences of the edges or nodes of this LandRGraph,
+      then its rows are sorted concurrently, this LandRGraph must not be modified meanwhile.
+      The neighbours of each LandREntity are reset and computed again on their next access.
+      @param MaxThreads The maximum number of threads to use,
+      0 (default) uses the ideal number of threads of the running host.
+      @return The compact adjacency of the LandREntity of this LandRGraph, in the order of getEntities().
     */
-    void computeNeighbours();
+    NeighboursAdjacency computeNeighbours(unsigned int MaxThreads = 0);
 
     /**
       @brief Creates on disk a shapefile representing this LandRGraph.
@@ -332,10 +408,13 @@ class OPENFLUID_API LandRGraph: public geos::planargraph::PlanarGraph
       @param Column The column of the core::GeoVectorValue to upload.
       @param Thresh The threshold of minimum distance between
       the core::GeoVectorValue geometry and the LandRGraph geometry.
+      @param MaxThreads The maximum number of threads used to locate the entities,
+      0 (default) uses the ideal number of threads.
     */
     virtual void setAttributeFromVectorLocation(const std::string& AttributeName,
                                                 openfluid::core::GeoVectorValue& Vector,
-                                                const std::string& Column,double Thresh=0.0001);
+                                                const std::string& Column,double Thresh=0.0001,
+                                                unsigned int MaxThreads=0);
 
     /**
       @brief Creates a new attribute for all the LandREntity of this LandRGraph, and set for each LandREntity
@@ -344,10 +423,13 @@ class OPENFLUID_API LandRGraph: public geos::planargraph::PlanarGraph
       @param Vector The Name of the VectorDataset.
       @param Column The column of the VectorDataset to upload.
       @param Thresh The threshold of minimum distance between the VectorDataset geometry and the LandRGraph geometry.
+      @param MaxThreads The maximum number of threads used to locate the entities,
+      0 (default) uses the ideal number of threads.
     */
     virtual void setAttributeFromVectorLocation(const std::string& AttributeName,
                                                 openfluid::landr::VectorDataset& Vector,
-                                                const std::string& Column,double Thresh=0.0001);
+                                                const std::string& Column,double Thresh=0.0001,
+                                                unsigned int MaxThreads=0);
 
     /**
       @brief Removes a LandREntity with identifier from this LandRGraph.
@@ -0,0 +1,666 @@
+/*
+
+  This file is part of OpenFLUID software
+  Copyright(c) 2007, INRA - Montpellier SupAgro
+
+
+ == GNU General Public License Usage ==
+
+  OpenFLUID is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OpenFLUID is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OpenFLUID. If not, see <http://www.gnu.org/licenses/>.
+
+
+ == Other Usage ==
+
+  Other Usage means a use of OpenFLUID that is inconsistent with the GPL
+  license, and requires a written agreement between You and INRA.
+  Licensees for Other Usage of OpenFLUID may use this file in accordance
+  with the terms contained in the written agreement between You and INRA.
+
+*/
+
+
+/**
+  @file LandRGraphCache.cpp
+
+  @author Jean-Christophe Fabre <jean-christophe.fabre@supagro.inra.fr>
+ */
+
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+#include <vector>
+#include <map>
+
+#include <ogr_geometry.h>
+
+#include <geos/geom/Geometry.h>
+#include <geos/geom/LineString.h>
+#include <geos/geom/Polygon.h>
+
+#include <openfluid/landr/LandRGraphCache.hpp>
+#include <openfluid/landr/GEOSHelpers.hpp>
+#include <openfluid/landr/PolygonGraph.hpp>
+#include <openfluid/landr/PolygonEdge.hpp>
+#include <openfluid/landr/LineStringGraph.hpp>
+#include <openfluid/core/BooleanValue.hpp>
+#include <openfluid/core/IntegerValue.hpp>
+#include <openfluid/core/DoubleValue.hpp>
+#include <openfluid/core/StringValue.hpp>
+#include <openfluid/core/NullValue.hpp>
+#include <openfluid/tools/Filesystem.hpp>
+#include <openfluid/base/FrameworkException.hpp>
+
+
+namespace openfluid { namespace landr {
+
+
+const unsigned int LandRGraphCache::FormatVersion = 1;
+
+static const char CacheMagic[8] = {'O','F','L','R','G','R','P','H'};
+
+
+// =====================================================================
+// =====================================================================
+
+
+template<typename T>
+static void writePOD(std::ostream& Stream, const T& Val)
+{
+  Stream.write(reinterpret_cast<const char*>(&Val),sizeof(T));
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+template<typename T>
+static T readPOD(std::istream& Stream)
+{
+  T Val = T();
+
+  if (!Stream.read(reinterpret_cast<char*>(&Val),sizeof(T)))
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Unexpected end of cache file");
+
+  return Val;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+static void writeString(std::ostream& Stream, const std::string& Str)
+{
+  writePOD<std::uint32_t>(Stream,Str.size());
+  Stream.write(Str.data(),Str.size());
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+static std::string readString(std::istream& Stream)
+{
+  std::uint32_t Size = readPOD<std::uint32_t>(Stream);
+  std::string Str;
+
+  // read by chunks so that a corrupted size can not trigger a huge allocation
+  char Buffer[4096];
+
+  while (Size > 0)
+  {
+    std::uint32_t ChunkSize = std::min<std::uint32_t>(Size,sizeof(Buffer));
+
+    if (!Stream.read(Buffer,ChunkSize))
+      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Unexpected end of cache file");
+
+    Str.append(Buffer,ChunkSize);
+    Size -= ChunkSize;
+  }
+
+  return Str;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+static void writeGeometry(std::ostream& Stream, const geos::geom::Geometry* Geom)
+{
+  OGRGeometry* OGRGeom = openfluid::landr::convertGEOSGeometryToOGR((GEOSGeom) Geom);
+
+  if (!OGRGeom)
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Unable to convert geometry for cache file");
+
+  std::string WKB(OGRGeom->WkbSize(),'\0');
+  OGRGeom->exportToWkb(wkbNDR,reinterpret_cast<unsigned char*>(&WKB[0]));
+  OGRGeometryFactory::destroyGeometry(OGRGeom);
+
+  writeString(Stream,WKB);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+static geos::geom::Geometry* readGeometry(std::istream& Stream)
+{
+  std::string WKB = readString(Stream);
+  OGRGeometry* OGRGeom = nullptr;
+
+  if (WKB.empty() ||
+      OGRGeometryFactory::createFromWkb(reinterpret_cast<unsigned char*>(&WKB[0]),nullptr,&OGRGeom,WKB.size())
+      != OGRERR_NONE || !OGRGeom)
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Invalid geometry in cache file");
+
+  geos::geom::Geometry* Geom = (geos::geom::Geometry*) openfluid::landr::convertOGRGeometryToGEOS(OGRGeom);
+  OGRGeometryFactory::destroyGeometry(OGRGeom);
+
+  if (!Geom)
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Invalid geometry in cache file");
+
+  return Geom;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+static void writeValue(std::ostream& Stream, const openfluid::core::Value* Val)
+{
+  if (!Val)
+  {
+    writePOD<std::uint32_t>(Stream,openfluid::core::Value::NONE);
+    return;
+  }
+
+  writePOD<std::uint32_t>(Stream,Val->getType());
+
+  switch (Val->getType())
+  {
+    case openfluid::core::Value::BOOLEAN:
+      writePOD<std::uint8_t>(Stream,Val->asBooleanValue().get());
+      break;
+    case openfluid::core::Value::INTEGER:
+      writePOD<std::int64_t>(Stream,Val->asIntegerValue().get());
+      break;
+    case openfluid::core::Value::DOUBLE:
+      writePOD<double>(Stream,Val->asDoubleValue().get());
+      break;
+    case openfluid::core::Value::STRING:
+      writeString(Stream,Val->asStringValue().get());
+      break;
+    case openfluid::core::Value::NULLL:
+      break;
+    default:
+      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                                "Attribute value of type " +
+                                                openfluid::core::Value::getStringFromValueType(Val->getType()) +
+                                                " can not be stored in cache file");
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+static openfluid::core::Value* readValue(std::istream& Stream)
+{
+  std::uint32_t Type = readPOD<std::uint32_t>(Stream);
+
+  switch (Type)
+  {
+    case openfluid::core::Value::NONE:
+      return nullptr;
+    case openfluid::core::Value::BOOLEAN:
+      return new openfluid::core::BooleanValue(readPOD<std::uint8_t>(Stream) != 0);
+    case openfluid::core::Value::INTEGER:
+      return new openfluid::core::IntegerValue(static_cast<long>(readPOD<std::int64_t>(Stream)));
+    case openfluid::core::Value::DOUBLE:
+      return new openfluid::core::DoubleValue(readPOD<double>(Stream));
+    case openfluid::core::Value::STRING:
+      return new openfluid::core::StringValue(readString(Stream));
+    case openfluid::core::Value::NULLL:
+      return new openfluid::core::NullValue();
+    default:
+      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Invalid attribute value in cache file");
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+static bool readHeader(std::istream& Stream, const std::string& Key, unsigned int GraphType)
+{
+  char Magic[sizeof(CacheMagic)];
+
+  if (!Stream.read(Magic,sizeof(Magic)) || std::memcmp(Magic,CacheMagic,sizeof(Magic)))
+    return false;
+
+  return (readPOD<std::uint32_t>(Stream) == LandRGraphCache::FormatVersion &&
+          readString(Stream) == Key &&
+          readPOD<std::uint32_t>(Stream) == GraphType);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+static void hashFile(const std::string& Path, std::uint64_t& Hash)
+{
+  std::ifstream File(Path.c_str(),std::ios::in | std::ios::binary);
+
+  if (!File.is_open())
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Unable to read file " + Path);
+
+  char Buffer[65536];
+
+  while (File.read(Buffer,sizeof(Buffer)) || File.gcount() > 0)
+  {
+    std::streamsize Count = File.gcount();
+
+    for (std::streamsize i = 0; i < Count; i++)
+    {
+      Hash ^= static_cast<unsigned char>(Buffer[i]);
+      Hash *= 1099511628211ULL;
+    }
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+std::string LandRGraphCache::computeKey(const std::string& SourcePath, const std::string& BuildOptions)
+{
+  // FNV-1a hash of the source files contents, followed by the build options
+  std::uint64_t Hash = 14695981039346656037ULL;
+
+  hashFile(SourcePath,Hash);
+
+  std::string Extension = openfluid::tools::Filesystem::extension(SourcePath);
+
+  if (Extension == "shp" || Extension == "SHP")
+  {
+    std::string BasePath = openfluid::tools::Filesystem::dirname(SourcePath) + "/" +
+                           openfluid::tools::Filesystem::basename(SourcePath);
+    std::vector<std::string> Companions = {"shx","dbf","prj","SHX","DBF","PRJ"};
+
+    for (const std::string& Ext : Companions)
+    {
+      if (openfluid::tools::Filesystem::isFile(BasePath + "." + Ext))
+        hashFile(BasePath + "." + Ext,Hash);
+    }
+  }
+
+  for (const char& C : "|" + BuildOptions)
+  {
+    Hash ^= static_cast<unsigned char>(C);
+    Hash *= 1099511628211ULL;
+  }
+
+  std::ostringstream Key;
+  Key << std::hex << std::setw(16) << std::setfill('0') << Hash;
+
+  return Key.str();
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+bool LandRGraphCache::hasComputedNeighbours(LandRGraph& Graph)
+{
+  if (Graph.m_Entities.empty())
+    return false;
+
+  if (Graph.m_NeighboursComputed)
+    return true;
+
+  LandRGraph::Entities_t::iterator it = Graph.m_Entities.begin();
+  LandRGraph::Entities_t::iterator ite = Graph.m_Entities.end();
+
+  for (; it != ite; ++it)
+  {
+    if (!(*it)->mp_Neighbours)
+      return false;
+  }
+
+  return true;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void LandRGraphCache::writeEntities(std::ostream& Stream, LandRGraph& Graph)
+{
+  writePOD<std::uint64_t>(Stream,Graph.m_Entities.size());
+
+  LandRGraph::Entities_t::iterator it = Graph.m_Entities.begin();
+  LandRGraph::Entities_t::iterator ite = Graph.m_Entities.end();
+
+  for (; it != ite; ++it)
+  {
+    writePOD<std::uint32_t>(Stream,(*it)->getOfldId());
+    writeGeometry(Stream,(*it)->geometry());
+
+    writePOD<std::uint32_t>(Stream,(*it)->m_Attributes.size());
+
+    std::map<std::string, core::Value*>::const_iterator itA = (*it)->m_Attributes.begin();
+    std::map<std::string, core::Value*>::const_iterator itAe = (*it)->m_Attributes.end();
+
+    for (; itA != itAe; ++itA)
+    {
+      writeString(Stream,itA->first);
+      writeValue(Stream,itA->second);
+    }
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void LandRGraphCache::readEntityAttributes(std::istream& Stream, LandREntity* Entity)
+{
+  std::uint32_t AttributesCount = readPOD<std::uint32_t>(Stream);
+
+  for (std::uint32_t i = 0; i < AttributesCount; i++)
+  {
+    std::string Name = readString(Stream);
+
+    delete Entity->m_Attributes[Name];
+    Entity->m_Attributes[Name] = readValue(Stream);
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void LandRGraphCache::save(LandRGraph& Graph, const std::string& FilePath, const std::string& Key)
+{
+  std::string Dir = openfluid::tools::Filesystem::dirname(FilePath);
+
+  if (!Dir.empty() && !openfluid::tools::Filesystem::isDirectory(Dir))
+    openfluid::tools::Filesystem::makeDirectory(Dir);
+
+  // the cache is written to a temporary file, renamed when complete,
+  // so that an interrupted writing never leaves a truncated cache file
+  std::string TmpPath = FilePath + ".tmp";
+  std::ofstream Stream(TmpPath.c_str(),std::ios::out | std::ios::binary | std::ios::trunc);
+
+  if (!Stream.is_open())
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Unable to create cache file " + FilePath);
+
+  try
+  {
+    Stream.write(CacheMagic,sizeof(CacheMagic));
+    writePOD<std::uint32_t>(Stream,FormatVersion);
+    writeString(Stream,Key);
+    writePOD<std::uint32_t>(Stream,Graph.getType());
+
+    writeEntities(Stream,Graph);
+    writePOD<std::uint8_t>(Stream,hasComputedNeighbours(Graph));
+
+    if (Graph.getType() == LandRGraph::POLYGON)
+    {
+      std::map<const LandREntity*,std::uint64_t> EntitiesRanks;
+      std::map<const PolygonEdge*,std::uint64_t> EdgesRanks;
+
+      LandRGraph::Entities_t::iterator it = Graph.m_Entities.begin();
+      LandRGraph::Entities_t::iterator ite = Graph.m_Entities.end();
+
+      for (; it != ite; ++it)
+        EntitiesRanks.insert(std::make_pair(*it,EntitiesRanks.size()));
+
+      std::vector<geos::planargraph::Edge*>* Edges = Graph.getEdges();
+
+      writePOD<std::uint64_t>(Stream,Edges->size());
+
+      for (unsigned int i = 0; i < Edges->size(); i++)
+      {
+        PolygonEdge* Edge = dynamic_cast<PolygonEdge*>(Edges->at(i));
+        EdgesRanks[Edge] = i;
+
+        writeGeometry(Stream,Edge->line());
+
+        writePOD<std::uint32_t>(Stream,Edge->m_Faces.size());
+        for (unsigned int f = 0; f < Edge->m_Faces.size(); f++)
+          writePOD<std::uint64_t>(Stream,EntitiesRanks.at(Edge->m_Faces[f]));
+
+        writePOD<std::uint32_t>(Stream,Edge->m_EdgeAttributes.size());
+
+        std::map<std::string, core::Value*>::const_iterator itA = Edge->m_EdgeAttributes.begin();
+        std::map<std::string, core::Value*>::const_iterator itAe = Edge->m_EdgeAttributes.end();
+
+        for (; itA != itAe; ++itA)
+        {
+          writeString(Stream,itA->first);
+          writeValue(Stream,itA->second);
+        }
+      }
+
+      for (it = Graph.m_Entities.begin(); it != ite; ++it)
+      {
+        const std::vector<PolygonEdge*>& PolyEdges = dynamic_cast<PolygonEntity*>(*it)->m_PolyEdges;
+
+        writePOD<std::uint32_t>(Stream,PolyEdges.size());
+        for (unsigned int e = 0; e < PolyEdges.size(); e++)
+          writePOD<std::uint64_t>(Stream,EdgesRanks.at(PolyEdges[e]));
+      }
+    }
+
+    Stream.close();
+
+    if (Stream.fail())
+      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Unable to write cache file " + FilePath);
+  }
+  catch (std::out_of_range&)
+  {
+    Stream.close();
+    std::remove(TmpPath.c_str());
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                              "Inconsistent graph topology, unable to write cache file " + FilePath);
+  }
+  catch (openfluid::base::FrameworkException&)
+  {
+    Stream.close();
+    std::remove(TmpPath.c_str());
+    throw;
+  }
+
+  std::remove(FilePath.c_str());
+
+  if (std::rename(TmpPath.c_str(),FilePath.c_str()))
+  {
+    std::remove(TmpPath.c_str());
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Unable to write cache file " + FilePath);
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+PolygonGraph* LandRGraphCache::loadPolygonGraph(const std::string& FilePath, const std::string& Key)
+{
+  std::ifstream Stream(FilePath.c_str(),std::ios::in | std::ios::binary);
+
+  if (!Stream.is_open())
+    return nullptr;
+
+  PolygonGraph* Graph = nullptr;
+
+  try
+  {
+    if (!readHeader(Stream,Key,LandRGraph::POLYGON))
+      return nullptr;
+
+    Graph = new PolygonGraph();
+
+    std::uint64_t EntitiesCount = readPOD<std::uint64_t>(Stream);
+    std::vector<PolygonEntity*> Entities;
+
+    for (std::uint64_t i = 0; i < EntitiesCount; i++)
+    {
+      unsigned int OfldId = readPOD<std::uint32_t>(Stream);
+      geos::geom::Geometry* Geom = readGeometry(Stream);
+
+      PolygonEntity* Entity = dynamic_cast<PolygonEntity*>(Graph->createNewEntity(Geom,OfldId));
+      Graph->registerEntity(Entity);
+      Entities.push_back(Entity);
+
+      readEntityAttributes(Stream,Entity);
+    }
+
+    bool NeighboursComputed = readPOD<std::uint8_t>(Stream);
+
+    std::uint64_t EdgesCount = readPOD<std::uint64_t>(Stream);
+    std::vector<PolygonEdge*> Edges;
+
+    for (std::uint64_t i = 0; i < EdgesCount; i++)
+    {
+      geos::geom::Geometry* EdgeGeom = readGeometry(Stream);
+      geos::geom::LineString* Line = dynamic_cast<geos::geom::LineString*>(EdgeGeom);
+
+      if (!Line)
+      {
+        delete EdgeGeom;
+        throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Invalid edge in cache file");
+      }
+
+      // as for built graphs, the edge line is kept alive by the edge
+      PolygonEdge* Edge = Graph->createEdge(*Line);
+
+      if (!Edge)
+      {
+        delete Line;
+        throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Invalid edge in cache file");
+      }
+
+      Edges.push_back(Edge);
+
+      // the faces are restored as stored, their boundaries were checked when the graph was built
+      std::uint32_t FacesCount = readPOD<std::uint32_t>(Stream);
+      for (std::uint32_t f = 0; f < FacesCount; f++)
+        Edge->m_Faces.push_back(Entities.at(readPOD<std::uint64_t>(Stream)));
+
+      std::uint32_t AttributesCount = readPOD<std::uint32_t>(Stream);
+      for (std::uint32_t a = 0; a < AttributesCount; a++)
+      {
+        std::string Name = readString(Stream);
+
+        delete Edge->m_EdgeAttributes[Name];
+        Edge->m_EdgeAttributes[Name] = readValue(Stream);
+      }
+    }
+
+    for (std::uint64_t i = 0; i < EntitiesCount; i++)
+    {
+      std::uint32_t PolyEdgesCount = readPOD<std::uint32_t>(Stream);
+      for (std::uint32_t e = 0; e < PolyEdgesCount; e++)
+        Entities[i]->m_PolyEdges.push_back(Edges.at(readPOD<std::uint64_t>(Stream)));
+    }
+
+    Graph->removeUnusedNodes();
+
+    if (NeighboursComputed)
+      Graph->computeNeighbours();
+  }
+  catch (std::exception&)
+  {
+    // any error while reading the cache (invalid content, geometry errors, memory) falls back to building the graph
+    delete Graph;
+    return nullptr;
+  }
+
+  return Graph;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+LineStringGraph* LandRGraphCache::loadLineStringGraph(const std::string& FilePath, const std::string& Key)
+{
+  std::ifstream Stream(FilePath.c_str(),std::ios::in | std::ios::binary);
+
+  if (!Stream.is_open())
+    return nullptr;
+
+  LineStringGraph* Graph = nullptr;
+
+  try
+  {
+    if (!readHeader(Stream,Key,LandRGraph::LINESTRING))
+      return nullptr;
+
+    Graph = new LineStringGraph();
+
+    std::uint64_t EntitiesCount = readPOD<std::uint64_t>(Stream);
+
+    for (std::uint64_t i = 0; i < EntitiesCount; i++)
+    {
+      unsigned int OfldId = readPOD<std::uint32_t>(Stream);
+      geos::geom::Geometry* Geom = readGeometry(Stream);
+
+      LandREntity* Entity = Graph->createNewEntity(Geom,OfldId);
+      Graph->addEntity(Entity);
+
+      readEntityAttributes(Stream,Entity);
+    }
+
+    bool NeighboursComputed = readPOD<std::uint8_t>(Stream);
+
+    Graph->removeUnusedNodes();
+
+    if (NeighboursComputed)
+      Graph->computeNeighbours();
+  }
+  catch (std::exception&)
+  {
+    // any error while reading the cache (invalid content, geometry errors, memory) falls back to building the graph
+    delete Graph;
+    return nullptr;
+  }
+
+  return Graph;
+}
+
+
+} } // namespaces
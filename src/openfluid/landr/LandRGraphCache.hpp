@@ -0,0 +1,140 @@
+/*
+
+  This file is part of OpenFLUID software
+  Copyright(c) 2007, INRA - Montpellier SupAgro
+
+
+ == GNU General Public License Usage ==
+
+  OpenFLUID is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OpenFLUID is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OpenFLUID. If not, see <http://www.gnu.org/licenses/>.
+
+
+ == Other Usage ==
+
+  Other Usage means a use of OpenFLUID that is inconsistent with the GPL
+  license, and requires a written agreement between You and INRA.
+  Licensees for Other Usage of OpenFLUID may use this file in accordance
+  with the terms contained in the written agreement between You and INRA.
+
+*/
+
+
+/**
+  @file LandRGraphCache.hpp
+
+  @author Jean-Christophe Fabre <jean-christophe.fabre@supagro.inra.fr>
+ */
+
+
+#ifndef __OPENFLUID_LANDR_LANDRGRAPHCACHE_HPP__
+#define __OPENFLUID_LANDR_LANDRGRAPHCACHE_HPP__
+
+
+#include <string>
+#include <iosfwd>
+
+#include <openfluid/dllexport.hpp>
+
+
+namespace openfluid { namespace landr {
+
+class LandRGraph;
+class LandREntity;
+class PolygonGraph;
+class LineStringGraph;
+
+
+/**
+  @brief Binary cache of built LandRGraph, for reloading a graph without building again its topology.
+  @details The cache file stores the entities geometries and attributes, the edges of PolygonGraph with their
+  faces and attributes, and whether the neighbours were computed. It is identified by a format version and by
+  a key, usually computed from the source dataset and the build options using computeKey().
+  The associated rasters are not stored.
+
+  Example:
+  @code
+  std::string Key = openfluid::landr::LandRGraphCache::computeKey(SourcePath,"neighbours");
+  openfluid::landr::PolygonGraph* Graph = openfluid::landr::LandRGraphCache::loadPolygonGraph(CachePath,Key);
+
+  if (!Graph)
+  {
+    Graph = openfluid::landr::PolygonGraph::create(Vector);
+    Graph->computeNeighbours();
+    openfluid::landr::LandRGraphCache::save(*Graph,CachePath,Key);
+  }
+  @endcode
+*/
+class OPENFLUID_API LandRGraphCache
+{
+  private:
+
+    static void writeEntities(std::ostream& Stream, LandRGraph& Graph);
+
+    static void readEntityAttributes(std::istream& Stream, LandREntity* Entity);
+
+    static bool hasComputedNeighbours(LandRGraph& Graph);
+
+
+  public:
+
+    /**
+      @brief The version of the cache files format, cache files of other versions are never loaded.
+    */
+    static const unsigned int FormatVersion;
+
+    /**
+      @brief Computes a cache key from the content of a source dataset and from build options.
+      @details For a shapefile, the content of the .shx, .dbf and .prj companion files is also used.
+      @param SourcePath The path of the source dataset file.
+      @param BuildOptions A string describing the options used to build the graph.
+      @return The key, as a string of hexadecimal digits.
+      @throw openfluid::base::FrameworkException if the source dataset file cannot be read.
+    */
+    static std::string computeKey(const std::string& SourcePath, const std::string& BuildOptions = "");
+
+    /**
+      @brief Saves a LandRGraph to a cache file, replacing an existing one.
+      @param Graph The LandRGraph to save.
+      @param FilePath The path of the cache file.
+      @param Key The key of the cache.
+      @throw openfluid::base::FrameworkException if the cache file cannot be written,
+      or if an attribute value type is not supported (vector, matrix, map and tree values).
+    */
+    static void save(LandRGraph& Graph, const std::string& FilePath, const std::string& Key);
+
+    /**
+      @brief Loads a PolygonGraph from a cache file.
+      @param FilePath The path of the cache file.
+      @param Key The expected key of the cache.
+      @return The loaded PolygonGraph, or nullptr if the cache file does not exist, is not readable,
+      or has not the expected format version, key or graph type.
+    */
+    static PolygonGraph* loadPolygonGraph(const std::string& FilePath, const std::string& Key);
+
+    /**
+      @brief Loads a LineStringGraph from a cache file.
+      @param FilePath The path of the cache file.
+      @param Key The expected key of the cache.
+      @return The loaded LineStringGraph, or nullptr if the cache file does not exist, is not readable,
+      or has not the expected format version, key or graph type.
+    */
+    static LineStringGraph* loadLineStringGraph(const std::string& FilePath, const std::string& Key);
+
+};
+
+
+} } // namespaces
+
+
+#endif /* __OPENFLUID_LANDR_LANDRGRAPHCACHE_HPP__ */
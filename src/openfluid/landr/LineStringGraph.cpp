@@ -41,6 +41,7 @@
  #include <sstream>
 
  #include <geos/planargraph/DirectedEdge.h>
+ #include <geos/planargraph/DirectedEdgeStar.h>
  #include <geos/planargraph/Node.h>
  #include <geos/geom/CoordinateSequence.h>
  #include <geos/geom/LineString.h>
@@ -206,6 +207,46 @@ LandREntity* LineStringGraph::createNewEntity(const geos::geom::Geometry* Geom,
 // =====================================================================
 
 
+void LineStringGraph::computeIncidences(const std::unordered_map<const LandREntity*,unsigned int>& Ranks,
+                                        std::vector<unsigned int>& Offsets, std::vector<unsigned int>& Incidents)
+{
+  Offsets.assign(1,0);
+  Incidents.clear();
+
+  geos::planargraph::NodeMap::container::iterator it = nodeBegin();
+  geos::planargraph::NodeMap::container::iterator ite = nodeEnd();
+
+  for (; it != ite; ++it)
+  {
+    std::vector<geos::planargraph::DirectedEdge*>::iterator jt = it->second->getOutEdges()->iterator();
+    std::vector<geos::planargraph::DirectedEdge*>::iterator jte = it->second->getOutEdges()->end();
+
+    for (; jt != jte; ++jt)
+    {
+      std::unordered_map<const LandREntity*,unsigned int>::const_iterator itR =
+          Ranks.find(dynamic_cast<LandREntity*>((*jt)->getEdge()));
+
+      if (itR != Ranks.end())
+        Incidents.push_back(itR->second);
+    }
+
+    // a closed LineStringEntity has its two ends on the same node
+    std::vector<unsigned int>::iterator itB = Incidents.begin()+Offsets.back();
+    std::sort(itB,Incidents.end());
+    Incidents.erase(std::unique(itB,Incidents.end()),Incidents.end());
+
+    if (Incidents.size()-Offsets.back() < 2)
+      Incidents.resize(Offsets.back());
+    else
+      Offsets.push_back(Incidents.size());
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 void LineStringGraph::removeEntity(int OfldId)
 {
   LineStringEntity* Ent = entity(OfldId);
@@ -337,28 +378,21 @@ double LineStringGraph::getRasterValueForEntityEndNode(LineStringEntity& Entity)
 // =====================================================================
 
 
-void LineStringGraph::setAttributeFromRasterValueAtStartNode(const std::string& AttributeName)
+std::vector<float> LineStringGraph::getRasterValuesForEntitiesNodes(bool StartNodes)
 {
-  addAttribute(AttributeName);
+  if (!mp_Raster)
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"No raster associated to the LineStringGraph");
 
-  LandRGraph::Entities_t::iterator it = m_Entities.begin();
-  LandRGraph::Entities_t::iterator ite = m_Entities.end();
+  std::vector<geos::geom::Coordinate> Coos;
 
-  for (; it != ite; ++it)
+  for (LandREntity* Entity : m_Entities)
   {
-    float* Val = new float(getRasterValueForEntityStartNode(*dynamic_cast<LineStringEntity*>(*it)));
+    LineStringEntity* LSEntity = dynamic_cast<LineStringEntity*>(Entity);
 
-    if (!Val)
-    {
-      std::ostringstream s;
-      s << "No raster value for entity " << (*it)->getOfldId() << " StartNode.";
-
-      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, s.str());
-    }
-
-    (*it)->setAttributeValue(AttributeName, new core::DoubleValue(*Val));
-    delete Val;
+    Coos.push_back(StartNodes ? LSEntity->startNode()->getCoordinate() : LSEntity->endNode()->getCoordinate());
   }
+
+  return mp_Raster->getValuesOfCoordinates(Coos);
 }
 
 
@@ -366,28 +400,31 @@ void LineStringGraph::setAttributeFromRasterValueAtStartNode(const std::string&
 // =====================================================================
 
 
-void LineStringGraph::setAttributeFromRasterValueAtEndNode(const std::string& AttributeName)
+void LineStringGraph::setAttributeFromRasterValueAtStartNode(const std::string& AttributeName)
 {
+  std::vector<float> Values = getRasterValuesForEntitiesNodes(true);
+
   addAttribute(AttributeName);
 
-  LandRGraph::Entities_t::iterator it = m_Entities.begin();
-  LandRGraph::Entities_t::iterator ite = m_Entities.end();
+  unsigned int i = 0;
+  for (LandREntity* Entity : m_Entities)
+    Entity->setAttributeValue(AttributeName, new core::DoubleValue(Values[i++]));
+}
 
-  for (; it != ite; ++it)
-  {
-    float* Val = new float (getRasterValueForEntityEndNode(*dynamic_cast<LineStringEntity*>(*it)));
 
-    if (!Val)
-    {
-      std::ostringstream s;
-      s << "No raster value for entity " << (*it)->getOfldId() << " EndNode.";
+// =====================================================================
+// =====================================================================
 
-      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, s.str());
-    }
 
-    (*it)->setAttributeValue(AttributeName, new core::DoubleValue(*Val));
-    delete Val;
-  }
+void LineStringGraph::setAttributeFromRasterValueAtEndNode(const std::string& AttributeName)
+{
+  std::vector<float> Values = getRasterValuesForEntitiesNodes(false);
+
+  addAttribute(AttributeName);
+
+  unsigned int i = 0;
+  for (LandREntity* Entity : m_Entities)
+    Entity->setAttributeValue(AttributeName, new core::DoubleValue(Values[i++]));
 }
 
 
@@ -479,43 +516,17 @@ bool LineStringGraph::isLineStringGraphArborescence( )
 
 void LineStringGraph::setAttributeFromMeanRasterValues(const std::string& AttributeName)
 {
-  addAttribute(AttributeName);
+  std::vector<float> StartValues = getRasterValuesForEntitiesNodes(true);
+  std::vector<float> EndValues = getRasterValuesForEntitiesNodes(false);
 
-  LandRGraph::Entities_t::iterator it = m_Entities.begin();
-  LandRGraph::Entities_t::iterator ite = m_Entities.end();
+  addAttribute(AttributeName);
 
-  for (; it != ite; ++it)
+  unsigned int i = 0;
+  for (LandREntity* Entity : m_Entities)
   {
-    float* EndVal = new float(getRasterValueForEntityEndNode(*dynamic_cast<LineStringEntity*>(*it)));
-
-    if (!EndVal)
-    {
-      std::ostringstream s;
-      s << "No raster value for entity " << (*it)->getOfldId() << " EndNode.";
-
-      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, s.str());
-    }
-
-    float* StartVal = new float( getRasterValueForEntityStartNode(*dynamic_cast<LineStringEntity*>(*it)));
-
-    if (!StartVal)
-    {
-      std::ostringstream s;
-      s << "No raster value for entity " << (*it)->getOfldId() << " StartNode.";
-
-      if (EndVal)
-        delete EndVal;
-
-      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, s.str());
-
-      return;
-    }
-
-    float Val = (*StartVal+*EndVal) / 2;
-    (*it)->setAttributeValue(AttributeName,new core::DoubleValue(Val));
-
-    delete EndVal;
-    delete StartVal;
+    float Val = (StartValues[i]+EndValues[i]) / 2;
+    Entity->setAttributeValue(AttributeName,new core::DoubleValue(Val));
+    i++;
   }
 }
 
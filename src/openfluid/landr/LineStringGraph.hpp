@@ -123,6 +123,8 @@ class OPENFLUID_API LineStringGraph : public LandRGraph
 
 	  LineStringGraph(LineStringGraph& Other);
 
+    friend class LandRGraphCache;
+
 
   protected:
 
@@ -151,6 +153,20 @@ class OPENFLUID_API LineStringGraph : public LandRGraph
     */
     virtual LandREntity* createNewEntity(const geos::geom::Geometry* Geom, unsigned int OfldId);
 
+    /**
+    @brief Gets the LineStringEntity connected to each node shared by several LineStringEntity.
+    */
+    virtual void computeIncidences(const std::unordered_map<const LandREntity*,unsigned int>& Ranks,
+                                   std::vector<unsigned int>& Offsets, std::vector<unsigned int>& Incidents);
+
+    /**
+    @brief Fetch at once the associated raster values corresponding to the StartNode or EndNode coordinates
+    of all the LineStringEntities.
+    @param StartNodes true to get the values at the StartNodes, false to get the values at the EndNodes.
+    @return The raster values, in the order of the LineStringEntities.
+    */
+    std::vector<float> getRasterValuesForEntitiesNodes(bool StartNodes);
+
 
   public:
 
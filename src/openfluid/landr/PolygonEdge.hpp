@@ -86,6 +86,9 @@ class OPENFLUID_API PolygonEdge: public geos::planargraph::Edge
     */
     std::vector<PolygonEntity*> m_Faces;
 
+    // for restoring faces from cache files
+    friend class LandRGraphCache;
+
 
   public:
 
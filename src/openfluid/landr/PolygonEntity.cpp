@@ -122,7 +122,7 @@ void PolygonEntity::addEdge(PolygonEdge& Edge)
 
   m_PolyEdges.push_back(&Edge);
 
-  mp_NeighboursMap = 0;
+  clearNeighbours();
 
   mp_LineStringNeighboursMap = 0;
 }
@@ -141,7 +141,7 @@ void PolygonEntity::removeEdge(PolygonEdge* Edge)
   else
     throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Edge doesn't exist in Edge vector.");
 
-  mp_NeighboursMap = 0;
+  clearNeighbours();
   mp_LineStringNeighboursMap = 0;
 
   delete Edge;
@@ -260,6 +260,19 @@ void PolygonEntity::computeNeighbours()
 // =====================================================================
 
 
+void PolygonEntity::clearNeighbours()
+{
+  LandREntity::clearNeighbours();
+
+  delete mp_NeighboursMap;
+  mp_NeighboursMap = nullptr;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 bool PolygonEntity::isComplete()
 {
   std::vector<geos::geom::Geometry*> Geoms;
@@ -76,6 +76,12 @@ class OPENFLUID_API PolygonEntity: public LandREntity
     PolygonEntity();
     PolygonEntity(const PolygonEntity&);
 
+    /**
+      @brief Resets the neighbours of this PolygonEntity and their shared PolygonEdge,
+      which are computed again on their next access.
+    */
+    void clearNeighbours();
+
   public:
 
     /**
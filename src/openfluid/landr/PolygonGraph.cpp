@@ -38,7 +38,10 @@
 
 
  #include <algorithm>
+ #include <set>
+ #include <map>
  #include <complex>
+ #include <cmath>
 
  #include <geos/geom/Polygon.h>
  #include <geos/geom/Point.h>
@@ -46,6 +49,7 @@
  #include <geos/geom/MultiLineString.h>
  #include <geos/geom/GeometryFactory.h>
  #include <geos/geom/Geometry.h>
+ #include <geos/geom/Envelope.h>
  #include <geos/planargraph/DirectedEdge.h>
 
 #include <openfluid/landr/PolygonGraph.hpp>
@@ -54,6 +58,8 @@
 #include <openfluid/landr/PolygonEdge.hpp>
 #include <openfluid/landr/LandRTools.hpp>
 #include <openfluid/landr/VectorDataset.hpp>
+#include <openfluid/landr/RasterDataset.hpp>
+#include <openfluid/tools/ParallelHelpers.hpp>
 #include <openfluid/base/FrameworkException.hpp>
 #include <openfluid/core/GeoRasterValue.hpp>
 #include <openfluid/core/GeoVectorValue.hpp>
@@ -65,7 +71,21 @@
 namespace openfluid { namespace landr {
 
 
-PolygonGraph::PolygonGraph() : LandRGraph()
+/**
+  Returns the compactness of an entity (Gravelius index : perimeter/2 x sqrt (Pi x area))
+*/
+static double computeCompactness(const LandREntity& Entity)
+{
+  return Entity.getLength()/(2*std::sqrt(4 * std::atan(1.0)*Entity.getArea()));
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+PolygonGraph::PolygonGraph() : LandRGraph(),
+  m_NextEntityRank(0)
 {
 
 }
@@ -75,7 +95,8 @@ PolygonGraph::PolygonGraph() : LandRGraph()
 // =====================================================================
 
 
-PolygonGraph::PolygonGraph(openfluid::core::GeoVectorValue& Val) : LandRGraph(Val)
+PolygonGraph::PolygonGraph(openfluid::core::GeoVectorValue& Val) : LandRGraph(Val),
+  m_NextEntityRank(0)
 {
 
 }
@@ -85,7 +106,8 @@ PolygonGraph::PolygonGraph(openfluid::core::GeoVectorValue& Val) : LandRGraph(Va
 // =====================================================================
 
 
-PolygonGraph::PolygonGraph(openfluid::landr::VectorDataset& Vect) : LandRGraph(Vect)
+PolygonGraph::PolygonGraph(openfluid::landr::VectorDataset& Vect) : LandRGraph(Vect),
+  m_NextEntityRank(0)
 {
 
 }
@@ -189,12 +211,29 @@ void PolygonGraph::addEntity(LandREntity* Entity)
 
   try
   {
-    LandRGraph::Entities_t::iterator it = m_Entities.begin();
-    LandRGraph::Entities_t::iterator ite = m_Entities.end();
+    // only entities with an envelope intersecting the new entity envelope can share a boundary with it,
+    // they are processed in insertion order so that the graph does not depend on the index structure
+    const geos::geom::Envelope* Envelope = Polygon->getEnvelopeInternal();
+    std::vector<void*> IndexedItems;
+    std::vector<PolygonEntity*> Candidates;
+
+    m_EntitiesIndex.query(Envelope,IndexedItems);
+
+    for (void* Item : IndexedItems)
+    {
+      PolygonEntity* Poly = static_cast<PolygonEntity*>(Item);
+
+      if (Envelope->intersects(Poly->polygon()->getEnvelopeInternal()))
+        Candidates.push_back(Poly);
+    }
+
+    std::sort(Candidates.begin(),Candidates.end(),[this](const PolygonEntity* E1, const PolygonEntity* E2)
+    {
+      return m_EntitiesRanks.at(E1) < m_EntitiesRanks.at(E2);
+    });
 
-    for (; it != ite; ++it)
+    for (PolygonEntity* Poly : Candidates)
     {
-      PolygonEntity* Poly = dynamic_cast<PolygonEntity*>(*it);
       std::vector<geos::geom::LineString*> SharedLines = NewEntity->computeLineIntersectionsWith(*Poly);
 
       unsigned int iEnd=SharedLines.size();
@@ -232,8 +271,7 @@ void PolygonGraph::addEntity(LandREntity* Entity)
       }
     }
 
-    m_EntitiesByOfldId[NewEntity->getOfldId()] = NewEntity;
-    m_Entities.push_back(NewEntity);
+    registerEntity(NewEntity);
 
     delete DiffGeom;
     delete NewMultiShared;
@@ -250,6 +288,20 @@ void PolygonGraph::addEntity(LandREntity* Entity)
 // =====================================================================
 
 
+void PolygonGraph::registerEntity(PolygonEntity* Entity)
+{
+  m_EntitiesByOfldId[Entity->getOfldId()] = Entity;
+  m_Entities.push_back(Entity);
+
+  m_EntitiesIndex.insert(Entity->polygon()->getEnvelopeInternal(),Entity);
+  m_EntitiesRanks[Entity] = m_NextEntityRank++;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 LandREntity* PolygonGraph::createNewEntity(const geos::geom::Geometry* Geom,
                                            unsigned int OfldId)
 {
@@ -261,6 +313,39 @@ LandREntity* PolygonGraph::createNewEntity(const geos::geom::Geometry* Geom,
 // =====================================================================
 
 
+void PolygonGraph::computeIncidences(const std::unordered_map<const LandREntity*,unsigned int>& Ranks,
+                                     std::vector<unsigned int>& Offsets, std::vector<unsigned int>& Incidents)
+{
+  Offsets.assign(1,0);
+  Incidents.clear();
+
+  std::vector<geos::planargraph::Edge*>::iterator it = getEdges()->begin();
+  std::vector<geos::planargraph::Edge*>::iterator ite = getEdges()->end();
+
+  for (; it != ite; ++it)
+  {
+    const std::vector<PolygonEntity*> Faces = dynamic_cast<PolygonEdge*>(*it)->getFaces();
+
+    if (Faces.size() < 2 || Faces[0] == Faces[1])
+      continue;
+
+    std::unordered_map<const LandREntity*,unsigned int>::const_iterator itR0 = Ranks.find(Faces[0]);
+    std::unordered_map<const LandREntity*,unsigned int>::const_iterator itR1 = Ranks.find(Faces[1]);
+
+    if (itR0 == Ranks.end() || itR1 == Ranks.end())
+      continue;
+
+    Incidents.push_back(itR0->second);
+    Incidents.push_back(itR1->second);
+    Offsets.push_back(Incidents.size());
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 PolygonEdge* PolygonGraph::createEdge(geos::geom::LineString& LineString)
 {
   if (LineString.isEmpty())
@@ -472,6 +557,14 @@ PolygonGraph::RastValByRastPoly_t PolygonGraph::computeRasterPolyOverlapping(Pol
 
 void PolygonGraph::setAttributeFromMeanRasterValues(const std::string& AttributeName)
 {
+  if (mp_Raster && mp_Raster->isAxisAligned())
+  {
+    setAttributeFromRasterStatistic(AttributeName,MEAN);
+    return;
+  }
+
+  // rotated rasters are processed through the polygonized raster
+
   addAttribute(AttributeName);
 
   LandRGraph::Entities_t::iterator it = m_Entities.begin();
@@ -513,6 +606,69 @@ void PolygonGraph::setAttributeFromMeanRasterValues(const std::string& Attribute
 // =====================================================================
 
 
+void PolygonGraph::setAttributeFromRasterStatistic(const std::string& AttributeName, RasterStatistic Statistic,
+                                                   unsigned int MaxThreads)
+{
+  if (!mp_Raster)
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"No raster associated to the PolygonGraph");
+
+  if (!mp_Raster->isAxisAligned())
+  {
+    if (Statistic != MEAN)
+      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                                "Raster statistic is not available for rotated rasters");
+
+    setAttributeFromMeanRasterValues(AttributeName);
+    return;
+  }
+
+  addAttribute(AttributeName);
+
+  std::vector<PolygonEntity*> Entities;
+
+  for (LandREntity* Entity : m_Entities)
+    Entities.push_back(dynamic_cast<PolygonEntity*>(Entity));
+
+  std::vector<RasterDataset::ZonalStatistics> Stats(Entities.size());
+
+  openfluid::tools::runParallelRange(0,Entities.size(),[this,&Entities,&Stats](std::size_t Begin, std::size_t End)
+  {
+    for (std::size_t i = Begin; i < End; i++)
+      Stats[i] = mp_Raster->computeZonalStatistics(*Entities[i]->polygon());
+  },MaxThreads);
+
+  const double PixelArea = std::fabs(mp_Raster->getPixelWidth()*mp_Raster->getPixelHeight());
+
+  for (unsigned int i = 0; i < Entities.size(); i++)
+  {
+    double Val = 0;
+
+    if (Statistic == MEAN)
+    {
+      double PolyArea = Entities[i]->getArea();
+
+      if (!PolyArea)
+        continue;
+
+      // NaN values are counted as 1, as they were through the polygonized raster
+      Val = (Stats[i].WeightedSum + Stats[i].NaNArea) / PolyArea;
+    }
+    else if (Statistic == MIN)
+      Val = Stats[i].Min;
+    else if (Statistic == MAX)
+      Val = Stats[i].Max;
+    else
+      Val = Stats[i].WeightedSum / PixelArea;
+
+    Entities[i]->setAttributeValue(AttributeName, new core::DoubleValue(Val));
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 void PolygonGraph::createVectorRepresentation(std::string FilePath,
                                               std::string FileName)
 {
@@ -676,7 +832,9 @@ void PolygonGraph::removeEntity(int OfldId)
     s << "No entity with id " << OfldId;
     throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,s.str());
   }
-  computeNeighbours();
+
+  // only the neighbours of Ent are needed, the neighbours of Ent neighbours are computed again by cleanEdges
+  Ent->computeNeighbours();
 
   std::vector<PolygonEdge*> vEdges = Ent->m_PolyEdges;
   std::vector<PolygonEdge*>::iterator it = vEdges.begin();
@@ -697,7 +855,8 @@ void PolygonGraph::removeEntity(int OfldId)
   for (;jt!=jte;++jt)
   {
 
-    jt->first->mp_NeighboursMap->erase(Ent);
+    if (jt->first->mp_NeighboursMap)
+      jt->first->mp_NeighboursMap->erase(Ent);
     lNeighbours.push_back(jt->first);
     std::vector<PolygonEdge*> vNeighbourEdges = jt->first->m_PolyEdges;
     std::vector<PolygonEdge*>::iterator ht = vNeighbourEdges.begin();
@@ -718,6 +877,8 @@ void PolygonGraph::removeEntity(int OfldId)
 
   m_Entities.erase(std::find(m_Entities.begin(), m_Entities.end(), Ent));
   m_EntitiesByOfldId.erase(OfldId);
+  m_EntitiesIndex.remove(Ent->polygon()->getEnvelopeInternal(),Ent);
+  m_EntitiesRanks.erase(Ent);
   delete Ent;
   removeUnusedNodes();
 
@@ -900,7 +1061,7 @@ std::multimap<double, PolygonEntity*> PolygonGraph::getPolygonEntitiesByCompactn
         NeighbourExist = false;
     }
 
-    double valCompact = (*it)->getLength()/(2*std::sqrt(4 * std::atan(1.0)*(*it)->getArea()));
+    double valCompact = computeCompactness(**it);
 
     if (valCompact>Compactness && NeighbourExist)
       mOrderedCompact.insert(std::pair<double,PolygonEntity*>
@@ -941,45 +1102,91 @@ void PolygonGraph::computeNeighboursWithBarriers(LineStringGraph& Graph,
 // =====================================================================
 
 
-void PolygonGraph::mergePolygonEntitiesByMinArea(double MinArea)
+void PolygonGraph::mergePolygonEntitiesByCriterion(const std::function<bool(PolygonEntity&,double&)>& Criterion,
+                                                   bool LowestFirst, const MergeProgressCallback_t& Progress)
 {
-  if (MinArea <= 0.0)
-    throw  openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Threshold must be greater than 0.0");
+  // candidates are ordered by criterion value then by identifier,
+  // so that ties are processed in the same order as in a multimap of identifier ordered entities
+  typedef std::pair<double,unsigned int> Candidate_t;
 
-  if (getEntities().size() == 1)
-    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"PolygonGraph have just one PolygonEntity");
+  std::set<Candidate_t> Candidates;
+  std::map<unsigned int,double> CandidatesValues;
+
+  auto updateCandidate = [this,&Criterion,&Candidates,&CandidatesValues](unsigned int OfldId)
+  {
+    std::map<unsigned int,double>::iterator itV = CandidatesValues.find(OfldId);
 
+    if (itV != CandidatesValues.end())
+    {
+      Candidates.erase(Candidate_t(itV->second,OfldId));
+      CandidatesValues.erase(itV);
+    }
 
-  std::multimap<double, openfluid::landr::PolygonEntity*> mOrderedArea;
+    PolygonEntity* Ent = entity(OfldId);
+    double Value = 0.0;
+
+    if (Ent && Criterion(*Ent,Value))
+    {
+      Candidates.insert(Candidate_t(Value,OfldId));
+      CandidatesValues[OfldId] = Value;
+    }
+  };
 
-  mOrderedArea = getPolygonEntitiesByMinArea(MinArea);
+  LandRGraph::Entities_t lEntities = getOfldIdOrderedEntities();
+  LandRGraph::Entities_t::iterator it = lEntities.begin();
+  LandRGraph::Entities_t::iterator ite = lEntities.end();
 
-  if (mOrderedArea.empty())
-    return ;
+  for (; it != ite; ++it)
+    updateCandidate((*it)->getOfldId());
 
+  unsigned int MergesCount = 0;
 
-  while (!mOrderedArea.empty())
+  while (!Candidates.empty())
   {
-    std::map<double, PolygonEntity*>::iterator jt = mOrderedArea.begin();
+    unsigned int OfldIdToMerge = (LowestFirst ? Candidates.begin()->second : Candidates.rbegin()->second);
+    PolygonEntity* EntityToMerge = entity(OfldIdToMerge);
+
+    std::multimap<double, PolygonEntity*> mNeighbours = EntityToMerge->getOrderedNeighboursByLengthBoundary();
+
+    if (mNeighbours.empty())
+    {
+      Candidates.erase(Candidate_t(CandidatesValues[OfldIdToMerge],OfldIdToMerge));
+      CandidatesValues.erase(OfldIdToMerge);
+      continue;
+    }
+
+    PolygonEntity* Entity = mNeighbours.rbegin()->second;
+
+    // only the merged entities and their neighbours may change of criterion value or of neighbourhood
+    std::set<unsigned int> Affected;
+    Affected.insert(OfldIdToMerge);
+    Affected.insert(Entity->getOfldId());
+
+    std::vector<int> Ids = EntityToMerge->getOrderedNeighbourOfldIds();
+    Affected.insert(Ids.begin(),Ids.end());
+
+    Ids = Entity->getOrderedNeighbourOfldIds();
+    Affected.insert(Ids.begin(),Ids.end());
 
     try
     {
-      PolygonEntity* EntityToMerge = (*jt).second;
-      std::multimap<double, PolygonEntity*> mNeighbours;
-      mNeighbours = EntityToMerge->getOrderedNeighboursByLengthBoundary();
-      std::multimap<double,PolygonEntity*>::reverse_iterator rit;
-      rit=mNeighbours.rbegin();
-      mergePolygonEntities(*(*rit).second,*EntityToMerge);
+      mergePolygonEntities(*Entity,*EntityToMerge);
     }
     catch (std::exception& e)
     {
       throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Unable to merge PolygonEntity");
     }
 
-    // TODO change this part to improve speed :
-    //   just remove from the list the Entity and the Entity to Merge if necessary
-    mOrderedArea.clear();
-    mOrderedArea = getPolygonEntitiesByMinArea(MinArea);
+    std::set<unsigned int>::iterator at = Affected.begin();
+    std::set<unsigned int>::iterator ate = Affected.end();
+
+    for (; at != ate; ++at)
+      updateCandidate(*at);
+
+    MergesCount++;
+
+    if (Progress)
+      Progress(MergesCount,Candidates.size());
   }
 }
 
@@ -988,45 +1195,53 @@ void PolygonGraph::mergePolygonEntitiesByMinArea(double MinArea)
 // =====================================================================
 
 
-void PolygonGraph::mergePolygonEntitiesByCompactness(double Compactness)
+void PolygonGraph::mergePolygonEntitiesByMinArea(double MinArea, const MergeProgressCallback_t& Progress)
 {
-  if (Compactness <= 0.0)
+  if (MinArea <= 0.0)
     throw  openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Threshold must be greater than 0.0");
 
   if (getEntities().size() == 1)
     throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"PolygonGraph have just one PolygonEntity");
 
+  // smallest entities first, as given by getPolygonEntitiesByMinArea()
+  mergePolygonEntitiesByCriterion([MinArea](PolygonEntity& Entity, double& Value)
+  {
+    Entity.computeNeighbours();
+
+    if (Entity.getOrderedNeighbourOfldIds().empty())
+      return false;
+
+    Value = Entity.getArea();
+
+    return Value < MinArea;
+  },true,Progress);
+}
+
+
+// =====================================================================
+// =====================================================================
 
-  std::multimap<double, PolygonEntity*> mOrderedCompactness;
-  mOrderedCompactness = getPolygonEntitiesByCompactness(Compactness);
 
-  if (mOrderedCompactness.empty())
-    return ;
+void PolygonGraph::mergePolygonEntitiesByCompactness(double Compactness, const MergeProgressCallback_t& Progress)
+{
+  if (Compactness <= 0.0)
+    throw  openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Threshold must be greater than 0.0");
+
+  if (getEntities().size() == 1)
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"PolygonGraph have just one PolygonEntity");
 
-  while (!mOrderedCompactness.empty())
+  // least compact entities first, as given by getPolygonEntitiesByCompactness()
+  mergePolygonEntitiesByCriterion([Compactness](PolygonEntity& Entity, double& Value)
   {
-    std::map<double, PolygonEntity*>::reverse_iterator jt = mOrderedCompactness.rbegin();
+    Entity.computeNeighbours();
 
-    try
-    {
-      PolygonEntity* EntityToMerge=(*jt).second;
-      std::multimap<double, PolygonEntity*> mNeighbours;
-      mNeighbours = EntityToMerge->getOrderedNeighboursByLengthBoundary();
+    if (Entity.getOrderedNeighbourOfldIds().empty())
+      return false;
 
-      std::multimap<double, PolygonEntity*>::reverse_iterator rit;
-      rit = mNeighbours.rbegin();
-      mergePolygonEntities(*(*rit).second,*EntityToMerge);
-    }
-    catch (std::exception& e)
-    {
-      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Unable to merge PolygonEntity.");
-    }
+    Value = computeCompactness(Entity);
 
-    // TODO change this part to improve speed :
-    //  just remove from the list the Entity and the Entity to Merge if necessary
-    mOrderedCompactness.clear();
-    mOrderedCompactness=getPolygonEntitiesByCompactness(Compactness);
-  }
+    return Value > Compactness;
+  },false,Progress);
 }
 
 
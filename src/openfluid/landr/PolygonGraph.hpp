@@ -41,6 +41,11 @@
 #define __OPENFLUID_LANDR_POLYGONGRAPH_HPP__
 
 
+#include <unordered_map>
+#include <functional>
+
+#include <geos/index/quadtree/Quadtree.h>
+
 #include <openfluid/core/Value.hpp>
 #include <openfluid/core/DoubleValue.hpp>
 #include <openfluid/landr/LandRGraph.hpp>
@@ -64,9 +69,56 @@ class OPENFLUID_API PolygonGraph: public LandRGraph
     */
     typedef std::map<geos::geom::Polygon*, double> RastValByRastPoly_t;
 
+    /**
+      @brief Statistics of the raster values covered by the PolygonEntities.
+    */
+    enum RasterStatistic
+    {
+      MEAN, MIN, MAX, SUM
+    };
+
+    /**
+      @brief Function called after each merge of PolygonEntities, with the number of merges done
+      and the number of PolygonEntities still to merge.
+    */
+    typedef std::function<void(unsigned int,unsigned int)> MergeProgressCallback_t;
+
 
   private:
 
+    /**
+      @brief Spatial index of the envelopes of the PolygonEntity of this PolygonGraph,
+      used to restrict the search of shared boundaries to the entities with intersecting envelopes.
+    */
+    geos::index::quadtree::Quadtree m_EntitiesIndex;
+
+    /**
+      @brief The insertion ranks of the PolygonEntity of this PolygonGraph,
+      used to process candidate neighbours in insertion order.
+    */
+    std::unordered_map<const PolygonEntity*,unsigned long> m_EntitiesRanks;
+
+    unsigned long m_NextEntityRank;
+
+    friend class LandRGraphCache;
+
+    /**
+      @brief Registers a PolygonEntity, whose edges are already built, into this PolygonGraph.
+    */
+    void registerEntity(PolygonEntity* Entity);
+
+    /**
+      @brief Merges the PolygonEntities matching a criterion into their neighbour sharing the longest boundary,
+      in the order of the criterion values.
+      @details The candidates are kept in a priority queue, only the merged PolygonEntities and their
+      neighbours are evaluated again after each merge.
+      @param Criterion Function returning true if a PolygonEntity has to be merged, and setting its criterion value.
+      @param LowestFirst If true, merges first the lowest criterion values, the highest ones otherwise.
+      @param Progress Function called after each merge, may be empty.
+    */
+    void mergePolygonEntitiesByCriterion(const std::function<bool(PolygonEntity&,double&)>& Criterion,
+                                         bool LowestFirst, const MergeProgressCallback_t& Progress);
+
     /**
       @brief Creates a new PolygonGraph from an other PolygonGraph.
     */
@@ -101,6 +153,12 @@ class OPENFLUID_API PolygonGraph: public LandRGraph
     virtual LandREntity* createNewEntity(const geos::geom::Geometry* Geom,
                                          unsigned int OfldId);
 
+    /**
+      @brief Gets the PolygonEntity faces of each PolygonEdge shared by two PolygonEntity.
+    */
+    virtual void computeIncidences(const std::unordered_map<const LandREntity*,unsigned int>& Ranks,
+                                   std::vector<unsigned int>& Offsets, std::vector<unsigned int>& Incidents);
+
     /**
       @brief Creates a new PolygonEdge, with its two DirectedEdges and add them to this graph.
       @param LineString The geos::geom::LineString representing the PolygonEdge to create.
@@ -191,6 +249,26 @@ class OPENFLUID_API PolygonGraph: public LandRGraph
     */
     virtual void setAttributeFromMeanRasterValues(const std::string& AttributeName);
 
+    /**
+      @brief Creates a new attribute for this PolygonGraph entities, and set for each PolygonEntity
+      this attribute value as a statistic of the covered raster values.
+      @details The raster values are read directly from the associated raster, the PolygonEntities being
+      rasterized line by line and processed concurrently.
+      Statistics are :
+      - MEAN : the mean of the covered raster values, weighted by the covered areas
+      relatively to the PolygonEntity area (NaN raster values count as 1)
+      - MIN : the minimal covered raster value, NaN if no raster value is covered
+      - MAX : the maximal covered raster value, NaN if no raster value is covered
+      - SUM : the sum of the covered raster values, weighted by the covered fraction of each pixel
+      @param AttributeName The name of the attribute to create
+      @param Statistic The statistic to compute
+      @param MaxThreads The maximum number of threads to use, 0 (default) uses the ideal number of threads
+      @throw openfluid::base::FrameworkException if no raster is associated to this PolygonGraph,
+      or if the raster is rotated and the statistic is not MEAN
+    */
+    void setAttributeFromRasterStatistic(const std::string& AttributeName, RasterStatistic Statistic,
+                                         unsigned int MaxThreads = 0);
+
     /**
       @brief Creates on disk a shapefile representing the PolygonEdges of this PolygonGraph.
       @param FilePath The path where to create the out file.
@@ -285,7 +363,8 @@ class OPENFLUID_API PolygonGraph: public LandRGraph
 
     /**
       @brief Merge a PolygonEntity into an other one.
-      @details The PolygonEntity to merge is deleted.
+      @details The PolygonEntity to merge is deleted. Only the neighbours of the two PolygonEntity
+      and of their neighbours are computed again.
       @param Entity An existent PolygonEntity.
       @param EntityToMerge The PolygonEntity which will be merged into Entity and will be deleted.
     */
@@ -296,16 +375,20 @@ class OPENFLUID_API PolygonGraph: public LandRGraph
       @brief Merge the entities of this PolygonGraph which area is under threshold
       @details The small PolygonEntity is merged into the one which share the longest boundary.
       @param MinArea The minimum area threshold.
+      @param Progress Function called after each merge, with the number of merges done
+      and the number of PolygonEntities still to merge; default is none.
     */
-    void mergePolygonEntitiesByMinArea(double MinArea);
+    void mergePolygonEntitiesByMinArea(double MinArea, const MergeProgressCallback_t& Progress = nullptr);
 
     /**
       @brief Merge the entities of this PolygonGraph which compactness value are superior
       to a compactness threshold (Gravelius Index).
       @details The small PolygonEntity is merged into the one which share the longest boundary.
       @param Compactness The compactness threshold (perimeter/2 x sqrt (Pi x area)).
+      @param Progress Function called after each merge, with the number of merges done
+      and the number of PolygonEntities still to merge; default is none.
     */
-    void mergePolygonEntitiesByCompactness(double Compactness);
+    void mergePolygonEntitiesByCompactness(double Compactness, const MergeProgressCallback_t& Progress = nullptr);
 
 };
 
@@ -39,10 +39,17 @@
 #include "RasterDataset.hpp"
 
 #include <string.h>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <numeric>
 
 #include <gdal_alg.h>
 
 #include <geos/geom/Coordinate.h>
+#include <geos/geom/CoordinateSequence.h>
+#include <geos/geom/LineString.h>
+#include <geos/geom/Polygon.h>
 
 #include <openfluid/core/GeoRasterValue.hpp>
 #include <openfluid/base/FrameworkException.hpp>
@@ -52,8 +59,86 @@
 namespace openfluid { namespace landr {
 
 
+// a ring in the pixels space, without the closing point
+typedef std::vector<std::pair<double,double>> PixelRing_t;
+
+
+// minimal coverage of a pixel by a polygon, under which the pixel is considered as touched only
+static const double MinPixelCoverage = 1E-12;
+
+
+// default maximum number of raster blocks kept in memory
+static const unsigned int DefaultBlocksCacheSize = 64;
+
+
+// =====================================================================
+// =====================================================================
+
+
+/**
+  Clips a ring with the half-plane on the Bound side of the vertical (OnX) or horizontal line,
+  using the Sutherland-Hodgman algorithm
+*/
+static void clipRing(const PixelRing_t& Ring, bool OnX, double Bound, bool KeepGreater, PixelRing_t& Clipped)
+{
+  Clipped.clear();
+
+  const std::size_t Count = Ring.size();
+
+  for (std::size_t i = 0; i < Count; i++)
+  {
+    const std::pair<double,double>& Prev = Ring[(i+Count-1)%Count];
+    const std::pair<double,double>& Curr = Ring[i];
+
+    const double PrevVal = (OnX ? Prev.first : Prev.second);
+    const double CurrVal = (OnX ? Curr.first : Curr.second);
+    const bool PrevIn = (KeepGreater ? PrevVal >= Bound : PrevVal <= Bound);
+    const bool CurrIn = (KeepGreater ? CurrVal >= Bound : CurrVal <= Bound);
+
+    if (PrevIn != CurrIn)
+    {
+      const double Ratio = (Bound-PrevVal)/(CurrVal-PrevVal);
+
+      if (OnX)
+        Clipped.push_back(std::make_pair(Bound,Prev.second+Ratio*(Curr.second-Prev.second)));
+      else
+        Clipped.push_back(std::make_pair(Prev.first+Ratio*(Curr.first-Prev.first),Bound));
+    }
+
+    if (CurrIn)
+      Clipped.push_back(Curr);
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+static double computeRingArea(const PixelRing_t& Ring)
+{
+  const std::size_t Count = Ring.size();
+  double DoubleArea = 0;
+
+  for (std::size_t i = 0; i < Count; i++)
+  {
+    const std::pair<double,double>& Curr = Ring[i];
+    const std::pair<double,double>& Next = Ring[(i+1)%Count];
+
+    DoubleArea += Curr.first*Next.second - Next.first*Curr.second;
+  }
+
+  return std::fabs(DoubleArea)/2;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+
 RasterDataset::RasterDataset(openfluid::core::GeoRasterValue& Value) :
-    mp_GeoTransform(0)
+    mp_GeoTransform(0), m_BlocksCacheSize(DefaultBlocksCacheSize)
 {
   GDALAllRegister();
 
@@ -70,6 +155,8 @@ RasterDataset::RasterDataset(openfluid::core::GeoRasterValue& Value) :
                                               "Error while creating a virtual copy of " + Value.getAbsolutePath() +
                                               " (" + CPLGetLastErrorMsg() + ")");
   }
+
+  computeGeoTransform();
 }
 
 
@@ -78,7 +165,7 @@ RasterDataset::RasterDataset(openfluid::core::GeoRasterValue& Value) :
 
 
 RasterDataset::RasterDataset(const RasterDataset& Other) :
-    mp_GeoTransform(0)
+    mp_GeoTransform(0), m_BlocksCacheSize(Other.m_BlocksCacheSize)
 {
   GDALAllRegister();
 
@@ -95,6 +182,8 @@ RasterDataset::RasterDataset(const RasterDataset& Other) :
                                               "Error while creating a virtual copy (" +
                                               std::string(CPLGetLastErrorMsg())  + ")");
   }
+
+  computeGeoTransform();
 }
 
 
@@ -145,8 +234,10 @@ GDALRasterBand* RasterDataset::rasterBand(unsigned int RasterBandIndex)
 
 std::pair<int, int> RasterDataset::getPixelFromCoordinate(geos::geom::Coordinate Coo)
 {
-  int offsetX = int((Coo.x - computeOrigin()->x) / getPixelWidth());
-  int offsetY = int((Coo.y - computeOrigin()->y) / getPixelHeight());
+  checkGeoTransform();
+
+  int offsetX = int((Coo.x - mp_GeoTransform[0]) / mp_GeoTransform[1]);
+  int offsetY = int((Coo.y - mp_GeoTransform[3]) / mp_GeoTransform[5]);
 
   return std::make_pair(offsetX, offsetY);
 }
@@ -158,8 +249,7 @@ std::pair<int, int> RasterDataset::getPixelFromCoordinate(geos::geom::Coordinate
 
 geos::geom::Coordinate* RasterDataset::computeOrigin()
 {
-  if (!mp_GeoTransform)
-    computeGeoTransform();
+  checkGeoTransform();
 
   return new geos::geom::Coordinate(mp_GeoTransform[0], mp_GeoTransform[3]);
 }
@@ -174,6 +264,20 @@ void RasterDataset::computeGeoTransform()
   mp_GeoTransform = new double[6];
 
   if (GDALGetGeoTransform(mp_Dataset, mp_GeoTransform) != CE_None)
+  {
+    delete[] mp_GeoTransform;
+    mp_GeoTransform = nullptr;
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void RasterDataset::checkGeoTransform() const
+{
+  if (!mp_GeoTransform)
     throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Error while getting GeoTransform information");
 }
 
@@ -184,8 +288,7 @@ void RasterDataset::computeGeoTransform()
 
 double RasterDataset::getPixelWidth()
 {
-  if (!mp_GeoTransform)
-    computeGeoTransform();
+  checkGeoTransform();
 
   return mp_GeoTransform[1];
 }
@@ -197,8 +300,7 @@ double RasterDataset::getPixelWidth()
 
 double RasterDataset::getPixelHeight()
 {
-  if (!mp_GeoTransform)
-    computeGeoTransform();
+  checkGeoTransform();
 
   return mp_GeoTransform[5];
 }
@@ -258,27 +360,75 @@ std::vector<float> RasterDataset::getValuesOfColumn(int ColIndex, unsigned int R
 // =====================================================================
 
 
-float RasterDataset::getValueOfPixel(int ColIndex,
-                                     int LineIndex,
-                                     unsigned int RasterBandIndex)
+const RasterDataset::CachedBlock& RasterDataset::getBlockOfPixel(int ColIndex, int LineIndex,
+                                                                 unsigned int RasterBandIndex,
+                                                                 int& ColInBlock, int& LineInBlock)
 {
-  float Val;
+  GDALRasterBand* Band = rasterBand(RasterBandIndex);
+
+  if (!Band || ColIndex < 0 || LineIndex < 0 || ColIndex >= Band->GetXSize() || LineIndex >= Band->GetYSize())
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Error while getting value from raster.");
 
-  float* ScanLine = (float *) CPLMalloc(sizeof(float));
+  int BlockWidth, BlockHeight;
+  Band->GetBlockSize(&BlockWidth,&BlockHeight);
+
+  const int BlockCol = ColIndex / BlockWidth;
+  const int BlockLine = LineIndex / BlockHeight;
+  ColInBlock = ColIndex % BlockWidth;
+  LineInBlock = LineIndex % BlockHeight;
+
+  const BlockKey_t Key = std::make_tuple(RasterBandIndex,BlockCol,BlockLine);
+
+  std::map<BlockKey_t,CachedBlock>::iterator itBlock = m_BlocksCache.find(Key);
+
+  if (itBlock != m_BlocksCache.end())
+  {
+    m_BlocksUsage.splice(m_BlocksUsage.begin(),m_BlocksUsage,itBlock->second.UsagePosition);
+    return itBlock->second;
+  }
+
+  while (m_BlocksCache.size() >= m_BlocksCacheSize)
+  {
+    m_BlocksCache.erase(m_BlocksUsage.back());
+    m_BlocksUsage.pop_back();
+  }
+
+  // blocks at the right and bottom borders may be partial
+  const int Width = std::min(BlockWidth,Band->GetXSize()-BlockCol*BlockWidth);
+  const int Height = std::min(BlockHeight,Band->GetYSize()-BlockLine*BlockHeight);
+
+  CachedBlock Block;
+  Block.Values.resize(Width*Height);
+  Block.Width = Width;
 
   //  The pixel values will automatically be translated from the GDALRasterBand data type as needed.
-  if (rasterBand(RasterBandIndex)->RasterIO(GF_Read, ColIndex, LineIndex, 1,
-                                               1, ScanLine, 1, 1, GDT_Float32,
-                                               0, 0) != CE_None)
+  if (Band->RasterIO(GF_Read, BlockCol*BlockWidth, BlockLine*BlockHeight, Width, Height,
+                     Block.Values.data(), Width, Height, GDT_Float32, 0, 0) != CE_None)
   {
     throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Error while getting value from raster.");
   }
 
-  Val = ScanLine[0];
+  m_BlocksUsage.push_front(Key);
+  Block.UsagePosition = m_BlocksUsage.begin();
 
-  CPLFree(ScanLine);
+  return m_BlocksCache.insert(std::make_pair(Key,std::move(Block))).first->second;
+}
 
-  return Val;
+
+// =====================================================================
+// =====================================================================
+
+
+float RasterDataset::getValueOfPixel(int ColIndex,
+                                     int LineIndex,
+                                     unsigned int RasterBandIndex)
+{
+  std::lock_guard<std::mutex> Lock(m_ReadMutex);
+
+  int ColInBlock, LineInBlock;
+  const CachedBlock& Block = getBlockOfPixel(ColIndex,LineIndex,RasterBandIndex,ColInBlock,LineInBlock);
+
+  return Block.Values[LineInBlock*Block.Width+ColInBlock];
 }
 
 
@@ -299,6 +449,259 @@ float RasterDataset::getValueOfCoordinate(geos::geom::Coordinate Coo,
 // =====================================================================
 
 
+std::vector<float> RasterDataset::getValuesOfCoordinates(const std::vector<geos::geom::Coordinate>& Coos,
+                                                         unsigned int RasterBandIndex)
+{
+  std::vector<float> Values(Coos.size());
+  std::vector<std::pair<int,int>> Pixels(Coos.size());
+
+  for (std::size_t i = 0; i < Coos.size(); i++)
+    Pixels[i] = getPixelFromCoordinate(Coos[i]);
+
+  GDALRasterBand* Band = rasterBand(RasterBandIndex);
+
+  if (!Band)
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Error while getting value from raster.");
+
+  int BlockWidth, BlockHeight;
+  Band->GetBlockSize(&BlockWidth,&BlockHeight);
+
+
+  // coordinates are processed by blocks, in the storage order of the blocks
+
+  std::vector<std::size_t> Order(Coos.size());
+  std::iota(Order.begin(),Order.end(),0);
+
+  std::sort(Order.begin(),Order.end(),[&Pixels,BlockWidth,BlockHeight](std::size_t I1, std::size_t I2)
+  {
+    return std::make_pair(Pixels[I1].second/BlockHeight,Pixels[I1].first/BlockWidth) <
+           std::make_pair(Pixels[I2].second/BlockHeight,Pixels[I2].first/BlockWidth);
+  });
+
+  std::lock_guard<std::mutex> Lock(m_ReadMutex);
+
+  for (std::size_t i : Order)
+  {
+    int ColInBlock, LineInBlock;
+    const CachedBlock& Block = getBlockOfPixel(Pixels[i].first,Pixels[i].second,RasterBandIndex,
+                                               ColInBlock,LineInBlock);
+
+    Values[i] = Block.Values[LineInBlock*Block.Width+ColInBlock];
+  }
+
+  return Values;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void RasterDataset::setBlocksCacheSize(unsigned int Size)
+{
+  std::lock_guard<std::mutex> Lock(m_ReadMutex);
+
+  m_BlocksCacheSize = std::max(Size,1u);
+
+  while (m_BlocksCache.size() > m_BlocksCacheSize)
+  {
+    m_BlocksCache.erase(m_BlocksUsage.back());
+    m_BlocksUsage.pop_back();
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+unsigned int RasterDataset::getBlocksCacheSize() const
+{
+  return m_BlocksCacheSize;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+bool RasterDataset::isAxisAligned()
+{
+  checkGeoTransform();
+
+  return (mp_GeoTransform[2] == 0 && mp_GeoTransform[4] == 0);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+RasterDataset::ZonalStatistics RasterDataset::computeZonalStatistics(const geos::geom::Polygon& Polygon,
+                                                                     unsigned int RasterBandIndex)
+{
+  ZonalStatistics Stats;
+  Stats.WeightedSum = 0;
+  Stats.CoveredArea = 0;
+  Stats.NaNArea = 0;
+  Stats.Min = std::numeric_limits<double>::quiet_NaN();
+  Stats.Max = std::numeric_limits<double>::quiet_NaN();
+  Stats.PixelsCount = 0;
+
+  double GeoTransform[6];
+  int ColumnCount, LineCount;
+
+  {
+    std::lock_guard<std::mutex> Lock(m_ReadMutex);
+
+    checkGeoTransform();
+
+    std::copy(mp_GeoTransform,mp_GeoTransform+6,GeoTransform);
+    ColumnCount = mp_Dataset->GetRasterXSize();
+    LineCount = mp_Dataset->GetRasterYSize();
+  }
+
+  if (GeoTransform[2] != 0 || GeoTransform[4] != 0)
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                              "Zonal statistics are not available for rotated rasters");
+
+
+  // rings of the polygon in the pixels space, exterior ring first
+
+  std::vector<PixelRing_t> Rings(Polygon.getNumInteriorRing()+1);
+
+  for (unsigned int r = 0; r < Rings.size(); r++)
+  {
+    const geos::geom::LineString* Ring = (r == 0 ? Polygon.getExteriorRing() : Polygon.getInteriorRingN(r-1));
+    const geos::geom::CoordinateSequence* Coos = Ring->getCoordinatesRO();
+
+    for (std::size_t i = 0; i+1 < Coos->getSize(); i++)
+    {
+      const geos::geom::Coordinate& Coo = Coos->getAt(i);
+      Rings[r].push_back(std::make_pair((Coo.x-GeoTransform[0])/GeoTransform[1],
+                                        (Coo.y-GeoTransform[3])/GeoTransform[5]));
+    }
+  }
+
+  if (Rings[0].empty())
+    return Stats;
+
+  double MinX = Rings[0].front().first, MaxX = MinX;
+  double MinY = Rings[0].front().second, MaxY = MinY;
+
+  for (const std::pair<double,double>& Point : Rings[0])
+  {
+    MinX = std::min(MinX,Point.first);
+    MaxX = std::max(MaxX,Point.first);
+    MinY = std::min(MinY,Point.second);
+    MaxY = std::max(MaxY,Point.second);
+  }
+
+  const int FirstCol = std::max(0,(int)std::floor(MinX));
+  const int LastCol = std::min(ColumnCount,(int)std::ceil(MaxX))-1;
+  const int FirstLine = std::max(0,(int)std::floor(MinY));
+  const int LastLine = std::min(LineCount,(int)std::ceil(MaxY))-1;
+
+  if (FirstCol > LastCol || FirstLine > LastLine)
+    return Stats;
+
+
+  // pixel values of the window covering the polygon envelope
+
+  const int WindowColumns = LastCol-FirstCol+1;
+  const int WindowLines = LastLine-FirstLine+1;
+  std::vector<float> Values(WindowColumns*WindowLines);
+
+  {
+    std::lock_guard<std::mutex> Lock(m_ReadMutex);
+
+    GDALRasterBand* Band = rasterBand(RasterBandIndex);
+
+    //  The pixel values will automatically be translated from the GDALRasterBand data type as needed.
+    if (!Band || Band->RasterIO(GF_Read, FirstCol, FirstLine, WindowColumns, WindowLines,
+                                Values.data(), WindowColumns, WindowLines, GDT_Float32, 0, 0) != CE_None)
+    {
+      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Error while getting values from raster.");
+    }
+  }
+
+
+  // scanline rasterization: rings are clipped to each line of pixels, then to each pixel of the line
+
+  const double PixelArea = std::fabs(GeoTransform[1]*GeoTransform[5]);
+  std::vector<PixelRing_t> LineRings(Rings.size());
+  PixelRing_t Clipped, PixelRing;
+
+  for (int Line = FirstLine; Line <= LastLine; Line++)
+  {
+    double LineMinX = std::numeric_limits<double>::max();
+    double LineMaxX = std::numeric_limits<double>::lowest();
+
+    for (unsigned int r = 0; r < Rings.size(); r++)
+    {
+      clipRing(Rings[r],false,Line,true,Clipped);
+      clipRing(Clipped,false,Line+1,false,LineRings[r]);
+
+      for (const std::pair<double,double>& Point : LineRings[r])
+      {
+        LineMinX = std::min(LineMinX,Point.first);
+        LineMaxX = std::max(LineMaxX,Point.first);
+      }
+    }
+
+    if (LineRings[0].empty())
+      continue;
+
+    const int LineFirstCol = std::max(FirstCol,(int)std::floor(LineMinX));
+    const int LineLastCol = std::min(LastCol,(int)std::ceil(LineMaxX)-1);
+
+    for (int Col = LineFirstCol; Col <= LineLastCol; Col++)
+    {
+      double Coverage = 0;
+
+      for (unsigned int r = 0; r < LineRings.size(); r++)
+      {
+        if (LineRings[r].empty())
+          continue;
+
+        clipRing(LineRings[r],true,Col,true,Clipped);
+        clipRing(Clipped,true,Col+1,false,PixelRing);
+
+        Coverage += (r == 0 ? 1 : -1) * computeRingArea(PixelRing);
+      }
+
+      if (Coverage <= MinPixelCoverage)
+        continue;
+
+      const double Area = Coverage*PixelArea;
+      const double Value = Values[(Line-FirstLine)*WindowColumns+(Col-FirstCol)];
+
+      if (std::isnan(Value))
+      {
+        Stats.NaNArea += Area;
+        continue;
+      }
+
+      Stats.WeightedSum += Value*Area;
+      Stats.CoveredArea += Area;
+
+      if (!Stats.PixelsCount || Value < Stats.Min)
+        Stats.Min = Value;
+      if (!Stats.PixelsCount || Value > Stats.Max)
+        Stats.Max = Value;
+
+      Stats.PixelsCount++;
+    }
+  }
+
+  return Stats;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 openfluid::landr::VectorDataset* RasterDataset::polygonize(const std::string& FileName,
                                                            std::string FieldName,
                                                            unsigned int RasterBandIndex)
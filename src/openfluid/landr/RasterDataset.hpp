@@ -41,6 +41,10 @@
 
 
 #include <map>
+#include <list>
+#include <tuple>
+#include <vector>
+#include <mutex>
 
 #include <gdal_priv.h>
 #include <ogrsf_frmts.h>
@@ -51,6 +55,7 @@
 
 namespace geos { namespace geom {
 class Coordinate;
+class Polygon;
 } }
 
 namespace openfluid {
@@ -69,6 +74,33 @@ class VectorDataset;
 */
 class OPENFLUID_API RasterDataset
 {
+  public:
+
+    /**
+      @brief Statistics of the pixel values of a RasterDataset covered by a polygon.
+    */
+    struct ZonalStatistics
+    {
+      /** Sum of the covered pixel values, each one weighted by its area covered by the polygon */
+      double WeightedSum;
+
+      /** Area of the polygon covered by pixels holding a value */
+      double CoveredArea;
+
+      /** Area of the polygon covered by pixels holding a NaN value */
+      double NaNArea;
+
+      /** Minimal value of the covered pixels, NaN if no pixel holding a value is covered */
+      double Min;
+
+      /** Maximal value of the covered pixels, NaN if no pixel holding a value is covered */
+      double Max;
+
+      /** Number of covered pixels holding a value */
+      unsigned int PixelsCount;
+    };
+
+
   private:
 
     /**
@@ -86,11 +118,67 @@ class OPENFLUID_API RasterDataset
     */
     std::map<unsigned int, openfluid::landr::VectorDataset*> mp_PolygonizedByRasterBandIndex;
 
+    /**
+      @brief Mutex protecting the reads of the GDALDataset, which is not thread-safe.
+    */
+    std::mutex m_ReadMutex;
+
+    /**
+      @brief Key of a cached block: raster band index, block column index and block line index.
+    */
+    typedef std::tuple<unsigned int,int,int> BlockKey_t;
+
+    /**
+      @brief A block of pixel values read from the GDALDataset.
+    */
+    struct CachedBlock
+    {
+      /** Pixel values of the block, line by line */
+      std::vector<float> Values;
+
+      /** Number of columns of the block, which can be less than the nominal block width at the right border */
+      int Width;
+
+      /** Position of the block in the usage list */
+      std::list<BlockKey_t>::iterator UsagePosition;
+    };
+
+    /**
+      @brief The cached blocks of this RasterDataset.
+    */
+    std::map<BlockKey_t,CachedBlock> m_BlocksCache;
+
+    /**
+      @brief The keys of the cached blocks, from the most recently used to the least recently used.
+    */
+    std::list<BlockKey_t> m_BlocksUsage;
+
+    /**
+      @brief The maximum number of cached blocks.
+    */
+    unsigned int m_BlocksCacheSize;
+
+    /**
+      @brief Returns the cached block containing a pixel, reading it from the GDALDataset if not cached.
+      @details The least recently used block is evicted when the cache is full.
+      Must be called with m_ReadMutex locked.
+      @throw openfluid::base::FrameworkException if the pixel is out of the raster or if the block cannot be read.
+    */
+    const CachedBlock& getBlockOfPixel(int ColIndex, int LineIndex, unsigned int RasterBandIndex,
+                                       int& ColInBlock, int& LineInBlock);
+
     /**
       @brief Computes the affine transformation coefficients of this RasterDataset.
+      @details Called when the dataset is built, so that concurrent readers never compute them.
+      The coefficients are left null if the dataset has no GeoTransform information.
     */
     void computeGeoTransform();
 
+    /**
+      @throw openfluid::base::FrameworkException if this RasterDataset has no GeoTransform information.
+    */
+    void checkGeoTransform() const;
+
   public:
 
     /**
@@ -186,6 +274,49 @@ class OPENFLUID_API RasterDataset
     */
     float getValueOfCoordinate(geos::geom::Coordinate Coo, unsigned int RasterBandIndex = 1);
 
+    /**
+      @brief Returns the pixel values of many coordinates.
+      @details Coordinates are processed grouped by raster block, so that each block is read only once
+      as long as it fits in the blocks cache.
+      @param Coos The vector of geos::geom::Coordinate.
+      @param RasterBandIndex The raster band index (default is 1).
+      @return The pixel values, in the order of the coordinates.
+      @throw openfluid::base::FrameworkException if a coordinate is out of the raster.
+    */
+    std::vector<float> getValuesOfCoordinates(const std::vector<geos::geom::Coordinate>& Coos,
+                                              unsigned int RasterBandIndex = 1);
+
+    /**
+      @brief Sets the maximum number of raster blocks kept in memory for pixel values reading.
+      @param Size The number of blocks, at least 1 block is always kept.
+    */
+    void setBlocksCacheSize(unsigned int Size);
+
+    /**
+      @brief Returns the maximum number of raster blocks kept in memory for pixel values reading.
+    */
+    unsigned int getBlocksCacheSize() const;
+
+    /**
+      @brief Returns true if the pixels of this RasterDataset are aligned on the coordinates axes
+      (no rotation nor shearing in the affine transformation coefficients).
+    */
+    bool isAxisAligned();
+
+    /**
+      @brief Computes the statistics of the pixel values covered by a polygon,
+      weighted by the exact area of each pixel covered by the polygon.
+      @details The pixels window of the polygon envelope is read in a single request,
+      then the polygon is rasterized line by line over this window.
+      This method can be called concurrently from several threads.
+      @param Polygon The geos::geom::Polygon, in the coordinates system of this RasterDataset.
+      @param RasterBandIndex The raster band index (default is 1).
+      @return The statistics of the covered pixel values.
+      @throw openfluid::base::FrameworkException if this RasterDataset is not axis aligned,
+      or if the pixel values cannot be read.
+    */
+    ZonalStatistics computeZonalStatistics(const geos::geom::Polygon& Polygon, unsigned int RasterBandIndex = 1);
+
     /**
       @brief Creates a new VectorDataset with polygons for all connected regions of pixels
       in the raster sharing a common pixel value.
@@ -41,6 +41,9 @@
 #include <algorithm>
 #include <utility>
 #include <chrono>
+#include <cmath>
+#include <clocale>
+#include <unordered_map>
 #include <geos/geom/Geometry.h>
 #include <geos/geom/GeometryFactory.h>
 #include <geos/geom/LineString.h>
@@ -50,17 +53,266 @@
 #include <geos/geom/Polygon.h>
 #include <geos/geom/Coordinate.h>
 #include <geos/operation/overlay/snap/GeometrySnapper.h>
+#include <geos/geom/Envelope.h>
+#include <geos/index/strtree/STRtree.h>
 #include <openfluid/landr/GEOSHelpers.hpp>
 #include <openfluid/base/FrameworkException.hpp>
 #include <openfluid/base/Environment.hpp>
 #include <openfluid/tools/Filesystem.hpp>
 #include <openfluid/tools/DataHelpers.hpp>
+#include <openfluid/tools/ParallelHelpers.hpp>
 
 
 namespace openfluid { namespace landr {
 
 
-VectorDataset::VectorDataset(const std::string& FileName)
+/**
+  Returns, for each feature, the indexes of the following features having an envelope
+  closer than Distance to its envelope
+*/
+static std::vector<std::vector<std::size_t>> findCandidateFeatures(
+    const std::vector<std::pair<OGRFeature*, geos::geom::Geometry*>>& Features, double Distance)
+{
+  std::vector<std::vector<std::size_t>> Candidates(Features.size());
+  std::vector<std::size_t> Indexes(Features.size());
+  std::vector<geos::geom::Envelope> Envelopes(Features.size());
+  geos::index::strtree::STRtree Index;
+
+  for (std::size_t i = 0; i < Features.size(); i++)
+  {
+    Indexes[i] = i;
+    Envelopes[i] = *(Features[i].second->getEnvelopeInternal());
+    Envelopes[i].expandBy(Distance);
+    Index.insert(Features[i].second->getEnvelopeInternal(),&Indexes[i]);
+  }
+
+  for (std::size_t i = 0; i < Features.size(); i++)
+  {
+    std::vector<void*> Found;
+    Index.query(&Envelopes[i],Found);
+
+    for (void* Item : Found)
+    {
+      std::size_t j = *static_cast<std::size_t*>(Item);
+
+      if (j > i)
+        Candidates[i].push_back(j);
+    }
+
+    std::sort(Candidates[i].begin(),Candidates[i].end());
+  }
+
+  return Candidates;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+/**
+  Grid of square cells of the snap threshold size, indexing the vertices of the features of a layer.
+  The vertices closer than the threshold to a coordinate are in the 3x3 cells around the cell of the coordinate.
+*/
+class SnapVerticesGrid
+{
+  private:
+
+    struct Vertex
+    {
+      geos::geom::Coordinate Coord;
+      std::size_t Feature;
+      std::size_t Rank;
+    };
+
+    typedef std::pair<long long,long long> Cell_t;
+
+    struct CellHash
+    {
+      std::size_t operator()(const Cell_t& Cell) const
+      {
+        return std::hash<long long>()(Cell.first)*31+std::hash<long long>()(Cell.second);
+      }
+    };
+
+    double m_Threshold;
+
+    std::unordered_map<Cell_t,std::vector<Vertex>,CellHash> m_Cells;
+
+    Cell_t cellOf(const geos::geom::Coordinate& Coord) const
+    {
+      return Cell_t(static_cast<long long>(std::floor(Coord.x/m_Threshold)),
+                    static_cast<long long>(std::floor(Coord.y/m_Threshold)));
+    }
+
+
+  public:
+
+    SnapVerticesGrid(double Threshold) : m_Threshold(Threshold)
+    { }
+
+    /**
+      Adds a vertex of a feature, ranked in the order of the vertices of the feature
+    */
+    void insert(const geos::geom::Coordinate& Coord, std::size_t Feature, std::size_t Rank)
+    {
+      m_Cells[cellOf(Coord)].push_back(Vertex{Coord,Feature,Rank});
+    }
+
+    /**
+      Removes the vertices of a feature located in the cell of the given coordinate
+    */
+    void remove(const geos::geom::Coordinate& Coord, std::size_t Feature)
+    {
+      auto CellIt = m_Cells.find(cellOf(Coord));
+
+      if (CellIt == m_Cells.end())
+        return;
+
+      std::vector<Vertex>& Vertices = CellIt->second;
+      Vertices.erase(std::remove_if(Vertices.begin(),Vertices.end(),
+                                    [Feature](const Vertex& V){ return V.Feature == Feature; }),
+                     Vertices.end());
+    }
+
+    /**
+      Returns the vertex of another feature at a non-null distance of the coordinate lower than the threshold,
+      or equal to the threshold if IncludeThreshold is true. When several vertices match, the last one
+      in the order of features and vertices is returned. Returns nullptr if no vertex matches.
+    */
+    const geos::geom::Coordinate* findSnapVertex(const geos::geom::Coordinate& Coord, std::size_t Feature,
+                                                 bool IncludeThreshold) const
+    {
+      const Vertex* Found = nullptr;
+      const Cell_t Center = cellOf(Coord);
+
+      for (long long dx = -1; dx <= 1; dx++)
+      {
+        for (long long dy = -1; dy <= 1; dy++)
+        {
+          auto CellIt = m_Cells.find(Cell_t(Center.first+dx,Center.second+dy));
+
+          if (CellIt == m_Cells.end())
+            continue;
+
+          for (const Vertex& V : CellIt->second)
+          {
+            if (V.Feature == Feature)
+              continue;
+
+            const double Distance = Coord.distance(V.Coord);
+
+            if (Distance > 0 && (Distance < m_Threshold || (IncludeThreshold && Distance == m_Threshold)) &&
+                (!Found || V.Feature > Found->Feature || (V.Feature == Found->Feature && V.Rank > Found->Rank)))
+              Found = &V;
+          }
+        }
+      }
+
+      return (Found ? &(Found->Coord) : nullptr);
+    }
+};
+
+
+// =====================================================================
+// =====================================================================
+
+
+/**
+  Converts the geometry of a feature into a new valid GEOS geometry,
+  throws an exception if the geometry is not valid
+*/
+static geos::geom::Geometry* convertFeatureGeometry(OGRFeature* Feat)
+{
+  OGRGeometry* OGRGeom = Feat->GetGeometryRef();
+
+  if (OGRGeom->getGeometryType()==wkbPolygon)
+  {
+    OGRPolygon *Polygon = (OGRPolygon *) OGRGeom;
+
+    if (Polygon->getExteriorRing()->getNumPoints() < 4)
+      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                                "Unable to build the polygon with FID " +
+                                                openfluid::tools::convertValue(Feat->GetFID()));
+  }
+
+  // c++ cast doesn't work (have to use C-style casting instead)
+  geos::geom::Geometry* GeosGeom = (geos::geom::Geometry*)openfluid::landr::convertOGRGeometryToGEOS(OGRGeom);
+
+  geos::operation::valid::IsValidOp ValidOp(GeosGeom);
+
+  if (!ValidOp.isValid())
+  {
+    std::string Message = ValidOp.getValidationError()->toString() + " \nwhile parsing " + GeosGeom->toString();
+    delete GeosGeom;
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,Message);
+  }
+
+  return GeosGeom;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+/**
+  Sets the "C" numeric locale, required to read and write the coordinates of the features,
+  and restores the previous numeric locale on destruction
+*/
+class CNumericLocaleGuard
+{
+  private:
+
+    std::string m_PreviousLocale;
+
+
+  public:
+
+    CNumericLocaleGuard()
+    {
+      const char* Locale = setlocale(LC_NUMERIC,nullptr);
+
+      if (Locale)
+        m_PreviousLocale = Locale;
+
+      setlocale(LC_NUMERIC,"C");
+    }
+
+    ~CNumericLocaleGuard()
+    {
+      if (!m_PreviousLocale.empty())
+        setlocale(LC_NUMERIC,m_PreviousLocale.c_str());
+    }
+};
+
+
+// =====================================================================
+// =====================================================================
+
+
+/**
+  Destroys the features and the geometries of a list, and empties it
+*/
+static void destroyFeatures(VectorDataset::FeaturesList_t& Features)
+{
+  for (auto& Feature : Features)
+  {
+    // destroying the feature destroys also the associated OGRGeom
+    OGRFeature::DestroyFeature(Feature.first);
+    delete Feature.second;
+  }
+
+  Features.clear();
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+VectorDataset::VectorDataset(const std::string& FileName) :
+  mp_DataSource(nullptr), m_ReadOnly(false)
 {
   std::string DefaultDriverName = "ESRI Shapefile";
 
@@ -127,7 +379,8 @@ VectorDataset::VectorDataset(const std::string& FileName)
 // =====================================================================
 
 
-VectorDataset::VectorDataset(openfluid::core::GeoVectorValue& Value)
+VectorDataset::VectorDataset(openfluid::core::GeoVectorValue& Value, bool ReadOnly) :
+  mp_DataSource(nullptr), m_ReadOnly(ReadOnly)
 {
 #if (GDAL_VERSION_MAJOR >= 2)
   GDALAllRegister();
@@ -148,6 +401,24 @@ VectorDataset::VectorDataset(openfluid::core::GeoVectorValue& Value)
     throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
                                               "\"" + DriverName + "\" driver not supported.");
 
+  if (m_ReadOnly)
+  {
+    // the source is opened again, so this VectorDataset does not depend on the lifetime of Value
+#if (GDAL_VERSION_MAJOR >= 2)
+    std::string SourcePath = DS->GetDescription();
+#else
+    std::string SourcePath = DS->GetName();
+#endif
+
+    mp_DataSource = GDALOpenRO_COMPAT(SourcePath.c_str());
+
+    if (!mp_DataSource)
+      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                                "Error while opening " + SourcePath + " : " +
+                                                "Loading of data source failed.");
+    return;
+  }
+
 #if (GDAL_VERSION_MAJOR >= 2)
   std::string Path = getTimestampedPath(openfluid::tools::Filesystem::basename(DS->GetDescription()));
 #else
@@ -183,7 +454,8 @@ VectorDataset::VectorDataset(openfluid::core::GeoVectorValue& Value)
 // =====================================================================
 
 
-VectorDataset::VectorDataset(const VectorDataset& Other)
+VectorDataset::VectorDataset(const VectorDataset& Other) :
+  mp_DataSource(nullptr), m_ReadOnly(false)
 {
 #if (GDAL_VERSION_MAJOR >= 2)
   GDALAllRegister();
@@ -297,6 +569,13 @@ bool VectorDataset::isAlreadyExisting(const std::string& Path)
 
 VectorDataset::~VectorDataset()
 {
+  // the source opened in place must never be deleted
+  if (m_ReadOnly)
+  {
+    GDALClose_COMPAT(mp_DataSource);
+    return;
+  }
+
   GDALDriver_COMPAT* Driver = mp_DataSource->GetDriver();
 
 #if (GDAL_VERSION_MAJOR >= 2)
@@ -339,6 +618,28 @@ GDALDataset_COMPAT* VectorDataset::source() const
 // =====================================================================
 
 
+bool VectorDataset::isReadOnly() const
+{
+  return m_ReadOnly;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void VectorDataset::checkWritable(const std::string& Operation) const
+{
+  if (m_ReadOnly)
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                              "Unable to " + Operation + " : the VectorDataset is read-only.");
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 void VectorDataset::copyToDisk(const std::string& FilePath,
                                const std::string& FileName,
                                bool ReplaceIfExists)
@@ -391,6 +692,8 @@ void VectorDataset::addALayer(std::string LayerName,
                               OGRwkbGeometryType LayerType,
                               OGRSpatialReference* SpatialRef)
 {
+  checkWritable("add a layer");
+
 #if (GDAL_VERSION_MAJOR >= 2)
   std::string Path = mp_DataSource->GetDescription();
 #else
@@ -450,6 +753,8 @@ void VectorDataset::addAField(const std::string& FieldName,
                               OGRFieldType FieldType,
                               unsigned int LayerIndex)
 {
+  checkWritable("add the field \"" + FieldName + "\"");
+
   OGRFieldDefn Field(FieldName.c_str(), FieldType);
 
   if (layer(LayerIndex)->CreateField(&Field) != OGRERR_NONE)
@@ -566,10 +871,82 @@ VectorDataset::FeaturesList_t VectorDataset::features(unsigned int LayerIndex)
 // =====================================================================
 
 
+void VectorDataset::streamFeatures(const std::function<void(const FeaturesList_t&)>& Func,
+                                   unsigned int ChunkSize,
+                                   unsigned int LayerIndex)
+{
+  CNumericLocaleGuard LocaleGuard;
+
+  if (!ChunkSize)
+    ChunkSize = 1;
+
+  OGRLayer* Layer = layer(LayerIndex);
+
+  Layer->ResetReading();
+
+  FeaturesList_t Chunk;
+  OGRFeature* Feat;
+
+  try
+  {
+    // GetNextFeature returns a copy of the feature, owned by the chunk
+    while ((Feat = Layer->GetNextFeature()) != nullptr)
+    {
+      Chunk.push_back(std::make_pair(Feat,static_cast<geos::geom::Geometry*>(nullptr)));
+      Chunk.back().second = convertFeatureGeometry(Feat);
+
+      if (Chunk.size() == ChunkSize)
+      {
+        Func(Chunk);
+        destroyFeatures(Chunk);
+      }
+    }
+
+    if (!Chunk.empty())
+    {
+      Func(Chunk);
+      destroyFeatures(Chunk);
+    }
+  }
+  catch (...)
+  {
+    destroyFeatures(Chunk);
+    throw;
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 geos::geom::Geometry* VectorDataset::geometries(unsigned int LayerIndex)
 {
   if (!m_Geometries.count(LayerIndex))
-    parse(LayerIndex);
+  {
+    if (!m_Features.count(LayerIndex))
+      parse(LayerIndex);
+
+    std::vector<geos::geom::Geometry*> Geoms;
+
+    for (auto& Feature : m_Features.at(LayerIndex))
+      Geoms.push_back(Feature.second);
+
+    // ! do not use buildGeometry, because it may build a MultiPolygon if all geometries
+    //are Polygons, what may produce an invalid MultiPolygon!
+    // (because the boundaries of any two Polygons of a valid MultiPolygon may touch,
+    //*but only at a finite number of points*)
+    m_Geometries.insert(std::make_pair(
+                          LayerIndex,
+                          geos::geom::GeometryFactory::getDefaultInstance()->createGeometryCollection(Geoms)));
+
+    geos::operation::valid::IsValidOp ValidOpColl(m_Geometries.at(LayerIndex));
+
+    if (!ValidOpColl.isValid())
+      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                                ValidOpColl.getValidationError()->toString() + " \nwhile creating " +
+                                                m_Geometries.at(LayerIndex)->toString());
+  }
 
   return m_Geometries.at(LayerIndex);
 }
@@ -582,71 +959,42 @@ geos::geom::Geometry* VectorDataset::geometries(unsigned int LayerIndex)
 // TODO add an option to allow choice of checking validity or not (because it's time consuming)
 void VectorDataset::parse(unsigned int LayerIndex)
 {
-  std::vector<geos::geom::Geometry*> Geoms;
-
-  // TODO move to... ?
-  setlocale(LC_NUMERIC, "C");
+  CNumericLocaleGuard LocaleGuard;
 
   OGRLayer* Layer = layer(LayerIndex);
 
   Layer->ResetReading();
 
-  OGRFeature* Feat;
+  // the features of a previous parsing are destroyed and replaced,
+  // the collection of geometries will be built again from the new ones
+  FeaturesList_t& List = m_Features[LayerIndex];
+  destroyFeatures(List);
 
-  FeaturesList_t List;
-  m_Features.insert(std::make_pair(LayerIndex, List));
+  if (m_Geometries.count(LayerIndex))
+  {
+    delete m_Geometries.at(LayerIndex);
+    m_Geometries.erase(LayerIndex);
+  }
 
-  // GetNextFeature returns a copy of the feature
+  OGRFeature* Feat;
+
+  // GetNextFeature returns a copy of the feature, kept with its geometry
   while ((Feat = Layer->GetNextFeature()) != nullptr)
   {
-    OGRGeometry* OGRGeom = Feat->GetGeometryRef();
+    geos::geom::Geometry* GeosGeom = nullptr;
 
-    if (OGRGeom->getGeometryType()==wkbPolygon && OGRGeom->getGeometryType()!=wkbMultiPolygon)
+    try
     {
-      OGRPolygon *Polygon = (OGRPolygon *) OGRGeom;
-
-      if (Polygon->getExteriorRing()->getNumPoints() < 4)
-        throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
-                                                  "Unable to build the polygon with FID " +
-                                                  openfluid::tools::convertValue(Feat->GetFID()));
-
+      GeosGeom = convertFeatureGeometry(Feat);
+    }
+    catch (...)
+    {
+      OGRFeature::DestroyFeature(Feat);
+      throw;
     }
 
-    // c++ cast doesn't work (have to use C-style casting instead)
-    geos::geom::Geometry* GeosGeom = (geos::geom::Geometry*)openfluid::landr::convertOGRGeometryToGEOS(OGRGeom);
-
-    geos::operation::valid::IsValidOp ValidOp(GeosGeom);
-
-    if (!ValidOp.isValid())
-      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
-                                                ValidOp.getValidationError()->toString() + " \nwhile parsing " +
-                                                GeosGeom->toString());
-
-    geos::geom::Geometry* GeomClone = GeosGeom->clone();
-    OGRFeature* FeatClone = Feat->Clone();
-
-    Geoms.push_back(GeomClone);
-    m_Features.at(LayerIndex).push_back(std::make_pair(FeatClone,GeomClone));
-
-    // destroying the feature destroys also the associated OGRGeom
-    OGRFeature::DestroyFeature(Feat);
-    delete GeosGeom;
+    List.push_back(std::make_pair(Feat,GeosGeom));
   }
-
-  // ! do not use buildGeometry, because it may build a MultiPolygon if all geometries
-  //are Polygons, what may produce an invalid MultiPolygon!
-  // (because the boundaries of any two Polygons of a valid MultiPolygon may touch,
-  //*but only at a finite number of points*)
-  m_Geometries.insert(std::make_pair(
-                        LayerIndex,
-                        geos::geom::GeometryFactory::getDefaultInstance()->createGeometryCollection(Geoms)));
-
-  geos::operation::valid::IsValidOp ValidOpColl(m_Geometries.at(LayerIndex));
-
-  if (!ValidOpColl.isValid())
-    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
-                                              ValidOpColl.getValidationError()->toString() + " \nwhile creating " +
-                                              m_Geometries.at(LayerIndex)->toString());
 }
 
 
@@ -669,6 +1017,8 @@ void VectorDataset::setIndexIntField(const std::string& FieldName,
                                      unsigned int LayerIndex)
 
 {
+  checkWritable("set the field \"" + FieldName + "\"");
+
   if (!isFieldOfType(FieldName, OFTInteger, LayerIndex))
       throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
                                                 "Field \"" + FieldName + "\" is not set or is not of type Int.");
@@ -713,6 +1063,8 @@ OGREnvelope VectorDataset::envelope()
 
 void VectorDataset::snapVertices(double Threshold,unsigned int LayerIndex)
 {
+  checkWritable("snap the vertices");
+
   if (isLineType())
     snapLineNodes(Threshold,LayerIndex);
   else if (isPolygonType())
@@ -729,82 +1081,84 @@ void VectorDataset::snapVertices(double Threshold,unsigned int LayerIndex)
 
 void VectorDataset::snapLineNodes(double Threshold,unsigned int LayerIndex)
 {
+  // only distinct nodes closer than a positive threshold are snapped
+  if (Threshold <= 0)
+    return;
 
   FeaturesList_t Features = features(LayerIndex);
 
+  // end nodes of all lines are indexed in a grid, each line is only compared to the end nodes
+  // of the grid cells around its own end nodes
+
+  SnapVerticesGrid Grid(Threshold);
+  std::vector<geos::geom::LineString*> Lines;
+  bool Snapped = false;
+
   for (FeaturesList_t::iterator it = Features.begin(); it != Features.end(); ++it)
   {
-    geos::geom::Geometry *Geom=geometries();
+    Lines.push_back(dynamic_cast<geos::geom::LineString*>((*it).second));
 
-    geos::geom::LineString *CurrentLine=(dynamic_cast<geos::geom::LineString*>((*it).second));
-    // get a vector of StartPoint and EndPoint of all Geometries
-    // except the current Geometry
-    std::vector<geos::geom::Point*> vPoints;
-    unsigned int iEnd = Geom->getNumGeometries();
-
-    for (unsigned int i = 0; i < iEnd; i++)
+    if (Lines.back() && !Lines.back()->isEmpty())
     {
-      if (!(const_cast<geos::geom::Geometry*>(Geom->getGeometryN(i)))->equals((*it).second))
-      {
-        geos::geom::LineString *Line =
-            dynamic_cast<geos::geom::LineString*>(const_cast<geos::geom::Geometry*>(Geom->getGeometryN(i)));
-        vPoints.push_back(Line->getStartPoint());
-        vPoints.push_back(Line->getEndPoint());
-      }
+      Grid.insert(Lines.back()->getCoordinateN(0),Lines.size()-1,0);
+      Grid.insert(Lines.back()->getCoordinateN(Lines.back()->getNumPoints()-1),Lines.size()-1,1);
     }
+  }
+
+  std::size_t i = 0;
+
+  for (FeaturesList_t::iterator it = Features.begin(); it != Features.end(); ++it, i++)
+  {
+    if (!Lines[i] || Lines[i]->isEmpty())
+      continue;
 
-    geos::geom::Point* PStart = CurrentLine->getStartPoint();
-    geos::geom::Point* PEnd = CurrentLine->getEndPoint();
-    geos::geom::Point* NewPStart = nullptr;
-    geos::geom::Point* NewPEnd = nullptr;
+    geos::geom::CoordinateSequence* CoordSeq = Lines[i]->getCoordinates();
+    const geos::geom::Coordinate Start = CoordSeq->getAt(0);
+    const geos::geom::Coordinate End = CoordSeq->getAt(CoordSeq->getSize()-1);
 
-    for (unsigned int j = 0; j < vPoints.size(); j++)
+    const geos::geom::Coordinate* NewStart = Grid.findSnapVertex(Start,i,true);
+    const geos::geom::Coordinate* NewEnd = Grid.findSnapVertex(End,i,true);
+
+    if (!NewStart && !NewEnd)
     {
-      if (!PStart->equals(vPoints.at(j)) && PStart->equalsExact(vPoints.at(j),Threshold))
-        NewPStart = vPoints.at(j);
-      if (!PEnd->equals(vPoints.at(j)) && PEnd->equalsExact(vPoints.at(j),Threshold))
-        NewPEnd = vPoints.at(j);
+      delete CoordSeq;
+      continue;
     }
 
-    if (!NewPStart && !NewPEnd)
-      continue;  // TODO to be replaced!
+    if (NewStart)
+      CoordSeq->setAt(*NewStart,0);
 
-    geos::geom::CoordinateSequence* CoordSeq=CurrentLine->getCoordinates();
-    if (NewPStart)
-      CoordSeq->setAt(*NewPStart->getCoordinate(),0);
+    if (NewEnd)
+      CoordSeq->setAt(*NewEnd,CoordSeq->getSize()-1);
 
-    if (NewPEnd)
-      CoordSeq->setAt(*NewPEnd->getCoordinate(),CoordSeq->getSize()-1);
+    // the next lines are snapped to the new end nodes of this line
+    Grid.remove(Start,i);
+    Grid.remove(End,i);
+    Grid.insert(CoordSeq->getAt(0),i,0);
+    Grid.insert(CoordSeq->getAt(CoordSeq->getSize()-1),i,1);
 
     geos::geom::LineString* NewLine = geos::geom::GeometryFactory::getDefaultInstance()->createLineString(CoordSeq);
     OGRGeometry* OGRGeom =
       openfluid::landr::convertGEOSGeometryToOGR((GEOSGeom) dynamic_cast<geos::geom::Geometry*>(NewLine));
-    OGRFeature* OGRFeat = (*it).first;
-    OGRFeat->SetGeometry(OGRGeom);
-    geos::geom::Geometry* NewLineClone = NewLine->clone();
-    OGRFeature* OGRFeatClone = OGRFeat->Clone();
-    (*it) = std::make_pair<OGRFeature*, geos::geom::Geometry*>
-    (dynamic_cast<OGRFeature *>(OGRFeat), dynamic_cast<geos::geom::Geometry*>(NewLineClone));
-    mp_DataSource->GetLayer(LayerIndex)->SetFeature(OGRFeatClone);
-    m_Geometries.clear();
+    (*it).first->SetGeometryDirectly(OGRGeom);
+    mp_DataSource->GetLayer(LayerIndex)->SetFeature((*it).first);
 
     delete NewLine;
-    OGRFeature::DestroyFeature(OGRFeat);
-    delete PStart;
-    delete PEnd;
-    delete NewPStart;
-    delete NewPEnd;
-    delete CurrentLine;
+    Snapped = true;
+  }
 
-    try
-    {
-      parse(LayerIndex);
-    }
-    catch (std::exception& e)
-    {
-      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
-                                                "Unable to parse the VectorDataset (" + std::string(e.what()) + ")");
-    }
+  if (!Snapped)
+    return;
+
+  // the dataset is parsed again once all lines have been snapped
+  try
+  {
+    parse(LayerIndex);
+  }
+  catch (std::exception& e)
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                              "Unable to parse the VectorDataset (" + std::string(e.what()) + ")");
   }
 }
 
@@ -815,82 +1169,120 @@ void VectorDataset::snapLineNodes(double Threshold,unsigned int LayerIndex)
 
 void VectorDataset::snapPolygonVertices(double Threshold,unsigned int LayerIndex)
 {
+  // only distinct vertices closer than a positive threshold are snapped
+  if (Threshold <= 0)
+    return;
+
   FeaturesList_t Features = features(LayerIndex);
 
+  // vertices of all polygons are indexed in a grid, each vertex is only compared to the vertices
+  // of the grid cells around it
+
+  SnapVerticesGrid Grid(Threshold);
+  std::vector<geos::geom::Polygon*> Polygons;
+
+  auto getRing = [](const geos::geom::Polygon* Polygon, std::size_t r)
+  {
+    return (r == 0 ? Polygon->getExteriorRing() : Polygon->getInteriorRingN(r-1));
+  };
+
   for (FeaturesList_t::iterator it = Features.begin(); it != Features.end(); ++it)
   {
+    Polygons.push_back(dynamic_cast<geos::geom::Polygon*>((*it).second));
 
-    geos::geom::Geometry* Geom = geometries();
-    geos::geom::Polygon* CurrentPolygon = (dynamic_cast<geos::geom::Polygon*>((*it).second));
+    if (!Polygons.back() || Polygons.back()->isEmpty())
+      continue;
 
-    // get a vector of the Coordinates of the vertices of all Geometries
-    // except the current Geometry
-    std::vector<geos::geom::Coordinate> vCoor;
-    unsigned int iEnd = Geom->getNumGeometries();
+    std::size_t Rank = 0;
 
-    for (unsigned int i = 0; i < iEnd; i++)
+    for (std::size_t r = 0; r <= Polygons.back()->getNumInteriorRing(); r++)
     {
+      const geos::geom::LineString* Ring = getRing(Polygons.back(),r);
 
-      if (!(const_cast<geos::geom::Geometry*>(Geom->getGeometryN(i)))->equals((*it).second))
+      for (std::size_t j = 0; j < Ring->getNumPoints(); j++)
+        Grid.insert(Ring->getCoordinateN(j),Polygons.size()-1,Rank++);
+    }
+  }
+
+  std::size_t i = 0;
+  bool Snapped = false;
+
+  for (FeaturesList_t::iterator it = Features.begin(); it != Features.end(); ++it, i++)
+  {
+    if (!Polygons[i] || Polygons[i]->isEmpty())
+      continue;
+
+    std::vector<geos::geom::CoordinateSequence*> RingsCoords;
+    std::vector<geos::geom::Coordinate> PreviousCoords;
+    bool PolygonSnapped = false;
+
+    for (std::size_t r = 0; r <= Polygons[i]->getNumInteriorRing(); r++)
+    {
+      RingsCoords.push_back(getRing(Polygons[i],r)->getCoordinates());
+
+      for (std::size_t j = 0; j < RingsCoords.back()->getSize(); j++)
       {
-        geos::geom::Polygon *Polygon=
-            (dynamic_cast<geos::geom::Polygon*>(const_cast<geos::geom::Geometry*>(Geom->getGeometryN(i))));
+        const geos::geom::Coordinate Coord = RingsCoords.back()->getAt(j);
+        const geos::geom::Coordinate* NewCoord = Grid.findSnapVertex(Coord,i,false);
+
+        PreviousCoords.push_back(Coord);
 
-        if (Polygon)
+        if (NewCoord)
         {
-          const std::vector<geos::geom::Coordinate> *vCoorPoly = Polygon->getCoordinates()->toVector();
-          vCoor.insert( vCoor.end(), vCoorPoly->begin(), vCoorPoly->end() );
-          delete vCoorPoly;
+          RingsCoords.back()->setAt(*NewCoord,j);
+          PolygonSnapped = true;
         }
-        delete Polygon;
       }
     }
 
-    const std::vector<geos::geom::Coordinate> *vCoorCurrentGeom = CurrentPolygon->getCoordinates()->toVector();
-    geos::geom::CoordinateSequence* CoordSeq = CurrentPolygon->getCoordinates();
-    for (unsigned int j = 0; j < vCoorCurrentGeom->size(); j++)
+    if (!PolygonSnapped)
     {
-      for (unsigned int h = 0; h < vCoor.size(); h++)
-      {
-        if (!vCoorCurrentGeom->at(j).equals(vCoor.at(h)) &&
-            vCoorCurrentGeom->at(j).distance(vCoor.at(h)) > 0 &&
-            vCoorCurrentGeom->at(j).distance(vCoor.at(h)) < Threshold)
-          CoordSeq->setAt(vCoor.at(h),j);
-      }
+      for (geos::geom::CoordinateSequence* Coords : RingsCoords)
+        delete Coords;
+      continue;
     }
 
-    geos::geom::Polygon* NewPolygon=geos::geom::GeometryFactory::getDefaultInstance()->createPolygon(
-        geos::geom::GeometryFactory::getDefaultInstance()->createLinearRing(CoordSeq),nullptr);
+    // the next polygons are snapped to the new vertices of this polygon
+    for (const geos::geom::Coordinate& Coord : PreviousCoords)
+      Grid.remove(Coord,i);
 
-    OGRGeometry* OGRGeom =
-        openfluid::landr::convertGEOSGeometryToOGR((GEOSGeom) dynamic_cast<geos::geom::Geometry*>(NewPolygon));
-    OGRFeature* OGRFeat = (*it).first;
+    std::size_t Rank = 0;
 
-    OGRFeat->SetGeometry(OGRGeom);
-    OGRFeature* OGRFeatClone = OGRFeat->Clone();
-    geos::geom::Geometry* NewPolygonClone = NewPolygon->clone();
-    (*it) = std::make_pair<OGRFeature*, geos::geom::Geometry*>
-    (dynamic_cast<OGRFeature *>(OGRFeatClone), dynamic_cast<geos::geom::Geometry*>(NewPolygonClone));
+    for (geos::geom::CoordinateSequence* Coords : RingsCoords)
+    {
+      for (std::size_t j = 0; j < Coords->getSize(); j++)
+        Grid.insert(Coords->getAt(j),i,Rank++);
+    }
 
-    mp_DataSource->GetLayer(LayerIndex)->SetFeature(OGRFeatClone);
+    const geos::geom::GeometryFactory* Factory = geos::geom::GeometryFactory::getDefaultInstance();
+    std::vector<geos::geom::Geometry*>* Holes = new std::vector<geos::geom::Geometry*>();
 
-    OGRFeature::DestroyFeature(OGRFeatClone);
-    delete NewPolygonClone;
-    delete CoordSeq;
-    delete vCoorCurrentGeom;
-    delete CurrentPolygon;
+    for (std::size_t r = 1; r < RingsCoords.size(); r++)
+      Holes->push_back(Factory->createLinearRing(RingsCoords[r]));
 
-    m_Geometries.clear();
-    try
-    {
-      parse(LayerIndex);
+    geos::geom::Polygon* NewPolygon = Factory->createPolygon(Factory->createLinearRing(RingsCoords[0]),Holes);
 
-    }
-    catch (std::exception& e)
-    {
-      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
-                                                "Unable to parse the VectorDataset (" + std::string(e.what()) + ")");
-    }
+    OGRGeometry* OGRGeom =
+        openfluid::landr::convertGEOSGeometryToOGR((GEOSGeom) dynamic_cast<geos::geom::Geometry*>(NewPolygon));
+    (*it).first->SetGeometryDirectly(OGRGeom);
+    mp_DataSource->GetLayer(LayerIndex)->SetFeature((*it).first);
+
+    delete NewPolygon;
+    Snapped = true;
+  }
+
+  if (!Snapped)
+    return;
+
+  // the dataset is parsed again once all polygons have been snapped
+  try
+  {
+    parse(LayerIndex);
+  }
+  catch (std::exception& e)
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                              "Unable to parse the VectorDataset (" + std::string(e.what()) + ")");
   }
 }
 
@@ -905,8 +1297,7 @@ std::string VectorDataset::checkTopology(double Threshold, unsigned int LayerInd
     throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"the VectorDataset is not Polygon type");
 
   std::string ErrorMsg;
-  // TODO move to... ?
-  setlocale(LC_NUMERIC, "C");
+  CNumericLocaleGuard LocaleGuard;
 
   OGRLayer* Layer = layer(LayerIndex);
 
@@ -968,7 +1359,8 @@ std::string VectorDataset::checkTopology(double Threshold, unsigned int LayerInd
 // =====================================================================
 
 
-std::list<std::pair<OGRFeature*, OGRFeature*> > VectorDataset::findOverlap(unsigned int LayerIndex)
+std::list<std::pair<OGRFeature*, OGRFeature*> > VectorDataset::findOverlap(unsigned int LayerIndex,
+                                                                            unsigned int MaxThreads)
 {
   if (!isPolygonType(LayerIndex))
     throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"the VectorDataset is not Polygon type.");
@@ -976,29 +1368,34 @@ std::list<std::pair<OGRFeature*, OGRFeature*> > VectorDataset::findOverlap(unsig
   m_Features.clear();
   m_Geometries.clear();
   std::list<std::pair<OGRFeature*,OGRFeature*>> lOverlaps;
-  FeaturesList_t Features = features(LayerIndex);
+  FeaturesList_t FeaturesList = features(LayerIndex);
+  std::vector<std::pair<OGRFeature*, geos::geom::Geometry*>> Features(FeaturesList.begin(),FeaturesList.end());
 
-  for (FeaturesList_t::iterator it = Features.begin(); it != Features.end(); ++it)
+  // overlapping polygons have intersecting envelopes
+  std::vector<std::vector<std::size_t>> Candidates = findCandidateFeatures(Features,0);
+  std::vector<std::vector<std::size_t>> Overlapping(Features.size());
+
+  openfluid::tools::runParallelRange(0,Features.size(),[&Features,&Candidates,&Overlapping](std::size_t Begin,
+                                                                                              std::size_t End)
   {
-    FeaturesList_t FeaturesToTest=features(LayerIndex);
-    for (FeaturesList_t::iterator jt = FeaturesToTest.begin(); jt != FeaturesToTest.end(); ++jt)
+    for (std::size_t i = Begin; i < End; i++)
     {
-      //test if overlap
-      if (!(*it).first->GetGeometryRef()->Equals((*jt).first->GetGeometryRef())
-          && (*it).first->GetGeometryRef()->Overlaps((*jt).first->GetGeometryRef()))
-      {
-        std::list<std::pair<OGRFeature*, OGRFeature*>>::iterator lt;
-        std::list<std::pair<OGRFeature*, OGRFeature*>>::iterator lt2;
-        std::pair<OGRFeature*, OGRFeature*> pair1 ((*it).first, (*jt).first);
-        std::pair<OGRFeature*, OGRFeature*> pair2 ((*jt).first, (*it).first);
-
-        lt = std::find(lOverlaps.begin(), lOverlaps.end(), pair1);
-        lt2 = std::find (lOverlaps.begin(), lOverlaps.end(), pair2);
-        if (lt == lOverlaps.end() && lt2 == lOverlaps.end())
-          lOverlaps.push_back(pair1);
+      OGRGeometry* Geom = Features[i].first->GetGeometryRef();
 
+      for (std::size_t j : Candidates[i])
+      {
+        //test if overlap
+        if (!Geom->Equals(Features[j].first->GetGeometryRef()) && Geom->Overlaps(Features[j].first->GetGeometryRef()))
+          Overlapping[i].push_back(j);
       }
     }
+  },MaxThreads);
+
+  // each pair is found once, from its first feature
+  for (std::size_t i = 0; i < Features.size(); i++)
+  {
+    for (std::size_t j : Overlapping[i])
+      lOverlaps.push_back(std::make_pair(Features[i].first,Features[j].first));
   }
 
   return lOverlaps;
@@ -1009,7 +1406,8 @@ std::list<std::pair<OGRFeature*, OGRFeature*> > VectorDataset::findOverlap(unsig
 // =====================================================================
 
 
-std::list<std::pair<OGRFeature*,OGRFeature*> > VectorDataset::findGap(double Threshold, unsigned int LayerIndex)
+std::list<std::pair<OGRFeature*,OGRFeature*> > VectorDataset::findGap(double Threshold, unsigned int LayerIndex,
+                                                                      unsigned int MaxThreads)
 {
   if ( ! isPolygonType(LayerIndex))
     throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"the VectorDataset is not Polygon type.");
@@ -1017,30 +1415,37 @@ std::list<std::pair<OGRFeature*,OGRFeature*> > VectorDataset::findGap(double Thr
   m_Features.clear();
   m_Geometries.clear();
   std::list<std::pair<OGRFeature*,OGRFeature*> > lGaps;
-  FeaturesList_t Features = features(LayerIndex);
+  FeaturesList_t FeaturesList = features(LayerIndex);
+  std::vector<std::pair<OGRFeature*, geos::geom::Geometry*>> Features(FeaturesList.begin(),FeaturesList.end());
 
-  for (FeaturesList_t::iterator it = Features.begin(); it != Features.end(); ++it)
+  // polygons closer than the threshold have envelopes closer than the threshold
+  std::vector<std::vector<std::size_t>> Candidates = findCandidateFeatures(Features,Threshold);
+  std::vector<std::vector<std::size_t>> Gaps(Features.size());
+
+  openfluid::tools::runParallelRange(0,Features.size(),[&Features,&Candidates,&Gaps,Threshold](std::size_t Begin,
+                                                                                                 std::size_t End)
   {
-    FeaturesList_t FeaturesToTest = features(LayerIndex);
-    for (FeaturesList_t::iterator jt = FeaturesToTest.begin(); jt != FeaturesToTest.end(); ++jt)
+    for (std::size_t i = Begin; i < End; i++)
     {
-      //test if Gap (under the threshold)
-      if (!(*it).first->GetGeometryRef()->Equals((*jt).first->GetGeometryRef()) &&
-          !(*it).first->GetGeometryRef()->Touches((*jt).first->GetGeometryRef()) &&
-          !(*it).first->GetGeometryRef()->Overlaps((*jt).first->GetGeometryRef()) &&
-          (*it).first->GetGeometryRef()->Distance((*jt).first->GetGeometryRef()) < Threshold)
+      OGRGeometry* Geom = Features[i].first->GetGeometryRef();
+
+      for (std::size_t j : Candidates[i])
       {
-        std::list<std::pair<OGRFeature*,OGRFeature*>>::iterator lt;
-        std::list<std::pair<OGRFeature*,OGRFeature*>>::iterator lt2;
-        std::pair<OGRFeature*,OGRFeature*> pair1((*it).first, (*jt).first);
-        std::pair<OGRFeature*,OGRFeature*> pair2((*jt).first, (*it).first);
-
-        lt = std::find(lGaps.begin(), lGaps.end(), pair1);
-        lt2 = std::find (lGaps.begin(), lGaps.end(), pair2);
-        if (lt == lGaps.end() && lt2 == lGaps.end())
-          lGaps.push_back(pair1);
+        OGRGeometry* OtherGeom = Features[j].first->GetGeometryRef();
+
+        //test if Gap (under the threshold)
+        if (!Geom->Equals(OtherGeom) && !Geom->Touches(OtherGeom) && !Geom->Overlaps(OtherGeom) &&
+            Geom->Distance(OtherGeom) < Threshold)
+          Gaps[i].push_back(j);
       }
     }
+  },MaxThreads);
+
+  // each pair is found once, from its first feature
+  for (std::size_t i = 0; i < Features.size(); i++)
+  {
+    for (std::size_t j : Gaps[i])
+      lGaps.push_back(std::make_pair(Features[i].first,Features[j].first));
   }
 
   return lGaps;
@@ -1053,12 +1458,14 @@ std::list<std::pair<OGRFeature*,OGRFeature*> > VectorDataset::findGap(double Thr
 
 void VectorDataset::cleanOverlap(double Threshold, unsigned int LayerIndex)
 {
+  checkWritable("clean the overlaps");
+
   if ( ! isPolygonType(LayerIndex))
     throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"the VectorDataset is not Polygon type.");
 
   m_Features.clear();
   m_Geometries.clear();
-  std::list<std::pair<OGRFeature*,OGRFeature*> > lOverlaps = findOverlap();
+  std::list<std::pair<OGRFeature*,OGRFeature*> > lOverlaps = findOverlap(LayerIndex);
 
   int lSize=lOverlaps.size();
   for (int i=0; i<lSize;i++)
@@ -1116,7 +1523,7 @@ void VectorDataset::cleanOverlap(double Threshold, unsigned int LayerIndex)
     }
 
     lOverlaps.clear();
-    lOverlaps=findOverlap();
+    lOverlaps=findOverlap(LayerIndex);
   }
 
   try
@@ -1138,22 +1545,30 @@ void VectorDataset::cleanOverlap(double Threshold, unsigned int LayerIndex)
 std::list<OGRFeature*> VectorDataset::hasDuplicateGeometry(unsigned int LayerIndex)
 {
   std::list<OGRFeature*> lDuplicate;
-  FeaturesList_t Features = features(LayerIndex);
+  FeaturesList_t FeaturesList = features(LayerIndex);
+  std::vector<std::pair<OGRFeature*, geos::geom::Geometry*>> Features(FeaturesList.begin(),FeaturesList.end());
 
-  for (FeaturesList_t::iterator it = Features.begin(); it != Features.end(); ++it)
-  {
-    geos::geom::Geometry* Geom = geometries();
-    unsigned int iEnd = Geom->getNumGeometries();
-    int DuplicateGeom = 0;
+  // equal geometries have equal envelopes
+  std::vector<std::vector<std::size_t>> Candidates = findCandidateFeatures(Features,0);
+  std::vector<bool> Duplicate(Features.size(),false);
 
-    for (unsigned int i = 0; i < iEnd; i++)
+  for (std::size_t i = 0; i < Features.size(); i++)
+  {
+    for (std::size_t j : Candidates[i])
     {
-      if ((const_cast<geos::geom::Geometry*>(Geom->getGeometryN(i)))->equals((*it).second))
-        DuplicateGeom++;
+      if (Features[i].second->getEnvelopeInternal()->equals(Features[j].second->getEnvelopeInternal()) &&
+          Features[i].second->equals(Features[j].second))
+      {
+        Duplicate[i] = true;
+        Duplicate[j] = true;
+      }
     }
+  }
 
-    if (DuplicateGeom > 1)
-      lDuplicate.push_back((*it).first);
+  for (std::size_t i = 0; i < Features.size(); i++)
+  {
+    if (Duplicate[i])
+      lDuplicate.push_back(Features[i].first);
   }
 
   return lDuplicate;
@@ -43,6 +43,7 @@
 #include <string>
 #include <map>
 #include <list>
+#include <functional>
 
 #include <ogrsf_frmts.h>
 
@@ -77,6 +78,11 @@ class OPENFLUID_API VectorDataset
     */
     GDALDataset_COMPAT* mp_DataSource;
 
+    /**
+      @brief True if the OGRDataSource is opened in place in read-only mode, false if it is a temporary copy.
+    */
+    bool m_ReadOnly;
+
     /**
       @brief A list of all features of layers of this VectorDataset, indexed by layer index.
     */
@@ -85,6 +91,7 @@ class OPENFLUID_API VectorDataset
     /**
       @brief A map of geos::geom::Geometry representing a collection of all
       the geometries of the layers of this VectorDataset, indexed by layer index.
+      Each collection is built on its first use.
     */
     std::map<unsigned int, geos::geom::Geometry*> m_Geometries;
 
@@ -111,6 +118,12 @@ class OPENFLUID_API VectorDataset
     */
     void parse(unsigned int LayerIndex);
 
+    /**
+      @brief Throws an openfluid::base::FrameworkException if this VectorDataset is read-only.
+      @param Operation The name of the operation, for the error message.
+    */
+    void checkWritable(const std::string& Operation) const;
+
     void snapLineNodes(double Threshold,unsigned int LayerIndex=0);
 
     void snapPolygonVertices(double Threshold,unsigned int LayerIndex=0);
@@ -128,19 +141,24 @@ class OPENFLUID_API VectorDataset
     /**
       @brief Creates in the openfluid temp directory a copy of Value OGRDatasource,
       using Value filename suffixed with timestamp as filename.
+      If ReadOnly is true, the OGRDatasource of Value is opened in place in read-only mode instead of being copied,
+      and the operations modifying this VectorDataset are not allowed.
       @param Value The GeoVectorValue to copy
+      @param ReadOnly If true, opens the OGRDatasource in place without copying it, default false.
       @throw openfluid::base::FrameworkException if fails.
     */
-    VectorDataset(openfluid::core::GeoVectorValue& Value);
+    VectorDataset(openfluid::core::GeoVectorValue& Value, bool ReadOnly = false);
 
     /**
       @brief Copy constructor.
+      The copy is always created in the openfluid temp directory and is writable, even if Other is read-only.
       @throw openfluid::base::FrameworkException if fails.
     */
     VectorDataset(const VectorDataset& Other);
 
     /**
       @brief Delete the OGRDatasource and relative files in openfluid temp directory.
+      A read-only OGRDatasource opened in place is only closed.
     */
     ~VectorDataset();
 
@@ -154,6 +172,11 @@ class OPENFLUID_API VectorDataset
     */
     GDALDataset_COMPAT* source() const;
 
+    /**
+      @brief Returns true if this VectorDataset is opened in place in read-only mode.
+    */
+    bool isReadOnly() const;
+
     /**
       @brief Write to disk a copy of the OGRDataSource.
       @param FilePath The path to the directory where writing, will be created if needed.
@@ -166,6 +189,7 @@ class OPENFLUID_API VectorDataset
 
     /**
       @brief Add to DataSource an empty new layer.
+      Not allowed on a read-only VectorDataset.
       @param LayerName The name of the layer to create.
       @param LayerType The type of the layer to create, default wkbUnknown.
       @param SpatialRef The coordinate system to use for the new layer,
@@ -192,6 +216,7 @@ class OPENFLUID_API VectorDataset
 
     /**
       @brief Add a field to a layer.
+      Not allowed on a read-only VectorDataset.
       @param FieldName The name of the field to add.
       @param FieldType The type of the field to add (default OFTString).
       @param LayerIndex The index of the layer to add the field, default 0.
@@ -263,9 +288,23 @@ class OPENFLUID_API VectorDataset
     */
     FeaturesList_t features(unsigned int LayerIndex = 0);
 
+    /**
+      @brief Reads all features of a layer of this VectorDataset by chunks, without keeping them.
+      Only one chunk of features and geometries is in memory at a time, which is suitable for large layers.
+      @param Func The function called for each chunk, with the list of OGRFeature and geos::geom::Geometry
+      of the chunk. The features and geometries are destroyed after the call.
+      @param ChunkSize The maximum number of features in a chunk, default 1024.
+      @param LayerIndex The index of the layer to query, default 0.
+      @throw openfluid::base::FrameworkException if a geometry is not valid.
+    */
+    void streamFeatures(const std::function<void(const FeaturesList_t&)>& Func,
+                        unsigned int ChunkSize = 1024,
+                        unsigned int LayerIndex = 0);
+
     /**
       @brief Gets a geos::geom::Geometry representing a collection of all
       the geometries of the layer LayerIndex of this GeoVectorValue.
+      The collection is built on the first call.
       @param LayerIndex The index of the layer to query, default 0.
       @return A geos::geom::Geometry.
     */
@@ -280,6 +319,7 @@ class OPENFLUID_API VectorDataset
 
     /**
       @brief Sets an integer Field with an index list (increment value one by one)
+      Not allowed on a read-only VectorDataset.
       @param FieldName The name of the field to query (must exist).
       @param BeginValue The begin value, default 1.
       @param LayerIndex The index of the layer to query, default 0.
@@ -295,7 +335,7 @@ class OPENFLUID_API VectorDataset
 
     /**
       @brief Snap the vertices of this VectorDataset.
-      Only for Polygon or Line Type;
+      Only for Polygon or Line Type; not allowed on a read-only VectorDataset.
       @param Threshold The snapping threshold value.
       @param LayerIndex The index of the layer to query, default 0.
      */
@@ -313,23 +353,33 @@ class OPENFLUID_API VectorDataset
     /**
       @brief Find the overlapping polygons.
       Only for Polygon Type;
+      Only the pairs of polygons with intersecting envelopes are tested,
+      using a spatial index of the polygons envelopes.
       @param LayerIndex The index of the layer to query, default 0.
+      @param MaxThreads The maximum number of threads used to test the pairs of polygons,
+      0 (default) uses the ideal number of threads.
       @return A list of pair of OGRFeature* for each overlap between two polygons.
      */
-    std::list<std::pair<OGRFeature*, OGRFeature*> > findOverlap(unsigned int LayerIndex=0);
+    std::list<std::pair<OGRFeature*, OGRFeature*> > findOverlap(unsigned int LayerIndex=0,
+                                                                unsigned int MaxThreads=0);
 
     /**
       @brief Find gap between polygons.
       Only for Polygon Type;
+      Only the pairs of polygons with envelopes closer than the threshold are tested,
+      using a spatial index of the polygons envelopes.
       @param Threshold The maximum distance between polygon to be considered as gap.
       @param LayerIndex The index of the layer to query, default 0.
+      @param MaxThreads The maximum number of threads used to test the pairs of polygons,
+      0 (default) uses the ideal number of threads.
       @return A list of pair of OGRFeature* for each overlap between two polygons.
      */
-    std::list<std::pair<OGRFeature*, OGRFeature*> > findGap(double Threshold,unsigned int LayerIndex=0);
+    std::list<std::pair<OGRFeature*, OGRFeature*> > findGap(double Threshold,unsigned int LayerIndex=0,
+                                                            unsigned int MaxThreads=0);
 
     /**
       @brief Clean the overlapping polygons.
-      Only for Polygon Type;
+      Only for Polygon Type; not allowed on a read-only VectorDataset.
       @param Threshold The snapping threshold value.
       @param LayerIndex The index of the layer to query, default 0.
      */
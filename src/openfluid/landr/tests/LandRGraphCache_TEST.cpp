@@ -0,0 +1,215 @@
+/*
+
+  This file is part of OpenFLUID software
+  Copyright(c) 2007, INRA - Montpellier SupAgro
+
+
+ == GNU General Public License Usage ==
+
+  OpenFLUID is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OpenFLUID is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OpenFLUID. If not, see <http://www.gnu.org/licenses/>.
+
+
+ == Other Usage ==
+
+  Other Usage means a use of OpenFLUID that is inconsistent with the GPL
+  license, and requires a written agreement between You and INRA.
+  Licensees for Other Usage of OpenFLUID may use this file in accordance
+  with the terms contained in the written agreement between You and INRA.
+
+*/
+
+/**
+  @file LandRGraphCache_TEST.cpp
+
+  @author Jean-Christophe Fabre <jean-christophe.fabre@supagro.inra.fr>
+ */
+
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE unittest_landrgraphcache
+#include <boost/test/unit_test.hpp>
+#include <boost/test/auto_unit_test.hpp>
+#include <iterator>
+#include <tests-config.hpp>
+#include <openfluid/base/FrameworkException.hpp>
+#include <openfluid/base/Environment.hpp>
+#include <openfluid/core/GeoVectorValue.hpp>
+#include <openfluid/core/DoubleValue.hpp>
+#include <openfluid/core/IntegerValue.hpp>
+#include <openfluid/core/StringValue.hpp>
+#include <openfluid/landr/LandRGraphCache.hpp>
+#include <openfluid/landr/PolygonGraph.hpp>
+#include <openfluid/landr/PolygonEdge.hpp>
+#include <openfluid/landr/LineStringGraph.hpp>
+#include <openfluid/tools/Filesystem.hpp>
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_computeKey)
+{
+  std::string SUPath = CONFIGTESTS_INPUT_MISCDATA_DIR + "/landr/SU.shp";
+  std::string RSPath = CONFIGTESTS_INPUT_MISCDATA_DIR + "/landr/RS.shp";
+
+  std::string Key = openfluid::landr::LandRGraphCache::computeKey(SUPath);
+
+  BOOST_CHECK_EQUAL(Key.size(),16);
+  BOOST_CHECK_EQUAL(Key,openfluid::landr::LandRGraphCache::computeKey(SUPath));
+  BOOST_CHECK_NE(Key,openfluid::landr::LandRGraphCache::computeKey(SUPath,"neighbours"));
+  BOOST_CHECK_NE(Key,openfluid::landr::LandRGraphCache::computeKey(RSPath));
+
+  BOOST_CHECK_THROW(openfluid::landr::LandRGraphCache::computeKey(CONFIGTESTS_INPUT_MISCDATA_DIR + "/landr/none.shp"),
+                    openfluid::base::FrameworkException);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_PolygonGraph)
+{
+  std::string CachePath = CONFIGTESTS_OUTPUT_DATA_DIR + "/landr/cache/SU.landrcache";
+  openfluid::tools::Filesystem::removeFile(CachePath);
+
+  openfluid::core::GeoVectorValue* Vector =
+    new openfluid::core::GeoVectorValue(CONFIGTESTS_INPUT_MISCDATA_DIR + "/landr", "SU.shp");
+
+  std::string Key = openfluid::landr::LandRGraphCache::computeKey(CONFIGTESTS_INPUT_MISCDATA_DIR + "/landr/SU.shp");
+
+  BOOST_CHECK(!openfluid::landr::LandRGraphCache::loadPolygonGraph(CachePath,Key));
+
+  openfluid::landr::PolygonGraph* Graph = openfluid::landr::PolygonGraph::create(*Vector);
+  Graph->computeNeighbours();
+
+  Graph->addAttribute("area");
+  Graph->addAttribute("name");
+  Graph->addAttribute("empty");
+
+  openfluid::landr::LandRGraph::Entities_t Entities = Graph->getEntities();
+  openfluid::landr::LandRGraph::Entities_t::iterator it = Entities.begin();
+  for (; it != Entities.end(); ++it)
+  {
+    (*it)->setAttributeValue("area",new openfluid::core::DoubleValue((*it)->getArea()/3.0));
+    (*it)->setAttributeValue("name",new openfluid::core::StringValue("SU#" + std::to_string((*it)->getOfldId())));
+  }
+
+  openfluid::core::IntegerValue EdgeVal(7);
+  Graph->createEdgeAttribute("edgeattr",EdgeVal);
+
+  openfluid::landr::LandRGraphCache::save(*Graph,CachePath,Key);
+
+  BOOST_CHECK(!openfluid::landr::LandRGraphCache::loadPolygonGraph(CachePath,Key + "x"));
+  BOOST_CHECK(!openfluid::landr::LandRGraphCache::loadLineStringGraph(CachePath,Key));
+
+  openfluid::landr::PolygonGraph* Loaded = openfluid::landr::LandRGraphCache::loadPolygonGraph(CachePath,Key);
+
+  BOOST_REQUIRE(Loaded);
+  BOOST_CHECK_EQUAL(Loaded->getSize(),Graph->getSize());
+  BOOST_CHECK_EQUAL(Loaded->getEdges()->size(),Graph->getEdges()->size());
+  BOOST_CHECK_EQUAL(std::distance(Loaded->nodeBegin(),Loaded->nodeEnd()),
+                    std::distance(Graph->nodeBegin(),Graph->nodeEnd()));
+  BOOST_CHECK(Loaded->isComplete());
+
+  openfluid::landr::LandRGraph::Entities_t LoadedEntities = Loaded->getEntities();
+  openfluid::landr::LandRGraph::Entities_t::iterator itL = LoadedEntities.begin();
+  for (it = Entities.begin(); it != Entities.end(); ++it, ++itL)
+  {
+    openfluid::landr::PolygonEntity* Ent = dynamic_cast<openfluid::landr::PolygonEntity*>(*it);
+    openfluid::landr::PolygonEntity* LoadedEnt = dynamic_cast<openfluid::landr::PolygonEntity*>(*itL);
+
+    BOOST_CHECK_EQUAL(LoadedEnt->getOfldId(),Ent->getOfldId());
+    BOOST_CHECK(LoadedEnt->geometry()->equalsExact(Ent->geometry()));
+    BOOST_CHECK(LoadedEnt->getOrderedNeighbourOfldIds() == Ent->getOrderedNeighbourOfldIds());
+    BOOST_CHECK_EQUAL(LoadedEnt->m_PolyEdges.size(),Ent->m_PolyEdges.size());
+
+    openfluid::core::DoubleValue Area, LoadedArea;
+    BOOST_CHECK(Ent->getAttributeValue("area",Area));
+    BOOST_CHECK(LoadedEnt->getAttributeValue("area",LoadedArea));
+    BOOST_CHECK_EQUAL(Area.get(),LoadedArea.get());
+
+    openfluid::core::StringValue Name;
+    BOOST_CHECK(LoadedEnt->getAttributeValue("name",Name));
+    BOOST_CHECK_EQUAL(Name.get(),"SU#" + std::to_string(Ent->getOfldId()));
+
+    openfluid::core::IntegerValue LoadedEdgeVal;
+    BOOST_CHECK(LoadedEnt->m_PolyEdges.front()->getAttributeValue("edgeattr",LoadedEdgeVal));
+    BOOST_CHECK_EQUAL(LoadedEdgeVal.get(),7);
+  }
+
+  BOOST_CHECK(Loaded->getAttributeNames() == Graph->getAttributeNames());
+
+  delete Loaded;
+  delete Graph;
+  delete Vector;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_LineStringGraph)
+{
+  std::string CachePath = CONFIGTESTS_OUTPUT_DATA_DIR + "/landr/cache/RS.landrcache";
+
+  openfluid::core::GeoVectorValue* Vector =
+    new openfluid::core::GeoVectorValue(CONFIGTESTS_INPUT_MISCDATA_DIR + "/landr", "RS.shp");
+
+  std::string Key = openfluid::landr::LandRGraphCache::computeKey(CONFIGTESTS_INPUT_MISCDATA_DIR + "/landr/RS.shp");
+
+  openfluid::landr::LineStringGraph* Graph = openfluid::landr::LineStringGraph::create(*Vector);
+
+  openfluid::landr::LandRGraphCache::save(*Graph,CachePath,Key);
+
+  BOOST_CHECK(!openfluid::landr::LandRGraphCache::loadPolygonGraph(CachePath,Key));
+
+  openfluid::landr::LineStringGraph* Loaded = openfluid::landr::LandRGraphCache::loadLineStringGraph(CachePath,Key);
+
+  BOOST_REQUIRE(Loaded);
+  BOOST_CHECK_EQUAL(Loaded->getSize(),Graph->getSize());
+  BOOST_CHECK_EQUAL(std::distance(Loaded->nodeBegin(),Loaded->nodeEnd()),
+                    std::distance(Graph->nodeBegin(),Graph->nodeEnd()));
+  BOOST_CHECK_EQUAL(Loaded->getStartLineStringEntities().size(),Graph->getStartLineStringEntities().size());
+
+  openfluid::landr::LandRGraph::Entities_t Entities = Graph->getEntities();
+  openfluid::landr::LandRGraph::Entities_t::iterator it = Entities.begin();
+  for (; it != Entities.end(); ++it)
+  {
+    openfluid::landr::LineStringEntity* Ent = dynamic_cast<openfluid::landr::LineStringEntity*>(*it);
+    openfluid::landr::LineStringEntity* LoadedEnt = Loaded->entity(Ent->getOfldId());
+
+    BOOST_REQUIRE(LoadedEnt);
+    BOOST_CHECK(LoadedEnt->line()->equalsExact(Ent->line()));
+    BOOST_CHECK_EQUAL(LoadedEnt->neighbours()->size(),Ent->neighbours()->size());
+  }
+
+  delete Loaded;
+  delete Graph;
+  delete Vector;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+int main(int argc, char *argv[])
+{
+  openfluid::base::Environment::init();
+
+  return ::boost::unit_test::unit_test_main( &init_unit_test, argc, argv );
+}
@@ -41,6 +41,7 @@
 #define BOOST_TEST_MODULE unittest_landrgraph
 #include <boost/test/unit_test.hpp>
 #include <boost/test/auto_unit_test.hpp>
+#include <algorithm>
 #include <tests-config.hpp>
 #include <openfluid/base/FrameworkException.hpp>
 #include <openfluid/base/Environment.hpp>
@@ -48,6 +49,7 @@
 #include <openfluid/core/GeoRasterValue.hpp>
 #include <openfluid/core/IntegerValue.hpp>
 #include <openfluid/core/StringValue.hpp>
+#include <openfluid/landr/LandREntity.hpp>
 #include <openfluid/landr/PolygonGraph.hpp>
 #include <openfluid/landr/LineStringGraph.hpp>
 #include <openfluid/landr/VectorDataset.hpp>
@@ -441,6 +443,18 @@ BOOST_AUTO_TEST_CASE(check_get_AVectorAttribute_from_Location_for_LineStringGrap
   Entity->getAttributeValue("attribut", DoubleValue);
   BOOST_CHECK( openfluid::scientific::isVeryClose(DoubleValue.get(), 17.14));
 
+  Graph->setAttributeFromVectorLocation("attribut_1thread",*Vect, "MYVALUE",8,1);
+  openfluid::core::DoubleValue SingleThreadValue(0);
+
+  for (unsigned int i = 1; i <= Graph->getSize(); i++)
+  {
+    if (Graph->entity(i) && Graph->entity(i)->getAttributeValue("attribut", DoubleValue))
+    {
+      BOOST_CHECK(Graph->entity(i)->getAttributeValue("attribut_1thread", SingleThreadValue));
+      BOOST_CHECK_EQUAL(DoubleValue.get(), SingleThreadValue.get());
+    }
+  }
+
 
   Graph->setAttributeFromVectorLocation("attribut",*Vect, "comment",8);
   openfluid::core::StringValue StringValue("");
@@ -661,6 +675,58 @@ BOOST_AUTO_TEST_CASE(check_DuplicateGeometry)
 // =====================================================================
 
 
+BOOST_AUTO_TEST_CASE(check_computeNeighbours_adjacency)
+{
+  std::vector<std::string> Files = {"SU.shp","RS.shp"};
+
+  for (const std::string& File : Files)
+  {
+    openfluid::core::GeoVectorValue* Vector =
+      new openfluid::core::GeoVectorValue(CONFIGTESTS_INPUT_MISCDATA_DIR + "/landr", File);
+
+    openfluid::landr::LandRGraph* Graph = nullptr;
+    if (Vector->isPolygonType())
+      Graph = openfluid::landr::PolygonGraph::create(*Vector);
+    else
+      Graph = openfluid::landr::LineStringGraph::create(*Vector);
+
+    openfluid::landr::LandRGraph::NeighboursAdjacency SingleAdj = Graph->computeNeighbours(1);
+    openfluid::landr::LandRGraph::NeighboursAdjacency Adj = Graph->computeNeighbours(4);
+
+    BOOST_CHECK_EQUAL(Adj.Entities.size(),Graph->getSize());
+    BOOST_CHECK_EQUAL(Adj.Offsets.size(),Graph->getSize()+1);
+    BOOST_CHECK(Adj.Entities == SingleAdj.Entities);
+    BOOST_CHECK(Adj.Offsets == SingleAdj.Offsets);
+    BOOST_CHECK(Adj.Neighbours == SingleAdj.Neighbours);
+    BOOST_CHECK_EQUAL(Adj.Neighbours.size(),Adj.Offsets.back());
+
+    for (unsigned int i = 0; i < Adj.Entities.size(); i++)
+    {
+      std::set<openfluid::landr::LandREntity*>* Neighbours = Adj.Entities[i]->neighbours();
+
+      BOOST_REQUIRE_EQUAL(Adj.Offsets[i+1]-Adj.Offsets[i],Neighbours->size());
+
+      for (unsigned int j = Adj.Offsets[i]; j < Adj.Offsets[i+1]; j++)
+      {
+        BOOST_CHECK(Neighbours->count(Adj.Entities[Adj.Neighbours[j]]));
+
+        // neighbourhood is symmetric
+        unsigned int k = Adj.Neighbours[j];
+        BOOST_CHECK(std::binary_search(Adj.Neighbours.begin()+Adj.Offsets[k],Adj.Neighbours.begin()+Adj.Offsets[k+1],
+                                       i));
+      }
+    }
+
+    delete Graph;
+    delete Vector;
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 int main(int argc, char *argv[])
 {
   openfluid::base::Environment::init();
@@ -41,6 +41,10 @@
 #define BOOST_TEST_MODULE unittest_polygongraph
 #include <boost/test/unit_test.hpp>
 #include <boost/test/auto_unit_test.hpp>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <map>
 #include <tests-config.hpp>
 #include <openfluid/base/FrameworkException.hpp>
 #include <openfluid/base/Environment.hpp>
@@ -70,6 +74,47 @@
 // =====================================================================
 
 
+/**
+  Returns the ordered neighbours of all entities of the graph, indexed by OpenFLUID ID
+*/
+std::map<unsigned int,std::vector<int>> getNeighboursByOfldId(openfluid::landr::PolygonGraph* Graph)
+{
+  std::map<unsigned int,std::vector<int>> Neighbours;
+
+  for (auto Entity : Graph->getEntities())
+  {
+    Neighbours[Entity->getOfldId()] =
+      dynamic_cast<openfluid::landr::PolygonEntity*>(Entity)->getOrderedNeighbourOfldIds();
+  }
+
+  return Neighbours;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+/**
+  Checks that the neighbours kept by the entities after merges are the ones of a full recomputation
+*/
+void checkNeighboursUpToDate(openfluid::landr::PolygonGraph* Graph)
+{
+  std::map<unsigned int,std::vector<int>> Neighbours = getNeighboursByOfldId(Graph);
+
+  Graph->computeNeighbours();
+
+  for (auto& ExpectedNeighbours : getNeighboursByOfldId(Graph))
+  {
+    BOOST_CHECK(Neighbours[ExpectedNeighbours.first] == ExpectedNeighbours.second);
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 BOOST_AUTO_TEST_CASE(check_construction_fromGeovectorValue)
 {
   openfluid::core::GeoVectorValue* Val =
@@ -251,6 +296,79 @@ BOOST_AUTO_TEST_CASE(check_construction_twoSimplePolygons)
 // =====================================================================
 
 
+BOOST_AUTO_TEST_CASE(check_construction_syntheticTessellation)
+{
+  // regular grid of Size x Size unit squares, ids are given row by row
+
+  const unsigned int Size = 30;
+
+  geos::geom::CoordinateArraySequenceFactory SeqFactory;
+  geos::geom::GeometryFactory Factory;
+  openfluid::landr::LandRGraph::Entities_t Entites;
+
+  for (unsigned int j = 0; j < Size; j++)
+  {
+    for (unsigned int i = 0; i < Size; i++)
+    {
+      std::vector<geos::geom::Coordinate>* Coos = new std::vector<geos::geom::Coordinate>();
+      Coos->push_back(geos::geom::Coordinate(i, j));
+      Coos->push_back(geos::geom::Coordinate(i, j+1));
+      Coos->push_back(geos::geom::Coordinate(i+1, j+1));
+      Coos->push_back(geos::geom::Coordinate(i+1, j));
+      Coos->push_back(geos::geom::Coordinate(i, j));
+
+      geos::geom::LinearRing* LR = Factory.createLinearRing(SeqFactory.create(Coos));
+      geos::geom::Polygon* P = Factory.createPolygon(LR, nullptr);
+      Entites.push_back(new openfluid::landr::PolygonEntity(P, j*Size+i+1));
+    }
+  }
+
+  std::chrono::high_resolution_clock::time_point Start = std::chrono::high_resolution_clock::now();
+
+  openfluid::landr::PolygonGraph* Graph = openfluid::landr::PolygonGraph::create(Entites);
+
+  std::chrono::high_resolution_clock::time_point End = std::chrono::high_resolution_clock::now();
+
+  std::cout << "Construction of a " << Size << "x" << Size << " polygons graph: "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(End-Start).count() << "ms" << std::endl;
+
+  BOOST_CHECK_EQUAL(Graph->getSize(), Size*Size);
+  BOOST_CHECK(Graph->isComplete());
+
+  for (unsigned int j = 0; j < Size; j++)
+  {
+    for (unsigned int i = 0; i < Size; i++)
+    {
+      unsigned int ExpectedCount = 4;
+
+      if (i == 0 || i == Size-1)
+        ExpectedCount--;
+      if (j == 0 || j == Size-1)
+        ExpectedCount--;
+
+      BOOST_CHECK_EQUAL(Graph->entity(j*Size+i+1)->getOrderedNeighbourOfldIds().size(), ExpectedCount);
+    }
+  }
+
+  // the first interior cell has its neighbours on both sides in the same row and in the adjacent rows
+  std::vector<int> Neighbours = Graph->entity(Size+2)->getOrderedNeighbourOfldIds();
+  BOOST_REQUIRE_EQUAL(Neighbours.size(), 4);
+  BOOST_CHECK_EQUAL(Neighbours[0], 2);
+  BOOST_CHECK_EQUAL(Neighbours[1], Size+1);
+  BOOST_CHECK_EQUAL(Neighbours[2], Size+3);
+  BOOST_CHECK_EQUAL(Neighbours[3], 2*Size+2);
+
+  delete Graph;
+
+  for (openfluid::landr::LandREntity* Ent : Entites)
+    delete Ent;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 BOOST_AUTO_TEST_CASE(check_construction_anIsolatedPolygon)
 {
   // * * * * *
@@ -848,6 +966,75 @@ BOOST_AUTO_TEST_CASE(check_setAttributeFromMeanRasterValues_intPixelType)
 // =====================================================================
 
 
+BOOST_AUTO_TEST_CASE(check_setAttributeFromRasterStatistic)
+{
+  openfluid::core::GeoVectorValue* Vector =
+    new openfluid::core::GeoVectorValue(CONFIGTESTS_INPUT_MISCDATA_DIR + "/landr", "SU.shp");
+
+  openfluid::core::GeoRasterValue* Raster =
+    new openfluid::core::GeoRasterValue(CONFIGTESTS_INPUT_MISCDATA_DIR + "/GeoRasterValue", "dem.jpeg");
+
+  openfluid::landr::PolygonGraph* Graph = openfluid::landr::PolygonGraph::create(*Vector);
+
+  BOOST_CHECK_THROW(Graph->setAttributeFromRasterStatistic("mean_val",openfluid::landr::PolygonGraph::MEAN),
+                    openfluid::base::FrameworkException);
+
+  Graph->addAGeoRasterValue(*Raster);
+
+  Graph->setAttributeFromRasterStatistic("mean_val",openfluid::landr::PolygonGraph::MEAN);
+  Graph->setAttributeFromRasterStatistic("mean_val_1thread",openfluid::landr::PolygonGraph::MEAN,1);
+  Graph->setAttributeFromRasterStatistic("min_val",openfluid::landr::PolygonGraph::MIN);
+  Graph->setAttributeFromRasterStatistic("max_val",openfluid::landr::PolygonGraph::MAX);
+  Graph->setAttributeFromRasterStatistic("sum_val",openfluid::landr::PolygonGraph::SUM);
+
+  openfluid::core::DoubleValue Mean, Mean1Thread, Min, Max, Sum;
+
+  Graph->entity(1)->getAttributeValue("mean_val", Mean);
+  BOOST_CHECK(openfluid::scientific::isVeryClose(Mean.get(), 34.0569));
+
+  Graph->entity(2)->getAttributeValue("mean_val", Mean);
+  BOOST_CHECK(openfluid::scientific::isVeryClose(Mean.get(), 46.6497));
+
+  // mean is the area weighted mean computed through the polygonized raster
+
+  openfluid::landr::PolygonGraph::RastValByRastPoly_t OverlapsU1 =
+      Graph->computeRasterPolyOverlapping(*Graph->entity(1));
+
+  double PolygonizedMean = 0;
+
+  for (openfluid::landr::PolygonGraph::RastValByRastPoly_t::iterator it = OverlapsU1.begin();
+       it != OverlapsU1.end(); ++it)
+    PolygonizedMean += *((double*)it->first->getUserData()) * it->second / Graph->entity(1)->getArea();
+
+  Graph->entity(1)->getAttributeValue("mean_val", Mean);
+  BOOST_CHECK(openfluid::scientific::isVeryClose(Mean.get(), PolygonizedMean));
+
+  openfluid::landr::LandRGraph::Entities_t Entities = Graph->getEntities();
+
+  for (openfluid::landr::LandRGraph::Entities_t::iterator it = Entities.begin(); it != Entities.end(); ++it)
+  {
+    (*it)->getAttributeValue("mean_val", Mean);
+    (*it)->getAttributeValue("mean_val_1thread", Mean1Thread);
+    (*it)->getAttributeValue("min_val", Min);
+    (*it)->getAttributeValue("max_val", Max);
+    (*it)->getAttributeValue("sum_val", Sum);
+
+    BOOST_CHECK_EQUAL(Mean.get(), Mean1Thread.get());
+    BOOST_CHECK(Min.get() <= Max.get());
+    BOOST_CHECK(Mean.get() <= Max.get() + 1E-9);
+    BOOST_CHECK(Sum.get() > 0);
+  }
+
+  delete Graph;
+  delete Vector;
+  delete Raster;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 BOOST_AUTO_TEST_CASE(check_setAttributeFromMeanRasterValues_float32PixelType)
 {
   openfluid::core::GeoVectorValue* Vector =
@@ -1163,6 +1350,10 @@ BOOST_AUTO_TEST_CASE(check_remove_PolygonEntity)
   Ent=Graph->entity(11);
   BOOST_CHECK_EQUAL(Ent->getOrderedNeighbourOfldIds().size(),1);
 
+  std::vector<geos::planargraph::Node*>* UnusedNodes = Graph->findNodesOfDegree(0);
+  BOOST_CHECK(UnusedNodes->empty());
+  delete UnusedNodes;
+
   delete Graph;
   delete Vector;
 
@@ -1236,7 +1427,25 @@ BOOST_AUTO_TEST_CASE(check_mergePolygonEntities)
                     openfluid::base::FrameworkException);
 
   double areaBefore = Graph->entity(7)->getArea()+Graph->entity(13)->getArea();
+
+  std::map<unsigned int,std::vector<int>> NeighboursBefore = getNeighboursByOfldId(Graph);
+  std::vector<int> TouchedIds = Graph->entity(7)->getOrderedNeighbourOfldIds();
+  std::vector<int> Neighbours13 = Graph->entity(13)->getOrderedNeighbourOfldIds();
+  TouchedIds.insert(TouchedIds.end(),Neighbours13.begin(),Neighbours13.end());
+
   Graph->mergePolygonEntities(*(Graph->entity(7)),*(Graph->entity(13)));
+
+  // entities which are not neighbours of the merged entities keep the same neighbours
+  for (auto& Neighbours : getNeighboursByOfldId(Graph))
+  {
+    if (Neighbours.first != 7 &&
+        std::find(TouchedIds.begin(),TouchedIds.end(),Neighbours.first) == TouchedIds.end())
+    {
+      BOOST_CHECK(Neighbours.second == NeighboursBefore[Neighbours.first]);
+    }
+  }
+  checkNeighboursUpToDate(Graph);
+
   BOOST_CHECK_EQUAL(Graph->getSize(), 23);
   BOOST_CHECK(!Graph->entity(13));
   BOOST_CHECK_EQUAL(Graph->isComplete(),true);
@@ -2453,6 +2662,7 @@ BOOST_AUTO_TEST_CASE(check_mergePolygonEntitiesByMinArea)
   double areaBefore = PolyGraph->entity(9)->getArea()+PolyGraph->entity(7)->getArea();
   PolyGraph->mergePolygonEntitiesByMinArea(12000);
   BOOST_CHECK_EQUAL(PolyGraph->getEntities().size(), 23);
+  checkNeighboursUpToDate(PolyGraph);
   BOOST_CHECK(!PolyGraph->entity(9));
   double areaAfter = PolyGraph->entity(7)->getArea();
   BOOST_CHECK( openfluid::scientific::isVeryClose(areaBefore, areaAfter));
@@ -2461,8 +2671,16 @@ BOOST_AUTO_TEST_CASE(check_mergePolygonEntitiesByMinArea)
 
   areaBefore = PolyGraph->entity(13)->getArea()+PolyGraph->entity(14)->getArea();
   double areaBefore1 = PolyGraph->entity(9)->getArea()+PolyGraph->entity(7)->getArea();
-  PolyGraph->mergePolygonEntitiesByMinArea(13000);
+  std::vector<std::pair<unsigned int,unsigned int>> Progress;
+  PolyGraph->mergePolygonEntitiesByMinArea(13000,[&Progress](unsigned int Merged, unsigned int Remaining)
+  {
+    Progress.push_back(std::make_pair(Merged,Remaining));
+  });
   BOOST_CHECK_EQUAL(PolyGraph->getEntities().size(), 22);
+  BOOST_REQUIRE_EQUAL(Progress.size(),2);
+  BOOST_CHECK_EQUAL(Progress.front().first,1);
+  BOOST_CHECK_EQUAL(Progress.back().first,2);
+  BOOST_CHECK_EQUAL(Progress.back().second,0);
   BOOST_CHECK(!PolyGraph->entity(9));
   BOOST_CHECK(!PolyGraph->entity(13));
   BOOST_CHECK(PolyGraph->entity(7));
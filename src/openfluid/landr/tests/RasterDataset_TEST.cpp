@@ -41,6 +41,8 @@
 #define BOOST_TEST_MODULE unittest_rasterdataset
 #include <boost/test/unit_test.hpp>
 #include <boost/test/auto_unit_test.hpp>
+#include <algorithm>
+#include <cmath>
 #include <tests-config.hpp>
 #include <openfluid/base/FrameworkException.hpp>
 #include <openfluid/base/Environment.hpp>
@@ -52,6 +54,10 @@
 #include <openfluid/base/Environment.hpp>
 #include <openfluid/scientific/FloatingPoint.hpp>
 #include <geos/geom/Coordinate.h>
+#include <geos/geom/CoordinateArraySequenceFactory.h>
+#include <geos/geom/GeometryFactory.h>
+#include <geos/geom/LinearRing.h>
+#include <geos/geom/Polygon.h>
 
 
 // =====================================================================
@@ -232,6 +238,70 @@ BOOST_AUTO_TEST_CASE(check_getValueOfCoordinate)
 // =====================================================================
 
 
+BOOST_AUTO_TEST_CASE(check_getValuesOfCoordinates)
+{
+  openfluid::core::GeoRasterValue Val(CONFIGTESTS_INPUT_MISCDATA_DIR + "/GeoRasterValue", "dem.jpeg");
+
+  openfluid::landr::RasterDataset* Rast = new openfluid::landr::RasterDataset(Val);
+
+  geos::geom::Coordinate* Origin = Rast->computeOrigin();
+  double Width = Rast->getPixelWidth();
+  double Height = Rast->getPixelHeight();
+
+  // centers of pixels, in a scattered order
+  std::vector<std::pair<int, int> > Pixels;
+  Pixels.push_back(std::make_pair(19,19));
+  Pixels.push_back(std::make_pair(0,0));
+  Pixels.push_back(std::make_pair(4,4));
+  Pixels.push_back(std::make_pair(19,0));
+  Pixels.push_back(std::make_pair(0,19));
+  Pixels.push_back(std::make_pair(4,0));
+  Pixels.push_back(std::make_pair(0,4));
+
+  std::vector<geos::geom::Coordinate> Coos;
+  for (unsigned int i = 0; i < Pixels.size(); i++)
+    Coos.push_back(geos::geom::Coordinate(Origin->x + (Pixels[i].first+0.5)*Width,
+                                          Origin->y + (Pixels[i].second+0.5)*Height));
+
+  float Expected[] = {21, 96, 86, 99, 21, 100, 80};
+
+  BOOST_CHECK_EQUAL(Rast->getBlocksCacheSize(), 64);
+
+  std::vector<float> Values = Rast->getValuesOfCoordinates(Coos);
+
+  BOOST_REQUIRE_EQUAL(Values.size(), Coos.size());
+  for (unsigned int i = 0; i < Values.size(); i++)
+  {
+    BOOST_CHECK_EQUAL(Values[i], Expected[i]);
+    BOOST_CHECK_EQUAL(Values[i], Rast->getValueOfCoordinate(Coos[i]));
+  }
+
+  // a single cached block forces evictions
+  Rast->setBlocksCacheSize(0);
+  BOOST_CHECK_EQUAL(Rast->getBlocksCacheSize(), 1);
+
+  for (unsigned int i = 0; i < Pixels.size(); i++)
+    BOOST_CHECK_EQUAL(Rast->getValueOfPixel(Pixels[i].first,Pixels[i].second), Expected[i]);
+
+  Values = Rast->getValuesOfCoordinates(Coos);
+  for (unsigned int i = 0; i < Values.size(); i++)
+    BOOST_CHECK_EQUAL(Values[i], Expected[i]);
+
+  BOOST_CHECK_THROW(Rast->getValueOfPixel(-1,0),openfluid::base::FrameworkException);
+  BOOST_CHECK_THROW(Rast->getValueOfPixel(0,Rast->rasterBand(1)->GetYSize()),openfluid::base::FrameworkException);
+
+  Coos.push_back(geos::geom::Coordinate(Origin->x - Width, Origin->y));
+  BOOST_CHECK_THROW(Rast->getValuesOfCoordinates(Coos),openfluid::base::FrameworkException);
+
+  delete Origin;
+  delete Rast;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 BOOST_AUTO_TEST_CASE(check_Polygonize)
 {
   // integer values
@@ -310,6 +380,75 @@ BOOST_AUTO_TEST_CASE(check_envelope)
 // =====================================================================
 
 
+BOOST_AUTO_TEST_CASE(check_computeZonalStatistics)
+{
+  openfluid::core::GeoRasterValue Val(CONFIGTESTS_INPUT_MISCDATA_DIR + "/GeoRasterValue", "dem.jpeg");
+
+  openfluid::landr::RasterDataset* Rast = new openfluid::landr::RasterDataset(Val);
+
+  BOOST_CHECK(Rast->isAxisAligned());
+
+  geos::geom::Coordinate* Origin = Rast->computeOrigin();
+  double Width = Rast->getPixelWidth();
+  double Height = Rast->getPixelHeight();
+  double PixelArea = std::fabs(Width*Height);
+
+  geos::geom::CoordinateArraySequenceFactory SeqFactory;
+  geos::geom::GeometryFactory Factory;
+
+  // polygon covering exactly the pixel (4,4)
+
+  std::vector<geos::geom::Coordinate>* Coos1 = new std::vector<geos::geom::Coordinate>();
+  Coos1->push_back(geos::geom::Coordinate(Origin->x+4*Width, Origin->y+4*Height));
+  Coos1->push_back(geos::geom::Coordinate(Origin->x+5*Width, Origin->y+4*Height));
+  Coos1->push_back(geos::geom::Coordinate(Origin->x+5*Width, Origin->y+5*Height));
+  Coos1->push_back(geos::geom::Coordinate(Origin->x+4*Width, Origin->y+5*Height));
+  Coos1->push_back(geos::geom::Coordinate(Origin->x+4*Width, Origin->y+4*Height));
+
+  geos::geom::Polygon* P1 = Factory.createPolygon(Factory.createLinearRing(SeqFactory.create(Coos1)), nullptr);
+
+  openfluid::landr::RasterDataset::ZonalStatistics Stats = Rast->computeZonalStatistics(*P1);
+
+  BOOST_CHECK_EQUAL(Stats.PixelsCount, 1);
+  BOOST_CHECK_EQUAL(Stats.Min, 86);
+  BOOST_CHECK_EQUAL(Stats.Max, 86);
+  BOOST_CHECK(openfluid::scientific::isVeryClose(Stats.CoveredArea,PixelArea));
+  BOOST_CHECK(openfluid::scientific::isVeryClose(Stats.WeightedSum,86*PixelArea));
+  BOOST_CHECK_EQUAL(Stats.NaNArea, 0);
+
+  // polygon covering line 4 from the middle of pixel (0,4) to the middle of pixel (4,4)
+
+  std::vector<geos::geom::Coordinate>* Coos2 = new std::vector<geos::geom::Coordinate>();
+  Coos2->push_back(geos::geom::Coordinate(Origin->x+0.5*Width, Origin->y+4*Height));
+  Coos2->push_back(geos::geom::Coordinate(Origin->x+4.5*Width, Origin->y+4*Height));
+  Coos2->push_back(geos::geom::Coordinate(Origin->x+4.5*Width, Origin->y+5*Height));
+  Coos2->push_back(geos::geom::Coordinate(Origin->x+0.5*Width, Origin->y+5*Height));
+  Coos2->push_back(geos::geom::Coordinate(Origin->x+0.5*Width, Origin->y+4*Height));
+
+  geos::geom::Polygon* P2 = Factory.createPolygon(Factory.createLinearRing(SeqFactory.create(Coos2)), nullptr);
+
+  Stats = Rast->computeZonalStatistics(*P2);
+
+  std::vector<float> Line4 = Rast->getValuesOfLine(4);
+  double ExpectedSum = (Line4[0]/2 + Line4[1] + Line4[2] + Line4[3] + Line4[4]/2) * PixelArea;
+
+  BOOST_CHECK_EQUAL(Stats.PixelsCount, 5);
+  BOOST_CHECK_EQUAL(Stats.Min, *std::min_element(Line4.begin(),Line4.begin()+5));
+  BOOST_CHECK_EQUAL(Stats.Max, *std::max_element(Line4.begin(),Line4.begin()+5));
+  BOOST_CHECK(openfluid::scientific::isVeryClose(Stats.CoveredArea,4*PixelArea));
+  BOOST_CHECK(openfluid::scientific::isVeryClose(Stats.WeightedSum,ExpectedSum));
+
+  delete P1;
+  delete P2;
+  delete Origin;
+  delete Rast;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 int main(int argc, char *argv[])
 {
   openfluid::base::Environment::init();
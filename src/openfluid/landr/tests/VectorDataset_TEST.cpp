@@ -40,6 +40,9 @@
 #define BOOST_TEST_NO_MAIN
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MODULE unittest_vectordataset
+
+#include <vector>
+
 #include <boost/test/unit_test.hpp>
 #include <boost/test/auto_unit_test.hpp>
 #include <tests-config.hpp>
@@ -153,6 +156,90 @@ BOOST_AUTO_TEST_CASE(check_constructor_fromValue)
 // =====================================================================
 
 
+BOOST_AUTO_TEST_CASE(check_constructor_fromValue_readOnly)
+{
+  openfluid::core::GeoVectorValue Value(CONFIGTESTS_INPUT_MISCDATA_DIR,"landr/SU.shp");
+
+  openfluid::landr::VectorDataset* Vect = new openfluid::landr::VectorDataset(Value,true);
+
+  BOOST_CHECK(Vect->isReadOnly());
+  BOOST_CHECK(Vect->source());
+
+#if (GDAL_VERSION_MAJOR >= 2)
+  BOOST_CHECK_EQUAL(std::string(Vect->source()->GetDescription()),std::string(Value.data()->GetDescription()));
+#else
+  BOOST_CHECK_EQUAL(std::string(Vect->source()->GetName()),std::string(Value.data()->GetName()));
+#endif
+
+  BOOST_CHECK(Vect->containsField("OFLD_ID"));
+  BOOST_CHECK_EQUAL(Vect->features().size(), 24);
+  BOOST_CHECK_EQUAL(Vect->geometries()->getNumGeometries(), 24);
+
+  BOOST_CHECK_THROW(Vect->addAField("NewField"),openfluid::base::FrameworkException);
+  BOOST_CHECK_THROW(Vect->snapVertices(1),openfluid::base::FrameworkException);
+
+  openfluid::landr::VectorDataset* Vect2 = new openfluid::landr::VectorDataset(*Vect);
+
+  BOOST_CHECK(!Vect2->isReadOnly());
+  Vect2->addAField("NewField");
+  BOOST_CHECK(Vect2->containsField("NewField"));
+  BOOST_CHECK(!Vect->containsField("NewField"));
+
+  delete Vect;
+  delete Vect2;
+
+  BOOST_CHECK(openfluid::tools::Filesystem::isFile(CONFIGTESTS_INPUT_MISCDATA_DIR+"/landr/SU.shp"));
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_streamFeatures)
+{
+  openfluid::core::GeoVectorValue Value(CONFIGTESTS_INPUT_MISCDATA_DIR + "/landr", "SU.shp");
+
+  openfluid::landr::VectorDataset* Vect = new openfluid::landr::VectorDataset(Value,true);
+
+  std::vector<unsigned int> ChunkSizes;
+  std::vector<int> StreamedIds;
+
+  Vect->streamFeatures([&](const openfluid::landr::VectorDataset::FeaturesList_t& Chunk)
+  {
+    ChunkSizes.push_back(Chunk.size());
+
+    for (auto& Feature : Chunk)
+    {
+      BOOST_CHECK(Feature.second);
+      BOOST_CHECK(Feature.second->isValid());
+      StreamedIds.push_back(Feature.first->GetFieldAsInteger("OFLD_ID"));
+    }
+  },5);
+
+  BOOST_REQUIRE_EQUAL(ChunkSizes.size(),5);
+  BOOST_CHECK_EQUAL(ChunkSizes.front(),5);
+  BOOST_CHECK_EQUAL(ChunkSizes.back(),4);
+
+  openfluid::landr::VectorDataset::FeaturesList_t Features = Vect->features();
+
+  BOOST_REQUIRE_EQUAL(StreamedIds.size(),Features.size());
+
+  unsigned int i = 0;
+  for (auto& Feature : Features)
+  {
+    BOOST_CHECK_EQUAL(StreamedIds[i],Feature.first->GetFieldAsInteger("OFLD_ID"));
+    i++;
+  }
+
+  delete Vect;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 BOOST_AUTO_TEST_CASE(check_copyToDisk)
 {
   std::string NewPath =
@@ -397,6 +484,17 @@ BOOST_AUTO_TEST_CASE(check_findOverlap)
   BOOST_CHECK_EQUAL((*it).first->GetFID(),3);
   BOOST_CHECK_EQUAL((*it).second->GetFID(),4);
 
+  // same overlaps in the same order whatever the number of threads
+  std::list<std::pair<OGRFeature*, OGRFeature*> > lOverlapSingleThread=VectSU->findOverlap(0,1);
+  BOOST_REQUIRE_EQUAL(lOverlapSingleThread.size(),lOverlap.size());
+
+  std::list<std::pair<OGRFeature*, OGRFeature*> >::iterator jt = lOverlapSingleThread.begin();
+  for (it = lOverlap.begin(); it != lOverlap.end(); ++it, ++jt)
+  {
+    BOOST_CHECK_EQUAL((*it).first->GetFID(),(*jt).first->GetFID());
+    BOOST_CHECK_EQUAL((*it).second->GetFID(),(*jt).second->GetFID());
+  }
+
 
   delete VectSU;
 }
@@ -429,6 +527,8 @@ BOOST_AUTO_TEST_CASE(check_findGap)
   BOOST_CHECK_EQUAL((*it).first->GetFID(),0);
   BOOST_CHECK_EQUAL((*it).second->GetFID(),23);
 
+  BOOST_CHECK_EQUAL(VectSU->findGap(0.1,0,1).size(),3);
+
   delete VectSU;
 }
 
@@ -118,7 +118,7 @@ void Engine::checkExistingVariable(const openfluid::core::VariableName_t& VarNam
                                    const std::string& SimulatorID)
 {
   openfluid::core::UnitsList_t::const_iterator UnitIter;
-  openfluid::core::UnitsList_t* UnitList;
+  const openfluid::core::UnitsList_t* UnitList;
 
   UnitList = nullptr;
   if (m_SimulationBlob.spatialGraph().isUnitsClassExist(ClassName))
@@ -158,12 +158,12 @@ void Engine::createVariable(const openfluid::core::VariableName_t& VarName,
                             bool UpdateMode,
                             const std::string& SimulatorID)
 {
-  openfluid::core::UnitsList_t::iterator UnitIter;
-  openfluid::core::UnitsList_t* UnitList;
+  openfluid::core::UnitsPtrVector_t::const_iterator UnitIter;
+  const openfluid::core::UnitsPtrVector_t* Units;
 
-  UnitList = nullptr;
+  Units = nullptr;
   if (m_SimulationBlob.spatialGraph().isUnitsClassExist(ClassName))
-    UnitList = m_SimulationBlob.spatialGraph().spatialUnits(ClassName)->list();
+    Units = m_SimulationBlob.spatialGraph().spatialUnits(ClassName)->units();
   else
     throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Unit class " + ClassName +
                                               " does not exist for " + VarName +
@@ -174,10 +174,10 @@ void Engine::createVariable(const openfluid::core::VariableName_t& VarName,
   // if not update mode, variables must not exist before creation
   if (!UpdateMode)
   {
-    UnitIter = UnitList->begin();
-    while (UnitIter != UnitList->end())
+    UnitIter = Units->begin();
+    while (UnitIter != Units->end())
     {
-       Status = !((*UnitIter).variables()->isVariableExist(VarName));
+       Status = !((*UnitIter)->variables()->isVariableExist(VarName));
 
       if (!Status)
         throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
@@ -189,10 +189,14 @@ void Engine::createVariable(const openfluid::core::VariableName_t& VarName,
     }
   }
 
-  for(UnitIter = UnitList->begin(); UnitIter != UnitList->end(); ++UnitIter )
+  for(UnitIter = Units->begin(); UnitIter != Units->end(); ++UnitIter )
   {
-    (*UnitIter).variables()->createVariable(VarName,VarType);
+    (*UnitIter)->variables()->createVariable(VarName,VarType);
   }
+
+  // ghost units of a partitioned run receive the values of the variable from other partitions
+  for (openfluid::core::SpatialUnit* GhostUnit : *(m_SimulationBlob.spatialGraph().spatialUnits(ClassName)->ghosts()))
+    GhostUnit->variables()->createVariable(VarName,VarType);
 }
 
 
@@ -205,7 +209,7 @@ void Engine::checkExistingAttribute(const openfluid::core::AttributeName_t AttrN
                                     const std::string& SimulatorID)
 {
   openfluid::core::UnitsList_t::const_iterator UnitIter;
-  openfluid::core::UnitsList_t* UnitList;
+  const openfluid::core::UnitsList_t* UnitList;
 
   UnitList = nullptr;
   if (m_SimulationBlob.spatialGraph().isUnitsClassExist(ClassName))
@@ -239,20 +243,20 @@ void Engine::createAttribute(openfluid::core::AttributeName_t AttrName,
                              openfluid::core::UnitsClass_t ClassName,
                              const std::string& SimulatorID)
 {
-  openfluid::core::UnitsList_t::iterator UnitIter;
-  openfluid::core::UnitsList_t* UnitList;
+  openfluid::core::UnitsPtrVector_t::const_iterator UnitIter;
+  const openfluid::core::UnitsPtrVector_t* Units;
 
-  UnitList = nullptr;
+  Units = nullptr;
   if (m_SimulationBlob.spatialGraph().isUnitsClassExist(ClassName))
-    UnitList = m_SimulationBlob.spatialGraph().spatialUnits(ClassName)->list();
+    Units = m_SimulationBlob.spatialGraph().spatialUnits(ClassName)->units();
   else throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
                                                  "Unit class " + ClassName + " does not exist for " +
                                                  AttrName + " attribute produced by " + SimulatorID);
 
 
-  for(UnitIter = UnitList->begin(); UnitIter != UnitList->end(); ++UnitIter )
+  for(UnitIter = Units->begin(); UnitIter != Units->end(); ++UnitIter )
   {
-    (*UnitIter).attributes()->setValue(AttrName,openfluid::core::NullValue());
+    (*UnitIter)->attributes()->setValue(AttrName,openfluid::core::NullValue());
   }
 }
 
@@ -611,6 +615,11 @@ void Engine::checkConsistency()
     mp_SimStatus->setCurrentStage(openfluid::base::SimulationStatus::CHECKCONSISTENCY);
     m_ModelInstance.call_checkConsistency();
     m_MonitoringInstance.call_onPrepared();
+
+    // units are reordered once the spatial graph is complete,
+    // since simulators may add or delete units and load geometries until here
+    if (m_SimulationBlob.runDescriptor().getUnitsOrdering() != openfluid::core::UnitsOrdering::DEFAULT)
+      m_SimulationBlob.spatialGraph().sortUnitsByLocality(m_SimulationBlob.runDescriptor().getUnitsOrdering());
   }
   catch (openfluid::base::FrameworkException& E)
   {
@@ -619,6 +628,10 @@ void Engine::checkConsistency()
   }
 
 
+  // the spatial graph is considered as frozen from here, its links are compressed for fast access
+  m_SimulationBlob.spatialGraph().buildAdjacency();
+
+
   if (mp_SimLogger->isCurrentWarningFlag())
     mp_MachineListener->onCheckConsistencyDone(openfluid::machine::MachineListener::LISTEN_WARNING);
   else
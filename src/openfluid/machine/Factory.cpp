@@ -77,12 +77,18 @@ void Factory::buildDomainFromDescriptor(const openfluid::fluidx::SpatialDomainDe
 
   openfluid::core::SpatialUnit *FromUnit, *ToUnit, *ParentUnit, *ChildUnit;
 
+  // units with process orders to compute from connections
+  std::vector<openfluid::core::SpatialUnit*> ComputedPcsOrdUnits;
+
   // creating units
   for (itUnits = Descriptor.spatialUnits().begin();itUnits != Descriptor.spatialUnits().end();++itUnits)
   {
     SGraph.addUnit(openfluid::core::SpatialUnit((*itUnits).getUnitsClass(),
                                                (*itUnits).getID(),
                                                (*itUnits).getProcessOrder()));
+
+    if ((*itUnits).isProcessOrderComputed())
+      ComputedPcsOrdUnits.push_back(SGraph.spatialUnit((*itUnits).getUnitsClass(),(*itUnits).getID()));
   }
 
   // linking to units
@@ -141,7 +147,10 @@ void Factory::buildDomainFromDescriptor(const openfluid::fluidx::SpatialDomainDe
   }
 
 
-  SGraph.sortUnitsByProcessOrder();
+  if (ComputedPcsOrdUnits.empty())
+    SGraph.sortUnitsByProcessOrder();
+  else
+    SGraph.computeProcessOrders(ComputedPcsOrdUnits);
 
 
 
@@ -187,20 +196,28 @@ void Factory::buildDomainFromDescriptor(const openfluid::fluidx::SpatialDomainDe
 
 
   std::list<openfluid::fluidx::EventDescriptor>::const_iterator itEvent;
-  openfluid::core::SpatialUnit* EventUnit;
+  openfluid::core::SpatialUnit* EventUnit = nullptr;
+
+  // events are gathered by unit then added at once, so that each events collection is sorted only once
+  std::map<openfluid::core::SpatialUnit*,openfluid::core::EventsList_t> EventsByUnit;
 
   for (itEvent = Descriptor.events().begin();itEvent != Descriptor.events().end();++itEvent)
   {
-
-    EventUnit = SGraph.spatialUnit((*itEvent).getUnitsClass(),(*itEvent).getUnitID());
+    // consecutive events are often related to the same unit
+    if (EventUnit == nullptr ||
+        EventUnit->getID() != (*itEvent).getUnitID() || EventUnit->getClass() != (*itEvent).getUnitsClass())
+      EventUnit = SGraph.spatialUnit((*itEvent).getUnitsClass(),(*itEvent).getUnitID());
 
     if (EventUnit != nullptr)
     {
-      EventUnit->events()->addEvent((*itEvent).event());
+      EventsByUnit[EventUnit].push_back((*itEvent).event());
     }
 
   }
 
+  for (auto& UnitEvents : EventsByUnit)
+    UnitEvents.first->events()->addEvents(UnitEvents.second);
+
 }
 
 
@@ -0,0 +1,636 @@
+/*
+
+  This file is part of OpenFLUID software
+  Copyright(c) 2007, INRA - Montpellier SupAgro
+
+
+ == GNU General Public License Usage ==
+
+  OpenFLUID is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OpenFLUID is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OpenFLUID. If not, see <http://www.gnu.org/licenses/>.
+
+
+ == Other Usage ==
+
+  Other Usage means a use of OpenFLUID that is inconsistent with the GPL
+  license, and requires a written agreement between You and INRA.
+  Licensees for Other Usage of OpenFLUID may use this file in accordance
+  with the terms contained in the written agreement between You and INRA.
+  
+*/
+
+
+/**
+  @file HaloChannel.cpp
+
+  @author Jean-Christophe FABRE <jean-christophe.fabre@supagro.inra.fr>
+ */
+
+
+
+#include <cstring>
+#include <cstdint>
+#include <cerrno>
+#include <thread>
+#include <chrono>
+
+#include <openfluid/machine/HaloChannel.hpp>
+#include <openfluid/core/BooleanValue.hpp>
+#include <openfluid/core/IntegerValue.hpp>
+#include <openfluid/core/DoubleValue.hpp>
+#include <openfluid/core/StringValue.hpp>
+#include <openfluid/core/VectorValue.hpp>
+#include <openfluid/core/MatrixValue.hpp>
+#include <openfluid/core/MapValue.hpp>
+#include <openfluid/core/TreeValue.hpp>
+#include <openfluid/core/NullValue.hpp>
+#include <openfluid/base/FrameworkException.hpp>
+
+#if defined(OPENFLUID_OS_UNIX)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+
+namespace openfluid { namespace machine {
+
+
+namespace {
+
+#if defined(OPENFLUID_OS_UNIX)
+
+sockaddr_un buildSocketAddress(const std::string& Path)
+{
+  sockaddr_un Address;
+  std::memset(&Address,0,sizeof(Address));
+  Address.sun_family = AF_UNIX;
+
+  if (Path.size() >= sizeof(Address.sun_path))
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Socket path is too long: " + Path);
+
+  std::strncpy(Address.sun_path,Path.c_str(),sizeof(Address.sun_path)-1);
+
+  return Address;
+}
+
+#endif
+
+
+void throwChannelError(const std::string& Msg)
+{
+  throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                            Msg + " (" + std::string(std::strerror(errno)) + ")");
+}
+
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+HaloChannel::HaloChannel() :
+  m_Socket(-1)
+{
+
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+HaloChannel::~HaloChannel()
+{
+  close();
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void HaloChannel::close()
+{
+#if defined(OPENFLUID_OS_UNIX)
+  if (m_Socket >= 0)
+    ::close(m_Socket);
+#endif
+
+  m_Socket = -1;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void HaloChannel::createPair(HaloChannel& First, HaloChannel& Second)
+{
+#if defined(OPENFLUID_OS_UNIX)
+  int Sockets[2];
+
+  if (::socketpair(AF_UNIX,SOCK_STREAM,0,Sockets) != 0)
+    throwChannelError("Cannot create halo channels");
+
+  First.close();
+  Second.close();
+  First.m_Socket = Sockets[0];
+  Second.m_Socket = Sockets[1];
+#else
+  (void)First;
+  (void)Second;
+  throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Halo channels are not supported on this system");
+#endif
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void HaloChannel::listen(const std::string& Path)
+{
+#if defined(OPENFLUID_OS_UNIX)
+  close();
+
+  sockaddr_un Address = buildSocketAddress(Path);
+
+  int ListenSocket = ::socket(AF_UNIX,SOCK_STREAM,0);
+
+  if (ListenSocket < 0)
+    throwChannelError("Cannot create halo channel");
+
+  ::unlink(Path.c_str());
+
+  if (::bind(ListenSocket,reinterpret_cast<sockaddr*>(&Address),sizeof(Address)) != 0 ||
+      ::listen(ListenSocket,1) != 0)
+  {
+    ::close(ListenSocket);
+    throwChannelError("Cannot listen on halo channel " + Path);
+  }
+
+  m_Socket = ::accept(ListenSocket,nullptr,nullptr);
+
+  ::close(ListenSocket);
+  ::unlink(Path.c_str());
+
+  if (m_Socket < 0)
+    throwChannelError("Cannot accept connection on halo channel " + Path);
+#else
+  (void)Path;
+  throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Halo channels are not supported on this system");
+#endif
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void HaloChannel::connect(const std::string& Path, unsigned int TimeoutMs)
+{
+#if defined(OPENFLUID_OS_UNIX)
+  close();
+
+  sockaddr_un Address = buildSocketAddress(Path);
+  auto Deadline = std::chrono::steady_clock::now()+std::chrono::milliseconds(TimeoutMs);
+
+  while (true)
+  {
+    m_Socket = ::socket(AF_UNIX,SOCK_STREAM,0);
+
+    if (m_Socket < 0)
+      throwChannelError("Cannot create halo channel");
+
+    if (::connect(m_Socket,reinterpret_cast<sockaddr*>(&Address),sizeof(Address)) == 0)
+      return;
+
+    close();
+
+    if (std::chrono::steady_clock::now() >= Deadline)
+      throwChannelError("Cannot connect to halo channel " + Path);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+#else
+  (void)Path;
+  (void)TimeoutMs;
+  throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Halo channels are not supported on this system");
+#endif
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void HaloChannel::writeBytes(const void* Data, std::size_t Size)
+{
+#if defined(OPENFLUID_OS_UNIX)
+  const char* Bytes = static_cast<const char*>(Data);
+
+#if defined(MSG_NOSIGNAL)
+  const int Flags = MSG_NOSIGNAL;
+#else
+  const int Flags = 0;
+#endif
+
+  while (Size)
+  {
+    ssize_t Written = ::send(m_Socket,Bytes,Size,Flags);
+
+    if (Written < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      throwChannelError("Cannot send values through halo channel");
+    }
+
+    Bytes += Written;
+    Size -= Written;
+  }
+#else
+  (void)Data;
+  (void)Size;
+#endif
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void HaloChannel::readBytes(void* Data, std::size_t Size)
+{
+#if defined(OPENFLUID_OS_UNIX)
+  char* Bytes = static_cast<char*>(Data);
+
+  while (Size)
+  {
+    ssize_t Read = ::recv(m_Socket,Bytes,Size,0);
+
+    if (Read < 0 && errno == EINTR)
+      continue;
+
+    if (Read <= 0)
+      throwChannelError("Cannot receive values from halo channel");
+
+    Bytes += Read;
+    Size -= Read;
+  }
+#else
+  (void)Data;
+  (void)Size;
+#endif
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void HaloChannel::send(const HaloValues_t& Values, std::uint64_t Tag)
+{
+  if (!isOpen())
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Halo channel is not open");
+
+  // values are serialized into a single buffer, using the native representation of the local host
+
+  std::vector<char> Buffer;
+
+  auto append = [&Buffer](const void* Data, std::size_t Size)
+  {
+    const char* Bytes = static_cast<const char*>(Data);
+    Buffer.insert(Buffer.end(),Bytes,Bytes+Size);
+  };
+
+  auto appendString = [&append](const std::string& Str)
+  {
+    const std::uint32_t Size = Str.size();
+    append(&Size,sizeof(Size));
+    append(Str.data(),Size);
+  };
+
+  const std::uint64_t Count = Values.size();
+  append(&Tag,sizeof(Tag));
+  append(&Count,sizeof(Count));
+
+  for (const HaloValue& Val : Values)
+  {
+    const std::uint32_t ID = Val.m_UnitID;
+    const std::uint64_t Index = Val.m_Index;
+    const std::uint8_t Type = Val.m_Value ? Val.m_Value->getType() : openfluid::core::Value::NONE;
+
+    appendString(Val.m_UnitsClass);
+    append(&ID,sizeof(ID));
+    appendString(Val.m_VarName);
+    append(&Index,sizeof(Index));
+    append(&Type,sizeof(Type));
+
+    switch (Type)
+    {
+      case openfluid::core::Value::NONE :
+      case openfluid::core::Value::NULLL :
+        break;
+
+      case openfluid::core::Value::BOOLEAN :
+      {
+        const std::uint8_t Bool = Val.m_Value->asBooleanValue().get();
+        append(&Bool,sizeof(Bool));
+        break;
+      }
+
+      case openfluid::core::Value::INTEGER :
+      {
+        const std::int64_t Int = Val.m_Value->asIntegerValue().get();
+        append(&Int,sizeof(Int));
+        break;
+      }
+
+      case openfluid::core::Value::DOUBLE :
+      {
+        const double Dbl = Val.m_Value->asDoubleValue().get();
+        append(&Dbl,sizeof(Dbl));
+        break;
+      }
+
+      case openfluid::core::Value::VECTOR :
+      {
+        const openfluid::core::VectorValue& Vect = Val.m_Value->asVectorValue();
+        const std::uint64_t Size = Vect.size();
+        append(&Size,sizeof(Size));
+        append(Vect.data(),Size*sizeof(double));
+        break;
+      }
+
+      case openfluid::core::Value::MATRIX :
+      {
+        const openfluid::core::MatrixValue& Matrix = Val.m_Value->asMatrixValue();
+        const std::uint64_t ColsNbr = Matrix.getColsNbr();
+        const std::uint64_t RowsNbr = Matrix.getRowsNbr();
+        append(&ColsNbr,sizeof(ColsNbr));
+        append(&RowsNbr,sizeof(RowsNbr));
+        append(Matrix.data(),ColsNbr*RowsNbr*sizeof(double));
+        break;
+      }
+
+      default :
+        appendString(Val.m_Value->toString());
+        break;
+    }
+  }
+
+  const std::uint64_t BufferSize = Buffer.size();
+  writeBytes(&BufferSize,sizeof(BufferSize));
+  writeBytes(Buffer.data(),Buffer.size());
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void HaloChannel::receive(HaloValues_t& Values, std::uint64_t& Tag)
+{
+  if (!isOpen())
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Halo channel is not open");
+
+  std::uint64_t BufferSize = 0;
+  readBytes(&BufferSize,sizeof(BufferSize));
+
+  std::vector<char> Buffer(BufferSize);
+  readBytes(Buffer.data(),Buffer.size());
+
+  std::size_t Pos = 0;
+
+  auto extract = [&Buffer,&Pos](void* Data, std::size_t Size)
+  {
+    if (Pos+Size > Buffer.size())
+      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Malformed values received from halo channel");
+
+    std::memcpy(Data,Buffer.data()+Pos,Size);
+    Pos += Size;
+  };
+
+  auto extractString = [&extract](std::string& Str)
+  {
+    std::uint32_t Size = 0;
+    extract(&Size,sizeof(Size));
+    Str.resize(Size);
+    if (Size)
+      extract(&Str[0],Size);
+  };
+
+  auto throwMalformed = []()
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Malformed values received from halo channel");
+  };
+
+  std::uint64_t Count = 0;
+  extract(&Tag,sizeof(Tag));
+  extract(&Count,sizeof(Count));
+
+  Values.clear();
+  Values.resize(Count);
+
+  for (HaloValue& Val : Values)
+  {
+    std::uint32_t ID = 0;
+    std::uint64_t Index = 0;
+    std::uint8_t Type = 0;
+
+    extractString(Val.m_UnitsClass);
+    extract(&ID,sizeof(ID));
+    extractString(Val.m_VarName);
+    extract(&Index,sizeof(Index));
+    extract(&Type,sizeof(Type));
+
+    Val.m_UnitID = ID;
+    Val.m_Index = Index;
+
+    switch (Type)
+    {
+      case openfluid::core::Value::NONE :
+        Val.m_Value.reset();
+        break;
+
+      case openfluid::core::Value::NULLL :
+        Val.m_Value = std::make_shared<openfluid::core::NullValue>();
+        break;
+
+      case openfluid::core::Value::BOOLEAN :
+      {
+        std::uint8_t Bool = 0;
+        extract(&Bool,sizeof(Bool));
+        Val.m_Value = std::make_shared<openfluid::core::BooleanValue>(Bool != 0);
+        break;
+      }
+
+      case openfluid::core::Value::INTEGER :
+      {
+        std::int64_t Int = 0;
+        extract(&Int,sizeof(Int));
+        Val.m_Value = std::make_shared<openfluid::core::IntegerValue>(static_cast<long>(Int));
+        break;
+      }
+
+      case openfluid::core::Value::DOUBLE :
+      {
+        double Dbl = 0.0;
+        extract(&Dbl,sizeof(Dbl));
+        Val.m_Value = std::make_shared<openfluid::core::DoubleValue>(Dbl);
+        break;
+      }
+
+      case openfluid::core::Value::VECTOR :
+      {
+        std::uint64_t Size = 0;
+        extract(&Size,sizeof(Size));
+        std::shared_ptr<openfluid::core::VectorValue> Vect = std::make_shared<openfluid::core::VectorValue>(Size);
+        extract(Vect->data(),Size*sizeof(double));
+        Val.m_Value = Vect;
+        break;
+      }
+
+      case openfluid::core::Value::MATRIX :
+      {
+        std::uint64_t ColsNbr = 0, RowsNbr = 0;
+        extract(&ColsNbr,sizeof(ColsNbr));
+        extract(&RowsNbr,sizeof(RowsNbr));
+        std::shared_ptr<openfluid::core::MatrixValue> Matrix =
+            std::make_shared<openfluid::core::MatrixValue>(ColsNbr,RowsNbr);
+        extract(Matrix->data(),ColsNbr*RowsNbr*sizeof(double));
+        Val.m_Value = Matrix;
+        break;
+      }
+
+      case openfluid::core::Value::STRING :
+      {
+        std::string Str;
+        extractString(Str);
+        Val.m_Value = std::make_shared<openfluid::core::StringValue>(Str);
+        break;
+      }
+
+      case openfluid::core::Value::MAP :
+      {
+        std::string Str;
+        extractString(Str);
+        std::shared_ptr<openfluid::core::MapValue> Map = std::make_shared<openfluid::core::MapValue>();
+        if (!openfluid::core::StringValue(Str).toMapValue(*Map))
+          throwMalformed();
+        Val.m_Value = Map;
+        break;
+      }
+
+      case openfluid::core::Value::TREE :
+      {
+        std::string Str;
+        extractString(Str);
+        std::shared_ptr<openfluid::core::TreeValue> Tree = std::make_shared<openfluid::core::TreeValue>();
+        if (!openfluid::core::StringValue(Str).toTreeValue(*Tree))
+          throwMalformed();
+        Val.m_Value = Tree;
+        break;
+      }
+
+      default :
+        throwMalformed();
+    }
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void HaloChannel::collectValues(const openfluid::core::UnitsPtrVector_t& Units,
+                                const std::vector<openfluid::core::VariableName_t>& VarNames,
+                                openfluid::core::TimeIndex_t Index,
+                                HaloValues_t& Values)
+{
+  for (openfluid::core::SpatialUnit* Unit : Units)
+  {
+    for (const openfluid::core::VariableName_t& Name : VarNames)
+    {
+      const openfluid::core::Value* Val = Unit->variables()->currentValueIfIndex(Name,Index);
+
+      if (Val != nullptr)
+      {
+        HaloValue HVal;
+        HVal.m_UnitsClass = Unit->getClass();
+        HVal.m_UnitID = Unit->getID();
+        HVal.m_VarName = Name;
+        HVal.m_Index = Index;
+        HVal.m_Value.reset(Val->clone());
+        Values.push_back(HVal);
+      }
+    }
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void HaloChannel::collectValues(const openfluid::core::UnitsPtrVector_t& Units,
+                                openfluid::core::TimeIndex_t Index,
+                                HaloValues_t& Values)
+{
+  for (openfluid::core::SpatialUnit* Unit : Units)
+    collectValues({Unit},Unit->variables()->getVariablesNames(),Index,Values);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void HaloChannel::applyValues(openfluid::core::SpatialGraph* Graph, const HaloValues_t& Values)
+{
+  for (const HaloValue& Val : Values)
+  {
+    openfluid::core::SpatialUnit* Unit = Graph->spatialUnit(Val.m_UnitsClass,Val.m_UnitID);
+
+    if (Unit == nullptr)
+      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                                "Unit " + Val.m_UnitsClass + "#" + std::to_string(Val.m_UnitID) +
+                                                " received from halo channel does not exist");
+
+    if (!Val.m_Value)
+      continue;
+
+    bool IsStored = false;
+
+    if (!Unit->variables()->isVariableExist(Val.m_VarName))
+      Unit->variables()->createVariable(Val.m_VarName,Val.m_Value->getType());
+
+    if (Unit->variables()->isVariableExist(Val.m_VarName,Val.m_Index))
+      IsStored = Unit->variables()->modifyValue(Val.m_VarName,Val.m_Index,*Val.m_Value);
+    else
+      IsStored = Unit->variables()->appendValue(Val.m_VarName,Val.m_Index,*Val.m_Value);
+
+    if (!IsStored)
+      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                                "Cannot store value of variable " + Val.m_VarName + " for unit " +
+                                                Val.m_UnitsClass + "#" + std::to_string(Val.m_UnitID) +
+                                                " received from halo channel");
+  }
+}
+
+
+} } // namespaces
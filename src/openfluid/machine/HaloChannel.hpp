@@ -0,0 +1,201 @@
+/*
+
+  This file is part of OpenFLUID software
+  Copyright(c) 2007, INRA - Montpellier SupAgro
+
+
+ == GNU General Public License Usage ==
+
+  OpenFLUID is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OpenFLUID is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OpenFLUID. If not, see <http://www.gnu.org/licenses/>.
+
+
+ == Other Usage ==
+
+  Other Usage means a use of OpenFLUID that is inconsistent with the GPL
+  license, and requires a written agreement between You and INRA.
+  Licensees for Other Usage of OpenFLUID may use this file in accordance
+  with the terms contained in the written agreement between You and INRA.
+  
+*/
+
+
+/**
+  @file HaloChannel.hpp
+
+  @author Jean-Christophe FABRE <jean-christophe.fabre@supagro.inra.fr>
+ */
+
+
+
+#ifndef __OPENFLUID_MACHINE_HALOCHANNEL_HPP__
+#define __OPENFLUID_MACHINE_HALOCHANNEL_HPP__
+
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <openfluid/dllexport.hpp>
+#include <openfluid/core/SpatialGraph.hpp>
+#include <openfluid/core/DateTime.hpp>
+#include <openfluid/core/Value.hpp>
+
+
+namespace openfluid { namespace machine {
+
+
+/**
+  Value of a boundary variable exchanged between partitions of a spatial graph
+*/
+struct HaloValue
+{
+  openfluid::core::UnitsClass_t m_UnitsClass;
+
+  openfluid::core::UnitID_t m_UnitID;
+
+  openfluid::core::VariableName_t m_VarName;
+
+  openfluid::core::TimeIndex_t m_Index;
+
+  std::shared_ptr<openfluid::core::Value> m_Value;
+
+  HaloValue() :
+    m_UnitID(0), m_Index(0)
+  { }
+};
+
+
+typedef std::vector<HaloValue> HaloValues_t;
+
+
+// =====================================================================
+// =====================================================================
+
+
+/**
+  Local transport channel between two engine processes running partitions of a same spatial graph
+  (see openfluid::core::SpatialGraphPartitioning), used to exchange the values of boundary variables
+  at each time point. The channel is a local stream socket identified by a filesystem path:
+  one process listens on the path while the other one connects to it.
+  Booleans, integers, doubles, vectors and matrices are exchanged in their binary representation,
+  other values through their string representation. Channels are available on Unix systems only.
+*/
+class OPENFLUID_API HaloChannel
+{
+  private:
+
+    int m_Socket;
+
+    void writeBytes(const void* Data, std::size_t Size);
+
+    void readBytes(void* Data, std::size_t Size);
+
+
+  public:
+
+    HaloChannel();
+
+    HaloChannel(const HaloChannel&) = delete;
+
+    HaloChannel& operator=(const HaloChannel&) = delete;
+
+    ~HaloChannel();
+
+    /**
+      Creates two connected channels, for partitions run by threads or forked processes
+    */
+    static void createPair(HaloChannel& First, HaloChannel& Second);
+
+    /**
+      Listens on the given path and waits for a connection from the other partition
+      @param[in] Path the path of the local socket
+    */
+    void listen(const std::string& Path);
+
+    /**
+      Connects to the given path, retrying until the other partition listens on it
+      @param[in] Path the path of the local socket
+      @param[in] TimeoutMs the maximum waiting time in milliseconds
+    */
+    void connect(const std::string& Path, unsigned int TimeoutMs = 10000);
+
+    inline bool isOpen() const
+    { return (m_Socket >= 0); };
+
+    void close();
+
+    /**
+      Sends values through the channel
+      @param[in] Values the values to send
+      @param[in] Tag a tag identifying the values, received with them
+    */
+    void send(const HaloValues_t& Values, std::uint64_t Tag = 0);
+
+    /**
+      Receives values sent by the other partition, blocking until they are available
+      @param[out] Values the received values
+      @param[out] Tag the tag of the received values
+    */
+    void receive(HaloValues_t& Values, std::uint64_t& Tag);
+
+    /**
+      Receives values sent by the other partition, blocking until they are available
+      @param[out] Values the received values
+    */
+    void receive(HaloValues_t& Values)
+    {
+      std::uint64_t Tag;
+      receive(Values,Tag);
+    }
+
+    /**
+      Collects the values of variables of units at a given time index.
+      Variables without value at this time index are ignored.
+      @param[in] Units the units, usually the units of a partition in the halo of another partition
+      @param[in] VarNames the names of the variables
+      @param[in] Index the time index
+      @param[out] Values the collected values
+    */
+    static void collectValues(const openfluid::core::UnitsPtrVector_t& Units,
+                              const std::vector<openfluid::core::VariableName_t>& VarNames,
+                              openfluid::core::TimeIndex_t Index,
+                              HaloValues_t& Values);
+
+    /**
+      Collects the values of all variables of units at a given time index.
+      Variables without value at this time index are ignored.
+      @param[in] Units the units, usually the units of a partition in the halo of another partition
+      @param[in] Index the time index
+      @param[out] Values the collected values
+    */
+    static void collectValues(const openfluid::core::UnitsPtrVector_t& Units,
+                              openfluid::core::TimeIndex_t Index,
+                              HaloValues_t& Values);
+
+    /**
+      Stores received values into the variables of the corresponding units of the spatial graph,
+      replacing existing values at the same time index. Variables are created if they do not exist.
+      @throw openfluid::base::FrameworkException if a unit does not exist in the spatial graph
+      or if a value cannot be stored
+    */
+    static void applyValues(openfluid::core::SpatialGraph* Graph, const HaloValues_t& Values);
+
+};
+
+
+} } // namespaces
+
+
+#endif /* __OPENFLUID_MACHINE_HALOCHANNEL_HPP__ */
@@ -0,0 +1,195 @@
+/*
+
+  This file is part of OpenFLUID software
+  Copyright(c) 2007, INRA - Montpellier SupAgro
+
+
+ == GNU General Public License Usage ==
+
+  OpenFLUID is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OpenFLUID is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OpenFLUID. If not, see <http://www.gnu.org/licenses/>.
+
+
+ == Other Usage ==
+
+  Other Usage means a use of OpenFLUID that is inconsistent with the GPL
+  license, and requires a written agreement between You and INRA.
+  Licensees for Other Usage of OpenFLUID may use this file in accordance
+  with the terms contained in the written agreement between You and INRA.
+  
+*/
+
+
+
+/**
+  @file HaloExchanger.cpp
+
+  @author Jean-Christophe FABRE <jean-christophe.fabre@supagro.inra.fr>
+ */
+
+
+#include <openfluid/machine/HaloExchanger.hpp>
+#include <openfluid/base/FrameworkException.hpp>
+
+
+namespace openfluid { namespace machine {
+
+
+HaloExchanger::HaloExchanger(openfluid::core::SpatialGraph* Graph,
+                             const openfluid::core::SpatialGraphPartitioning& Partitioning,
+                             PartitionID_t Partition) :
+  mp_SpatialGraph(Graph), m_Partition(Partition), m_StepsCount(0)
+{
+  m_Units = Partitioning.units(Partition);
+
+  for (PartitionID_t Other = 0; Other < Partitioning.getPartitionsCount(); Other++)
+  {
+    if (Other == Partition)
+      continue;
+
+    const openfluid::core::UnitsPtrVector_t& Received = Partitioning.haloUnits(Partition,Other);
+    const openfluid::core::UnitsPtrVector_t& Sent = Partitioning.haloUnits(Other,Partition);
+
+    if (!Received.empty() || !Sent.empty())
+    {
+      m_Neighbours[Other].m_SentUnits = Sent;
+      m_GhostUnits.insert(m_GhostUnits.end(),Received.begin(),Received.end());
+    }
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+std::vector<HaloExchanger::PartitionID_t> HaloExchanger::getNeighbourPartitions() const
+{
+  std::vector<PartitionID_t> Partitions;
+
+  for (auto& Neighb : m_Neighbours)
+    Partitions.push_back(Neighb.first);
+
+  return Partitions;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void HaloExchanger::setChannel(PartitionID_t Other, std::unique_ptr<HaloChannel> Channel)
+{
+  auto it = m_Neighbours.find(Other);
+
+  if (it == m_Neighbours.end())
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                              "Partition " + std::to_string(Other) +
+                                              " is not a neighbour of partition " + std::to_string(m_Partition));
+
+  it->second.m_Channel = std::move(Channel);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void HaloExchanger::restrictSpatialGraph()
+{
+  mp_SpatialGraph->restrictToUnits(m_Units,m_GhostUnits);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void HaloExchanger::receiveFrom(Neighbour& Neighb, PartitionID_t Other, std::uint64_t Step)
+{
+  if (!Neighb.m_Channel || !Neighb.m_Channel->isOpen())
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                              "Missing halo channel to partition " + std::to_string(Other));
+
+  HaloValues_t Values;
+  std::uint64_t ReceivedStep;
+
+  Neighb.m_Channel->receive(Values,ReceivedStep);
+
+  if (ReceivedStep != Step)
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                              "Partitions " + std::to_string(m_Partition) + " and " +
+                                              std::to_string(Other) + " are not synchronized (step " +
+                                              std::to_string(ReceivedStep) + " received, step " +
+                                              std::to_string(Step) + " expected)");
+
+  HaloChannel::applyValues(mp_SpatialGraph,Values);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void HaloExchanger::receiveBeforeStep()
+{
+  // current step from previous partitions, previous step from next partitions
+  for (auto& Neighb : m_Neighbours)
+  {
+    if (Neighb.first < m_Partition)
+      receiveFrom(Neighb.second,Neighb.first,m_StepsCount);
+    else if (m_StepsCount)
+      receiveFrom(Neighb.second,Neighb.first,m_StepsCount-1);
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void HaloExchanger::sendAfterStep(openfluid::core::TimeIndex_t Index)
+{
+  for (auto& Neighb : m_Neighbours)
+  {
+    if (!Neighb.second.m_Channel || !Neighb.second.m_Channel->isOpen())
+      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                                "Missing halo channel to partition " + std::to_string(Neighb.first));
+
+    HaloValues_t Values;
+    HaloChannel::collectValues(Neighb.second.m_SentUnits,Index,Values);
+    Neighb.second.m_Channel->send(Values,m_StepsCount);
+  }
+
+  m_StepsCount++;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void HaloExchanger::finish()
+{
+  if (!m_StepsCount)
+    return;
+
+  for (auto& Neighb : m_Neighbours)
+  {
+    if (Neighb.first > m_Partition)
+      receiveFrom(Neighb.second,Neighb.first,m_StepsCount-1);
+  }
+}
+
+
+} } // namespaces
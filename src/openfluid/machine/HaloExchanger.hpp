@@ -0,0 +1,169 @@
+/*
+
+  This file is part of OpenFLUID software
+  Copyright(c) 2007, INRA - Montpellier SupAgro
+
+
+ == GNU General Public License Usage ==
+
+  OpenFLUID is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OpenFLUID is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OpenFLUID. If not, see <http://www.gnu.org/licenses/>.
+
+
+ == Other Usage ==
+
+  Other Usage means a use of OpenFLUID that is inconsistent with the GPL
+  license, and requires a written agreement between You and INRA.
+  Licensees for Other Usage of OpenFLUID may use this file in accordance
+  with the terms contained in the written agreement between You and INRA.
+  
+*/
+
+
+
+/**
+  @file HaloExchanger.hpp
+
+  @author Jean-Christophe FABRE <jean-christophe.fabre@supagro.inra.fr>
+ */
+
+
+
+#ifndef __OPENFLUID_MACHINE_HALOEXCHANGER_HPP__
+#define __OPENFLUID_MACHINE_HALOEXCHANGER_HPP__
+
+
+#include <map>
+#include <memory>
+
+#include <openfluid/dllexport.hpp>
+#include <openfluid/core/SpatialGraphPartitioning.hpp>
+#include <openfluid/machine/HaloChannel.hpp>
+
+
+namespace openfluid { namespace machine {
+
+
+/**
+  Exchange of the values of boundary variables between the engine processes running the partitions
+  of a spatial graph (see openfluid::core::SpatialGraphPartitioning).
+
+  The spatial graph of the partition is restricted to the units of the partition, plus the units of other
+  partitions linked to them as ghost units. Before each simulator processing, the partition receives the
+  values of its ghost units: the values of the current step from the previous partitions, and the values
+  of the previous step from the next partitions. After each simulator processing, it sends the values of its units
+  in the halos of other partitions. Partitions being ordered following the process order, a unit receives the
+  values of the linked units processed before it at the same step, as in a non-partitioned run.
+
+  All partitions must run the same model with the same scheduling: steps are numbered and a mismatch
+  between partitions is reported as an error.
+*/
+class OPENFLUID_API HaloExchanger
+{
+  public:
+
+    typedef openfluid::core::SpatialGraphPartitioning::PartitionID_t PartitionID_t;
+
+
+  private:
+
+    struct Neighbour
+    {
+      std::unique_ptr<HaloChannel> m_Channel;
+
+      openfluid::core::UnitsPtrVector_t m_SentUnits;
+    };
+
+    openfluid::core::SpatialGraph* mp_SpatialGraph;
+
+    PartitionID_t m_Partition;
+
+    openfluid::core::UnitsPtrVector_t m_Units;
+
+    openfluid::core::UnitsPtrVector_t m_GhostUnits;
+
+    std::map<PartitionID_t,Neighbour> m_Neighbours;
+
+    std::uint64_t m_StepsCount;
+
+    void receiveFrom(Neighbour& Neighb, PartitionID_t Other, std::uint64_t Step);
+
+
+  public:
+
+    /**
+      Prepares the exchange for a partition of a spatial graph. The spatial graph is not modified.
+      @param[in] Graph the spatial graph
+      @param[in] Partitioning the partitioning of the spatial graph
+      @param[in] Partition the partition run by this process
+      @throw openfluid::base::FrameworkException if the partition does not exist
+    */
+    HaloExchanger(openfluid::core::SpatialGraph* Graph,
+                  const openfluid::core::SpatialGraphPartitioning& Partitioning,
+                  PartitionID_t Partition);
+
+    HaloExchanger(const HaloExchanger&) = delete;
+
+    HaloExchanger& operator=(const HaloExchanger&) = delete;
+
+    inline PartitionID_t getPartition() const
+    { return m_Partition; };
+
+    /**
+      Returns the partitions exchanging values with this partition
+    */
+    std::vector<PartitionID_t> getNeighbourPartitions() const;
+
+    /**
+      Sets the channel connected to the process running another partition
+      @param[in] Other the other partition, which must be a neighbour partition
+      @param[in] Channel the open channel
+      @throw openfluid::base::FrameworkException if the other partition is not a neighbour partition
+    */
+    void setChannel(PartitionID_t Other, std::unique_ptr<HaloChannel> Channel);
+
+    /**
+      Restricts the spatial graph to the units of the partition and to their ghost units.
+      Must be called before building the model and the monitoring
+    */
+    void restrictSpatialGraph();
+
+    /**
+      Receives the values of ghost units before a simulator processing
+      @throw openfluid::base::FrameworkException if a channel is missing or if partitions are not synchronized
+    */
+    void receiveBeforeStep();
+
+    /**
+      Sends the values of units in halos of other partitions after a simulator processing
+      @param[in] Index the current time index
+    */
+    void sendAfterStep(openfluid::core::TimeIndex_t Index);
+
+    /**
+      Receives the last values sent by the next partitions, at the end of the run
+    */
+    void finish();
+
+    /**
+      Returns the number of processed steps
+    */
+    inline std::uint64_t getStepsCount() const
+    { return m_StepsCount; };
+};
+
+
+} } // namespaces
+
+
+#endif /* __OPENFLUID_MACHINE_HALOEXCHANGER_HPP__ */
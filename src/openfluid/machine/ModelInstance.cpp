@@ -48,6 +48,7 @@
 #include <openfluid/machine/RandomGenerator.hpp>
 #include <openfluid/machine/InterpGenerator.hpp>
 #include <openfluid/machine/InjectGenerator.hpp>
+#include <openfluid/machine/HaloExchanger.hpp>
 #include <openfluid/tools/DataHelpers.hpp>
 
 
@@ -99,7 +100,7 @@ namespace openfluid { namespace machine {
 ModelInstance::ModelInstance(openfluid::machine::SimulationBlob& SimulationBlob,
                              openfluid::machine::MachineListener* Listener)
              : mp_Listener(Listener), mp_SimLogger(nullptr), mp_SimProfiler(nullptr),
-               m_SimulationBlob(SimulationBlob), m_Initialized(false)
+               m_SimulationBlob(SimulationBlob), m_Initialized(false), mp_HaloExchanger(nullptr)
 {
   if (!mp_Listener)
     throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Listener can not be NULL");
@@ -495,6 +496,9 @@ void ModelInstance::call_initializeRun()
     {
       mp_Listener->onSimulatorInitializeRun(CurrentSimulator->Signature->ID);
 
+      if (mp_HaloExchanger != nullptr)
+        mp_HaloExchanger->receiveBeforeStep();
+
       std::chrono::high_resolution_clock::time_point TimeProfileStart = std::chrono::high_resolution_clock::now();
 
       openfluid::base::SchedulingRequest SchedReq = CurrentSimulator->Body->initializeRun();
@@ -506,6 +510,9 @@ void ModelInstance::call_initializeRun()
                                         std::chrono::high_resolution_clock::now()-TimeProfileStart)
                                     );
 
+      if (mp_HaloExchanger != nullptr)
+        mp_HaloExchanger->sendAfterStep(m_SimulationBlob.simulationStatus().getCurrentTimeIndex());
+
       if (mp_SimLogger->isCurrentWarningFlag())
         mp_Listener->onSimulatorInitializeRunDone(openfluid::machine::MachineListener::LISTEN_WARNING,
                                                   CurrentSimulator->Signature->ID);
@@ -561,6 +568,10 @@ void ModelInstance::processNextTimePoint()
     openfluid::machine::ModelItemInstance* NextItem = m_TimePointList.front().nextItem();
 
     mp_Listener->onSimulatorRunStep(NextItem->Signature->ID);
+
+    if (mp_HaloExchanger != nullptr)
+      mp_HaloExchanger->receiveBeforeStep();
+
     std::chrono::high_resolution_clock::time_point TimeProfileStart = std::chrono::high_resolution_clock::now();
 
     openfluid::base::SchedulingRequest SchedReq = m_TimePointList.front().processNextItem();
@@ -572,6 +583,9 @@ void ModelInstance::processNextTimePoint()
                                       std::chrono::high_resolution_clock::now()-TimeProfileStart)
                                  );
 
+    if (mp_HaloExchanger != nullptr)
+      mp_HaloExchanger->sendAfterStep(m_SimulationBlob.simulationStatus().getCurrentTimeIndex());
+
     if (mp_SimLogger->isCurrentWarningFlag())
     {
       AtLeastOneWarningFlag = true;
@@ -615,6 +629,10 @@ void ModelInstance::call_finalizeRun() const
     throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Model not initialized");
 
 
+  // last values sent by next partitions
+  if (mp_HaloExchanger != nullptr)
+    mp_HaloExchanger->finish();
+
   DECLARE_SIMULATOR_PARSER;
   PARSE_SIMULATOR_LIST(finalizeRun(),FinalizeRun,openfluid::base::SimulationStatus::FINALIZERUN);
 }
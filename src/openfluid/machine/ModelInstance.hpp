@@ -63,6 +63,7 @@ namespace openfluid { namespace machine {
 class MachineListener;
 class SimulationBlob;
 class ModelItemInstance;
+class HaloExchanger;
 
 
 class OPENFLUID_API ModelInstance
@@ -85,6 +86,8 @@ class OPENFLUID_API ModelInstance
 
     bool m_Initialized;
 
+    HaloExchanger* mp_HaloExchanger;
+
     void appendItemToTimePoint(openfluid::core::TimeIndex_t TimeIndex, openfluid::machine::ModelItemInstance* Item);
 
     void checkDeltaTMode(openfluid::base::SchedulingRequest& SReq, const openfluid::ware::WareID_t& ID);
@@ -163,6 +166,14 @@ class OPENFLUID_API ModelInstance
     void resetInitialized()
     { m_Initialized = false; }
 
+    /**
+      Sets the halo exchanger used to exchange values with other partitions before and after each simulator
+      processing, when the model runs on a partition of the spatial graph
+      @param[in] Exchanger the halo exchanger, nullptr for a non-partitioned run
+    */
+    void setHaloExchanger(HaloExchanger* Exchanger)
+    { mp_HaloExchanger = Exchanger; }
+
 };
 
 
@@ -41,6 +41,7 @@
 #include <ctime>
 
 #include <openfluid/machine/RandomGenerator.hpp>
+#include <openfluid/ware/ThreadedLoopMacros.hpp>
 #include <openfluid/tools/DataHelpers.hpp>
 
 
@@ -48,7 +49,8 @@ namespace openfluid { namespace machine {
 
 
 RandomGenerator::RandomGenerator() :
-  Generator(), m_Min(0.0), m_Max(0.0), m_DeltaT(0)
+  Generator(), m_Min(0.0), m_Max(0.0), m_Mean(0.0), m_StdDev(1.0), m_DeltaT(0),
+  m_Distribution(DistributionType::UNIFORM), m_IsCounterBased(false)
 {
   std::random_device RandomDevice;
 
@@ -73,11 +75,48 @@ RandomGenerator::~RandomGenerator()
 
 void RandomGenerator::initParams(const openfluid::ware::WareParams_t& Params)
 {
-  if (!OPENFLUID_GetSimulatorParameter(Params,"min",m_Min))
-    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"missing min value for generator");
+  std::string DistributionStr;
+  if (OPENFLUID_GetSimulatorParameter(Params,"distribution-law",DistributionStr))
+  {
+    if (DistributionStr == "uniform")
+      m_Distribution = DistributionType::UNIFORM;
+    else if (DistributionStr == "normal")
+      m_Distribution = DistributionType::NORMAL;
+    else if (DistributionStr == "lognormal")
+      m_Distribution = DistributionType::LOGNORMAL;
+    else
+      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                                "unknown distribution law " + DistributionStr + " for generator");
+  }
+
+  if (m_Distribution == DistributionType::UNIFORM)
+  {
+    if (!OPENFLUID_GetSimulatorParameter(Params,"min",m_Min))
+      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"missing min value for generator");
 
-  if (!OPENFLUID_GetSimulatorParameter(Params,"max",m_Max))
-    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"missing max value for generator");
+    if (!OPENFLUID_GetSimulatorParameter(Params,"max",m_Max))
+      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"missing max value for generator");
+  }
+  else
+  {
+    if (!OPENFLUID_GetSimulatorParameter(Params,"mean",m_Mean))
+      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"missing mean value for generator");
+
+    if (!OPENFLUID_GetSimulatorParameter(Params,"stddev",m_StdDev))
+      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"missing stddev value for generator");
+  }
+
+  std::string SeedStr;
+  if (OPENFLUID_GetSimulatorParameter(Params,"seed",SeedStr))
+  {
+    unsigned long long Seed;
+
+    if (!openfluid::tools::convertString(SeedStr,&Seed))
+      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"wrong value for seed");
+
+    m_IsCounterBased = true;
+    m_CounterBasedEngine.setSeed(Seed);
+  }
 
   std::string DeltaTStr;
   if (OPENFLUID_GetSimulatorParameter(Params,"deltat",DeltaTStr) &&
@@ -92,9 +131,16 @@ void RandomGenerator::initParams(const openfluid::ware::WareParams_t& Params)
 
 void RandomGenerator::checkConsistency()
 {
-  if ( m_Min > m_Max)
+  if (m_Distribution == DistributionType::UNIFORM && m_Min > m_Max)
     throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
                                               "max value must be greater or equal to min value for generator");
+
+  if (m_Distribution != DistributionType::UNIFORM && m_StdDev < 0.0)
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                              "stddev value must be positive or null for generator");
+
+  // the sub-stream separates generators sharing the same seed
+  m_CounterBasedEngine.setSubStream(openfluid::scientific::CounterBasedRandom::computeSubStream(m_VarName));
 }
 
 
@@ -127,23 +173,99 @@ openfluid::base::SchedulingRequest RandomGenerator::initializeRun()
 // =====================================================================
 
 
+double RandomGenerator::drawValue()
+{
+  switch (m_Distribution)
+  {
+    case DistributionType::NORMAL:
+      return std::normal_distribution<double>(m_Mean,m_StdDev)(m_RandomEngine);
+
+    case DistributionType::LOGNORMAL:
+      return std::lognormal_distribution<double>(m_Mean,m_StdDev)(m_RandomEngine);
+
+    default:
+      return std::uniform_real_distribution<double>(m_Min,m_Max)(m_RandomEngine);
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+double RandomGenerator::drawValue(const openfluid::core::SpatialUnit* U)
+{
+  const std::uint32_t Stream = U->getID();
+  const std::uint64_t Index = OPENFLUID_GetCurrentTimeIndex();
+
+  switch (m_Distribution)
+  {
+    case DistributionType::NORMAL:
+      return m_CounterBasedEngine.normal(Stream,Index,m_Mean,m_StdDev);
+
+    case DistributionType::LOGNORMAL:
+      return m_CounterBasedEngine.logNormal(Stream,Index,m_Mean,m_StdDev);
+
+    default:
+      return m_CounterBasedEngine.uniform(Stream,Index,m_Min,m_Max);
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void RandomGenerator::appendValue(openfluid::core::SpatialUnit* U, double Val)
+{
+  openfluid::core::DoubleValue Value(Val);
+
+  if (isVectorVariable())
+  {
+    openfluid::core::VectorValue VV(m_VarSize,Value);
+    OPENFLUID_AppendVariable(U,m_VarName,VV);
+  }
+  else
+    OPENFLUID_AppendVariable(U,m_VarName,Value);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void RandomGenerator::appendCounterBasedValue(openfluid::core::SpatialUnit* U)
+{
+  appendValue(U,drawValue(U));
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 openfluid::base::SchedulingRequest RandomGenerator::runStep()
 {
   openfluid::core::SpatialUnit* LU;
-  std::uniform_real_distribution<double> Distribution(m_Min, m_Max);
 
-  OPENFLUID_UNITS_ORDERED_LOOP(m_UnitsClass,LU)
+  if (!m_IsCounterBased)
   {
-    openfluid::core::DoubleValue Value(Distribution(m_RandomEngine));
-
-    if (isVectorVariable())
+    OPENFLUID_UNITS_ORDERED_LOOP(m_UnitsClass,LU)
     {
-      openfluid::core::VectorValue VV(m_VarSize,Value);
-      OPENFLUID_AppendVariable(LU,m_VarName,VV);
+      appendValue(LU,drawValue());
+    }
+  }
+  else if (OPENFLUID_GetSimulatorMaxThreads() > 1)
+  {
+    // values do not depend on the processing order, units can be processed concurrently
+    APPLY_UNITS_ORDERED_LOOP_THREADED(m_UnitsClass,RandomGenerator::appendCounterBasedValue);
+  }
+  else
+  {
+    OPENFLUID_UNITS_ORDERED_LOOP(m_UnitsClass,LU)
+    {
+      appendCounterBasedValue(LU);
     }
-    else
-      OPENFLUID_AppendVariable(LU,m_VarName,Value);
-
   }
 
   if (m_DeltaT > 0)
@@ -155,4 +277,3 @@ openfluid::base::SchedulingRequest RandomGenerator::runStep()
 
 } } //namespaces
 
-
@@ -44,23 +44,53 @@
 
 #include <openfluid/dllexport.hpp>
 #include <openfluid/machine/Generator.hpp>
+#include <openfluid/scientific/CounterBasedRandom.hpp>
 
 
 namespace openfluid { namespace machine {
 
 
+/**
+  Generator producing random values, following a uniform, normal or log-normal distribution.
+  When a seed is given, values are produced by a counter-based generator keyed by the seed, the unit ID
+  and the time index: they are reproducible and independent of the units processing order
+  and of the number of threads.
+*/
 class OPENFLUID_API RandomGenerator : public Generator
 {
+  public:
+
+    enum class DistributionType { UNIFORM, NORMAL, LOGNORMAL };
+
+
   private:
 
     openfluid::core::DoubleValue m_Min;
 
     openfluid::core::DoubleValue m_Max;
 
+    openfluid::core::DoubleValue m_Mean;
+
+    openfluid::core::DoubleValue m_StdDev;
+
     openfluid::core::Duration_t m_DeltaT;
 
+    DistributionType m_Distribution;
+
     std::mt19937 m_RandomEngine;
 
+    bool m_IsCounterBased;
+
+    openfluid::scientific::CounterBasedRandom m_CounterBasedEngine;
+
+    double drawValue();
+
+    double drawValue(const openfluid::core::SpatialUnit* U);
+
+    void appendValue(openfluid::core::SpatialUnit* U, double Val);
+
+    void appendCounterBasedValue(openfluid::core::SpatialUnit* U);
+
 
   public:
 
@@ -79,6 +109,12 @@ class OPENFLUID_API RandomGenerator : public Generator
     void finalizeRun()
     { };
 
+    inline DistributionType getDistribution() const
+    { return m_Distribution; };
+
+    inline bool isCounterBased() const
+    { return m_IsCounterBased; };
+
 };
 
 
@@ -0,0 +1,258 @@
+/*
+
+  This file is part of OpenFLUID software
+  Copyright(c) 2007, INRA - Montpellier SupAgro
+
+
+ == GNU General Public License Usage ==
+
+  OpenFLUID is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OpenFLUID is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OpenFLUID. If not, see <http://www.gnu.org/licenses/>.
+
+
+ == Other Usage ==
+
+  Other Usage means a use of OpenFLUID that is inconsistent with the GPL
+  license, and requires a written agreement between You and INRA.
+  Licensees for Other Usage of OpenFLUID may use this file in accordance
+  with the terms contained in the written agreement between You and INRA.
+  
+*/
+
+
+
+/**
+  @file HaloChannel_TEST.cpp
+
+  @author Jean-Christophe FABRE <jean-christophe.fabre@supagro.inra.fr>
+ */
+
+
+#define BOOST_TEST_MAIN
+#define BOOST_AUTO_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE unittest_halochannel
+#include <boost/test/unit_test.hpp>
+#include <boost/test/auto_unit_test.hpp>
+
+#include <thread>
+
+#include <openfluid/machine/HaloChannel.hpp>
+#include <openfluid/core/SpatialGraphPartitioning.hpp>
+#include <openfluid/core/BooleanValue.hpp>
+#include <openfluid/core/IntegerValue.hpp>
+#include <openfluid/core/DoubleValue.hpp>
+#include <openfluid/core/StringValue.hpp>
+#include <openfluid/core/VectorValue.hpp>
+#include <openfluid/core/MatrixValue.hpp>
+#include <openfluid/core/ValuesBufferProperties.hpp>
+#include <openfluid/base/FrameworkException.hpp>
+
+#if defined(OPENFLUID_OS_UNIX)
+#include <unistd.h>
+#endif
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_construction)
+{
+  openfluid::machine::HaloChannel Channel;
+
+  BOOST_REQUIRE(!Channel.isOpen());
+
+  openfluid::machine::HaloValues_t Values;
+  BOOST_REQUIRE_THROW(Channel.send(Values),openfluid::base::FrameworkException);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+#if defined(OPENFLUID_OS_UNIX)
+
+BOOST_AUTO_TEST_CASE(check_exchange)
+{
+  openfluid::core::ValuesBufferProperties::setBufferSize(5);
+
+  // chain of 10 units : 1 -> 2 -> ... -> 10
+  openfluid::core::SpatialGraph SGraph;
+
+  for (int i=1; i<=10; i++)
+    SGraph.addUnit(openfluid::core::SpatialUnit("SU",i,i));
+
+  for (int i=1; i<10; i++)
+  {
+    openfluid::core::SpatialUnit* From = SGraph.spatialUnit("SU",i);
+    openfluid::core::SpatialUnit* To = SGraph.spatialUnit("SU",i+1);
+    From->addToUnit(To);
+    To->addFromUnit(From);
+  }
+  SGraph.sortUnitsByProcessOrder();
+
+  openfluid::core::SpatialGraphPartitioning Partitioning;
+  Partitioning.compute(&SGraph,2);
+  BOOST_REQUIRE_EQUAL(Partitioning.getCutLinksCount(),1);
+
+  for (openfluid::core::SpatialUnit* U : *(SGraph.allSpatialUnits()))
+  {
+    U->variables()->createVariable("water");
+    U->variables()->createVariable("name");
+    U->variables()->appendValue("water",0,openfluid::core::DoubleValue(U->getID()*1.5));
+    U->variables()->appendValue("name",0,openfluid::core::StringValue("unit"));
+  }
+
+  // values of partition 0 needed by partition 1, and conversely
+  openfluid::machine::HaloValues_t SentTo1, SentTo0;
+  openfluid::machine::HaloChannel::collectValues(Partitioning.haloUnits(1,0),{"water","name"},0,SentTo1);
+  openfluid::machine::HaloChannel::collectValues(Partitioning.haloUnits(0,1),{"water","name"},0,SentTo0);
+  BOOST_REQUIRE_EQUAL(SentTo1.size(),2);
+  BOOST_REQUIRE_EQUAL(SentTo0.size(),2);
+
+  openfluid::machine::HaloChannel Channel0, Channel1;
+  openfluid::machine::HaloChannel::createPair(Channel0,Channel1);
+  BOOST_REQUIRE(Channel0.isOpen() && Channel1.isOpen());
+
+  openfluid::machine::HaloValues_t ReceivedBy1, ReceivedBy0;
+
+  std::thread Partition1([&]()
+  {
+    Channel1.send(SentTo0);
+    Channel1.receive(ReceivedBy1);
+  });
+
+  Channel0.send(SentTo1);
+  Channel0.receive(ReceivedBy0);
+  Partition1.join();
+
+  BOOST_REQUIRE_EQUAL(ReceivedBy1.size(),2);
+  BOOST_REQUIRE_EQUAL(ReceivedBy1[0].m_UnitsClass,"SU");
+  BOOST_REQUIRE_EQUAL(ReceivedBy1[0].m_UnitID,SentTo1[0].m_UnitID);
+  BOOST_REQUIRE_EQUAL(ReceivedBy1[0].m_VarName,"water");
+  BOOST_REQUIRE_EQUAL(ReceivedBy1[0].m_Index,0);
+  BOOST_REQUIRE_CLOSE(ReceivedBy1[0].m_Value->asDoubleValue().get(),
+                      SentTo1[0].m_Value->asDoubleValue().get(),0.0001);
+  BOOST_REQUIRE_EQUAL(ReceivedBy1[1].m_VarName,"name");
+  BOOST_REQUIRE_EQUAL(ReceivedBy1[1].m_Value->asStringValue().get(),"unit");
+  BOOST_REQUIRE_EQUAL(ReceivedBy0[0].m_UnitID,SentTo0[0].m_UnitID);
+
+  // received values replace existing values
+  ReceivedBy1[0].m_Value = std::make_shared<openfluid::core::DoubleValue>(100.0);
+  openfluid::machine::HaloChannel::applyValues(&SGraph,ReceivedBy1);
+
+  openfluid::core::DoubleValue Val;
+  SGraph.spatialUnit("SU",ReceivedBy1[0].m_UnitID)->variables()->getValue("water",0,&Val);
+  BOOST_REQUIRE_CLOSE(Val.get(),100.0,0.0001);
+
+  ReceivedBy1[0].m_UnitID = 1000;
+  BOOST_REQUIRE_THROW(openfluid::machine::HaloChannel::applyValues(&SGraph,ReceivedBy1),
+                      openfluid::base::FrameworkException);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_values_types)
+{
+  openfluid::machine::HaloChannel Channel0, Channel1;
+  openfluid::machine::HaloChannel::createPair(Channel0,Channel1);
+
+  openfluid::core::VectorValue Vect(3);
+  openfluid::core::MatrixValue Matrix(2,3);
+  for (unsigned int i=0; i<3; i++)
+  {
+    Vect.set(i,i/3.0);
+    Matrix.set(1,i,i*1.1);
+  }
+
+  openfluid::machine::HaloValues_t Sent(6);
+  Sent[0].m_Value = std::make_shared<openfluid::core::BooleanValue>(true);
+  Sent[1].m_Value = std::make_shared<openfluid::core::IntegerValue>(-42);
+  Sent[2].m_Value = std::make_shared<openfluid::core::DoubleValue>(1.0/3.0);
+  Sent[3].m_Value = std::make_shared<openfluid::core::StringValue>("halo value");
+  Sent[4].m_Value = std::make_shared<openfluid::core::VectorValue>(Vect);
+  Sent[5].m_Value = std::make_shared<openfluid::core::MatrixValue>(Matrix);
+
+  openfluid::machine::HaloValues_t Received;
+  Channel0.send(Sent);
+  Channel1.receive(Received);
+
+  BOOST_REQUIRE_EQUAL(Received.size(),6);
+  BOOST_REQUIRE(Received[0].m_Value->asBooleanValue().get());
+  BOOST_REQUIRE_EQUAL(Received[1].m_Value->asIntegerValue().get(),-42);
+  BOOST_REQUIRE_EQUAL(Received[2].m_Value->asDoubleValue().get(),1.0/3.0);
+  BOOST_REQUIRE_EQUAL(Received[3].m_Value->asStringValue().get(),"halo value");
+
+  const openfluid::core::VectorValue& ReceivedVect = Received[4].m_Value->asVectorValue();
+  const openfluid::core::MatrixValue& ReceivedMatrix = Received[5].m_Value->asMatrixValue();
+  BOOST_REQUIRE_EQUAL(ReceivedVect.size(),3);
+  BOOST_REQUIRE_EQUAL(ReceivedMatrix.getColsNbr(),2);
+  BOOST_REQUIRE_EQUAL(ReceivedMatrix.getRowsNbr(),3);
+  for (unsigned int i=0; i<3; i++)
+  {
+    BOOST_REQUIRE_EQUAL(ReceivedVect.get(i),i/3.0);
+    BOOST_REQUIRE_EQUAL(ReceivedMatrix.get(1,i),i*1.1);
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_local_socket)
+{
+  const std::string Path = "/tmp/openfluid-halochannel-" + std::to_string(getpid()) + ".sock";
+
+  openfluid::machine::HaloChannel Server, Client;
+  openfluid::machine::HaloValues_t Received;
+  std::uint64_t Tag = 0;
+
+  std::thread ServerThread([&]()
+  {
+    Server.listen(Path);
+    Server.receive(Received,Tag);
+  });
+
+  Client.connect(Path);
+
+  openfluid::machine::HaloValues_t Sent(3);
+  for (unsigned int i=0; i<3; i++)
+  {
+    Sent[i].m_UnitsClass = "RS";
+    Sent[i].m_UnitID = i+1;
+    Sent[i].m_VarName = "discharge";
+    Sent[i].m_Index = 3600;
+    Sent[i].m_Value = std::make_shared<openfluid::core::DoubleValue>(i*0.25);
+  }
+  Client.send(Sent,7);
+
+  ServerThread.join();
+
+  BOOST_REQUIRE_EQUAL(Tag,7);
+  BOOST_REQUIRE_EQUAL(Received.size(),3);
+  BOOST_REQUIRE_EQUAL(Received[2].m_UnitID,3);
+  BOOST_REQUIRE_EQUAL(Received[2].m_Index,3600);
+  BOOST_REQUIRE_CLOSE(Received[2].m_Value->asDoubleValue().get(),0.5,0.0001);
+
+  Client.close();
+  BOOST_REQUIRE(!Client.isOpen());
+  BOOST_REQUIRE_THROW(Client.connect(Path,50),openfluid::base::FrameworkException);
+}
+
+#endif
@@ -0,0 +1,278 @@
+/*
+
+  This file is part of OpenFLUID software
+  Copyright(c) 2007, INRA - Montpellier SupAgro
+
+
+ == GNU General Public License Usage ==
+
+  OpenFLUID is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OpenFLUID is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OpenFLUID. If not, see <http://www.gnu.org/licenses/>.
+
+
+ == Other Usage ==
+
+  Other Usage means a use of OpenFLUID that is inconsistent with the GPL
+  license, and requires a written agreement between You and INRA.
+  Licensees for Other Usage of OpenFLUID may use this file in accordance
+  with the terms contained in the written agreement between You and INRA.
+  
+*/
+
+
+
+/**
+  @file HaloExchanger_TEST.cpp
+
+  @author Jean-Christophe FABRE <jean-christophe.fabre@supagro.inra.fr>
+ */
+
+
+
+
+#define BOOST_TEST_MAIN
+#define BOOST_AUTO_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE unittest_haloexchanger
+#include <boost/test/unit_test.hpp>
+#include <boost/test/auto_unit_test.hpp>
+
+#include <thread>
+
+#include <openfluid/machine/HaloExchanger.hpp>
+#include <openfluid/core/DoubleValue.hpp>
+#include <openfluid/core/ValuesBufferProperties.hpp>
+#include <openfluid/base/FrameworkException.hpp>
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_construction)
+{
+  openfluid::core::SpatialGraph SGraph;
+
+  for (int i=1; i<=4; i++)
+    SGraph.addUnit(openfluid::core::SpatialUnit("SU",i,i));
+
+  for (int i=1; i<4; i++)
+  {
+    openfluid::core::SpatialUnit* From = SGraph.spatialUnit("SU",i);
+    openfluid::core::SpatialUnit* To = SGraph.spatialUnit("SU",i+1);
+    From->addToUnit(To);
+    To->addFromUnit(From);
+  }
+  SGraph.sortUnitsByProcessOrder();
+
+  openfluid::core::SpatialGraphPartitioning Partitioning;
+  Partitioning.compute(&SGraph,2);
+
+  openfluid::machine::HaloExchanger Exchanger(&SGraph,Partitioning,1);
+  BOOST_REQUIRE_EQUAL(Exchanger.getPartition(),1);
+  BOOST_REQUIRE_EQUAL(Exchanger.getNeighbourPartitions().size(),1);
+  BOOST_REQUIRE_EQUAL(Exchanger.getNeighbourPartitions().front(),0);
+  BOOST_REQUIRE_EQUAL(Exchanger.getStepsCount(),0);
+
+  BOOST_REQUIRE_THROW(Exchanger.setChannel(2,std::unique_ptr<openfluid::machine::HaloChannel>()),
+                      openfluid::base::FrameworkException);
+
+  // no channel set to the neighbour partition
+  BOOST_REQUIRE_THROW(Exchanger.sendAfterStep(0),openfluid::base::FrameworkException);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+#if defined(OPENFLUID_OS_UNIX)
+
+namespace {
+
+const unsigned int UnitsCount = 12;
+
+const unsigned int PartitionsCount = 3;
+
+
+void buildChain(openfluid::core::SpatialGraph& SGraph)
+{
+  // chain of units : 1 -> 2 -> ... -> 12
+  for (unsigned int i=1; i<=UnitsCount; i++)
+    SGraph.addUnit(openfluid::core::SpatialUnit("SU",i,i));
+
+  for (unsigned int i=1; i<UnitsCount; i++)
+  {
+    openfluid::core::SpatialUnit* From = SGraph.spatialUnit("SU",i);
+    openfluid::core::SpatialUnit* To = SGraph.spatialUnit("SU",i+1);
+    From->addToUnit(To);
+    To->addFromUnit(From);
+  }
+  SGraph.sortUnitsByProcessOrder();
+
+  for (openfluid::core::SpatialUnit* U : *(SGraph.allSpatialUnits()))
+  {
+    U->variables()->createVariable("acc",openfluid::core::Value::DOUBLE);
+    U->variables()->createVariable("down",openfluid::core::Value::DOUBLE);
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+double getValue(openfluid::core::SpatialUnit* U, const openfluid::core::VariableName_t& Name,
+                openfluid::core::TimeIndex_t Index)
+{
+  openfluid::core::DoubleValue Val;
+
+  if (!U->variables()->getValue(Name,Index,&Val))
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                              "Missing value for " + Name + " on unit " + std::to_string(U->getID()));
+
+  return Val.get();
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void runSteps(openfluid::core::SpatialGraph* SGraph, openfluid::machine::HaloExchanger* Exchanger)
+{
+  for (openfluid::core::TimeIndex_t Index : {0,60,120})
+  {
+    // first simulator: accumulation from upstream units, processed before in the same step
+    Exchanger->receiveBeforeStep();
+    for (openfluid::core::SpatialUnit* U : *(SGraph->allSpatialUnits()))
+    {
+      double Acc = 1.0+Index;
+      const openfluid::core::UnitsPtrList_t* FromUnits = U->fromSpatialUnits("SU");
+
+      if (FromUnits != nullptr)
+      {
+        for (openfluid::core::SpatialUnit* FromU : *FromUnits)
+          Acc += getValue(FromU,"acc",Index)-Index;
+      }
+
+      U->variables()->appendValue("acc",Index,openfluid::core::DoubleValue(Acc));
+    }
+    Exchanger->sendAfterStep(Index);
+
+    // second simulator: value of the downstream unit, computed by the previous simulator
+    Exchanger->receiveBeforeStep();
+    for (openfluid::core::SpatialUnit* U : *(SGraph->allSpatialUnits()))
+    {
+      double Down = 0.0;
+      const openfluid::core::UnitsPtrList_t* ToUnits = U->toSpatialUnits("SU");
+
+      if (ToUnits != nullptr && !ToUnits->empty())
+        Down = getValue(ToUnits->front(),"acc",Index);
+
+      U->variables()->appendValue("down",Index,openfluid::core::DoubleValue(Down));
+    }
+    Exchanger->sendAfterStep(Index);
+  }
+
+  Exchanger->finish();
+}
+
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_partitioned_steps)
+{
+  openfluid::core::ValuesBufferProperties::setBufferSize(10);
+
+  // each partition has its own copy of the spatial graph, as in forked processes
+  std::vector<std::unique_ptr<openfluid::core::SpatialGraph>> Graphs;
+  std::vector<std::unique_ptr<openfluid::machine::HaloExchanger>> Exchangers;
+  std::vector<openfluid::core::SpatialGraphPartitioning> Partitionings(PartitionsCount);
+
+  for (unsigned int p=0; p<PartitionsCount; p++)
+  {
+    Graphs.emplace_back(new openfluid::core::SpatialGraph());
+    buildChain(*Graphs[p]);
+    Partitionings[p].compute(Graphs[p].get(),PartitionsCount);
+    Exchangers.emplace_back(new openfluid::machine::HaloExchanger(Graphs[p].get(),Partitionings[p],p));
+  }
+
+  BOOST_REQUIRE_EQUAL(Exchangers[0]->getNeighbourPartitions().size(),1);
+  BOOST_REQUIRE_EQUAL(Exchangers[1]->getNeighbourPartitions().size(),2);
+  BOOST_REQUIRE_EQUAL(Exchangers[2]->getNeighbourPartitions().size(),1);
+
+  for (unsigned int p=0; p<PartitionsCount; p++)
+  {
+    for (unsigned int q : Exchangers[p]->getNeighbourPartitions())
+    {
+      if (q > p)
+      {
+        std::unique_ptr<openfluid::machine::HaloChannel> ChannelP(new openfluid::machine::HaloChannel());
+        std::unique_ptr<openfluid::machine::HaloChannel> ChannelQ(new openfluid::machine::HaloChannel());
+        openfluid::machine::HaloChannel::createPair(*ChannelP,*ChannelQ);
+        Exchangers[p]->setChannel(q,std::move(ChannelP));
+        Exchangers[q]->setChannel(p,std::move(ChannelQ));
+      }
+    }
+
+    Exchangers[p]->restrictSpatialGraph();
+  }
+
+  std::vector<std::string> Errors(PartitionsCount);
+  std::vector<std::thread> Threads;
+
+  for (unsigned int p=0; p<PartitionsCount; p++)
+  {
+    Threads.push_back(std::thread([&,p]()
+    {
+      try
+      {
+        runSteps(Graphs[p].get(),Exchangers[p].get());
+      }
+      catch (openfluid::base::FrameworkException& E)
+      {
+        Errors[p] = E.getMessage();
+      }
+    }));
+  }
+
+  for (auto& Th : Threads)
+    Th.join();
+
+  std::size_t CheckedCount = 0;
+
+  for (unsigned int p=0; p<PartitionsCount; p++)
+  {
+    BOOST_REQUIRE_EQUAL(Errors[p],"");
+    BOOST_REQUIRE_EQUAL(Exchangers[p]->getStepsCount(),6);
+
+    for (openfluid::core::SpatialUnit* U : *(Graphs[p]->allSpatialUnits()))
+    {
+      for (openfluid::core::TimeIndex_t Index : {0,60,120})
+      {
+        BOOST_REQUIRE_EQUAL(getValue(U,"acc",Index),U->getID()+Index);
+        BOOST_REQUIRE_EQUAL(getValue(U,"down",Index),U->getID() < UnitsCount ? U->getID()+1+Index : 0.0);
+      }
+      CheckedCount++;
+    }
+  }
+
+  BOOST_REQUIRE_EQUAL(CheckedCount,UnitsCount);
+}
+
+#endif
@@ -0,0 +1,259 @@
+/*
+
+  This file is part of OpenFLUID software
+  Copyright(c) 2007, INRA - Montpellier SupAgro
+
+
+ == GNU General Public License Usage ==
+
+  OpenFLUID is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OpenFLUID is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OpenFLUID. If not, see <http://www.gnu.org/licenses/>.
+
+
+ == Other Usage ==
+
+  Other Usage means a use of OpenFLUID that is inconsistent with the GPL
+  license, and requires a written agreement between You and INRA.
+  Licensees for Other Usage of OpenFLUID may use this file in accordance
+  with the terms contained in the written agreement between You and INRA.
+  
+*/
+
+/**
+  @file CounterBasedRandom.hpp
+
+  @author Jean-Christophe FABRE <jean-christophe.fabre@supagro.inra.fr>
+*/
+
+
+#ifndef __OPENFLUID_SCIENTIFIC_COUNTERBASEDRANDOM_HPP__
+#define __OPENFLUID_SCIENTIFIC_COUNTERBASEDRANDOM_HPP__
+
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+
+namespace openfluid { namespace scientific {
+
+
+/**
+  Philox4x32-10 counter-based pseudo-random bijection.
+  The output block only depends on the given counter and key, so that any value of a random stream
+  can be computed independently of the others, in any order and from any thread.
+
+  @see J.K. Salmon, M.A. Moraes, R.O. Dror, D.E. Shaw, "Parallel random numbers: as easy as 1, 2, 3", SC'11
+*/
+class Philox4x32
+{
+  public:
+
+    typedef std::array<std::uint32_t,4> Counter_t;
+
+    typedef std::array<std::uint32_t,2> Key_t;
+
+    static const unsigned int RoundsCount = 10;
+
+
+  private:
+
+    static inline void mulHiLo(std::uint32_t A, std::uint32_t B, std::uint32_t& Hi, std::uint32_t& Lo)
+    {
+      const std::uint64_t Product = std::uint64_t(A)*std::uint64_t(B);
+      Hi = std::uint32_t(Product >> 32);
+      Lo = std::uint32_t(Product);
+    }
+
+
+  public:
+
+    /**
+      Computes the random block corresponding to the given counter and key
+      @param[in] Ctr the counter
+      @param[in] Key the key
+      @return the random block as four 32 bits words
+    */
+    static inline Counter_t generate(Counter_t Ctr, Key_t Key)
+    {
+      for (unsigned int i=0; i<RoundsCount; i++)
+      {
+        if (i > 0)
+        {
+          Key[0] += 0x9E3779B9;
+          Key[1] += 0xBB67AE85;
+        }
+
+        std::uint32_t Hi0, Lo0, Hi1, Lo1;
+        mulHiLo(0xD2511F53,Ctr[0],Hi0,Lo0);
+        mulHiLo(0xCD9E8D57,Ctr[2],Hi1,Lo1);
+
+        Ctr = {{ Hi1^Ctr[1]^Key[0], Lo1, Hi0^Ctr[3]^Key[1], Lo0 }};
+      }
+
+      return Ctr;
+    }
+
+};
+
+
+// =====================================================================
+// =====================================================================
+
+
+/**
+  Reproducible random numbers generator based on the Philox4x32 counter-based bijection.
+  Each value is addressed by a stream identifier, a sub-stream identifier and an index in the stream
+  (e.g. a spatial unit ID, a variable and a time index) so that the produced values are the same
+  whatever the computation order or the number of threads used.
+
+  example of use:
+  @code
+  openfluid::scientific::CounterBasedRandom RNG(12345);
+
+  double U = RNG.uniform(UnitID,TimeIndex,0.0,10.0);
+  double N = RNG.normal(UnitID,TimeIndex,5.0,1.2);
+  double LN = RNG.logNormal(UnitID,TimeIndex,0.0,0.5);
+  @endcode
+*/
+class CounterBasedRandom
+{
+  private:
+
+    Philox4x32::Key_t m_Key;
+
+    std::uint32_t m_SubStream;
+
+
+    static constexpr double m_TwoPi = 6.283185307179586476925286766559;
+
+    /**
+      Builds a double in [0,1) from two 32 bits words, using 53 bits of randomness
+    */
+    static inline double toUniform53(std::uint32_t A, std::uint32_t B)
+    {
+      return ((A >> 5)*67108864.0 + (B >> 6)) * (1.0/9007199254740992.0);
+    }
+
+
+  public:
+
+    CounterBasedRandom(std::uint64_t Seed = 0, std::uint32_t SubStream = 0) :
+      m_Key({{ std::uint32_t(Seed), std::uint32_t(Seed >> 32) }}), m_SubStream(SubStream)
+    { }
+
+    /**
+      Sets the seed used as key of the generator
+    */
+    void setSeed(std::uint64_t Seed)
+    {
+      m_Key = {{ std::uint32_t(Seed), std::uint32_t(Seed >> 32) }};
+    }
+
+    /**
+      Sets the sub-stream identifier, used to separate independent uses of the same seed
+    */
+    void setSubStream(std::uint32_t SubStream)
+    {
+      m_SubStream = SubStream;
+    }
+
+    /**
+      Returns a stable sub-stream identifier computed from a string (FNV-1a hash),
+      identical on every platform and for every run
+      @param[in] Str the string to hash, such as a variable name
+    */
+    static std::uint32_t computeSubStream(const std::string& Str)
+    {
+      std::uint32_t Hash = 2166136261u;
+
+      for (unsigned char C : Str)
+      {
+        Hash ^= C;
+        Hash *= 16777619u;
+      }
+
+      return Hash;
+    }
+
+    /**
+      Returns the raw random block for the given stream and index
+      @param[in] Stream the stream identifier
+      @param[in] Index the index in the stream
+    */
+    inline Philox4x32::Counter_t block(std::uint32_t Stream, std::uint64_t Index) const
+    {
+      return Philox4x32::generate({{ std::uint32_t(Index), std::uint32_t(Index >> 32), Stream, m_SubStream }},m_Key);
+    }
+
+    /**
+      Returns a uniformly distributed value in [0,1)
+      @param[in] Stream the stream identifier
+      @param[in] Index the index in the stream
+    */
+    inline double uniform(std::uint32_t Stream, std::uint64_t Index) const
+    {
+      const Philox4x32::Counter_t R = block(Stream,Index);
+      return toUniform53(R[0],R[1]);
+    }
+
+    /**
+      Returns a uniformly distributed value in [Min,Max)
+      @param[in] Stream the stream identifier
+      @param[in] Index the index in the stream
+      @param[in] Min the lower bound
+      @param[in] Max the upper bound
+    */
+    inline double uniform(std::uint32_t Stream, std::uint64_t Index, double Min, double Max) const
+    {
+      return Min + (Max-Min)*uniform(Stream,Index);
+    }
+
+    /**
+      Returns a normally distributed value, using the Box-Muller transform on a single random block
+      @param[in] Stream the stream identifier
+      @param[in] Index the index in the stream
+      @param[in] Mean the mean of the distribution
+      @param[in] StdDev the standard deviation of the distribution
+    */
+    inline double normal(std::uint32_t Stream, std::uint64_t Index, double Mean = 0.0, double StdDev = 1.0) const
+    {
+      const Philox4x32::Counter_t R = block(Stream,Index);
+
+      // U1 in (0,1] to avoid log(0)
+      const double U1 = 1.0 - toUniform53(R[0],R[1]);
+      const double U2 = toUniform53(R[2],R[3]);
+
+      return Mean + StdDev * std::sqrt(-2.0*std::log(U1)) * std::cos(m_TwoPi*U2);
+    }
+
+    /**
+      Returns a log-normally distributed value
+      @param[in] Stream the stream identifier
+      @param[in] Index the index in the stream
+      @param[in] M the mean of the underlying normal distribution
+      @param[in] S the standard deviation of the underlying normal distribution
+    */
+    inline double logNormal(std::uint32_t Stream, std::uint64_t Index, double M = 0.0, double S = 1.0) const
+    {
+      return std::exp(normal(Stream,Index,M,S));
+    }
+
+};
+
+
+} }  // namespaces
+
+
+#endif /* __OPENFLUID_SCIENTIFIC_COUNTERBASEDRANDOM_HPP__ */
@@ -0,0 +1,157 @@
+/*
+
+  This file is part of OpenFLUID software
+  Copyright(c) 2007, INRA - Montpellier SupAgro
+
+
+ == GNU General Public License Usage ==
+
+  OpenFLUID is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OpenFLUID is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OpenFLUID. If not, see <http://www.gnu.org/licenses/>.
+
+
+ == Other Usage ==
+
+  Other Usage means a use of OpenFLUID that is inconsistent with the GPL
+  license, and requires a written agreement between You and INRA.
+  Licensees for Other Usage of OpenFLUID may use this file in accordance
+  with the terms contained in the written agreement between You and INRA.
+  
+*/
+
+
+
+/**
+  @file CounterBasedRandom_TEST.cpp
+
+  @author Jean-Christophe FABRE <jean-christophe.fabre@supagro.inra.fr>
+ */
+
+
+
+#define BOOST_TEST_MAIN
+#define BOOST_AUTO_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE unittest_counterbasedrandom
+#include <boost/test/unit_test.hpp>
+#include <boost/test/auto_unit_test.hpp>
+
+#include <cmath>
+#include <set>
+
+#include <openfluid/scientific/CounterBasedRandom.hpp>
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_philox)
+{
+  // known answers from the Random123 reference implementation
+
+  openfluid::scientific::Philox4x32::Counter_t R;
+
+  R = openfluid::scientific::Philox4x32::generate({{0,0,0,0}},{{0,0}});
+  BOOST_REQUIRE_EQUAL(R[0],0x6627e8d5);
+  BOOST_REQUIRE_EQUAL(R[1],0xe169c58d);
+  BOOST_REQUIRE_EQUAL(R[2],0xbc57ac4c);
+  BOOST_REQUIRE_EQUAL(R[3],0x9b00dbd8);
+
+  R = openfluid::scientific::Philox4x32::generate({{0xffffffff,0xffffffff,0xffffffff,0xffffffff}},
+                                                  {{0xffffffff,0xffffffff}});
+  BOOST_REQUIRE_EQUAL(R[0],0x408f276d);
+  BOOST_REQUIRE_EQUAL(R[1],0x41c83b0e);
+  BOOST_REQUIRE_EQUAL(R[2],0xa20bc7c6);
+  BOOST_REQUIRE_EQUAL(R[3],0x6d5451fd);
+
+  R = openfluid::scientific::Philox4x32::generate({{0x243f6a88,0x85a308d3,0x13198a2e,0x03707344}},
+                                                  {{0xa4093822,0x299f31d0}});
+  BOOST_REQUIRE_EQUAL(R[0],0xd16cfe09);
+  BOOST_REQUIRE_EQUAL(R[1],0x94fdcceb);
+  BOOST_REQUIRE_EQUAL(R[2],0x5001e420);
+  BOOST_REQUIRE_EQUAL(R[3],0x24126ea1);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_reproducibility)
+{
+  openfluid::scientific::CounterBasedRandom RNG1(123456789);
+  openfluid::scientific::CounterBasedRandom RNG2(123456789);
+  openfluid::scientific::CounterBasedRandom RNG3(987654321);
+
+  // same values whatever the order of computation
+  double Forward[100];
+  for (unsigned int i=0; i<100;i++)
+    Forward[i] = RNG1.uniform(17,i);
+
+  for (int i=99; i>=0;i--)
+    BOOST_REQUIRE_EQUAL(RNG2.uniform(17,i),Forward[i]);
+
+  BOOST_REQUIRE(RNG1.uniform(17,0) != RNG1.uniform(18,0));
+  BOOST_REQUIRE(RNG1.uniform(17,0) != RNG3.uniform(17,0));
+
+  RNG2.setSubStream(openfluid::scientific::CounterBasedRandom::computeSubStream("tests.var"));
+  BOOST_REQUIRE(RNG1.uniform(17,0) != RNG2.uniform(17,0));
+
+  BOOST_REQUIRE_EQUAL(openfluid::scientific::CounterBasedRandom::computeSubStream("tests.var"),
+                      openfluid::scientific::CounterBasedRandom::computeSubStream("tests.var"));
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_distributions)
+{
+  openfluid::scientific::CounterBasedRandom RNG(42);
+  const unsigned int Count = 100000;
+
+  double Sum = 0.0;
+  double SqSum = 0.0;
+  std::set<double> Values;
+
+  for (unsigned int i=0; i<Count;i++)
+  {
+    double U = RNG.uniform(1,i,-2.0,3.0);
+    BOOST_REQUIRE(U >= -2.0 && U < 3.0);
+    Values.insert(U);
+  }
+  BOOST_REQUIRE_EQUAL(Values.size(),Count);
+
+  for (unsigned int i=0; i<Count;i++)
+  {
+    double N = RNG.normal(2,i,10.0,2.0);
+    Sum += N;
+    SqSum += N*N;
+  }
+  double Mean = Sum/Count;
+  double StdDev = std::sqrt(SqSum/Count - Mean*Mean);
+  BOOST_REQUIRE_CLOSE(Mean,10.0,0.5);
+  BOOST_REQUIRE_CLOSE(StdDev,2.0,2.0);
+
+  Sum = 0.0;
+  for (unsigned int i=0; i<Count;i++)
+  {
+    double LN = RNG.logNormal(3,i,0.0,0.5);
+    BOOST_REQUIRE_GT(LN,0.0);
+    Sum += std::log(LN);
+  }
+  BOOST_REQUIRE_SMALL(Sum/Count,0.01);
+}
+
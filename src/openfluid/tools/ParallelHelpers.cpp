@@ -0,0 +1,119 @@
+/*
+
+  This file is part of OpenFLUID software
+  Copyright(c) 2007, INRA - Montpellier SupAgro
+
+
+ == GNU General Public License Usage ==
+
+  OpenFLUID is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OpenFLUID is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OpenFLUID. If not, see <http://www.gnu.org/licenses/>.
+
+
+ == Other Usage ==
+
+  Other Usage means a use of OpenFLUID that is inconsistent with the GPL
+  license, and requires a written agreement between You and INRA.
+  Licensees for Other Usage of OpenFLUID may use this file in accordance
+  with the terms contained in the written agreement between You and INRA.
+  
+*/
+
+
+/**
+  @file ParallelHelpers.cpp
+
+  @author Jean-Christophe FABRE <jean-christophe.fabre@supagro.inra.fr>
+ */
+
+
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <exception>
+#include <system_error>
+
+#include <openfluid/base/FrameworkException.hpp>
+#include <openfluid/tools/ParallelHelpers.hpp>
+
+
+namespace openfluid { namespace tools {
+
+
+void runParallelRange(std::size_t Begin, std::size_t End,
+                      const std::function<void(std::size_t,std::size_t)>& Func,
+                      unsigned int MaxThreads, std::size_t MinChunkSize)
+{
+  if (End <= Begin)
+    return;
+
+  if (!MaxThreads)
+    MaxThreads = std::max(std::thread::hardware_concurrency(),1u);
+
+  const std::size_t Count = End-Begin;
+  const std::size_t ThreadsCount = std::min<std::size_t>(MaxThreads,Count/std::max<std::size_t>(MinChunkSize,1));
+
+  if (ThreadsCount <= 1)
+  {
+    Func(Begin,End);
+    return;
+  }
+
+  const std::size_t ChunkSize = (Count+ThreadsCount-1)/ThreadsCount;
+  std::vector<std::thread> Threads;
+  std::vector<std::exception_ptr> Errors(ThreadsCount);
+
+  try
+  {
+    for (std::size_t t = 0; t < ThreadsCount; t++)
+    {
+      const std::size_t ChunkBegin = Begin+t*ChunkSize;
+      const std::size_t ChunkEnd = std::min(ChunkBegin+ChunkSize,End);
+
+      if (ChunkBegin >= ChunkEnd)
+        break;
+
+      Threads.push_back(std::thread([&Func,&Errors,t,ChunkBegin,ChunkEnd]()
+      {
+        try
+        {
+          Func(ChunkBegin,ChunkEnd);
+        }
+        catch (...)
+        {
+          Errors[t] = std::current_exception();
+        }
+      }));
+    }
+  }
+  catch (std::system_error& E)
+  {
+    for (auto& Thread : Threads)
+      Thread.join();
+
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                              "Error in threaded loop (" + std::string(E.what()) +")");
+  }
+
+  for (auto& Thread : Threads)
+    Thread.join();
+
+  for (auto& Error : Errors)
+  {
+    if (Error)
+      std::rethrow_exception(Error);
+  }
+}
+
+
+} } // namespaces
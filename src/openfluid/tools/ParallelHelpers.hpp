@@ -0,0 +1,72 @@
+/*
+
+  This file is part of OpenFLUID software
+  Copyright(c) 2007, INRA - Montpellier SupAgro
+
+
+ == GNU General Public License Usage ==
+
+  OpenFLUID is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OpenFLUID is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OpenFLUID. If not, see <http://www.gnu.org/licenses/>.
+
+
+ == Other Usage ==
+
+  Other Usage means a use of OpenFLUID that is inconsistent with the GPL
+  license, and requires a written agreement between You and INRA.
+  Licensees for Other Usage of OpenFLUID may use this file in accordance
+  with the terms contained in the written agreement between You and INRA.
+  
+*/
+
+
+/**
+  @file ParallelHelpers.hpp
+
+  @author Jean-Christophe FABRE <jean-christophe.fabre@supagro.inra.fr>
+ */
+
+
+#ifndef __OPENFLUID_TOOLS_PARALLELHELPERS_HPP__
+#define __OPENFLUID_TOOLS_PARALLELHELPERS_HPP__
+
+
+#include <cstddef>
+#include <functional>
+
+#include <openfluid/dllexport.hpp>
+
+
+namespace openfluid { namespace tools {
+
+
+/**
+  Runs a function over the [Begin,End) range of indexes, split in contiguous chunks processed by concurrent threads.
+  Exceptions thrown in threads are rethrown in the calling thread.
+  @param[in] Begin the first index of the range
+  @param[in] End the index following the last index of the range
+  @param[in] Func the function to run on each chunk, called with the begin and end indexes of the chunk
+  @param[in] MaxThreads the maximum number of threads to use,
+  0 uses the number of concurrent threads supported by the running host
+  @param[in] MinChunkSize the minimal number of indexes processed by a thread, 1 by default
+  @throw openfluid::base::FrameworkException if threads cannot be created
+*/
+void OPENFLUID_API runParallelRange(std::size_t Begin, std::size_t End,
+                                    const std::function<void(std::size_t,std::size_t)>& Func,
+                                    unsigned int MaxThreads = 0, std::size_t MinChunkSize = 1);
+
+
+} } // namespaces
+
+
+#endif /* __OPENFLUID_TOOLS_PARALLELHELPERS_HPP__ */
@@ -0,0 +1,109 @@
+/*
+
+  This file is part of OpenFLUID software
+  Copyright(c) 2007, INRA - Montpellier SupAgro
+
+
+ == GNU General Public License Usage ==
+
+  OpenFLUID is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OpenFLUID is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OpenFLUID. If not, see <http://www.gnu.org/licenses/>.
+
+
+ == Other Usage ==
+
+  Other Usage means a use of OpenFLUID that is inconsistent with the GPL
+  license, and requires a written agreement between You and INRA.
+  Licensees for Other Usage of OpenFLUID may use this file in accordance
+  with the terms contained in the written agreement between You and INRA.
+  
+*/
+
+
+
+
+/**
+  @file ParallelHelpers_TEST.cpp
+
+  @author Jean-Christophe FABRE <jean-christophe.fabre@supagro.inra.fr>
+ */
+
+
+#define BOOST_TEST_MAIN
+#define BOOST_AUTO_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE unittest_parallelhelpers
+#include <boost/test/unit_test.hpp>
+#include <boost/test/auto_unit_test.hpp>
+
+#include <vector>
+#include <mutex>
+#include <stdexcept>
+
+#include <openfluid/tools/ParallelHelpers.hpp>
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_range)
+{
+  for (unsigned int Threads : {0,1,3,8})
+  {
+    for (std::size_t MinChunk : {1,10,1000})
+    {
+      std::vector<int> Visits(1000,0);
+      std::vector<std::pair<std::size_t,std::size_t>> Chunks;
+      std::mutex ChunksMutex;
+
+      openfluid::tools::runParallelRange(10,1000,[&](std::size_t Begin, std::size_t End)
+      {
+        for (std::size_t i = Begin; i < End; i++)
+          Visits[i]++;
+
+        std::lock_guard<std::mutex> Lock(ChunksMutex);
+        Chunks.push_back(std::make_pair(Begin,End));
+      },Threads,MinChunk);
+
+      for (std::size_t i = 0; i < Visits.size(); i++)
+        BOOST_REQUIRE_EQUAL(Visits[i],(i < 10) ? 0 : 1);
+
+      BOOST_REQUIRE(!Chunks.empty());
+      if (Threads)
+        BOOST_REQUIRE_LE(Chunks.size(),Threads);
+      for (const auto& Chunk : Chunks)
+        BOOST_REQUIRE(Chunks.size() == 1 || Chunk.second-Chunk.first >= MinChunk);
+    }
+  }
+
+  // empty range
+  bool Called = false;
+  openfluid::tools::runParallelRange(5,5,[&Called](std::size_t,std::size_t){ Called = true; },4);
+  BOOST_REQUIRE(!Called);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_exceptions)
+{
+  BOOST_REQUIRE_THROW(openfluid::tools::runParallelRange(0,100,[](std::size_t Begin, std::size_t)
+                                                         {
+                                                           if (Begin > 0)
+                                                             throw std::runtime_error("error in chunk");
+                                                         },4),
+                      std::runtime_error);
+}
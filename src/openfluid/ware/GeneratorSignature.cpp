@@ -95,13 +95,33 @@ void GeneratorSignature::setFixedInfo()
 void GeneratorSignature::setRandomInfo()
 {
   Name = "Random values";
-  Description = "Generates a random value in a range";
+  Description = "Generates a random value following a uniform (in a range), normal or log-normal distribution";
 
-  HandledData.RequiredParams.push_back(
-      openfluid::ware::SignatureDataItem("min","Lower bound of the random range for the value to produce","-"));
+  HandledData.UsedParams.push_back(
+      openfluid::ware::SignatureDataItem("distribution-law",
+                                         "Distribution of the values to produce: uniform (default), normal or lognormal",
+                                         "-"));
 
-  HandledData.RequiredParams.push_back(
-      openfluid::ware::SignatureDataItem("max","Upper bound of the random range for the value to produce","-"));
+  HandledData.UsedParams.push_back(
+      openfluid::ware::SignatureDataItem("min","Lower bound of the random range for the value to produce"
+                                               " (required for uniform distribution)","-"));
+
+  HandledData.UsedParams.push_back(
+      openfluid::ware::SignatureDataItem("max","Upper bound of the random range for the value to produce"
+                                               " (required for uniform distribution)","-"));
+
+  HandledData.UsedParams.push_back(
+      openfluid::ware::SignatureDataItem("mean","Mean of the normal distribution, or of the underlying normal"
+                                                " distribution for log-normal (required for normal and lognormal)","-"));
+
+  HandledData.UsedParams.push_back(
+      openfluid::ware::SignatureDataItem("stddev","Standard deviation of the normal distribution, or of the underlying"
+                                                  " normal distribution for log-normal"
+                                                  " (required for normal and lognormal)","-"));
+
+  HandledData.UsedParams.push_back(
+      openfluid::ware::SignatureDataItem("seed","Seed for reproducible values, independent of units processing order"
+                                                " and threads count","-"));
 
   HandledData.UsedParams.push_back(
       openfluid::ware::SignatureDataItem("deltat","DeltaT to use instead of the default DeltaT","s"));
@@ -62,10 +62,11 @@
 
 
 #define _OPENFLUID_UNITS_ORDERED_LOOP_WITHID(unitsclass,unitptr,id) \
-    openfluid::core::UnitsList_t* _UNITSLISTID(id) = mp_SpatialData->spatialUnits(unitsclass)->list(); \
+    const openfluid::core::UnitsPtrVector_t* _UNITSLISTID(id) = mp_SpatialData->spatialUnits(unitsclass)->units(); \
     if (_UNITSLISTID(id) != nullptr && !(_UNITSLISTID(id)->empty())) \
-      for (openfluid::core::UnitsList_t::iterator _UNITSLISTITERID(id) = _UNITSLISTID(id)->begin(); \
-           unitptr = &(*_UNITSLISTITERID(id)),_UNITSLISTITERID(id) != _UNITSLISTID(id)->end(); \
+      for (std::size_t _UNITSLISTITERID(id) = 0; \
+           _UNITSLISTITERID(id) < _UNITSLISTID(id)->size() && \
+           (unitptr = (*_UNITSLISTID(id))[_UNITSLISTITERID(id)],true); \
            ++_UNITSLISTITERID(id))
 
 /**
@@ -114,7 +115,7 @@
 
 #define _OPENFLUID_EVENT_COLLECTION_LOOP_WITHID(id,evlist,evobj) \
     for(openfluid::core::EventsList_t::iterator _EVENTSLISTITERID(id) = (evlist)->begin(); \
-        evobj = &(*_EVENTSLISTITERID(id)), _EVENTSLISTITERID(id) != (evlist)->end(); \
+        _EVENTSLISTITERID(id) != (evlist)->end() && (evobj = &(*_EVENTSLISTITERID(id)),true); \
        ++_EVENTSLISTITERID(id))
 
 /**
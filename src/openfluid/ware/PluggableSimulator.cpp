@@ -42,6 +42,7 @@
 #include <openfluid/config.hpp>
 #include <openfluid/base/FrameworkException.hpp>
 #include <openfluid/tools/DataHelpers.hpp>
+#include <openfluid/tools/ParallelHelpers.hpp>
 #include <openfluid/ware/PluggableSimulator.hpp>
 
 
@@ -53,6 +54,14 @@ namespace openfluid { namespace ware {
 
 
 
+// minimal number of units processed by a thread in parallel ranges
+static const std::size_t ParallelRangeMinChunk = 256;
+
+
+// =====================================================================
+// =====================================================================
+
+
 PluggableSimulator::PluggableSimulator() : SimulationContributorWare(WareType::SIMULATOR),
     m_MaxThreads(1)
 {
@@ -392,4 +401,95 @@ void PluggableSimulator::OPENFLUID_SetSimulatorMaxThreads(const int& MaxNumThrea
 }
 
 
+// =====================================================================
+// =====================================================================
+
+
+void PluggableSimulator::OPENFLUID_AccumulateUpstream(const openfluid::core::UnitsClass_t& UnitsClass,
+                                                      const openfluid::core::VariableName_t& InVarName,
+                                                      const openfluid::core::VariableName_t& OutVarName,
+                                                      AccumulationCombiner_t Combiner)
+{
+  REQUIRE_SIMULATION_STAGE(openfluid::base::SimulationStatus::RUNSTEP,
+                           "Variables values cannot be added outside RUNSTEP stage")
+
+  const openfluid::core::UnitsCollection* Units = mp_SpatialData->spatialUnits(UnitsClass);
+
+  if (Units == nullptr || !Units->size())
+    return;
+
+  const std::size_t UnitsCount = Units->size();
+  const openfluid::core::UnitsAdjacency* Upstream =
+      OPENFLUID_GetUnitsAdjacency(UnitsClass,openfluid::core::UnitsLinkType::FROM,UnitsClass);
+
+  std::vector<std::size_t> Order;
+  std::vector<std::size_t> LevelsOffsets;
+
+  if (Upstream != nullptr)
+  {
+    if (!Upstream->computeLevels(Order,LevelsOffsets))
+      throw openfluid::base::FrameworkException(computeFrameworkContext(OPENFLUID_CODE_LOCATION),
+                                                "Connections between units of class " + UnitsClass +
+                                                " contain a cycle");
+  }
+
+
+  // gathering of input values
+
+  // ghost units are indexed after the units of the class, their accumulated values are already computed
+
+  const openfluid::core::UnitsPtrVector_t* Ghosts = Units->ghosts();
+  std::vector<double> Values(UnitsCount+Ghosts->size());
+
+  openfluid::tools::runParallelRange(0,UnitsCount,[&](std::size_t ChunkBegin, std::size_t ChunkEnd)
+  {
+    for (std::size_t i = ChunkBegin; i < ChunkEnd; i++)
+      OPENFLUID_GetVariable(Units->unitAt(i),InVarName,Values[i]);
+  },m_MaxThreads,ParallelRangeMinChunk);
+
+  for (std::size_t i = 0; i < Ghosts->size(); i++)
+  {
+    if (Ghosts->at(i)->variables()->isVariableExist(OutVarName,OPENFLUID_GetCurrentTimeIndex()))
+      OPENFLUID_GetVariable(Ghosts->at(i),OutVarName,Values[UnitsCount+i]);
+  }
+
+
+  // accumulation level by level, values of upstream units being final when a level is processed
+  // (units of the first level have no upstream unit of the class, but may have upstream ghost units)
+
+  if (Upstream != nullptr)
+  {
+    const std::vector<std::size_t>& Offsets = Upstream->offsets();
+    const std::vector<std::size_t>& Indices = Upstream->neighboursIndices();
+
+    for (std::size_t Level = 0; Level+1 < LevelsOffsets.size(); Level++)
+    {
+      openfluid::tools::runParallelRange(LevelsOffsets[Level],LevelsOffsets[Level+1],
+                                         [&](std::size_t ChunkBegin, std::size_t ChunkEnd)
+      {
+        for (std::size_t k = ChunkBegin; k < ChunkEnd; k++)
+        {
+          const std::size_t i = Order[k];
+          double Accumulated = Values[i];
+
+          for (std::size_t j = Offsets[i]; j < Offsets[i+1]; j++)
+            Accumulated = Combiner(Accumulated,Values[Indices[j]]);
+
+          Values[i] = Accumulated;
+        }
+      },m_MaxThreads,ParallelRangeMinChunk);
+    }
+  }
+
+
+  // storing of output values
+
+  openfluid::tools::runParallelRange(0,UnitsCount,[&](std::size_t ChunkBegin, std::size_t ChunkEnd)
+  {
+    for (std::size_t i = ChunkBegin; i < ChunkEnd; i++)
+      OPENFLUID_AppendVariable(Units->unitAt(i),OutVarName,Values[i]);
+  },m_MaxThreads,ParallelRangeMinChunk);
+}
+
+
 } } // namespaces
@@ -42,6 +42,7 @@
 
 
 #include <string>
+#include <functional>
 
 #include <openfluid/dllexport.hpp>
 #include <openfluid/ware/SimulatorSignature.hpp>
@@ -283,6 +284,30 @@ class OPENFLUID_API PluggableSimulator : public SimulationContributorWare
     */
     void OPENFLUID_SetSimulatorMaxThreads(const int& MaxNumThreads);
 
+    /**
+      Function combining an accumulated value with the value of an upstream unit,
+      called as Combiner(Accumulated,UpstreamValue)
+    */
+    typedef std::function<double(double,double)> AccumulationCombiner_t;
+
+    /**
+      Accumulates a variable along the from-to connections between units of a class, at the current time index.
+      For each unit, the output value is the input value of the unit combined with the output values
+      of all its upstream units of the same class (the sum by default).
+      Units are processed level by level on contiguous arrays, units of a same level being processed
+      in parallel using up to OPENFLUID_GetSimulatorMaxThreads() threads.
+      In a partitioned run, the output values of upstream ghost units are received from the partitions owning them.
+      @param[in] UnitsClass the units class
+      @param[in] InVarName the name of the input variable, which must have a value at the current time index
+      @param[in] OutVarName the name of the output variable, which value is appended at the current time index
+      @param[in] Combiner the combination function, which must be thread safe
+      @throw openfluid::base::FrameworkException if the connections between units of the class contain a cycle
+    */
+    void OPENFLUID_AccumulateUpstream(const openfluid::core::UnitsClass_t& UnitsClass,
+                                      const openfluid::core::VariableName_t& InVarName,
+                                      const openfluid::core::VariableName_t& OutVarName,
+                                      AccumulationCombiner_t Combiner = std::plus<double>());
+
     /**
       Returns a scheduling request to a single scheduling at the end
       Return the corresponding scheduling request
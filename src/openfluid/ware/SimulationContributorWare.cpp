@@ -646,6 +646,7 @@ bool SimulationContributorWare::OPENFLUID_AddFromToConnection(openfluid::core::S
 
   if (FromUnit != nullptr || ToUnit != nullptr)
   {
+    mp_SpatialData->invalidateAdjacency();
     return (FromUnit->addToUnit(ToUnit) && ToUnit->addFromUnit(FromUnit));
   }
   else
@@ -740,6 +741,7 @@ bool SimulationContributorWare::OPENFLUID_AddChildParentConnection(openfluid::co
 
   if (ChildUnit != nullptr || ParentUnit != nullptr)
   {
+    mp_SpatialData->invalidateAdjacency();
     return (ChildUnit->addParentUnit(ParentUnit) && ParentUnit->addChildUnit(ChildUnit));
   }
   else
@@ -966,6 +968,24 @@ void SimulationContributorWare::OPENFLUID_BuildUnitsMatrix(const openfluid::core
 }
 
 
+// =====================================================================
+// =====================================================================
+
+
+openfluid::core::UnitsGrid* SimulationContributorWare::OPENFLUID_BuildUnitsGrid(
+                                                                  const openfluid::core::UnitsClass_t& UnitsClass,
+                                                                  const unsigned int& ColsNbr,
+                                                                  const unsigned int& RowsNbr)
+{
+  REQUIRE_SIMULATION_STAGE_GE(openfluid::base::SimulationStatus::PREPAREDATA,
+                              "Spatial graph can be modified during PREPAREDATA and CHECKCONSISTENCY stages only")
+  REQUIRE_SIMULATION_STAGE_LE(openfluid::base::SimulationStatus::CHECKCONSISTENCY,
+                              "Spatial graph can be modified during PREPAREDATA and CHECKCONSISTENCY stages only")
+
+  return mp_SpatialData->addUnitsGrid(UnitsClass,ColsNbr,RowsNbr);
+}
+
+
 } } // namespaces
 
 
@@ -414,6 +414,19 @@ class OPENFLUID_API SimulationContributorWare : public SimulationInspectorWare
                                     const unsigned int& ColsNbr,
                                     const unsigned int& RowsNbr);
 
+    /**
+      Builds a ColsNbr x RowsNbr regular grid of units.
+      Unlike OPENFLUID_BuildUnitsMatrix(), cells are not created as spatial units with explicit connections:
+      neighbourhoods are implicit and data are stored in dense layers of the grid.
+      @param[in] UnitsClass the name of units class
+      @param[in] ColsNbr the number of cells on the X axis
+      @param[in] RowsNbr the number of cells on the Y axis
+      @return the built grid
+    */
+    openfluid::core::UnitsGrid* OPENFLUID_BuildUnitsGrid(const openfluid::core::UnitsClass_t& UnitsClass,
+                                                         const unsigned int& ColsNbr,
+                                                         const unsigned int& RowsNbr);
+
     SimulationContributorWare(WareType WType) : SimulationInspectorWare(WType)
     {};
 
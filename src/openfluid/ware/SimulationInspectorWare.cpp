@@ -735,6 +735,57 @@ openfluid::core::EventsCollection SimulationInspectorWare::OPENFLUID_GetEvents(
 // =====================================================================
 
 
+openfluid::core::EventsRange SimulationInspectorWare::OPENFLUID_GetEventsRange(
+                                                      const openfluid::core::SpatialUnit *UnitPtr,
+                                                      const openfluid::core::DateTime& BeginDate,
+                                                      const openfluid::core::DateTime& EndDate) const
+{
+  REQUIRE_SIMULATION_STAGE_GE(openfluid::base::SimulationStatus::PREPAREDATA,
+                              "Events cannot be accessed during INITPARAMS stage")
+
+  if (UnitPtr == nullptr)
+    throw openfluid::base::FrameworkException(computeFrameworkContext(OPENFLUID_CODE_LOCATION),"Unit is NULL");
+
+  return UnitPtr->events()->eventsBetween(BeginDate,EndDate);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void SimulationInspectorWare::OPENFLUID_GetEventsRanges(const openfluid::core::UnitsClass_t& ClassName,
+                                                        const openfluid::core::DateTime& BeginDate,
+                                                        const openfluid::core::DateTime& EndDate,
+                                                        openfluid::core::UnitsEventsRanges_t& UnitsEvents) const
+{
+  REQUIRE_SIMULATION_STAGE_GE(openfluid::base::SimulationStatus::PREPAREDATA,
+                              "Events cannot be accessed during INITPARAMS stage")
+
+  UnitsEvents.clear();
+
+  openfluid::core::UnitsCollection* Units = mp_SpatialData->spatialUnits(ClassName);
+
+  if (Units == nullptr)
+    return;
+
+  for (openfluid::core::SpatialUnit* U : *(Units->units()))
+  {
+    if (U->events()->getCount())
+    {
+      openfluid::core::EventsRange Range = U->events()->eventsBetween(BeginDate,EndDate);
+
+      if (!Range.empty())
+        UnitsEvents.push_back(std::make_pair(U,Range));
+    }
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 bool SimulationInspectorWare::OPENFLUID_IsUnitExist(const openfluid::core::UnitsClass_t& ClassName,
                                                     openfluid::core::UnitID_t ID) const
 {
@@ -759,10 +810,12 @@ bool SimulationInspectorWare::OPENFLUID_IsUnitsClassExist(const openfluid::core:
 bool SimulationInspectorWare::OPENFLUID_GetUnitsCount(const openfluid::core::UnitsClass_t& ClassName,
                                                       unsigned int& UnitsCount) const
 {
+  const openfluid::core::UnitsCollection* Units = mp_SpatialData->spatialUnits(ClassName);
+
   UnitsCount = 0;
-  if (mp_SpatialData->isUnitsClassExist(ClassName))
+  if (Units != nullptr)
   {
-    UnitsCount = mp_SpatialData->spatialUnits(ClassName)->list()->size();
+    UnitsCount = Units->size();
     return true;
   }
   else
@@ -776,8 +829,10 @@ bool SimulationInspectorWare::OPENFLUID_GetUnitsCount(const openfluid::core::Uni
 
 unsigned int SimulationInspectorWare::OPENFLUID_GetUnitsCount(const openfluid::core::UnitsClass_t& ClassName) const
 {
-  if (mp_SpatialData->isUnitsClassExist(ClassName))
-    return mp_SpatialData->spatialUnits(ClassName)->list()->size();
+  const openfluid::core::UnitsCollection* Units = mp_SpatialData->spatialUnits(ClassName);
+
+  if (Units != nullptr)
+    return Units->size();
   else
     return 0;
 }
@@ -789,14 +844,7 @@ unsigned int SimulationInspectorWare::OPENFLUID_GetUnitsCount(const openfluid::c
 
 void SimulationInspectorWare::OPENFLUID_GetUnitsCount(unsigned int& UnitsCount) const
 {
-  UnitsCount = 0;
-  openfluid::core::UnitsListByClassMap_t::const_iterator UnitsIt;
-
-  for (UnitsIt = mp_SpatialData->allSpatialUnitsByClass()->begin();
-       UnitsIt != mp_SpatialData->allSpatialUnitsByClass()->end();++UnitsIt )
-  {
-    UnitsCount = UnitsCount + (*UnitsIt).second.list()->size();
-  }
+  UnitsCount = mp_SpatialData->getUnitsCount();
 }
 
 
@@ -806,16 +854,7 @@ void SimulationInspectorWare::OPENFLUID_GetUnitsCount(unsigned int& UnitsCount)
 
 unsigned int SimulationInspectorWare::OPENFLUID_GetUnitsCount() const
 {
-  unsigned int UnitsCount = 0;
-  openfluid::core::UnitsListByClassMap_t::const_iterator UnitsIt;
-
-  for (UnitsIt = mp_SpatialData->allSpatialUnitsByClass()->begin();
-       UnitsIt != mp_SpatialData->allSpatialUnitsByClass()->end();++UnitsIt )
-  {
-    UnitsCount += (*UnitsIt).second.list()->size();
-  }
-
-  return UnitsCount;
+  return mp_SpatialData->getUnitsCount();
 }
 
 
@@ -850,20 +889,25 @@ openfluid::core::SpatialUnit* SimulationInspectorWare::OPENFLUID_GetUnit(const o
 openfluid::core::UnitsPtrList_t SimulationInspectorWare::OPENFLUID_GetUnits(
     const openfluid::core::UnitsClass_t& ClassName)
 {
-  openfluid::core::UnitsPtrList_t UnitsPtrList;
+  openfluid::core::UnitsSpan Units = OPENFLUID_GetUnitsSpan(ClassName);
 
-  if (mp_SpatialData->isUnitsClassExist(ClassName))
-  {
-    openfluid::core::UnitsList_t* UnitsListPtr = mp_SpatialData->spatialUnits(ClassName)->list();
+  return openfluid::core::UnitsPtrList_t(Units.begin(),Units.end());
+}
 
-    if (UnitsListPtr)
-    {
-      for (openfluid::core::UnitsList_t::iterator it = UnitsListPtr->begin(); it != UnitsListPtr->end(); ++it)
-        UnitsPtrList.push_back(&(*it));
-    }
-  }
 
-  return UnitsPtrList;
+// =====================================================================
+// =====================================================================
+
+
+openfluid::core::UnitsSpan SimulationInspectorWare::OPENFLUID_GetUnitsSpan(
+    const openfluid::core::UnitsClass_t& ClassName) const
+{
+  const openfluid::core::UnitsCollection* Units = mp_SpatialData->spatialUnits(ClassName);
+
+  if (Units == nullptr)
+    return openfluid::core::UnitsSpan();
+
+  return Units->span();
 }
 
 
@@ -926,5 +970,29 @@ bool SimulationInspectorWare::OPENFLUID_IsUnitParentOf(openfluid::core::SpatialU
 }
 
 
+// =====================================================================
+// =====================================================================
+
+
+const openfluid::core::UnitsAdjacency* SimulationInspectorWare::OPENFLUID_GetUnitsAdjacency(
+                                                             const openfluid::core::UnitsClass_t& SourceClass,
+                                                             openfluid::core::UnitsLinkType LinkType,
+                                                             const openfluid::core::UnitsClass_t& TargetClass)
+{
+  return mp_SpatialData->adjacency(SourceClass,LinkType,TargetClass);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+openfluid::core::UnitsGrid* SimulationInspectorWare::OPENFLUID_GetUnitsGrid(
+                                                             const openfluid::core::UnitsClass_t& UnitsClass)
+{
+  return mp_SpatialData->unitsGrid(UnitsClass);
+}
+
+
 } } // openfluid::ware
 
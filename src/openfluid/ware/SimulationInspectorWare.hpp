@@ -454,6 +454,32 @@ class OPENFLUID_API SimulationInspectorWare : public SimulationDrivenWare
                                                           const openfluid::core::DateTime BeginDate,
                                                           const openfluid::core::DateTime EndDate) const;
 
+    /**
+      Returns a read-only view on discrete events happening on a unit during a time period.
+      Events are not copied, the returned range is valid until the events of the unit are modified.
+      @param[in] UnitPtr a Unit
+      @param[in] BeginDate the beginning of the time period
+      @param[in] EndDate the ending of the time period
+      @return the range of events corresponding to the request
+    */
+    openfluid::core::EventsRange OPENFLUID_GetEventsRange(const openfluid::core::SpatialUnit *UnitPtr,
+                                                          const openfluid::core::DateTime& BeginDate,
+                                                          const openfluid::core::DateTime& EndDate) const;
+
+    /**
+      Gets read-only views on discrete events happening during a time period on the units of a class, in one pass.
+      Only the units having at least one event during the period are given, following their process order.
+      Events are not copied, the ranges are valid until the events of the units are modified.
+      @param[in] ClassName the units class
+      @param[in] BeginDate the beginning of the time period
+      @param[in] EndDate the ending of the time period
+      @param[out] UnitsEvents the list of units associated to their range of events
+    */
+    void OPENFLUID_GetEventsRanges(const openfluid::core::UnitsClass_t& ClassName,
+                                   const openfluid::core::DateTime& BeginDate,
+                                   const openfluid::core::DateTime& EndDate,
+                                   openfluid::core::UnitsEventsRanges_t& UnitsEvents) const;
+
     /**
       Returns true if the queried unit class exists
       @param[in] ClassName the queried class name
@@ -524,6 +550,21 @@ class OPENFLUID_API SimulationInspectorWare : public SimulationDrivenWare
     */
     openfluid::core::UnitsPtrList_t OPENFLUID_GetUnits(const openfluid::core::UnitsClass_t& ClassName);
 
+    /**
+      Returns a read-only view on the units of the requested class, ordered by process order.
+      Contrary to OPENFLUID_GetUnits(), no list is built so it can be used in loops without memory allocation.
+      The view remains valid as long as no unit is added to or removed from the class.
+      Returns an empty view if the units class does not exist.
+      @param[in] ClassName the requested class
+      @code
+      for (openfluid::core::SpatialUnit* TU : OPENFLUID_GetUnitsSpan("TU"))
+      {
+        // processing of TU
+      }
+      @endcode
+    */
+    openfluid::core::UnitsSpan OPENFLUID_GetUnitsSpan(const openfluid::core::UnitsClass_t& ClassName) const;
+
     /**
       Returns true if a given unit is connected "to" another unit
       @param[in] aUnit the given unit
@@ -572,6 +613,29 @@ class OPENFLUID_API SimulationInspectorWare : public SimulationDrivenWare
                                   const openfluid::core::UnitID_t& IDChild) const;
 
 
+    /**
+      Returns the compressed adjacency of the links of a given type, from the units of a class
+      to the units of another class. Neighbours of a unit are then accessed as a contiguous span,
+      using the dense index of the unit.
+      The adjacency is built once the spatial graph is checked, and rebuilt if the spatial graph is modified.
+      It must not be requested from threaded code.
+      @param[in] SourceClass the class of the source units
+      @param[in] LinkType the type of links
+      @param[in] TargetClass the class of the linked units
+      @return the adjacency, nullptr if no link of this type exists between these classes
+    */
+    const openfluid::core::UnitsAdjacency* OPENFLUID_GetUnitsAdjacency(const openfluid::core::UnitsClass_t& SourceClass,
+                                                                      openfluid::core::UnitsLinkType LinkType,
+                                                                      const openfluid::core::UnitsClass_t& TargetClass);
+
+    /**
+      Returns the regular grid of units of a class, as built using OPENFLUID_BuildUnitsGrid()
+      @param[in] UnitsClass the units class of the grid
+      @return the grid, nullptr if no grid exists for this class
+    */
+    openfluid::core::UnitsGrid* OPENFLUID_GetUnitsGrid(const openfluid::core::UnitsClass_t& UnitsClass);
+
+
     SimulationInspectorWare(WareType WType) : SimulationDrivenWare(WType),
       mp_Datastore(nullptr), mp_SpatialData(nullptr)
     { };
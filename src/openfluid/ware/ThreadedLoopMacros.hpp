@@ -62,46 +62,40 @@
 
 
 #define _APPLY_UNITS_ORDERED_LOOP_THREADED_WITHID(id,unitsclass,funcptr,...) \
-  openfluid::core::UnitsList_t* _UNITSLISTID(id) = mp_SpatialData->spatialUnits(unitsclass)->list(); \
+  const openfluid::core::UnitsCollection* _UNITSLISTID(id) = mp_SpatialData->spatialUnits(unitsclass); \
   if (_UNITSLISTID(id) != nullptr) \
   { \
-    openfluid::core::UnitsList_t::iterator _UNITSLISTITERID(id) = _UNITSLISTID(id)->begin(); \
-    if (_UNITSLISTITERID(id) != _UNITSLISTID(id)->end()) \
+    for (std::size_t _PCSORDID(id) = 0; _PCSORDID(id) < _UNITSLISTID(id)->getLevelsCount(); ++_PCSORDID(id)) \
     { \
-      openfluid::core::PcsOrd_t _PCSORDID(id) = _UNITSLISTITERID(id)->getProcessOrder(); \
-      while (_UNITSLISTITERID(id) != _UNITSLISTID(id)->end()) \
+      std::vector<std::thread> _THREADGROUPID(id); \
+      for (std::size_t _UNITSLISTITERID(id) = _UNITSLISTID(id)->levelsOffsets()->at(_PCSORDID(id)); \
+           _UNITSLISTITERID(id) < _UNITSLISTID(id)->levelsOffsets()->at(_PCSORDID(id)+1); \
+           ++_UNITSLISTITERID(id)) \
       { \
-        std::vector<std::thread> _THREADGROUPID(id); \
-        while (_UNITSLISTITERID(id) != _UNITSLISTID(id)->end() && \
-               _UNITSLISTITERID(id)->getProcessOrder() == _PCSORDID(id)) \
+        try \
         { \
-          try \
-          { \
-            _THREADGROUPID(id).push_back(std::thread(std::bind(&funcptr,this,\
-                                                    &(*_UNITSLISTITERID(id)),## __VA_ARGS__))); \
-            if (_THREADGROUPID(id).size() == (unsigned int)OPENFLUID_GetSimulatorMaxThreads()) \
-            { \
-              for (auto& _THREADID(id) : _THREADGROUPID(id)) \
-                _THREADID(id).join(); \
-              _THREADGROUPID(id).clear(); \
-            } \
-          } \
-          catch (std::system_error& E) \
+          _THREADGROUPID(id).push_back(std::thread(std::bind(&funcptr,this,\
+                                                  _UNITSLISTID(id)->unitAt(_UNITSLISTITERID(id)),## __VA_ARGS__))); \
+          if (_THREADGROUPID(id).size() == (unsigned int)OPENFLUID_GetSimulatorMaxThreads()) \
           { \
-            throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, \
-                                                      "Error in threaded loop (" + std::string(E.what()) +")"); \
+            for (auto& _THREADID(id) : _THREADGROUPID(id)) \
+              _THREADID(id).join(); \
+            _THREADGROUPID(id).clear(); \
           } \
-          ++_UNITSLISTITERID(id); \
         } \
-        for (auto& _THREADID(id) : _THREADGROUPID(id)) \
-          _THREADID(id).join(); \
-        _THREADGROUPID(id).clear(); \
-        if (_UNITSLISTITERID(id) != _UNITSLISTID(id)->end()) \
-          _PCSORDID(id) = _UNITSLISTITERID(id)->getProcessOrder(); \
+        catch (std::system_error& E) \
+        { \
+          throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, \
+                                                    "Error in threaded loop (" + std::string(E.what()) +")"); \
+        } \
       } \
+      for (auto& _THREADID(id) : _THREADGROUPID(id)) \
+        _THREADID(id).join(); \
+      _THREADGROUPID(id).clear(); \
     } \
   }
 
+
 /**
   Macro for applying a threaded simulator to each unit of a class, following their process order
   @param[in] unitsclass name of the units class
@@ -65,6 +65,12 @@ BEGIN_SIMULATOR_SIGNATURE("tests.generators")
   DECLARE_REQUIRED_VARIABLE("tests.fixed-vector[vector]","TestUnits","fixed value from generators for tests","");
   DECLARE_REQUIRED_VARIABLE("tests.random[double]","TestUnits","random value from generators for tests","");
   DECLARE_REQUIRED_VARIABLE("tests.random-vector[vector]","TestUnits","random value from generators for tests","");
+  DECLARE_REQUIRED_VARIABLE("tests.random-seeded[double]","TestUnits",
+                            "seeded random value from generators for tests","");
+  DECLARE_REQUIRED_VARIABLE("tests.random-normal[double]","TestUnits",
+                            "normally distributed random value from generators for tests","");
+  DECLARE_REQUIRED_VARIABLE("tests.random-lognormal[vector]","TestUnits",
+                            "log-normally distributed random value from generators for tests","");
   DECLARE_REQUIRED_VARIABLE("tests.interp[double]","TestUnits","interpolated value from generators for tests","");
   DECLARE_REQUIRED_VARIABLE("tests.interp-vector[vector]","TestUnits",
                             "interpolated value from generators for tests","");
@@ -163,6 +169,30 @@ class GeneratorsSimulator : public openfluid::ware::PluggableSimulator
         OPENFLUID_RaiseError("incorrect value for tests.random variable");
 
 
+      OPENFLUID_GetVariable(TU,"tests.random-seeded",OPENFLUID_GetCurrentTimeIndex(),SValue);
+      if (!(SValue >= 20.53 && SValue<= 50.0))
+        OPENFLUID_RaiseError("incorrect value for tests.random-seeded variable");
+
+      if (OPENFLUID_GetCurrentTimeIndex() > 0)
+      {
+        openfluid::core::DoubleValue PrevSValue;
+        OPENFLUID_GetVariable(TU,"tests.random-seeded",
+                              OPENFLUID_GetCurrentTimeIndex()-OPENFLUID_GetDefaultDeltaT(),PrevSValue);
+        if (openfluid::scientific::isCloseEnough<double>(SValue,PrevSValue,1e-12))
+          OPENFLUID_RaiseError("incorrect value for tests.random-seeded variable (same value as previous step)");
+      }
+
+
+      OPENFLUID_GetVariable(TU,"tests.random-normal",OPENFLUID_GetCurrentTimeIndex(),SValue);
+      if (!openfluid::scientific::isCloseEnough<double>(SValue,10.0))
+        OPENFLUID_RaiseError("incorrect value for tests.random-normal variable");
+
+
+      OPENFLUID_GetVariable(TU,"tests.random-lognormal",OPENFLUID_GetCurrentTimeIndex(),VValue);
+      if (VValue.size() != 5 || !(VValue[0] > 0.0) || !openfluid::scientific::isCloseEnough(VValue[0],VValue[4]))
+        OPENFLUID_RaiseError("incorrect value for tests.random-lognormal variable");
+
+
       OPENFLUID_GetVariable(TU,"tests.interp",OPENFLUID_GetCurrentTimeIndex(),SValue);
 
       if (TU->getID() % 2 != 0)
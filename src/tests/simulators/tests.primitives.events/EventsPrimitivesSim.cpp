@@ -244,11 +244,35 @@ class EventsPrimitivesUseSimulator : public openfluid::ware::PluggableSimulator
       EndDate = OPENFLUID_GetCurrentDate()- 1;
 
 
+      openfluid::core::UnitsEventsRanges_t UnitsEvents;
+      OPENFLUID_GetEventsRanges("TestUnits",BeginDate,EndDate,UnitsEvents);
+
+      for (auto& UnitEvents : UnitsEvents)
+      {
+        if (UnitEvents.second.empty())
+          OPENFLUID_RaiseError("unexpected empty events range");
+
+        if (UnitEvents.second.size() != OPENFLUID_GetEventsRange(UnitEvents.first,BeginDate,EndDate).size())
+          OPENFLUID_RaiseError("wrong events range size on some TestUnit");
+      }
+
+
       OPENFLUID_UNITS_ORDERED_LOOP("TestUnits",aUnit)
       {
         EvColl.clear();
         OPENFLUID_GetEvents(aUnit,BeginDate,EndDate,EvColl);
 
+        openfluid::core::EventsRange EvRange = OPENFLUID_GetEventsRange(aUnit,BeginDate,EndDate);
+
+        if (EvRange.size() != (std::size_t)EvColl.getCount())
+          OPENFLUID_RaiseError("wrong events range size on some TestUnit");
+
+        for (const openfluid::core::Event& RangeEvent : EvRange)
+        {
+          if (RangeEvent.getDateTime() < BeginDate || EndDate < RangeEvent.getDateTime())
+            OPENFLUID_RaiseError("event out of range on some TestUnit");
+        }
+
         OPENFLUID_EVENT_COLLECTION_LOOP(EvColl.eventsList(),Event)
         {
     //      std::cout << std::endl << "========== Unit " << aUnit->getID() << " ==========" << std::endl;
@@ -202,6 +202,24 @@ class LandPrimitivesSimulator : public openfluid::ware::PluggableSimulator
       if (!OPENFLUID_GetUnits("FU").empty())
         OPENFLUID_RaiseError("incorrect number of units in FU units list");
 
+      if (OPENFLUID_GetUnitsSpan("MU").size() != (Cols*Rows))
+        OPENFLUID_RaiseError("incorrect number of units in MU units span");
+
+      if (!OPENFLUID_GetUnitsSpan("FU").empty())
+        OPENFLUID_RaiseError("incorrect number of units in FU units span");
+
+      {
+        openfluid::core::UnitsPtrList_t UList = OPENFLUID_GetUnits("TU");
+        openfluid::core::UnitsPtrList_t::const_iterator ListIt = UList.begin();
+
+        for (openfluid::core::SpatialUnit* TU : OPENFLUID_GetUnitsSpan("TU"))
+        {
+          if (ListIt == UList.end() || *ListIt != TU)
+            OPENFLUID_RaiseError("incorrect units sequence in TU units span");
+          ++ListIt;
+        }
+      }
+
 
 
       auto CheckUnitsList = [this,Cols,Rows](const openfluid::core::UnitsClass_t& ClassName)
@@ -66,6 +66,10 @@ BEGIN_SIMULATOR_SIGNATURE("tests.threadedloops")
 
   DECLARE_PRODUCED_VARIABLE("tests.data.sequence[double]","TU","sequenced test data","");
   DECLARE_PRODUCED_VARIABLE("tests.data.threaded[double]","TU","threaded test data","");
+  DECLARE_PRODUCED_VARIABLE("tests.data.accumulated[double]","TU","upstream accumulated test data","");
+
+  DECLARE_REQUIRED_ATTRIBUTE("upstream.idssum","TU","sum of IDs of the unit and its upstream units","");
+  DECLARE_REQUIRED_ATTRIBUTE("upstream.count","TU","number of units in the upstream tree of the unit","");
 
 
 
@@ -140,6 +144,7 @@ class ThreadedLoopsSimulator : public openfluid::ware::PluggableSimulator
     {
       OPENFLUID_InitializeVariable(TU,"tests.data.sequence",0.0);
       OPENFLUID_InitializeVariable(TU,"tests.data.threaded",0.0);
+      OPENFLUID_InitializeVariable(TU,"tests.data.accumulated",0.0);
     }
 
     return DefaultDeltaT();
@@ -249,6 +254,49 @@ class ThreadedLoopsSimulator : public openfluid::ware::PluggableSimulator
     std::cout << "TU Production Threaded: " << Duration.count() << "ms"  << std::endl;
 
 
+    StartTime = std::chrono::high_resolution_clock::now();
+
+    OPENFLUID_AccumulateUpstream("TU","tests.data.sequence","tests.data.accumulated");
+
+    EndTime = std::chrono::high_resolution_clock::now();
+    Duration = std::chrono::duration_cast<std::chrono::milliseconds>(EndTime - StartTime);
+    std::cout << "TU Upstream accumulation: " << Duration.count() << "ms"  << std::endl;
+
+    OPENFLUID_UNITS_ORDERED_LOOP("TU",TU)
+    {
+      double Expected = 0.0;
+      double Value = 0.0;
+
+      OPENFLUID_GetVariable(TU,"tests.data.sequence",Expected);
+
+      const openfluid::core::UnitsPtrList_t* UpTUs = TU->fromSpatialUnits("TU");
+      if (UpTUs != nullptr)
+      {
+        for (openfluid::core::SpatialUnit* UpTU : *UpTUs)
+        {
+          OPENFLUID_GetVariable(UpTU,"tests.data.accumulated",Value);
+          Expected += Value;
+        }
+      }
+
+      OPENFLUID_GetVariable(TU,"tests.data.accumulated",Value);
+
+      if (std::abs(Value-Expected) > 1e-9*std::max(1.0,std::abs(Expected)))
+        OPENFLUID_RaiseError("wrong upstream accumulated value");
+
+      // reference value computed on the whole spatial domain, also valid when the domain is partitioned
+      long IDsSum = 0;
+      long Count = 0;
+
+      OPENFLUID_GetAttribute(TU,"upstream.idssum",IDsSum);
+      OPENFLUID_GetAttribute(TU,"upstream.count",Count);
+      Expected = IDsSum+Count*(OPENFLUID_GetCurrentTimeIndex()/OPENFLUID_GetDefaultDeltaT())/1000.0;
+
+      if (std::abs(Value-Expected) > 1e-9*std::max(1.0,std::abs(Expected)))
+        OPENFLUID_RaiseError("wrong upstream accumulated value compared to the whole domain");
+    }
+
+
     StartTime = std::chrono::high_resolution_clock::now();
     m_LastOrd = 0;
     OPENFLUID_UNITS_ORDERED_LOOP("TU",TU)